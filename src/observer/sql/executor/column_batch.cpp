@@ -0,0 +1,364 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+
+#include "sql/executor/column_batch.h"
+#include "storage/common/table_meta.h"
+#include "storage/common/field_meta.h"
+#include "storage/common/record_manager.h"
+#include "common/log/log.h"
+
+void ColumnVector::init(const FieldMeta *field, int null_offset) {
+  field_ = field;
+  null_offset_ = null_offset;
+  size_ = 0;
+  ints_.clear();
+  floats_.clear();
+  if (field->type() == INTS) {
+    ints_.resize(COLUMN_BATCH_SIZE);
+  } else if (field->type() == FLOATS) {
+    floats_.resize(COLUMN_BATCH_SIZE);
+  }
+  nulls_.assign((COLUMN_BATCH_SIZE + 63) / 64, 0);
+}
+
+void ColumnVector::clear() {
+  size_ = 0;
+  std::fill(nulls_.begin(), nulls_.end(), 0);
+}
+
+void ColumnVector::append(const char *record) {
+  if (record[null_offset_] != 0) {
+    nulls_[size_ >> 6] |= (uint64_t)1 << (size_ & 63);
+  } else if (field_->type() == INTS) {
+    memcpy(&ints_[size_], record + field_->offset(), sizeof(int32_t));
+  } else if (field_->type() == FLOATS) {
+    memcpy(&floats_[size_], record + field_->offset(), sizeof(float));
+  }
+  size_++;
+}
+
+void ColumnBatch::init(const std::vector<const FieldMeta *> &fields, const TableMeta &table_meta) {
+  // 和TupleRecordConverter一样，NULL标志紧跟在最后一个字段后面，每个字段一个字节，不包括第一个系统字段
+  const FieldMeta *last_field = table_meta.field(table_meta.field_num() - 1);
+  const int null_field_index = last_field->offset() + last_field->len();
+  columns_.resize(fields.size());
+  for (size_t i = 0; i < fields.size(); i++) {
+    int field_index = table_meta.find_field_index_by_name(fields[i]->name());
+    columns_[i].init(fields[i], null_field_index + field_index - 1);
+  }
+  selection_.reserve(COLUMN_BATCH_SIZE);
+  clear();
+}
+
+void ColumnBatch::clear() {
+  for (ColumnVector &column : columns_) {
+    column.clear();
+  }
+  selection_.clear();
+  size_ = 0;
+}
+
+void ColumnBatch::append(const char *record) {
+  for (ColumnVector &column : columns_) {
+    column.append(record);
+  }
+  selection_.push_back(size_++);
+}
+
+// 和DefaultConditionFilter中浮点数的比较相同，差值在1e-6以内认为相等
+static int compare_float(float left, float right) {
+  float result = left - right;
+  if (result < 1e-6 && result > -1e-6) {
+    return 0;
+  }
+  return result > 0 ? 1 : -1;
+}
+
+static bool compare_result(int result, CompOp comp_op) {
+  switch (comp_op) {
+  case EQUAL_TO:
+    return result == 0;
+  case LESS_EQUAL:
+    return result <= 0;
+  case NOT_EQUAL:
+    return result != 0;
+  case LESS_THAN:
+    return result < 0;
+  case GREAT_EQUAL:
+    return result >= 0;
+  default:
+    return result > 0;
+  }
+}
+
+// 保留selection中不为NULL并且满足match的行，每种比较符展开成单独的循环
+template <typename T, typename Match>
+static void select_rows(const T *values, const ColumnVector &column, std::vector<uint16_t> &rows, Match match) {
+  size_t num = 0;
+  for (uint16_t row : rows) {
+    if (!column.is_null(row) && match(values[row])) {
+      rows[num++] = row;
+    }
+  }
+  rows.resize(num);
+}
+
+template <typename T>
+static void select_rows(const T *values, const ColumnVector &column, std::vector<uint16_t> &rows, CompOp comp_op,
+                        T value) {
+  switch (comp_op) {
+  case EQUAL_TO:
+    select_rows(values, column, rows, [value](T v) { return v == value; });
+    break;
+  case LESS_EQUAL:
+    select_rows(values, column, rows, [value](T v) { return v <= value; });
+    break;
+  case NOT_EQUAL:
+    select_rows(values, column, rows, [value](T v) { return v != value; });
+    break;
+  case LESS_THAN:
+    select_rows(values, column, rows, [value](T v) { return v < value; });
+    break;
+  case GREAT_EQUAL:
+    select_rows(values, column, rows, [value](T v) { return v >= value; });
+    break;
+  default:
+    select_rows(values, column, rows, [value](T v) { return v > value; });
+    break;
+  }
+}
+
+RC ColumnScanExeNode::init(Trx *trx, Table *table, const std::vector<DefaultConditionFilter *> &condition_filters,
+                           const std::vector<const FieldMeta *> &fields) {
+  trx_ = trx;
+  table_ = table;
+  fields_ = fields;
+  all_filters_.clear();
+  row_filters_.clear();
+  column_filters_.clear();
+
+  const TableMeta &table_meta = table->table_meta();
+  for (DefaultConditionFilter *filter : condition_filters) {
+    all_filters_.push_back(filter);
+    const AttrType type = filter->attr_type();
+    const CompOp comp_op = filter->comp_op();
+    if (!filter->left().is_attr || filter->right().is_attr || (type != INTS && type != FLOATS) ||
+        filter->another_attr_type() != type || comp_op > GREAT_THAN) {
+      row_filters_.push_back(filter);
+      continue;
+    }
+
+    const FieldMeta *field = nullptr;
+    for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+      if (table_meta.field(i)->offset() == filter->left().attr_offset && table_meta.field(i)->type() == type) {
+        field = table_meta.field(i);
+        break;
+      }
+    }
+    if (nullptr == field) {
+      row_filters_.push_back(filter);
+      continue;
+    }
+    ColumnFilter column_filter{add_column(field), comp_op, 0, 0};
+    if (type == INTS) {
+      memcpy(&column_filter.int_value, filter->right().value, sizeof(int32_t));
+    } else {
+      memcpy(&column_filter.float_value, filter->right().value, sizeof(float));
+    }
+    column_filters_.push_back(column_filter);
+  }
+
+  field_names_.clear();
+  for (const FieldMeta *field : fields_) {
+    field_names_.push_back(field->name());
+  }
+  return RC::SUCCESS;
+}
+
+int ColumnScanExeNode::add_column(const FieldMeta *field) {
+  auto iter = std::find(fields_.begin(), fields_.end(), field);
+  if (iter != fields_.end()) {
+    return iter - fields_.begin();
+  }
+  fields_.push_back(field);
+  return fields_.size() - 1;
+}
+
+void ColumnScanExeNode::init_batch(ColumnBatch &batch) const {
+  batch.init(fields_, table_->table_meta());
+}
+
+RC ColumnScanExeNode::open() {
+  eof_ = false;
+  all_filter_.init(all_filters_.data(), all_filters_.size());
+  row_filter_.init(row_filters_.data(), row_filters_.size());
+  // 索引按全部条件选择；扫描全表时，能按列计算的条件留到批次上过滤
+  RC rc = scanner_.open(table_, trx_, &all_filter_, &row_filter_, field_names_.data(), field_names_.size());
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  use_column_filters_ = !scanner_.uses_index() && !column_filters_.empty();
+  if (use_column_filters_) {
+    LOG_INFO("按列过滤%d个条件, 逐行过滤%d个条件", (int)column_filters_.size(), (int)row_filters_.size());
+  }
+  return RC::SUCCESS;
+}
+
+RC ColumnScanExeNode::next_batch(ColumnBatch &batch) {
+  batch.clear();
+  if (eof_) {
+    return RC::RECORD_EOF;
+  }
+  RC rc = RC::SUCCESS;
+  Record record;
+  while (batch.size() < COLUMN_BATCH_SIZE && (rc = scanner_.next(record)) == RC::SUCCESS) {
+    batch.append(record.data);
+  }
+  if (rc == RC::RECORD_EOF) {
+    eof_ = true;
+  } else if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to scan table %s by batch. rc=%d:%s", table_->name(), rc, strrc(rc));
+    return rc;
+  }
+  if (batch.size() == 0) {
+    return RC::RECORD_EOF;
+  }
+  if (use_column_filters_) {
+    filter_batch(batch);
+  }
+  return RC::SUCCESS;
+}
+
+void ColumnScanExeNode::close() {
+  scanner_.close();
+}
+
+void ColumnScanExeNode::filter_batch(ColumnBatch &batch) const {
+  std::vector<uint16_t> &rows = batch.selection();
+  for (const ColumnFilter &filter : column_filters_) {
+    const ColumnVector &column = batch.column(filter.column);
+    if (column.field()->type() == INTS) {
+      select_rows(column.ints(), column, rows, filter.comp_op, filter.int_value);
+    } else {
+      const float value = filter.float_value;
+      const CompOp comp_op = filter.comp_op;
+      select_rows(column.floats(), column, rows,
+                  [value, comp_op](float v) { return compare_result(compare_float(v, value), comp_op); });
+    }
+  }
+}
+
+void ColumnAggregator::add(FuncType func_type, int column, AttrType type) {
+  aggregates_.push_back({func_type, column, type, 0, 0, 0, 0});
+}
+
+void ColumnAggregator::update(const ColumnBatch &batch) {
+  const std::vector<uint16_t> &rows = batch.selection();
+  for (Aggregate &aggregate : aggregates_) {
+    if (aggregate.column < 0) {
+      aggregate.count += rows.size();
+      continue;
+    }
+    const ColumnVector &column = batch.column(aggregate.column);
+    if (aggregate.func_type == FuncType::COUNT) {
+      for (uint16_t row : rows) {
+        aggregate.count += !column.is_null(row);
+      }
+    } else if (aggregate.type == INTS) {
+      update_ints(aggregate, column, rows);
+    } else {
+      update_floats(aggregate, column, rows);
+    }
+  }
+}
+
+void ColumnAggregator::update_ints(Aggregate &aggregate, const ColumnVector &column, const std::vector<uint16_t> &rows) {
+  const int32_t *values = column.ints();
+  switch (aggregate.func_type) {
+  case FuncType::AVG:
+    for (uint16_t row : rows) {
+      if (!column.is_null(row)) {
+        aggregate.sum += values[row];
+        aggregate.count++;
+      }
+    }
+    break;
+  case FuncType::MAX:
+    for (uint16_t row : rows) {
+      if (!column.is_null(row) && (aggregate.count++ == 0 || values[row] > aggregate.int_value)) {
+        aggregate.int_value = values[row];
+      }
+    }
+    break;
+  default:
+    for (uint16_t row : rows) {
+      if (!column.is_null(row) && (aggregate.count++ == 0 || values[row] < aggregate.int_value)) {
+        aggregate.int_value = values[row];
+      }
+    }
+    break;
+  }
+}
+
+void ColumnAggregator::update_floats(Aggregate &aggregate, const ColumnVector &column,
+                                     const std::vector<uint16_t> &rows) {
+  const float *values = column.floats();
+  switch (aggregate.func_type) {
+  case FuncType::AVG:
+    for (uint16_t row : rows) {
+      if (!column.is_null(row)) {
+        aggregate.sum += values[row];
+        aggregate.count++;
+      }
+    }
+    break;
+  case FuncType::MAX:
+    for (uint16_t row : rows) {
+      if (!column.is_null(row) &&
+          (aggregate.count++ == 0 || compare_float(values[row], aggregate.float_value) > 0)) {
+        aggregate.float_value = values[row];
+      }
+    }
+    break;
+  default:
+    for (uint16_t row : rows) {
+      if (!column.is_null(row) &&
+          (aggregate.count++ == 0 || compare_float(values[row], aggregate.float_value) < 0)) {
+        aggregate.float_value = values[row];
+      }
+    }
+    break;
+  }
+}
+
+AttrType ColumnAggregator::output(int index, Tuple &tuple) const {
+  const Aggregate &aggregate = aggregates_[index];
+  if (aggregate.func_type == FuncType::COUNT) {
+    tuple.add(aggregate.count);
+    return INTS;
+  }
+  if (aggregate.count == 0) {
+    tuple.add("NULL", 4);
+    return CHARS;
+  }
+  if (aggregate.func_type == FuncType::AVG) {
+    tuple.add(aggregate.sum / aggregate.count);
+    return FLOATS;
+  }
+  if (aggregate.type == FLOATS) {
+    tuple.add(aggregate.float_value);
+  } else {
+    tuple.add(aggregate.int_value);
+  }
+  return aggregate.type;
+}
@@ -0,0 +1,164 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_SQL_EXECUTOR_COLUMN_BATCH_H_
+#define __OBSERVER_SQL_EXECUTOR_COLUMN_BATCH_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "storage/common/table.h"
+#include "storage/common/condition_filter.h"
+#include "sql/executor/tuple.h"
+
+class Trx;
+class FieldMeta;
+
+// 一批最多包含的行数
+#define COLUMN_BATCH_SIZE 1024
+
+/**
+ * 一批记录中的一列。整数和浮点数连续存放在数组里，其它类型只记录是否为NULL，NULL用位图表示
+ */
+class ColumnVector {
+public:
+  void init(const FieldMeta *field, int null_offset);
+  void clear();
+  void append(const char *record);
+
+  const FieldMeta *field() const {
+    return field_;
+  }
+  bool is_null(int row) const {
+    return (nulls_[row >> 6] >> (row & 63)) & 1;
+  }
+  const int32_t *ints() const {
+    return ints_.data();
+  }
+  const float *floats() const {
+    return floats_.data();
+  }
+
+private:
+  const FieldMeta *field_ = nullptr;
+  int null_offset_ = 0;       // 这个字段的NULL标志在记录中的偏移
+  int size_ = 0;
+  std::vector<int32_t> ints_;
+  std::vector<float> floats_;
+  std::vector<uint64_t> nulls_;
+};
+
+/**
+ * 算子之间传递的列式批次。selection中是通过了过滤条件的行号，过滤只缩小selection，不移动数据
+ */
+class ColumnBatch {
+public:
+  void init(const std::vector<const FieldMeta *> &fields, const TableMeta &table_meta);
+  void clear();
+  void append(const char *record);
+
+  int size() const {
+    return size_;
+  }
+  ColumnVector &column(int index) {
+    return columns_[index];
+  }
+  const ColumnVector &column(int index) const {
+    return columns_[index];
+  }
+  std::vector<uint16_t> &selection() {
+    return selection_;
+  }
+  const std::vector<uint16_t> &selection() const {
+    return selection_;
+  }
+
+private:
+  std::vector<ColumnVector> columns_;
+  std::vector<uint16_t> selection_;
+  int size_ = 0;
+};
+
+/**
+ * 按批扫描一张表，每次输出最多COLUMN_BATCH_SIZE行。
+ * 全表扫描时，字段和常量之间类型相同的整数、浮点数比较在批次上逐列过滤，其它条件仍然由存储层逐条判断；
+ * 用到索引时所有条件都交给存储层，保证索引的选择和逐行执行时相同
+ */
+class ColumnScanExeNode {
+public:
+  // fields是需要输出的列，过滤条件用到的列会自动追加在后面
+  RC init(Trx *trx, Table *table, const std::vector<DefaultConditionFilter *> &condition_filters,
+          const std::vector<const FieldMeta *> &fields);
+
+  // 按照扫描输出的列初始化批次，next_batch之前调用一次
+  void init_batch(ColumnBatch &batch) const;
+
+  RC open();
+  // 没有更多记录时返回RC::RECORD_EOF。输出的批次可能一行都没有通过过滤
+  RC next_batch(ColumnBatch &batch);
+  void close();
+
+private:
+  struct ColumnFilter {
+    int column;
+    CompOp comp_op;
+    int32_t int_value;
+    float float_value;
+  };
+
+  int add_column(const FieldMeta *field);
+  void filter_batch(ColumnBatch &batch) const;
+
+private:
+  Trx *trx_ = nullptr;
+  Table *table_ = nullptr;
+  std::vector<const FieldMeta *> fields_;
+  std::vector<const char *> field_names_;
+  std::vector<const ConditionFilter *> all_filters_;
+  std::vector<const ConditionFilter *> row_filters_;   // 不能按列计算的条件
+  std::vector<ColumnFilter> column_filters_;
+  CompositeConditionFilter all_filter_;
+  CompositeConditionFilter row_filter_;
+  bool use_column_filters_ = false;
+  bool eof_ = false;
+  TableScanner scanner_;
+};
+
+/**
+ * 在列批次上计算不分组的COUNT/MIN/MAX/AVG，每个聚合函数是一个遍历数组的循环。
+ * 计算的顺序和结果与逐行的HashAggregator相同，AVG同样用float累加
+ */
+class ColumnAggregator {
+public:
+  // column为-1表示COUNT(*)
+  void add(FuncType func_type, int column, AttrType type);
+  void update(const ColumnBatch &batch);
+  // 第index个聚合函数的结果追加到tuple中，返回结果的类型，没有非NULL值时结果是字符串NULL
+  AttrType output(int index, Tuple &tuple) const;
+
+private:
+  struct Aggregate {
+    FuncType func_type;
+    int column;
+    AttrType type;
+    int count;
+    float sum;
+    int32_t int_value;
+    float float_value;
+  };
+
+  static void update_ints(Aggregate &aggregate, const ColumnVector &column, const std::vector<uint16_t> &rows);
+  static void update_floats(Aggregate &aggregate, const ColumnVector &column, const std::vector<uint16_t> &rows);
+
+private:
+  std::vector<Aggregate> aggregates_;
+};
+
+#endif //__OBSERVER_SQL_EXECUTOR_COLUMN_BATCH_H_
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Longda on 2021/4/13.
 //
 
+#include <limits.h>
 #include <string>
 #include <sstream>
 #include <algorithm>
@@ -28,6 +29,10 @@ See the Mulan PSL v2 for more details. */
 #include "event/session_event.h"
 #include "event/execution_plan_event.h"
 #include "sql/executor/execution_node.h"
+#include "sql/executor/column_batch.h"
+#include "sql/executor/hash_aggregator.h"
+#include "sql/executor/external_sorter.h"
+#include "sql/executor/semi_join.h"
 #include "sql/executor/tuple.h"
 #include "storage/common/table.h"
 #include "storage/default/default_handler.h"
@@ -38,7 +43,6 @@ using namespace common;
 
 static RC schema_add_field(Table *table, const char *field_name, TupleSchema &schema);
 
-RC do_aggregation(TupleSet *tuple_set, AttrFunction *attr_function, std::vector<TupleSet> &results, int rel_num);
 
 RC create_selection_executor(Trx *trx, const Selects &selects, const char *db, const char *table_name, SelectExeNode &select_node, bool is_sub_select);
 
@@ -50,7 +54,31 @@ bool cmp_value(AttrType left_type, AttrType right_type, void *left_data, const s
 
 int is_col_legal(const RelAttr &attr, const TupleSchema &schema);
 
-void quick_sort(TupleSet *tuple_set, int l, int r, OrderInfo *order_info);
+static RC make_sort_keys(const Selects &selects, const TupleSchema &schema, std::vector<SortKey> &keys);
+
+static bool set_order_by_index(const Selects &selects, const char *db, SelectExeNode &select_node);
+static void set_merge_join_by_index(const Selects &selects, const char *db, std::vector<SelectExeNode *> &select_nodes);
+static bool may_lookup_by_index(const Selects &selects, const char *db, size_t table_index);
+static bool can_aggregate_by_column(const Selects &selects, const Table *table);
+static RC do_column_aggregation(Trx *trx, const Selects &selects, SelectExeNode &select_node, TupleSet &result);
+static void collect_attr_functions(const Selects &selects, AttrFunction &attr_function);
+static bool single_table_expression(const Condition &condition, std::string &table_name, std::vector<std::string> &fields);
+static RC filter_by_expression(const Condition &condition, TupleSet &result);
+static bool can_push_down_limit(const Selects &selects, bool ordered_by_index);
+static int limit_end(const Selects &selects);
+static void apply_limit(const Selects &selects, TupleSet &tuple_set);
+static RC make_aggregate_specs(const TupleSchema &schema, AttrFunction &attr_function, int rel_num,
+                               std::vector<AggregateSpec> &specs);
+static RC aggregate(ExecutionNode *source, const TupleSet &result, const std::vector<int> &group_index,
+                    const std::vector<AggregateSpec> &specs, TupleSet &output);
+static bool need_materialize(const Selects &selects);
+static bool is_outer_attr(const Selects &sub_select, const RelAttr &attr, const char *main_table);
+static RC decorrelate_sub_select(Selects &sub_select, const char *main_table, bool is_in, bool &is_related, RelAttr &outer_attr,
+                                 RelAttr &key_attr);
+static int sub_select_key_index(const TupleSchema &schema, const RelAttr &key_attr);
+static std::shared_ptr<TupleValue> value_to_tuple_value(const Value &value);
+static bool compare_sub_value(AttrType left_type, AttrType right_type, const std::shared_ptr<TupleValue> &left_value, CompOp op,
+                              const std::shared_ptr<TupleValue> &right_value);
 
 bool is_type_legal(AttrType left_type, AttrType right_type);
 
@@ -154,7 +182,6 @@ void ExecuteStage::handle_request(common::StageEvent *event)
   case SCF_SELECT:
   { // select
     TupleSet tmp;
-    is_related = false;
     do_select(current_db, sql->sstr.selection, exe_event->sql_event()->session_event(), tmp);
     exe_event->done_immediate();
   }
@@ -170,6 +197,7 @@ void ExecuteStage::handle_request(common::StageEvent *event)
   case SCF_CREATE_INDEX:
   case SCF_DROP_INDEX:
   case SCF_LOAD_DATA:
+  case SCF_ANALYZE:
   {
     StorageEvent *storage_event = new (std::nothrow) StorageEvent(exe_event);
     if (storage_event == nullptr)
@@ -267,171 +295,19 @@ void end_trx_if_need(Session *session, Trx *trx, bool all_right)
   }
 }
 
-bool valueCompare(const TupleValue *value_a, const TupleValue *value_b, CompOp op)
+// 从最后一张表开始，依次把前一张表连接到已有的结果上，列和行的顺序与逐表嵌套循环的结果相同。
+// 各个连接节点串成一条流水线：最后一张表逐条扫描，每个连接节点从下层分批拉取元组，返回最上层的节点。
+// deferred[i]为true的表先尝试用它的索引逐键查找，不划算时再扫描全表。join_nodes比表少一个，只有一张表时返回它的扫描节点
+static ExecutionNode *build_join_pipeline(std::vector<SelectExeNode *> &select_nodes, const std::vector<bool> &deferred,
+                                          const Selects &selects, std::vector<StreamJoinExeNode> &join_nodes)
 {
-  bool compare_result = false;
-  switch (op)
-  {
-  case EQUAL_TO:
-    compare_result = (value_a->compare(*value_b) == 0);
-    break;
-  case LESS_EQUAL:
-    compare_result = (value_a->compare(*value_b) <= 0);
-    break;
-  case NOT_EQUAL:
-    compare_result = (value_a->compare(*value_b) != 0);
-    break;
-  case LESS_THAN:
-    compare_result = (value_a->compare(*value_b) < 0);
-    break;
-  case GREAT_EQUAL:
-    compare_result = (value_a->compare(*value_b) >= 0);
-    break;
-  case GREAT_THAN:
-    compare_result = (value_a->compare(*value_b) > 0);
-    break;
-  default:
-    break;
-  }
-  return compare_result;
-}
-
-// 判断Tuple是否满足条件
-bool isTupleSatisfy(const Tuple &tp, const TupleSchema &schema, const Selects &selects)
-{
-  bool valid = true;
-  for (size_t i = 0; i < selects.condition_num; i++)
-  {
-    const Condition &cond = selects.conditions[i];
-    // 只考虑两边都是attr的condition
-    if (cond.left_is_attr == 1 && cond.right_is_attr == 1)
-    {
-      int left_index = schema.index_of_field(cond.left_attr.relation_name, cond.left_attr.attribute_name);
-      int right_index = schema.index_of_field(cond.right_attr.relation_name, cond.right_attr.attribute_name);
-      TupleValue *va = tp.get_pointer(left_index).get();
-      TupleValue *vb = tp.get_pointer(right_index).get();
-      if (valueCompare(va, vb, cond.comp) == false)
-      {
-        valid = false;
-        break;
-      }
-    }
-  }
-  return valid;
-}
-
-// 检查condition两边的列是否再元组中
-bool conditionInTuple(const TupleSchema &schema, const Condition &cond)
-{
-  bool left = false;
-  bool right = false;
-  auto fields = schema.fields();
-  for (const auto &each : fields)
-  {
-    if ((0 == strcmp(cond.left_attr.relation_name, each.table_name())) &&
-        (0 == strcmp(cond.left_attr.attribute_name, each.field_name())))
-    {
-      left = true;
-    }
-    if ((0 == strcmp(cond.right_attr.relation_name, each.table_name())) &&
-        (0 == strcmp(cond.right_attr.attribute_name, each.field_name())))
-    {
-      right = true;
-    }
-  }
-  return left && right;
-}
-
-void backtrack(TupleSet &ans, const std::vector<TupleSet> &sets, int index, Tuple &tmp, const Selects &selects, const TupleSchema &schema, TupleSchema &tmpSchema)
-{
-  // LOG_INFO("START OF backtrack:");
-  // tmpSchema.print(std::cout, true);
-
-  if (index == -1)
-  {
-    Tuple t(tmp);
-    // 满足条件再加入
-    if (isTupleSatisfy(t, schema, selects))
-    {
-      ans.add(std::move(t));
-    }
-  }
-  else
-  {
-
-    int len = sets[index].size();
-    for (int i = 0; i < len; i++)
-    {
-      tmp.merge(sets[index].get(i));
-      tmpSchema.append(sets[index].get_schema());
-      // 在这里应该检查一下相应的condition，不满足就不用回溯
-      bool satisfied = true;
-      for (size_t i = 0; i < selects.condition_num; i++)
-      {
-        const Condition &cond = selects.conditions[i];
-        if (cond.right_is_attr == 2)
-        {
-          continue;
-        }
-        if ((cond.left_is_attr == 1) && (cond.right_is_attr == 1))
-        {
-          // LOG_INFO("Condition %d: %s.%s, %s.%s", i, cond.left_attr.relation_name, cond.left_attr.attribute_name, cond.right_attr.relation_name, cond.right_attr.attribute_name);
-          // tmpSchema.print(std::cout, true);
-          if (conditionInTuple(tmpSchema, cond))
-          {
-            int left_index = tmpSchema.index_of_field(cond.left_attr.relation_name, cond.left_attr.attribute_name);
-            int right_index = tmpSchema.index_of_field(cond.right_attr.relation_name, cond.right_attr.attribute_name);
-            TupleValue *va = tmp.get_pointer(left_index).get();
-            TupleValue *vb = tmp.get_pointer(right_index).get();
-            if (valueCompare(va, vb, cond.comp) == false)
-            {
-              satisfied = false;
-              break;
-            }
-          }
-          else
-          {
-          }
-        }
-      }
-      if (satisfied)
-      {
-        backtrack(ans, sets, index - 1, tmp, selects, schema, tmpSchema);
-      }
-      // LOG_INFO("index : %d", index);
-      // LOG_INFO("sets[index].get_schema()");
-      // sets[index].get_schema().print(std::cout, true);
-      // LOG_INFO("tmpSchema:");
-      // tmpSchema.print(std::cout, true);
-      tmp.remove(sets[index].get(i));
-      tmpSchema.remove(sets[index].get_schema());
-    }
-  }
-}
-
-TupleSet do_join(const std::vector<TupleSet> &sets, const Selects &selects, const char *db)
-{
-  // 构造一个表名到对应的TupleSet的下标的map
-  // std::unordered_map<std::string, int> name2set;
-  // for (int i = 0; i < sets.size(); i++) {
-  //     const char* table_name = sets[i].get_schema().field(0).table_name();
-  //     name2set[std::string(table_name, strlen(table_name))] = i;
-  // }
-  // 先根据所有的tuple_set构造一个包含所有列的TupleSet
-  TupleSchema total_schema;
-  TupleSet total_set;
-  for (auto it = sets.rbegin(); it != sets.rend(); it++)
+  ExecutionNode *root = select_nodes.back();
+  for (int i = (int)select_nodes.size() - 2; i >= 0; i--)
   {
-    total_schema.append(it->get_schema());
+    join_nodes[i].init(root, select_nodes[i], deferred[i], &selects);
+    root = &join_nodes[i];
   }
-  total_set.set_schema(total_schema);
-
-  int len_sets = sets.size();
-  Tuple tmp;
-  TupleSchema tmpSchema;
-  backtrack(total_set, sets, len_sets - 1, tmp, selects, total_schema, tmpSchema);
-
-  return total_set;
+  return root;
 }
 
 // 检查Select, where中的表名是否都出现在from中
@@ -654,6 +530,20 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
     select_nodes.push_back(select_node);
   }
 
+  // order by如果能沿着第一张表的索引顺序扫描，结果天然有序，不需要再排序。连接的输出保持第一张表的顺序
+  bool ordered_by_index = !select_nodes.empty() && set_order_by_index(selects, db, *select_nodes.back());
+  if (ordered_by_index && selects.relation_num > 1)
+  {
+    set_merge_join_by_index(selects, db, select_nodes);
+  }
+
+  // 结果不需要排序、聚合和二次过滤时，扫描或连接读够offset+limit行就停止
+  int scan_limit = can_push_down_limit(selects, ordered_by_index) ? limit_end(selects) : -1;
+  if (scan_limit >= 0 && select_nodes.size() == 1)
+  {
+    select_nodes[0]->set_limit(scan_limit);
+  }
+
   if (select_nodes.empty())
   {
     LOG_ERROR("No table given");
@@ -665,65 +555,71 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
     return RC::SQL_SYNTAX;
   }
 
-  std::vector<TupleSet> tuple_sets;
-  for (SelectExeNode *&node : select_nodes)
+  if (!is_sub_select && select_nodes.size() == 1 && can_aggregate_by_column(selects, select_nodes[0]->table()))
   {
-    TupleSet tuple_set;
-    // excute里设置了聚合函数的type，type定义于tuple.h文件
-    rc = node->execute(tuple_set);
-    if (rc != RC::SUCCESS)
+    TupleSet aggregated;
+    rc = do_column_aggregation(trx, selects, *select_nodes[0], aggregated);
+    for (SelectExeNode *&tmp_node : select_nodes)
     {
-      LOG_INFO("node->execute失败 rc=%d", rc);
-      for (SelectExeNode *&tmp_node : select_nodes)
-      {
-        delete tmp_node;
-      }
-      if (!is_sub_select)
-      {
-        session_event->set_response("FAILURE\n");
-        end_trx_if_need(session, trx, false);
-      }
-      return rc;
+      delete tmp_node;
     }
-    else
+    if (rc != RC::SUCCESS)
     {
-      tuple_sets.push_back(std::move(tuple_set));
+      session_event->set_response("FAILURE\n");
+      end_trx_if_need(session, trx, false);
+      return rc;
     }
+    apply_limit(selects, aggregated);
+    std::stringstream ss;
+    aggregated.print(ss);
+    session_event->set_response(ss.str());
+    end_trx_if_need(session, trx, true);
+    return rc;
+  }
+
+  // 多表查询由连接流水线按需读取各表。可能用索引嵌套循环连接的内表，等连接时知道了外层的行数再决定是否扫描
+  std::vector<bool> deferred(select_nodes.size(), false);
+  for (size_t i = 0; select_nodes.size() > 1 && i < select_nodes.size(); i++)
+  {
+    deferred[i] = may_lookup_by_index(selects, db, i);
   }
+  std::vector<StreamJoinExeNode> join_nodes(select_nodes.size() - 1);
+  ExecutionNode *root = build_join_pipeline(select_nodes, deferred, selects, join_nodes);
+  bool is_multi_table = select_nodes.size() > 1;
 
+  // 子查询和表达式要在整个结果上计算，这时先把扫描或连接的结果物化。
+  // 其它查询的聚合、投影、排序和limit都是执行节点，直接从扫描或连接中拉取元组，result只带有schema
+  bool pipelined = !need_materialize(selects);
   std::stringstream ss;
   TupleSet result;
-  bool is_multi_table = false;
-  if (tuple_sets.size() > 1)
-  { // 本次查询了多张表，需要做join操作
-    is_multi_table = true;
-
-    result = do_join(tuple_sets, selects, db);
-    if (result.get_schema().size() == 0)
-    {
-      // 出现错误
-      for (SelectExeNode *&tmp_node : select_nodes)
-      {
-        delete tmp_node;
-      }
-      if (!is_sub_select)
-      {
-        session_event->set_response("FAILURE\n");
-        end_trx_if_need(session, trx, true);
-      }
-      return RC::GENERIC_ERROR;
-    }
+  if (pipelined)
+  {
+    result.set_schema(root->schema());
   }
   else
   {
-    // 当前只查询一张表，直接返回结果即可
-    result = std::move(tuple_sets.front());
+    rc = root->execute(result);
+  }
+  if (rc != RC::SUCCESS)
+  {
+    LOG_ERROR("Failed to scan or join tables. rc=%d:%s", rc, strrc(rc));
+    for (SelectExeNode *&tmp_node : select_nodes)
+    {
+      delete tmp_node;
+    }
+    if (!is_sub_select)
+    {
+      session_event->set_response("FAILURE\n");
+      end_trx_if_need(session, trx, false);
+    }
+    return rc;
   }
 
   LOG_INFO("多表后");
   result.print(std::cout, true);
 
   // 在此执行子查询操作
+  // IN/NOT IN用哈希半连接/反连接，关联子查询去关联后只执行一次，再按关联列和主查询的行匹配
   bool has_subselect = false;
 
   if (main_table == nullptr)
@@ -744,62 +640,41 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
     // 处理子查询
     has_subselect = true;
     CompOp comp = condition.comp;
+    bool is_in = comp == CompOp::IN_SUB || comp == CompOp::NOT_IN;
 
     Selects *sub_select = new Selects();
     memcpy(sub_select, condition.sub_select, sizeof(Selects));
 
-    // 检查是否为关联子查询
-    int n = sub_select->condition_num;
-
-    for (size_t i = 0; i < n; i++)
+    // 检查是否为关联子查询，关联子查询的结果中多输出一列关联列
+    RelAttr outer_attr;
+    RelAttr key_attr;
+    bool is_related = false;
+    rc = decorrelate_sub_select(*sub_select, main_table, is_in, is_related, outer_attr, key_attr);
+    if (rc != RC::SUCCESS)
     {
-      const Condition &sub_cond = condition.sub_select->conditions[i];
-
-      // 查看条件中是否存在与主查询相关的条件，关联子查询必有表名
-      if (sub_cond.right_is_attr == 1 && sub_cond.right_attr.relation_name != nullptr && strcmp(sub_cond.right_attr.relation_name, main_table) == 0)
-      {
-        // 加入子查询
-        sub_select->relations[sub_select->relation_num++] = main_table;
-        // 加上group by
-        sub_select->group_num = 0;
-        sub_select->group_attrs[sub_select->group_num++] = sub_cond.right_attr;
-        sub_select->attributes[sub_select->attr_num++] = sub_cond.right_attr;
-        if (sub_select->attributes[0].agg_function_name == nullptr)
-        {
-          const char *tmp = "max";
-          // sub_select->attributes[sub_select->attr_num - 1].agg_function_name = (char *)malloc(4);
-          // memcpy(sub_select->attributes[sub_select->attr_num - 1].agg_function_name, tmp, 4);
-          sub_select->attributes[0].agg_function_name = (char *)malloc(4);
-          memcpy(sub_select->attributes[0].agg_function_name, tmp, 4);
-        }
-
-        LOG_INFO("关联子查询 - agg_name = %s, attr_name = %s, table_name = %s", sub_select->attributes[0].agg_function_name, sub_select->attributes[0].attribute_name, sub_select->attributes[0].relation_name);
-
-        is_related = true;
-      }
-      else if (sub_cond.left_is_attr == 1 && sub_cond.left_attr.relation_name != nullptr && strcmp(sub_cond.left_attr.relation_name, main_table) == 0)
-      {
-        // 加入子查询
-        sub_select->relations[sub_select->relation_num++] = main_table;
-        // 加上group by
-        sub_select->group_num = 0;
-        sub_select->group_attrs[sub_select->group_num++] = sub_cond.left_attr;
-        sub_select->attributes[sub_select->attr_num++] = sub_cond.left_attr;
-        if (sub_select->attributes[0].agg_function_name == nullptr)
-        {
-          sub_select->attributes[0].agg_function_name = (char *)malloc(4);
-          const char *tmp = "max";
-          memcpy(sub_select->attributes[0].agg_function_name, tmp, 4);
-        }
+      free(condition.sub_select);
+      delete sub_select;
+      break;
+    }
+    if (is_related)
+    {
+      LOG_INFO("关联子查询 - 主查询的列 = %s.%s, 子查询的关联列 = %s", outer_attr.relation_name, outer_attr.attribute_name, key_attr.attribute_name);
+    }
 
-        is_related = true;
-      }
+    // 主查询的行在关联子查询中没有对应的组时，COUNT的值是0，其它聚合函数的值是NULL。
+    // 输出列是包含COUNT的表达式时不在此列，仍然按NULL处理
+    std::shared_ptr<TupleValue> missing_value;
+    bool is_plain_column = sub_select->total_exp == 0 || sub_select->exp_num[0] == 1;
+    if (is_related && is_plain_column && FuncType::COUNT == judge_function_type(sub_select->attributes[0].agg_function_name))
+    {
+      missing_value = std::make_shared<IntValue>(0, false);
     }
 
     free(condition.sub_select);
     TupleSet sub_res;
 
     rc = do_select(db, *sub_select, session_event, sub_res, true, main_table);
+    delete sub_select;
     LOG_INFO("子查询执行结果");
     sub_res.print(std::cout, true);
 
@@ -809,12 +684,20 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       break;
     }
 
-    // sub_res.print(std::cout);
-    // LOG_INFO("---------");
-    // result.print(std::cout);
+    // 关联的COUNT子查询没有结果时也没有输出列，主查询的每一行对应的值都是0
+    bool empty_count = missing_value && sub_res.size() == 0;
+
+    int value_index = 0;
+    int key_index = -1;
+    if (is_related)
+    {
+      key_index = sub_select_key_index(sub_res.get_schema(), key_attr);
+      value_index = (key_index == 0 && sub_res.get_schema().size() > 1) ? 1 : 0;
+    }
 
-    // 如果查询结果不为单列则不合法
-    if (!is_related && sub_res.get_schema().size() != 1)
+    // 如果查询结果不为单列(关联子查询再加上关联列)则不合法
+    int column_num = (key_index >= 0 && key_index != value_index) ? 2 : 1;
+    if (!empty_count && ((is_related && key_index < 0) || sub_res.get_schema().size() != column_num))
     {
       rc = RC::GENERIC_ERROR;
       break;
@@ -833,7 +716,7 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       }
 
       // 两侧都是子查询，只能值比值
-      if (left_sub_res.get_schema().size() != 1 || left_sub_res.size() != 1 || sub_res.size() != 1)
+      if (is_related || left_sub_res.get_schema().size() != 1 || left_sub_res.size() != 1 || sub_res.size() != 1)
       {
         rc = RC::GENERIC_ERROR;
         break;
@@ -850,7 +733,7 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       const std::shared_ptr<TupleValue> &left_data = left_sub_res.get(0).get_pointer(0);
       const std::shared_ptr<TupleValue> &right_data = sub_res.get(0).get_pointer(0);
 
-      if (!cmp_value(left_type, right_type, nullptr, right_data, comp, left_data, nullptr))
+      if (!compare_sub_value(left_type, right_type, left_data, comp, right_data))
       {
         // 比较，不相等则清空
         result.clear_tuples();
@@ -860,16 +743,17 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       continue;
     }
 
-    // LOG_INFO("sub_res.size() = %d", sub_res.size());
-
-    if (sub_res.size() == 1 && sub_res.get_schema().field(0).type() == CHARS) {
-      const char *value = std::dynamic_pointer_cast<StringValue>(sub_res.get(0).get_pointer(0))->get_value();
-      if (strcmp(value, "NULL") == 0) {
+    // 聚合函数没有非NULL值时结果是字符串NULL，相当于子查询没有结果
+    if (!is_related && sub_res.size() == 1 && sub_res.get_schema().field(0).type() == CHARS)
+    {
+      const std::shared_ptr<TupleValue> &value = sub_res.get(0).get_pointer(0);
+      if (!value->is_null() && strcmp(std::dynamic_pointer_cast<StringValue>(value)->get_value(), "NULL") == 0)
+      {
         sub_res.clear_tuples();
       }
     }
 
-    if (sub_res.size() == 0)
+    if (sub_res.size() == 0 && !empty_count)
     {
       // 子查询没有结果，如果是not in保留所有结果，否则清空
       if (comp == NOT_IN)
@@ -881,8 +765,8 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       break;
     }
 
-    // 提取右侧类型和TupleValue
-    AttrType right_type = sub_res.get_schema().field(0).type();
+    // 提取右侧类型
+    AttrType right_type = empty_count ? INTS : sub_res.get_schema().field(value_index).type();
 
     // 如果左侧是列，提取index
     int index = -1;
@@ -908,8 +792,9 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       }
     }
 
-    // 提取左侧类型
+    // 提取左侧类型，左侧是值时转成和元组中相同的TupleValue
     AttrType left_type;
+    std::shared_ptr<TupleValue> left_value;
     if (condition.left_is_attr)
     {
       left_type = result.get_schema().field(index).type();
@@ -917,6 +802,7 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
     else
     {
       left_type = condition.left_value.type;
+      left_value = value_to_tuple_value(condition.left_value);
     }
 
     if (!is_type_legal(left_type, right_type))
@@ -925,8 +811,24 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       break;
     }
 
+    // 主查询中关联列的位置
+    int outer_index = -1;
+    if (is_related)
+    {
+      outer_index = result.get_schema().index_of_field(outer_attr.relation_name, outer_attr.attribute_name);
+      if (outer_index == -1)
+      {
+        rc = RC::GENERIC_ERROR;
+        break;
+      }
+    }
+
+    TupleSet tmp_res;
+    tmp_res.set_schema(result.get_schema());
+    int n = result.size();
+
     // 开始处理操作符
-    if (comp != CompOp::NOT_IN && comp != CompOp::IN_SUB)
+    if (!is_in)
     {
       // 处理比较操作符，超过一行且非关联子查询则不合法
       if (sub_res.size() > 1 && !is_related)
@@ -935,194 +837,54 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
         break;
       }
 
-      const std::shared_ptr<TupleValue> &right_data = sub_res.get(0).get_pointer(0);
-
-      if (condition.left_is_attr == 0)
+      // 关联子查询按关联列分组，每组一行
+      ScalarSubqueryGroups groups;
+      if (is_related)
       {
-        // 左侧也是值
-        bool cmp_res = cmp_value(condition.left_value.type, right_type, condition.left_value.data, right_data, condition.comp, right_data, nullptr);
+        groups.build(sub_res, value_index, key_index, missing_value);
+      }
 
-        if (!cmp_res)
+      for (int j = 0; j < n; ++j)
+      {
+        // 遍历result，找出满足条件的tuple。子查询的值是NULL时比较不成立
+        const Tuple &tuple = result.get(j);
+        const std::shared_ptr<TupleValue> &right_data =
+            is_related ? groups.find(*tuple.get_pointer(outer_index)) : sub_res.get(0).get_pointer(value_index);
+        if (!right_data)
         {
-          result.clear_tuples();
+          continue;
         }
-      }
-      else
-      {
-        // 左侧是列
-        TupleSet tmp_res;
-        TupleSchema tmp_schema;
-        tmp_schema.append(result.get_schema());
-        tmp_res.set_schema(tmp_schema);
 
-        int n = result.size();
-        for (int j = 0; j < n; ++j)
+        const std::shared_ptr<TupleValue> &left_data = condition.left_is_attr ? tuple.get_pointer(index) : left_value;
+        if (compare_sub_value(left_type, right_type, left_data, comp, right_data))
         {
-          // 遍历result，找出满足条件的tuple
-          if (!is_related)
-          {
-            if (cmp_value(left_type, right_type, nullptr, right_data, comp, result.get(j).get_pointer(index), nullptr))
-            {
-              result.copy_ith_to(tmp_res, j);
-            }
-          }
-          else
-          {
-            // 处理关联子查询
-            int k = sub_res.size() - 1;
-            int last_index = sub_res.get_schema().size() - 1;
-            for (; k >= 0; --k)
-            {
-              if (cmp_value(left_type, right_type, nullptr, sub_res.get(k).get_pointer(last_index), comp, result.get(j).get_pointer(index), nullptr) == 0)
-              {
-                break;
-              }
-            }
-
-            if (k < 0)
-            {
-              // 出现错误
-              rc = RC::GENERIC_ERROR;
-              break;
-            }
-
-            if (cmp_value(left_type, right_type, nullptr, sub_res.get(k).get_pointer(0), comp, result.get(j).get_pointer(index), nullptr))
-            {
-              result.copy_ith_to(tmp_res, j);
-            }
-          }
+          result.copy_ith_to(tmp_res, j);
         }
-
-        result = std::move(tmp_res);
       }
     }
     else
     {
-      // 处理操作符in/not in，用哈希表
-      // 生成哈希表
-      // std::unordered_set<size_t> target_set;
-      // int n = sub_res.size();
-
-      // for (int j = 0; j < n; ++j)
-      // {
-      //   target_set.insert(sub_res.get(j).get_pointer(0)->to_hash());
-      // }
-
-      // 查询验证
-      if (condition.left_is_attr == 0)
-      {
-        // 左侧是值
-        bool in_target = false;
-        int sub_size = sub_res.size();
+      // 处理操作符in/not in，子查询的结果建成哈希表，主查询的每一行探测一次
+      HashSemiJoin semi_join;
+      semi_join.build(sub_res, value_index, key_index, missing_value);
 
-        for (int k = 0; k < sub_size; ++k)
-        {
-          if (cmp_value(left_type, right_type, condition.left_value.data, sub_res.get(k).get_pointer(0), CompOp::EQUAL_TO, sub_res.get(k).get_pointer(0), nullptr))
-          {
-            in_target = true;
-            break;
-          }
-        }
-        // switch (condition.left_value.type)
-        // {
-        // case AttrType::CHARS:
-        // {
-        //   std::string v = std::string((const char *)condition.left_value.data);
-        //   std::hash<std::string> hash_func;
-        //   in_target = target_set.find(hash_func(v)) != target_set.end();
-        //   break;
-        // }
-        // case AttrType::DATES:
-        // case AttrType::INTS:
-        // {
-        //   int v = *(int *)condition.left_value.data;
-        //   std::hash<int> hash_func;
-        //   in_target = target_set.find(hash_func(v)) != target_set.end();
-        //   break;
-        // }
-        // case AttrType::FLOATS:
-        // {
-        //   int v = *(float *)condition.left_value.data;
-        //   std::hash<float> hash_func;
-        //   in_target = target_set.find(hash_func(v)) != target_set.end();
-        //   break;
-        // }
-        // default:
-        //   break;
-        // }
-
-        if (comp == CompOp::IN_SUB && !in_target)
-        {
-          result.clear_tuples();
-        }
-        else if (comp == CompOp::NOT_IN && in_target)
-        {
-          result.clear_tuples();
-        }
-      }
-      else
+      for (int j = 0; j < n; ++j)
       {
-        // 左侧是列
-        TupleSet tmp_res;
-        tmp_res.set_schema(result.get_schema());
+        const Tuple &tuple = result.get(j);
+        const TupleValue &left_data = condition.left_is_attr ? *tuple.get_pointer(index) : *left_value;
+        const TupleValue *key = is_related ? tuple.get_pointer(outer_index).get() : nullptr;
 
-        int m = result.size();
-        for (int j = 0; j < m; ++j)
+        // 结果未知时in和not in都不成立
+        InResult in_result = semi_join.probe(left_data, key);
+        if ((comp == CompOp::IN_SUB && in_result == InResult::MATCH) ||
+            (comp == CompOp::NOT_IN && in_result == InResult::NO_MATCH))
         {
-          // 遍历result，找出满足条件的tuple
-          // bool in_target = target_set.find(result.get(j).get_pointer(index)->to_hash()) != target_set.end();
-          // LOG_INFO("index = %d", index);
-
-          // if (comp == CompOp::IN_SUB)
-          // {
-          //   if (in_target)
-          //   {
-          //     result.copy_ith_to(tmp_res, j);
-          //   }
-          // }
-          // else
-          // {
-          //   if (is_related || !in_target)
-          //   {
-          //     result.copy_ith_to(tmp_res, j);
-          //   }
-          // }
-          bool in_target = false;
-          int sub_size = sub_res.size();
-
-          for (int k = 0; k < sub_size; ++k)
-          {
-            if (cmp_value(left_type, right_type, nullptr, sub_res.get(k).get_pointer(0), CompOp::EQUAL_TO, result.get(j).get_pointer(index), nullptr))
-            {
-              in_target = true;
-              break;
-            }
-          }
-
-          if (comp == CompOp::IN_SUB)
-          {
-            if (in_target)
-            {
-              result.copy_ith_to(tmp_res, j);
-            }
-          }
-          else if (is_related)
-          {
-            result.copy_ith_to(tmp_res, j);
-          }
-          else
-          {
-            if (!in_target)
-            {
-              result.copy_ith_to(tmp_res, j);
-            }
-          }
+          result.copy_ith_to(tmp_res, j);
         }
-
-        result = std::move(tmp_res);
       }
     }
 
+    result = std::move(tmp_res);
     rc = RC::SUCCESS;
     LOG_INFO("子查询结束");
     result.print(std::cout, true);
@@ -1168,178 +930,62 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
   //   map[key] = i;
   // }
   // 处理where里的表达式，即left_is_attr, right_is_attr至少有一个== 3
-  for (int i = selects.condition_num - 1; i >= 0; --i)
+  // 多表查询中只涉及一张表的表达式条件已经下推到那张表的扫描中
+  for (int i = selects.condition_num - 1; !pipelined && i >= 0; --i)
   {
-    std::vector<int> is_include(result.size(), 1);
     const Condition &condition = selects.conditions[i];
-    TupleSet left_result;
-    TupleSet right_result;
-    int n = result.size();
+    std::string table_name;
+    std::vector<std::string> fields;
+    if (select_nodes.size() > 1 && single_table_expression(condition, table_name, fields))
+    {
+      continue;
+    }
+
+    if (filter_by_expression(condition, result) != RC::SUCCESS)
+    {
+      for (SelectExeNode *&tmp_node : select_nodes)
+      {
+        delete tmp_node;
+      }
+
+      if (!is_sub_select)
+      {
+        session_event->set_response("FAILURE\n");
+        end_trx_if_need(session, trx, true);
+      }
+      return RC::GENERIC_ERROR;
+    }
+  }
+
+  LOG_INFO("经过where表达式计算后");
+  result.print(std::cout, true);
 
-    LOG_INFO("condition.left_is_attr = %d, right_is_attr = %d", condition.left_is_attr, condition.right_is_attr);
+  // group by的结果，每个分组一行
+  TupleSet grouped;
+  if (selects.group_num > 0)
+  {
+    // group by特点：不在group by中的列，在select中只能以聚合函数形式出现
+    // 检查group by列名是否存在
+    std::vector<int> group_idx; // 用于group by的列在tutal_set中的index
+    int n = selects.group_num;
 
-    if (condition.left_is_attr == 3)
+    for (int i = 0; i < n; ++i)
     {
-      if (calculate(result, left_result, condition.expression, 0, condition.exp_num, is_include) != RC::SUCCESS)
+      const RelAttr &attr = selects.group_attrs[i];
+      // int index = is_col_legal(attr, result.get_schema());
+      int index = -1;
+      if (attr.relation_name == nullptr)
+      {
+        index = result.get_schema().index_of_field(attr.attribute_name);
+      }
+      else
+      {
+        index = result.get_schema().index_of_field(attr.relation_name, attr.attribute_name);
+      }
+
+      if (index == -1)
       {
-        for (SelectExeNode *&tmp_node : select_nodes)
-        {
-          delete tmp_node;
-        }
-
-        if (!is_sub_select)
-        {
-          session_event->set_response("FAILURE\n");
-          end_trx_if_need(session, trx, true);
-        }
-        return RC::GENERIC_ERROR;
-      }
-
-      LOG_INFO("where左表达式计算结果：");
-      left_result.print(std::cout, true);
-    }
-
-    if (condition.right_is_attr == 3)
-    {
-      if (calculate(result, right_result, condition.right_expression, 0, condition.right_exp_num, is_include) != RC::SUCCESS)
-      {
-        for (SelectExeNode *&tmp_node : select_nodes)
-        {
-          delete tmp_node;
-        }
-
-        if (!is_sub_select)
-        {
-          session_event->set_response("FAILURE\n");
-          end_trx_if_need(session, trx, true);
-        }
-        return RC::GENERIC_ERROR;
-      }
-
-      LOG_INFO("where右表达式计算结果：");
-      // right_result.print(std::cout, true);
-    }
-
-    if (condition.left_is_attr == 3 && condition.right_is_attr == 0)
-    {
-      // 左表达式右值
-      AttrType right_type = condition.right_value.type;
-      void *right_data = condition.right_value.data;
-
-      if (right_type == NULLS || right_type == CHARS)
-      {
-        for (SelectExeNode *&tmp_node : select_nodes)
-        {
-          delete tmp_node;
-        }
-
-        if (!is_sub_select)
-        {
-          session_event->set_response("FAILURE\n");
-          end_trx_if_need(session, trx, true);
-        }
-        return RC::GENERIC_ERROR;
-      }
-
-      TupleSet new_result;
-      new_result.set_schema(result.get_schema());
-
-      for (int j = 0; j < left_result.size(); ++j)
-      {
-        const std::shared_ptr<TupleValue> &left_value = left_result.get(j).get_pointer(0);
-        if (cmp_value(FLOATS, right_type, nullptr, left_value, condition.comp, left_value, right_data) && is_include[j] == 1)
-        {
-          result.copy_ith_to(new_result, j);
-        }
-      }
-
-      result = std::move(new_result);
-    }
-
-    if (condition.left_is_attr == 0 && condition.right_is_attr == 3)
-    {
-      // 右表达式左值
-      AttrType left_type = condition.left_value.type;
-      void *left_data = condition.left_value.data;
-
-      if (left_type == NULLS || left_type == CHARS)
-      {
-        for (SelectExeNode *&tmp_node : select_nodes)
-        {
-          delete tmp_node;
-        }
-
-        if (!is_sub_select)
-        {
-          session_event->set_response("FAILURE\n");
-          end_trx_if_need(session, trx, true);
-        }
-        return RC::GENERIC_ERROR;
-      }
-
-      TupleSet new_result;
-      new_result.set_schema(result.get_schema());
-      for (int j = 0; j < right_result.size(); ++j)
-      {
-        const std::shared_ptr<TupleValue> &right_value = right_result.get(j).get_pointer(0);
-        if (cmp_value(left_type, FLOATS, left_data, right_value, condition.comp, right_value, nullptr) && is_include[j] == 1)
-        {
-          result.copy_ith_to(new_result, j);
-        }
-      }
-
-      result = std::move(new_result);
-    }
-
-    if (condition.left_is_attr == 3 && condition.right_is_attr == 3)
-    {
-      // 左右都是表达式
-      TupleSet new_result;
-      new_result.set_schema(result.get_schema());
-      for (int j = 0; j < right_result.size(); ++j)
-      {
-        const std::shared_ptr<TupleValue> &left_value = left_result.get(j).get_pointer(0);
-        const std::shared_ptr<TupleValue> &right_value = right_result.get(j).get_pointer(0);
-        if (cmp_value(FLOATS, FLOATS, nullptr, right_value, condition.comp, left_value, nullptr) && is_include[j] == 1)
-        {
-          result.copy_ith_to(new_result, j);
-        }
-      }
-
-      result = std::move(new_result);
-    }
-  }
-
-  LOG_INFO("经过where表达式计算后");
-  result.print(std::cout, true);
-
-  // tuple_to_indexes记录<group by哈希值，在result中对应的列>
-  std::unordered_map<size_t, std::vector<int>> tuple_to_indexes;
-  std::vector<TupleSet> results;
-  if (selects.group_num > 0)
-  {
-    // group by特点：不在group by中的列，在select中只能以聚合函数形式出现
-    // 检查group by列名是否存在
-    std::vector<int> group_idx; // 用于group by的列在tutal_set中的index
-    int n = selects.group_num;
-
-    for (int i = 0; i < n; ++i)
-    {
-      const RelAttr &attr = selects.group_attrs[i];
-      // int index = is_col_legal(attr, result.get_schema());
-      int index = -1;
-      if (attr.relation_name == nullptr)
-      {
-        index = result.get_schema().index_of_field(attr.attribute_name);
-      }
-      else
-      {
-        index = result.get_schema().index_of_field(attr.relation_name, attr.attribute_name);
-      }
-
-      if (index == -1)
-      {
-        LOG_ERROR("出现错误列名或者二义性问题");
+        LOG_ERROR("出现错误列名或者二义性问题");
         for (SelectExeNode *&tmp_node : select_nodes)
         {
           delete tmp_node;
@@ -1357,26 +1003,27 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       group_idx.emplace_back(index);
     }
 
-    // 存放<Tuple哈希值，Tuple在TupleSet中的index>
-    // 遍历total set，哈希分组
-    n = result.size();
-    for (int i = 0; i < n; ++i)
+    // 聚合节点逐行更新所在分组的聚合值，输入的行不保存
+    AttrFunction group_function;
+    collect_attr_functions(selects, group_function);
+    std::vector<AggregateSpec> specs;
+    rc = make_aggregate_specs(result.get_schema(), group_function, selects.relation_num, specs);
+    if (rc == RC::SUCCESS)
     {
-      tuple_to_indexes[result.get(i).to_hash(group_idx)].emplace_back(i);
+      rc = aggregate(pipelined ? root : nullptr, result, group_idx, specs, grouped);
     }
-
-    // 遍历哈希桶，做成vector<TupleSet>的形式
-    results = std::vector<TupleSet>(tuple_to_indexes.size());
-    int i = 0;
-    for (auto iter = tuple_to_indexes.begin(); iter != tuple_to_indexes.end(); ++iter)
+    if (rc != RC::SUCCESS)
     {
-      const std::vector<int> hash_bin = iter->second;
-      results[i].set_schema(result.get_schema());
-      for (const int &idx : hash_bin)
+      for (SelectExeNode *&tmp_node : select_nodes)
+      {
+        delete tmp_node;
+      }
+      if (!is_sub_select)
       {
-        result.copy_ith_to(results[i], idx);
+        session_event->set_response("FAILURE\n");
+        end_trx_if_need(session, trx, true);
       }
-      ++i;
+      return rc;
     }
   }
   //////////////////////////group by结束/////////////////////////////
@@ -1386,6 +1033,7 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
   // Select表达式计算
   TupleSet new_result;
   TupleSchema new_schema;
+  std::vector<int> project_indexes;
   int size = result.size();
   bool is_star = false;
   std::vector<int> is_include(result.size(), 1);
@@ -1394,7 +1042,7 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
   for (int i = 0; i < selects.total_exp; ++i) {
     if (selects.exp_num[i] > 1) {
       is_exp = true;
-      is_multi_table = tuple_sets.size() > 1;
+      is_multi_table = select_nodes.size() > 1;
       break;
     }
   }
@@ -1504,6 +1152,12 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       {
         new_schema.add(result.get_schema().field(index).type(), relation_name, attribute_name, result.get_schema().field(index).is_nullable());
       }
+      // 没有算式时只记录列的下标，由投影节点逐行提取
+      project_indexes.push_back(index);
+      if (!is_exp)
+      {
+        continue;
+      }
       if (i == 0)
       {
         for (int j = 0; j < size; ++j)
@@ -1525,7 +1179,13 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
     }
   }
 
-  if (selects.total_exp && !is_star)
+  // 没有算式时，select中的列由投影节点提取。group by的结果会替换result，不需要投影
+  bool need_project = false;
+  if (selects.total_exp && !is_star && !is_exp)
+  {
+    need_project = selects.group_num == 0;
+  }
+  else if (selects.total_exp && !is_star)
   {
     // 如果出现*不会调用expression
     result.clear();
@@ -1543,104 +1203,73 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
   LOG_INFO("select表达式计算后, size = %d");
   result.print(std::cout, true);
 
-  // for (int i = 0; i < tuple_to_indexes.size(); ++i) {
-  //   results[i].print(std::cout);
-  // }
-  // result.print(std::cout);
-
   ////////////////////////////聚合函数开始/////////////////////////////
-  // 由于加入group by，这里可能会开始出现多个TupleSet
-  // 处理聚合函数
-  AttrFunction *attr_function = new AttrFunction;
-  for (int i = selects.attr_num - 1; i >= 0; i--)
-  {
-    const RelAttr &attr = selects.attributes[i];
-
-    if (attr.agg_function_name != nullptr)
-    {
-      // 注意这里attr.relation_name可能为nullptr
-      FuncType function_type = judge_function_type(attr.agg_function_name);
-      attr_function->add_function_type(std::string(attr.attribute_name), function_type, attr.relation_name);
-    }
-    else if (selects.group_num > 0)
-    {
-      attr_function->add_function_type(std::string(attr.attribute_name), FuncType::NOFUNC, attr.relation_name);
-    }
-  }
+  // 处理聚合函数，group by的聚合已经在分组时完成
+  AttrFunction attr_function;
+  collect_attr_functions(selects, attr_function);
 
   LOG_INFO("聚合函数之前");
   // result.print(std::cout, true);
 
-  if (attr_function->get_size() > 0)
+  if (selects.group_num > 0)
   {
-    std::vector<TupleSet> tmp_res;
-    int size = results.size();
-
-    if (size == 0)
+    is_multi_table = false;
+    result = std::move(grouped);
+  }
+  else if (attr_function.get_size() > 0)
+  {
+    // 没有group by时整个结果是一组
+    std::vector<AggregateSpec> specs;
+    TupleSet aggregated;
+    rc = make_aggregate_specs(result.get_schema(), attr_function, selects.relation_num, specs);
+    if (rc == RC::SUCCESS)
     {
-      rc = do_aggregation(&result, attr_function, tmp_res, selects.relation_num);
-
-      if (rc != RC::SUCCESS)
-      {
-        for (SelectExeNode *&tmp_node : select_nodes)
-        {
-          delete tmp_node;
-        }
-        if (!is_sub_select)
-        {
-          session_event->set_response("FAILURE\n");
-          end_trx_if_need(session, trx, true);
-        }
-        return rc;
-      }
-
-      if (tmp_res[0].get_schema().size() > 0)
-      {
-        is_multi_table = false;
-        result = std::move(tmp_res[0]);
-        tmp_res.clear();
-      }
+      rc = aggregate(pipelined ? root : nullptr, result, {}, specs, aggregated);
     }
-    else
+
+    if (rc != RC::SUCCESS)
     {
-      for (int i = 0; i < size; ++i)
+      for (SelectExeNode *&tmp_node : select_nodes)
       {
-        rc = do_aggregation(&results[i], attr_function, tmp_res, selects.relation_num);
-
-        if (rc != RC::SUCCESS)
-        {
-          ;
-          for (SelectExeNode *&tmp_node : select_nodes)
-          {
-            delete tmp_node;
-          }
-          if (!is_sub_select)
-          {
-            session_event->set_response("FAILURE\n");
-            end_trx_if_need(session, trx, true);
-          }
-          return rc;
-        }
+        delete tmp_node;
       }
-
-      is_multi_table = false;
-      result = std::move(tmp_res[0]);
-      for (int i = 1; i < size; ++i)
+      if (!is_sub_select)
       {
-        tmp_res[i].copy_ith_to(result, 0);
+        session_event->set_response("FAILURE\n");
+        end_trx_if_need(session, trx, true);
       }
+      return rc;
     }
+
+    is_multi_table = false;
+    result = std::move(aggregated);
   }
+  bool is_aggregated = selects.group_num > 0 || attr_function.get_size() > 0;
 
   ////////////////////////////聚合函数结束/////////////////////////////
 
+  // 之后的投影、排序和limit都是执行节点，最上层的节点输出最终结果。
+  // 聚合之后或者结果已经物化时从result拉取元组，否则直接从扫描或连接中拉取
+  TupleSetScanExeNode result_node;
+  result_node.init(&result);
+  ExecutionNode *current = (pipelined && !is_aggregated) ? root : &result_node;
+
+  ProjectExeNode select_project;
+  if (need_project && !is_aggregated)
+  {
+    rc = select_project.init(current, new_schema, project_indexes);
+    current = &select_project;
+  }
+
   // 有两种情况需要二次提取列
   // 1. 多表且没有group by，如果有group by，提取列已经在聚合里完成
   // 2. 单表且有子查询操作
-  if (!is_exp && attr_function->get_size() == 0 && ((selects.relation_num > 1 && selects.group_num == 0) || (selects.relation_num == 1 && has_subselect)))
+  ProjectExeNode final_project;
+  if (rc == RC::SUCCESS && !is_exp && attr_function.get_size() == 0 &&
+      ((selects.relation_num > 1 && selects.group_num == 0) || (selects.relation_num == 1 && has_subselect)))
   {
     TupleSchema final_schema;
-    const TupleSchema &result_schema = result.get_schema();
+    const TupleSchema &result_schema = current->schema();
 
     // for (int i = selects.attr_num - 1; i >= 0; i--)
     int n = selects.attr_num;
@@ -1674,71 +1303,69 @@ RC ExecuteStage::do_select(const char *db, const Selects &selects, SessionEvent
       }
     }
 
-    TupleSet final_set;
-    // TupleSchema final_schema = buildSchema(selects, total_schema, db);
-    final_set.set_schema(final_schema);
-
     LOG_INFO("提取列");
-    // result.print(std::cout, true);
     // 取出需要的列
-    for (const Tuple &tp : result.tuples())
+    std::vector<int> final_indexes;
+    for (const TupleField &s : final_schema.fields())
     {
-      Tuple t;
-
-      for (const TupleField &s : final_schema.fields())
+      int index = -1;
+      LOG_INFO("table_name = %s, field_name = %s", s.table_name(), s.field_name());
+      if (s.table_name() != nullptr)
       {
-        int index = -1;
-        LOG_INFO("table_name = %s, field_name = %s", s.table_name(), s.field_name());
-        if (s.table_name() != nullptr)
-        {
-          index = result_schema.index_of_field(s.table_name(), s.field_name());
-        }
-        else
-        {
-          index = result_schema.index_of_field(s.field_name());
-        }
-        t.add(tp.get_pointer(index));
+        index = result_schema.index_of_field(s.table_name(), s.field_name());
       }
-      final_set.add(std::move(t));
+      else
+      {
+        index = result_schema.index_of_field(s.field_name());
+      }
+      final_indexes.push_back(index);
     }
 
-    result = std::move(final_set);
+    rc = final_project.init(current, final_schema, final_indexes);
+    current = &final_project;
   }
 
-  if (selects.order_num > 0)
+  // 沿索引顺序扫描的结果已经有序，不需要排序
+  SortExeNode sort_node;
+  if (rc == RC::SUCCESS && selects.order_num > 0)
   {
-    // 当前没有group by，先假设聚合和排序是矛盾的，仍然用tuples_sets进行快速排序
-    ///////////////////////////////////排序开始////////////////////////////////
-    // 提取排序信息
-    OrderInfo *order_info = new OrderInfo;
-    const TupleSchema &schema = result.get_schema();
-
-    for (int i = selects.order_num - 1; i >= 0; i--)
+    std::vector<SortKey> keys;
+    rc = make_sort_keys(selects, current->schema(), keys);
+    if (rc == RC::SUCCESS && !ordered_by_index)
     {
-      const RelAttr &attr = selects.order_attrs[i];
-      int index = is_col_legal(attr, schema);
-
-      if (index == -1)
-      {
-        // 出现错误列名或者二义性问题
-        for (SelectExeNode *&tmp_node : select_nodes)
-        {
-          delete tmp_node;
-        }
+      rc = sort_node.init(current, keys, selects.has_limit ? limit_end(selects) : -1);
+      current = &sort_node;
+    }
+  }
 
-        if (!is_sub_select)
-        {
-          session_event->set_response("FAILURE\n");
-          end_trx_if_need(session, trx, true);
-        }
-        return RC::GENERIC_ERROR;
-      }
+  // 输出够offset+limit行后不再从下层拉取
+  LimitExeNode limit_node;
+  if (rc == RC::SUCCESS && selects.has_limit)
+  {
+    rc = limit_node.init(current, selects.offset, selects.limit);
+    current = &limit_node;
+  }
 
-      order_info->add(attr.attribute_name, index, attr.is_desc == 1);
+  TupleSet output;
+  if (rc == RC::SUCCESS)
+  {
+    rc = current->execute(output);
+  }
+  if (rc != RC::SUCCESS)
+  {
+    for (SelectExeNode *&tmp_node : select_nodes)
+    {
+      delete tmp_node;
     }
 
-    quick_sort(&result, 0, result.size() - 1, order_info);
+    if (!is_sub_select)
+    {
+      session_event->set_response("FAILURE\n");
+      end_trx_if_need(session, trx, true);
+    }
+    return rc;
   }
+  result = std::move(output);
 
   if (!is_sub_select)
   {
@@ -1784,369 +1411,30 @@ int is_col_legal(const RelAttr &attr, const TupleSchema &schema)
     {
       if (strcmp(attr.attribute_name, schema.field(i).field_name()) == 0)
       {
-        if (cnt == 0)
-        {
-          ++cnt;
-          last_table_name = schema.field(i).table_name();
-          index = i;
-        }
-        else
-        {
-          if (last_table_name != schema.field(i).table_name())
-          {
-            ++cnt;
-            break;
-          }
-        }
-      }
-    }
-  }
-
-  if (index == -1 || cnt > 1)
-  {
-    return -1;
-  }
-
-  return index;
-}
-
-bool tuple_compare(const Tuple *lhs, const Tuple *rhs, OrderInfo *order_info)
-{
-  // 左在右前返回true
-  for (int i = order_info->get_size() - 1; i >= 0; --i)
-  {
-    auto l_value = lhs->get_pointer(order_info->get_index(i));
-    auto r_value = rhs->get_pointer(order_info->get_index(i));
-    bool is_desc = order_info->get_is_desc(i);
-
-    if (l_value->compare(*r_value) > 0)
-    {
-      return !is_desc;
-    }
-
-    if (l_value->compare(*r_value) < 0)
-    {
-      return is_desc;
-    }
-  }
-
-  // 两者数据完全一样，返回true/false都可以
-  return true;
-}
-
-int partition(TupleSet *tuple_set, int l, int r, OrderInfo *order_info)
-{
-  auto pivot = &(tuple_set->get(r));
-  int i = l - 1;
-
-  for (int j = l; j < r; j++)
-  {
-    if (tuple_compare(pivot, &(tuple_set->get(j)), order_info))
-    {
-      i++;
-      tuple_set->swap_tuple(i, j);
-    }
-  }
-
-  tuple_set->swap_tuple(i + 1, r);
-  return i + 1;
-}
-
-/**
- * @brief 快速排序
- *
- * @param tuple_set 表的当前结果集合
- * @param index     按第index列进行排序
- * @param is_desc   是否降序，默认升序
- * @return RC
- */
-void quick_sort(TupleSet *tuple_set, int l, int r, OrderInfo *order_info)
-{
-  if (l < r)
-  {
-    int mid = partition(tuple_set, l, r, order_info);
-    quick_sort(tuple_set, l, mid - 1, order_info);
-    quick_sort(tuple_set, mid + 1, r, order_info);
-  }
-}
-
-/**
- * @brief 聚合函数运算
- *
- * @param tuple_set 表的当前结果集合
- * @param attr_function 表的聚合函数信息
- * @param results 表的聚合数结果
- * @return RC
- */
-RC do_aggregation(TupleSet *tuple_set, AttrFunction *attr_function, std::vector<TupleSet> &results, int rel_num)
-{
-  TupleSchema tmp_scheme;
-  Tuple tmp_tuple;
-
-  // 遍历所有带函数的属性
-  RC rc = RC::SUCCESS;
-  for (int j = attr_function->get_size() - 1; j >= 0; --j)
-  {
-    const char *table_name = attr_function->get_table_name(j);
-    const char *attr_name = attr_function->get_attr_name(j);
-    auto func_type = attr_function->get_function_type(j);
-    // 获取 func_type( 字符串
-    std::string add_scheme_name = attr_function->to_string(j, rel_num);
-
-    if (strcmp(attr_name, "*") == 0)
-    {
-      // 处理COUNT(*)
-      tmp_scheme.add_if_not_exists(AttrType::INTS, "", add_scheme_name.c_str());
-      tmp_tuple.add((int)tuple_set->tuples().size());
-      continue;
-    }
-
-    int index = -1;
-    AttrType type = AttrType::UNDEFINED;
-
-    if (table_name != nullptr)
-    {
-      index = tuple_set->get_schema().index_of_field(table_name, attr_name);
-      type = tuple_set->get_schema().field(index).type();
-    }
-    else
-    {
-      // 手动搜寻
-      index = tuple_set->get_schema().index_of_field(attr_name);
-      type = tuple_set->get_schema().field(index).type();
-    }
-    LOG_INFO("index = %d, table_name = %s, attr_name = %s", index, table_name, attr_name);
-    // const TupleField &field = tuple_set->get_schema().field(index);
-
-    if (func_type == FuncType::NOFUNC)
-    {
-      // 碰到group by
-      if (table_name == nullptr)
-      {
-        tmp_scheme.add_if_not_exists(type, "", attr_name);
-      }
-      else
-      {
-        std::string add_name = table_name;
-        add_name = add_name + "." + attr_name;
-        tmp_scheme.add_if_not_exists(type, "", add_name.c_str());
-      }
-      auto ans = tuple_set->get(0).get_pointer(index);
-      if (type == AttrType::FLOATS)
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<FloatValue>(ans)->get_value());
-      }
-      else if (type == AttrType::INTS)
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<IntValue>(ans)->get_value());
-      }
-      else // AttrType::CHARS和DATES一样计算
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<StringValue>(ans)->get_value(),
-                      std::dynamic_pointer_cast<StringValue>(ans)->get_len());
-      }
-      continue;
-    }
-
-    // 增加tuple
-    AttrType add_type = AttrType::UNDEFINED;
-    switch (func_type)
-    {
-    case FuncType::COUNT:
-    {
-      // 增加Scheme
-      add_type = AttrType::INTS;
-      // tmp_tuple.add((int)tuple_set->tuples().size());
-      int ans = 0;
-
-      for (int tuple_i = 0; tuple_i < tuple_set->size(); ++tuple_i)
-      {
-        std::shared_ptr<TupleValue> value = tuple_set->get(tuple_i).get_pointer(index);
-        if (!value->is_null())
-        {
-          ++ans;
-        }
-      }
-      tmp_tuple.add(ans);
-      break;
-    }
-    case FuncType::AVG:
-    {
-      if (type == AttrType::CHARS || type == AttrType::DATES)
-      {
-        // CHARS和DATES不应该计算平均值
-        rc = RC::GENERIC_ERROR;
-        break;
-      }
-      add_type = AttrType::FLOATS;
-
-      int size = (int)tuple_set->tuples().size();
-      float ans = 0;
-      int cnt = 0;
-
-      if (type == AttrType::FLOATS)
-      {
-        for (int tuple_i = 0; tuple_i < tuple_set->size(); ++tuple_i)
-        {
-          std::shared_ptr<TupleValue> val = tuple_set->get(tuple_i).get_pointer(index);
-          if (val->is_null())
-          {
-            continue;
-          }
-          std::shared_ptr<FloatValue> value = std::dynamic_pointer_cast<FloatValue>(val);
-          ans += value->get_value();
-          ++cnt;
-        }
-      }
-      else if (type == AttrType::INTS)
-      {
-        for (int tuple_i = 0; tuple_i < tuple_set->size(); ++tuple_i)
-        {
-          std::shared_ptr<TupleValue> val = tuple_set->get(tuple_i).get_pointer(index);
-          if (val->is_null())
-          {
-            continue;
-          }
-          std::shared_ptr<IntValue> value = std::dynamic_pointer_cast<IntValue>(val);
-          ans += value->get_value();
-          ++cnt;
-        }
-      }
-
-      if (size == 0 || cnt == 0)
-      {
-        add_type = AttrType::CHARS;
-        tmp_tuple.add("NULL", 4);
-        break;
-      }
-
-      tmp_tuple.add(ans / cnt);
-
-      break;
-    }
-    case FuncType::MAX:
-    {
-      int tuple_i = 0;
-      for (; tuple_i < tuple_set->size(); ++tuple_i)
-      {
-        auto ans = tuple_set->get(tuple_i).get_pointer(index);
-        if (!ans->is_null())
-        {
-          break;
-        }
-      }
-
-      if (tuple_i == tuple_set->size())
-      {
-        // TODO: 显示什么，NULL会影响吗
-        add_type = AttrType::CHARS;
-        tmp_tuple.add("NULL", 4);
-        break;
-      }
-
-      auto ans = tuple_set->get(tuple_i).get_pointer(index);
-      for (; tuple_i < tuple_set->size(); ++tuple_i)
-      {
-
-        auto value = tuple_set->get(tuple_i).get_pointer(index);
-
-        if (value->compare(*ans) > 0)
-        {
-          ans = value;
-        }
-      }
-
-      add_type = type;
-
-      if (type == AttrType::FLOATS)
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<FloatValue>(ans)->get_value());
-      }
-      else if (type == AttrType::INTS)
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<IntValue>(ans)->get_value());
-      }
-      else // AttrType::CHARS和DATES一样计算
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<StringValue>(ans)->get_value(),
-                      std::dynamic_pointer_cast<StringValue>(ans)->get_len());
-      }
-
-      break;
-    }
-    case FuncType::MIN:
-    {
-      int tuple_i = 0;
-      for (; tuple_i < tuple_set->size(); ++tuple_i)
-      {
-        auto ans = tuple_set->get(tuple_i).get_pointer(index);
-        if (!ans->is_null())
-        {
-          break;
-        }
-      }
-
-      if (tuple_i == tuple_set->size())
-      {
-        // TODO: 显示什么，NULL会影响吗
-        add_type = AttrType::CHARS;
-        tmp_tuple.add("NULL", 4);
-        break;
-      }
-
-      auto ans = tuple_set->get(tuple_i).get_pointer(index);
-      for (; tuple_i < tuple_set->size(); ++tuple_i)
-      {
-
-        auto value = tuple_set->get(tuple_i).get_pointer(index);
-
-        if (value->compare(*ans) < 0)
+        if (cnt == 0)
         {
-
-          ans = value;
+          ++cnt;
+          last_table_name = schema.field(i).table_name();
+          index = i;
+        }
+        else
+        {
+          if (last_table_name != schema.field(i).table_name())
+          {
+            ++cnt;
+            break;
+          }
         }
       }
-
-      add_type = type;
-
-      if (type == AttrType::FLOATS)
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<FloatValue>(ans)->get_value());
-      }
-      else if (type == AttrType::INTS)
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<IntValue>(ans)->get_value());
-      }
-      else // AttrType::CHARS和DATES一样计算
-      {
-        tmp_tuple.add(std::dynamic_pointer_cast<StringValue>(ans)->get_value(),
-                      std::dynamic_pointer_cast<StringValue>(ans)->get_len());
-      }
-
-      break;
-    }
-    default:
-      break;
-    }
-
-    tmp_scheme.add_if_not_exists(add_type, "", add_scheme_name.c_str());
-
-    if (rc != RC::SUCCESS)
-    {
-      return rc;
     }
   }
 
-  TupleSet tmp_set;
-  tmp_set.set_schema(tmp_scheme);
-  if (tmp_tuple.size() > 0)
+  if (index == -1 || cnt > 1)
   {
-    tmp_set.add(std ::move(tmp_tuple));
+    return -1;
   }
-  tmp_set.print(std::cout);
-  results.push_back(std::move(tmp_set));
 
-  return rc;
+  return index;
 }
 
 bool match_table(const Selects &selects, const char *table_name_in_condition, const char *table_name_to_match)
@@ -2207,6 +1495,168 @@ FuncType judge_function_type(char *agg_function_name)
   return FuncType::NOFUNC;
 }
 
+// order by的字段恰好是第一张表(relations的最后一个)某个索引的前缀，且方向一致时，让select节点沿着索引顺序(或逆序)扫描
+// 空值的比较结果与索引中的顺序不一致，所以只处理不允许为空的字段
+static bool set_order_by_index(const Selects &selects, const char *db, SelectExeNode &select_node)
+{
+  if (selects.order_num <= 0 || selects.group_num > 0)
+  {
+    return false;
+  }
+  for (size_t i = 0; i < selects.attr_num; i++)
+  {
+    if (selects.attributes[i].agg_function_name != nullptr)
+    {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < selects.condition_num; i++)
+  {
+    if (selects.conditions[i].right_is_attr == 2)
+    {
+      return false;
+    }
+  }
+
+  const char *table_name = selects.relations[selects.relation_num - 1];
+  Table *table = DefaultHandler::get_default().find_table(db, table_name);
+  if (nullptr == table)
+  {
+    return false;
+  }
+
+  // order_attrs[0]是第一排序键，所有排序键的方向必须一致
+  const char *field_names[MAX_NUM];
+  int field_num = 0;
+  bool is_desc = selects.order_attrs[0].is_desc == 1;
+  for (int i = 0; i < selects.order_num; i++)
+  {
+    const RelAttr &attr = selects.order_attrs[i];
+    if ((attr.is_desc == 1) != is_desc)
+    {
+      return false;
+    }
+    if ((attr.relation_name == nullptr && selects.relation_num > 1) ||
+        (attr.relation_name != nullptr && 0 != strcmp(attr.relation_name, table_name)))
+    {
+      return false;
+    }
+    const FieldMeta *field_meta = table->table_meta().field(attr.attribute_name);
+    if (nullptr == field_meta || field_meta->nullable())
+    {
+      return false;
+    }
+    field_names[field_num++] = attr.attribute_name;
+  }
+
+  const IndexMeta *index_meta = table->table_meta().find_index_by_prefix(field_names, field_num);
+  if (nullptr == index_meta)
+  {
+    return false;
+  }
+  LOG_INFO("order by使用索引顺序. table=%s, index=%s, desc=%d", table_name, index_meta->name(), is_desc);
+  select_node.set_index_order(index_meta->name(), is_desc);
+  return true;
+}
+
+// relations[table_index]不是第一张表，并且它的某个整数或字符串字段上有索引，和之前连接的表(下标更大)上的字段等值连接
+static bool may_lookup_by_index(const Selects &selects, const char *db, size_t table_index)
+{
+  if (table_index + 1 >= selects.relation_num)
+  {
+    return false;
+  }
+  const char *table_name = selects.relations[table_index];
+  Table *table = DefaultHandler::get_default().find_table(db, table_name);
+  for (size_t i = 0; i < selects.condition_num; i++)
+  {
+    const Condition &condition = selects.conditions[i];
+    if (condition.left_is_attr != 1 || condition.right_is_attr != 1 || condition.comp != EQUAL_TO ||
+        nullptr == condition.left_attr.relation_name || nullptr == condition.right_attr.relation_name)
+    {
+      continue;
+    }
+    const RelAttr *inner_attr = &condition.left_attr;
+    const RelAttr *outer_attr = &condition.right_attr;
+    if (0 != strcmp(inner_attr->relation_name, table_name))
+    {
+      std::swap(inner_attr, outer_attr);
+    }
+    if (0 != strcmp(inner_attr->relation_name, table_name))
+    {
+      continue;
+    }
+    bool outer_joined = false;
+    for (size_t j = table_index + 1; j < selects.relation_num; j++)
+    {
+      outer_joined = outer_joined || 0 == strcmp(outer_attr->relation_name, selects.relations[j]);
+    }
+    const FieldMeta *field_meta = table->table_meta().field(inner_attr->attribute_name);
+    if (outer_joined && field_meta != nullptr && (field_meta->type() == INTS || field_meta->type() == CHARS) &&
+        table->table_meta().find_single_index_by_field(field_meta->name()) != nullptr)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 第一张表已经按第一排序键升序扫描时，和这个字段等值连接的其它表如果也能沿连接字段的索引扫描，连接的两侧都有序，可以直接归并
+static void set_merge_join_by_index(const Selects &selects, const char *db, std::vector<SelectExeNode *> &select_nodes)
+{
+  const RelAttr &order_attr = selects.order_attrs[0];
+  if (order_attr.is_desc == 1)
+  {
+    return;
+  }
+  for (size_t i = 0; i < selects.condition_num; i++)
+  {
+    const Condition &condition = selects.conditions[i];
+    if (condition.left_is_attr != 1 || condition.right_is_attr != 1 || condition.comp != EQUAL_TO ||
+        nullptr == condition.left_attr.relation_name || nullptr == condition.right_attr.relation_name)
+    {
+      continue;
+    }
+    const RelAttr *other_attr = nullptr;
+    if (0 == strcmp(condition.left_attr.relation_name, order_attr.relation_name) &&
+        0 == strcmp(condition.left_attr.attribute_name, order_attr.attribute_name))
+    {
+      other_attr = &condition.right_attr;
+    }
+    else if (0 == strcmp(condition.right_attr.relation_name, order_attr.relation_name) &&
+             0 == strcmp(condition.right_attr.attribute_name, order_attr.attribute_name))
+    {
+      other_attr = &condition.left_attr;
+    }
+    if (nullptr == other_attr || 0 == strcmp(other_attr->relation_name, order_attr.relation_name))
+    {
+      continue;
+    }
+
+    for (size_t j = 0; j + 1 < selects.relation_num; j++)
+    {
+      if (0 != strcmp(selects.relations[j], other_attr->relation_name))
+      {
+        continue;
+      }
+      Table *table = DefaultHandler::get_default().find_table(db, selects.relations[j]);
+      const FieldMeta *field_meta = table->table_meta().field(other_attr->attribute_name);
+      if (nullptr == field_meta || field_meta->nullable())
+      {
+        break;
+      }
+      const char *field_names[] = {other_attr->attribute_name};
+      const IndexMeta *index_meta = table->table_meta().find_index_by_prefix(field_names, 1);
+      if (index_meta != nullptr)
+      {
+        LOG_INFO("连接字段使用索引顺序. table=%s, index=%s", selects.relations[j], index_meta->name());
+        select_nodes[j]->set_index_order(index_meta->name(), false);
+      }
+      break;
+    }
+  }
+}
+
 // 把所有的表和只跟这张表关联的condition都拿出来，生成最底层的select 执行节点
 RC create_selection_executor(Trx *trx, const Selects &selects, const char *db, const char *table_name, SelectExeNode &select_node, bool is_sub_select)
 {
@@ -2242,6 +1692,7 @@ RC create_selection_executor(Trx *trx, const Selects &selects, const char *db, c
 
   // 2. 遍历Select中所有属性
   bool attrIsStar = false;
+  bool count_star = false;
   // int rel_num = selects.relation_num;
   int n = selects.attr_num;
   for (int i = 0; i < n; ++i)
@@ -2254,6 +1705,13 @@ RC create_selection_executor(Trx *trx, const Selects &selects, const char *db, c
       // 对应select *的情况
       if (0 == strcmp("*", attr.attribute_name) || isdigit(attr.attribute_name[0]) || attr.attribute_name[0] == '-')
       {
+        // 单表的count(*)只关心行数，不需要列出所有字段
+        if (selects.relation_num == 1 && selects.group_num == 0 && attr.agg_function_name != nullptr &&
+            FuncType::COUNT == judge_function_type(attr.agg_function_name))
+        {
+          count_star = true;
+          continue;
+        }
         TupleSchema::from_table(table, schema); // 列出这张表所有字段
         attrIsStar = true;
         break; // 没有校验，给出* 之后，再写字段的错误
@@ -2308,11 +1766,53 @@ RC create_selection_executor(Trx *trx, const Selects &selects, const char *db, c
           return rc;
         }
       }
+      // 关联子查询和主查询按关联列匹配，子查询条件中引用的这张表的列也要加入schema
+      for (size_t j = 0; attrIsStar == false && j < condition.sub_select->condition_num; j++)
+      {
+        const Condition &sub_cond = condition.sub_select->conditions[j];
+        const RelAttr *outer_attr = nullptr;
+        if (sub_cond.left_is_attr == 1 && is_outer_attr(*condition.sub_select, sub_cond.left_attr, table_name))
+        {
+          outer_attr = &sub_cond.left_attr;
+        }
+        else if (sub_cond.right_is_attr == 1 && is_outer_attr(*condition.sub_select, sub_cond.right_attr, table_name))
+        {
+          outer_attr = &sub_cond.right_attr;
+        }
+        if (outer_attr != nullptr)
+        {
+          RC rc = schema_add_field(table, outer_attr->attribute_name, schema);
+          if (rc != RC::SUCCESS)
+          {
+            return rc;
+          }
+        }
+      }
       continue;
     }
 
     if (condition.left_is_attr > 1 || condition.right_is_attr > 1)
     {
+      // 多表查询中只涉及这张表的表达式条件，在扫描之后、连接之前过滤，表达式用到的列要加入schema
+      std::string expression_table;
+      std::vector<std::string> expression_fields;
+      if (selects.relation_num > 1 && single_table_expression(condition, expression_table, expression_fields) &&
+          expression_table == table_name)
+      {
+        for (const std::string &field : expression_fields)
+        {
+          RC rc = schema_add_field(table, field.c_str(), schema);
+          if (rc != RC::SUCCESS)
+          {
+            for (DefaultConditionFilter *&filter : condition_filters)
+            {
+              delete filter;
+            }
+            return rc;
+          }
+        }
+        select_node.add_batch_filter([&condition](TupleSet &tuple_set) { return filter_by_expression(condition, tuple_set); });
+      }
       continue;
     }
 
@@ -2364,7 +1864,19 @@ RC create_selection_executor(Trx *trx, const Selects &selects, const char *db, c
   // 这里是为了处理 select t1.id from t1,t2; 这种情况
   if (schema.empty())
   {
-    TupleSchema::from_table(table, schema);
+    if (count_star && table->table_meta().index_num() > 0)
+    {
+      // count(*)只输出一个索引字段，这样可以只扫描索引
+      RC rc = schema_add_field(table, table->table_meta().index(0)->field(0), schema);
+      if (rc != RC::SUCCESS)
+      {
+        return rc;
+      }
+    }
+    else
+    {
+      TupleSchema::from_table(table, schema);
+    }
   }
 
   return select_node.init(trx, table, std::move(schema), std::move(condition_filters));
@@ -2520,23 +2032,196 @@ bool cmp_value(AttrType left_type, AttrType right_type, void *left_data, const s
   }
 }
 
-bool is_type_legal(AttrType left_type, AttrType right_type)
+bool is_type_legal(AttrType left_type, AttrType right_type)
+{
+  // 判断左右两侧类型是否可以比较
+  if (left_type == AttrType::FLOATS || left_type == AttrType::INTS)
+  {
+    // INTS和FLOATS可以互相比较
+    if (right_type != AttrType::INTS && right_type != AttrType::FLOATS)
+    {
+      return false;
+    }
+  }
+  else if (left_type != right_type)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+// 子查询条件中的列是否引用了主查询的表。子查询自己也查询了同名的表时，列属于子查询
+static bool is_outer_attr(const Selects &sub_select, const RelAttr &attr, const char *main_table)
+{
+  if (attr.relation_name == nullptr || strcmp(attr.relation_name, main_table) != 0)
+  {
+    return false;
+  }
+  for (size_t i = 0; i < sub_select.relation_num; i++)
+  {
+    if (strcmp(sub_select.relations[i], main_table) == 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 关联子查询去关联，is_related返回是否是关联子查询。关联列作为子查询的最后一列输出：
+// 1. 唯一的关联条件是子查询的列等于主查询的列时，去掉这个条件，输出子查询的列。子查询和主查询无关，只执行一次
+// 2. 其它情况把主查询的表加入子查询，输出主查询的列
+// 比较运算和带聚合函数的子查询按关联列分组，每组得到一个值，没有聚合函数时取max。
+// 结果只按一个关联列和主查询的行匹配，关联条件引用了主查询的多个列时不支持
+static RC decorrelate_sub_select(Selects &sub_select, const char *main_table, bool is_in, bool &is_related, RelAttr &outer_attr,
+                                 RelAttr &key_attr)
+{
+  int correlated_num = 0;
+  int correlated_index = -1;
+  for (size_t i = 0; i < sub_select.condition_num; i++)
+  {
+    const Condition &sub_cond = sub_select.conditions[i];
+    const RelAttr *cond_outer_attr = nullptr;
+    if (sub_cond.right_is_attr == 1 && is_outer_attr(sub_select, sub_cond.right_attr, main_table))
+    {
+      cond_outer_attr = &sub_cond.right_attr;
+      key_attr = sub_cond.left_attr;
+    }
+    else if (sub_cond.left_is_attr == 1 && is_outer_attr(sub_select, sub_cond.left_attr, main_table))
+    {
+      cond_outer_attr = &sub_cond.left_attr;
+      key_attr = sub_cond.right_attr;
+    }
+    else
+    {
+      continue;
+    }
+    if (correlated_num > 0 && 0 != strcmp(outer_attr.attribute_name, cond_outer_attr->attribute_name))
+    {
+      LOG_WARN("关联子查询引用了主查询的多个列 %s, %s，不支持", outer_attr.attribute_name, cond_outer_attr->attribute_name);
+      return RC::GENERIC_ERROR;
+    }
+    outer_attr = *cond_outer_attr;
+    correlated_num++;
+    correlated_index = i;
+  }
+  is_related = correlated_num > 0;
+  if (!is_related)
+  {
+    return RC::SUCCESS;
+  }
+
+  const Condition &sub_cond = sub_select.conditions[correlated_index];
+  if (correlated_num == 1 && sub_cond.comp == CompOp::EQUAL_TO && sub_cond.left_is_attr == 1 && sub_cond.right_is_attr == 1 &&
+      !is_outer_attr(sub_select, key_attr, main_table))
+  {
+    for (size_t i = correlated_index + 1; i < sub_select.condition_num; i++)
+    {
+      sub_select.conditions[i - 1] = sub_select.conditions[i];
+    }
+    sub_select.condition_num--;
+  }
+  else
+  {
+    sub_select.relations[sub_select.relation_num++] = (char *)main_table;
+    key_attr = outer_attr;
+  }
+
+  bool has_agg = sub_select.attributes[0].agg_function_name != nullptr;
+  sub_select.attributes[sub_select.attr_num++] = key_attr;
+  if (sub_select.total_exp > 0)
+  {
+    // 查询列最后按表达式提取，关联列也要作为一个表达式
+    std::string key_name = key_attr.attribute_name;
+    if (key_attr.relation_name != nullptr)
+    {
+      key_name = std::string(key_attr.relation_name) + "." + key_attr.attribute_name;
+    }
+    sub_select.expression[sub_select.total_exp][0] = strdup(key_name.c_str());
+    sub_select.exp_num[sub_select.total_exp++] = 1;
+  }
+  if (!is_in || has_agg)
+  {
+    sub_select.group_num = 0;
+    sub_select.group_attrs[sub_select.group_num++] = key_attr;
+    if (!has_agg)
+    {
+      sub_select.attributes[0].agg_function_name = strdup("max");
+    }
+  }
+  return RC::SUCCESS;
+}
+
+// 关联列在子查询结果中的下标。分组输出的列名是"表名.列名"或者列名，不带表名
+static int sub_select_key_index(const TupleSchema &schema, const RelAttr &key_attr)
+{
+  std::string full_name = key_attr.attribute_name;
+  if (key_attr.relation_name != nullptr)
+  {
+    full_name = std::string(key_attr.relation_name) + "." + key_attr.attribute_name;
+  }
+  for (int i = schema.size() - 1; i >= 0; --i)
+  {
+    const TupleField &field = schema.field(i);
+    if (full_name == field.field_name())
+    {
+      return i;
+    }
+    if (strcmp(field.field_name(), key_attr.attribute_name) == 0 &&
+        (key_attr.relation_name == nullptr || strcmp(field.table_name(), key_attr.relation_name) == 0))
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// 条件中的常量转成元组中的值，日期在元组中是字符串
+static std::shared_ptr<TupleValue> value_to_tuple_value(const Value &value)
+{
+  switch (value.type)
+  {
+  case INTS:
+    return std::make_shared<IntValue>(*(int *)value.data, false);
+  case FLOATS:
+    return std::make_shared<FloatValue>(*(float *)value.data, false);
+  case DATES:
+  {
+    char str[11] = {0};
+    num2date(*(int *)value.data, str);
+    return std::make_shared<StringValue>(str, 10, false);
+  }
+  case NULLS:
+    return std::make_shared<StringValue>("NULL", 4, true);
+  default:
+    return std::make_shared<StringValue>((const char *)value.data, false);
+  }
+}
+
+// 值是否是NULL。数值列中的字符串是聚合函数没有非NULL值时输出的NULL
+static bool is_null_value(AttrType type, const TupleValue &value)
+{
+  if (value.is_null())
+  {
+    return true;
+  }
+  return (type == INTS || type == FLOATS) && dynamic_cast<const StringValue *>(&value) != nullptr;
+}
+
+// 和子查询的结果比较，NULL和任何值比较都不成立。日期在元组中是字符串，按字符串比较
+static bool compare_sub_value(AttrType left_type, AttrType right_type, const std::shared_ptr<TupleValue> &left_value, CompOp op,
+                              const std::shared_ptr<TupleValue> &right_value)
 {
-  // 判断左右两侧类型是否可以比较
-  if (left_type == AttrType::FLOATS || left_type == AttrType::INTS)
+  if (is_null_value(left_type, *left_value) || is_null_value(right_type, *right_value))
   {
-    // INTS和FLOATS可以互相比较
-    if (right_type != AttrType::INTS && right_type != AttrType::FLOATS)
-    {
-      return false;
-    }
+    return false;
   }
-  else if (left_type != right_type)
+  if (left_type == DATES)
   {
-    return false;
+    left_type = CHARS;
+    right_type = CHARS;
   }
-
-  return true;
+  return cmp_value(left_type, right_type, nullptr, right_value, op, left_value, nullptr);
 }
 
 int find_rbrace(char *const *s, int start, int end)
@@ -2892,3 +2577,428 @@ RC calculate(const TupleSet &total_set, TupleSet &result, char *const *expressio
 
   return RC::SUCCESS;
 }
+
+// 单表上只有COUNT/MIN/MAX/AVG、没有分组和表达式的查询可以按列批量计算。
+// MIN/MAX/AVG只处理整数和浮点数，其它情况(包括需要报错的情况)仍然走逐行的执行流程
+static bool can_aggregate_by_column(const Selects &selects, const Table *table)
+{
+  if (selects.relation_num != 1 || selects.group_num > 0 || selects.order_num > 0 || selects.attr_num == 0)
+  {
+    return false;
+  }
+  for (size_t i = 0; i < selects.total_exp; i++)
+  {
+    if (selects.exp_num[i] > 1)
+    {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < selects.condition_num; i++)
+  {
+    const Condition &condition = selects.conditions[i];
+    if (condition.left_is_attr > 1 || condition.right_is_attr > 1 || condition.sub_select != nullptr ||
+        condition.another_sub_select != nullptr)
+    {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < selects.attr_num; i++)
+  {
+    const RelAttr &attr = selects.attributes[i];
+    if (attr.agg_function_name == nullptr ||
+        (attr.relation_name != nullptr && 0 != strcmp(attr.relation_name, table->name())))
+    {
+      return false;
+    }
+    FuncType function_type = judge_function_type(attr.agg_function_name);
+    if (0 == strcmp(attr.attribute_name, "*"))
+    {
+      if (function_type != FuncType::COUNT)
+      {
+        return false;
+      }
+      continue;
+    }
+    const FieldMeta *field_meta = table->table_meta().field(attr.attribute_name);
+    if (function_type == FuncType::NOFUNC || nullptr == field_meta ||
+        (function_type != FuncType::COUNT && field_meta->type() != INTS && field_meta->type() != FLOATS))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 输出的列名、列的顺序和结果都和逐行的聚合节点相同
+static RC do_column_aggregation(Trx *trx, const Selects &selects, SelectExeNode &select_node, TupleSet &result)
+{
+  Table *table = select_node.table();
+  AttrFunction attr_function;
+  for (int i = selects.attr_num - 1; i >= 0; i--)
+  {
+    const RelAttr &attr = selects.attributes[i];
+    attr_function.add_function_type(std::string(attr.attribute_name), judge_function_type(attr.agg_function_name),
+                                    attr.relation_name);
+  }
+
+  std::vector<const FieldMeta *> fields;
+  ColumnAggregator aggregator;
+  for (int j = attr_function.get_size() - 1; j >= 0; --j)
+  {
+    const char *attr_name = attr_function.get_attr_name(j);
+    if (0 == strcmp(attr_name, "*"))
+    {
+      aggregator.add(FuncType::COUNT, -1, INTS);
+      continue;
+    }
+    const FieldMeta *field_meta = table->table_meta().field(attr_name);
+    auto iter = std::find(fields.begin(), fields.end(), field_meta);
+    if (iter == fields.end())
+    {
+      iter = fields.insert(fields.end(), field_meta);
+    }
+    aggregator.add(attr_function.get_function_type(j), iter - fields.begin(), field_meta->type());
+  }
+
+  ColumnScanExeNode scan_node;
+  RC rc = scan_node.init(trx, table, select_node.condition_filters(), fields);
+  if (rc != RC::SUCCESS)
+  {
+    return rc;
+  }
+  ColumnBatch batch;
+  scan_node.init_batch(batch);
+  rc = scan_node.open();
+  while (rc == RC::SUCCESS && (rc = scan_node.next_batch(batch)) == RC::SUCCESS)
+  {
+    aggregator.update(batch);
+  }
+  scan_node.close();
+  if (rc != RC::RECORD_EOF)
+  {
+    LOG_ERROR("Failed to aggregate table %s by column. rc=%d:%s", table->name(), rc, strrc(rc));
+    return rc;
+  }
+
+  TupleSchema schema;
+  Tuple tuple;
+  for (int j = attr_function.get_size() - 1, index = 0; j >= 0; --j, ++index)
+  {
+    AttrType type = aggregator.output(index, tuple);
+    schema.add_if_not_exists(type, "", attr_function.to_string(j, selects.relation_num).c_str());
+  }
+  result.set_schema(schema);
+  result.add(std::move(tuple));
+  return RC::SUCCESS;
+}
+
+// 收集查询列上的聚合函数，有group by时不带函数的列记为NOFUNC
+static void collect_attr_functions(const Selects &selects, AttrFunction &attr_function)
+{
+  for (int i = selects.attr_num - 1; i >= 0; i--)
+  {
+    const RelAttr &attr = selects.attributes[i];
+
+    if (attr.agg_function_name != nullptr)
+    {
+      // 注意这里attr.relation_name可能为nullptr
+      FuncType function_type = judge_function_type(attr.agg_function_name);
+      attr_function.add_function_type(std::string(attr.attribute_name), function_type, attr.relation_name);
+    }
+    else if (selects.group_num > 0)
+    {
+      attr_function.add_function_type(std::string(attr.attribute_name), FuncType::NOFUNC, attr.relation_name);
+    }
+  }
+}
+
+// 把聚合函数转成HashAggregator的输入
+static RC make_aggregate_specs(const TupleSchema &schema, AttrFunction &attr_function, int rel_num,
+                               std::vector<AggregateSpec> &specs)
+{
+  for (int j = attr_function.get_size() - 1; j >= 0; --j)
+  {
+    const char *table_name = attr_function.get_table_name(j);
+    const char *attr_name = attr_function.get_attr_name(j);
+    FuncType func_type = attr_function.get_function_type(j);
+    if (strcmp(attr_name, "*") == 0)
+    {
+      specs.push_back({func_type, -1, attr_function.to_string(j, rel_num)});
+      continue;
+    }
+
+    int index = table_name != nullptr ? schema.index_of_field(table_name, attr_name) : schema.index_of_field(attr_name);
+    if (index < 0)
+    {
+      LOG_ERROR("No such field in group by result. table=%s, field=%s", table_name, attr_name);
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    if (func_type != FuncType::NOFUNC)
+    {
+      specs.push_back({func_type, index, attr_function.to_string(j, rel_num)});
+    }
+    else if (table_name == nullptr)
+    {
+      specs.push_back({func_type, index, attr_name});
+    }
+    else
+    {
+      specs.push_back({func_type, index, std::string(table_name) + "." + attr_name});
+    }
+  }
+  return RC::SUCCESS;
+}
+
+// 用聚合节点计算聚合函数。source为nullptr时从已经物化的result中拉取元组，否则从扫描或连接的流水线中拉取
+static RC aggregate(ExecutionNode *source, const TupleSet &result, const std::vector<int> &group_index,
+                    const std::vector<AggregateSpec> &specs, TupleSet &output)
+{
+  TupleSetScanExeNode result_node;
+  result_node.init(&result);
+  AggregateExeNode aggregate_node;
+  RC rc = aggregate_node.init(nullptr == source ? &result_node : source, group_index, specs);
+  if (rc != RC::SUCCESS)
+  {
+    return rc;
+  }
+  return aggregate_node.execute(output);
+}
+
+// order by的列在schema中的下标，第一个是第一排序键
+static RC make_sort_keys(const Selects &selects, const TupleSchema &schema, std::vector<SortKey> &keys)
+{
+  for (size_t i = 0; i < selects.order_num; i++)
+  {
+    const RelAttr &attr = selects.order_attrs[i];
+    int index = is_col_legal(attr, schema);
+    if (index == -1)
+    {
+      // 出现错误列名或者二义性问题
+      LOG_ERROR("Invalid order by field. table=%s, field=%s", attr.relation_name, attr.attribute_name);
+      return RC::GENERIC_ERROR;
+    }
+    keys.push_back({index, attr.is_desc == 1});
+  }
+  return RC::SUCCESS;
+}
+
+// 子查询、where中没有下推到扫描的表达式和select中的算式都在整个结果上计算，需要先物化扫描或连接的结果
+static bool need_materialize(const Selects &selects)
+{
+  for (size_t i = 0; i < selects.total_exp; i++)
+  {
+    if (selects.exp_num[i] > 1)
+    {
+      return true;
+    }
+  }
+  for (size_t i = 0; i < selects.condition_num; i++)
+  {
+    const Condition &condition = selects.conditions[i];
+    std::string table_name;
+    std::vector<std::string> fields;
+    if (condition.left_is_attr == 2 || condition.right_is_attr == 2 || condition.sub_select != nullptr ||
+        condition.another_sub_select != nullptr)
+    {
+      return true;
+    }
+    if ((condition.left_is_attr == 3 || condition.right_is_attr == 3) &&
+        !(selects.relation_num > 1 && single_table_expression(condition, table_name, fields)))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 只有单表过滤条件、连接条件和不需要计算的查询列时，扫描或连接输出的行就是最终结果的行，limit可以下推
+static bool can_push_down_limit(const Selects &selects, bool ordered_by_index)
+{
+  if (!selects.has_limit || selects.group_num > 0 || (selects.order_num > 0 && !ordered_by_index))
+  {
+    return false;
+  }
+  for (size_t i = 0; i < selects.total_exp; i++)
+  {
+    if (selects.exp_num[i] > 1)
+    {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < selects.condition_num; i++)
+  {
+    const Condition &condition = selects.conditions[i];
+    if (condition.left_is_attr > 1 || condition.right_is_attr > 1 || condition.sub_select != nullptr ||
+        condition.another_sub_select != nullptr)
+    {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < selects.attr_num; i++)
+  {
+    if (selects.attributes[i].agg_function_name != nullptr)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 最终结果需要的行数，即offset+limit
+static int limit_end(const Selects &selects)
+{
+  return selects.limit > INT_MAX - selects.offset ? INT_MAX : selects.limit + selects.offset;
+}
+
+// 跳过前offset行，最多保留limit行
+static void apply_limit(const Selects &selects, TupleSet &tuple_set)
+{
+  if (!selects.has_limit)
+  {
+    return;
+  }
+  std::vector<Tuple> tuples = tuple_set.release_tuples();
+  int end = std::min(limit_end(selects), (int)tuples.size());
+  for (int i = selects.offset; i < end; i++)
+  {
+    tuple_set.add(std::move(tuples[i]));
+  }
+}
+
+// 条件两侧是表达式和值、或者都是表达式，并且表达式中的列都写成同一张表的表名.列名时，返回这张表的表名和用到的列
+static bool single_table_expression(const Condition &condition, std::string &table_name, std::vector<std::string> &fields)
+{
+  if (!((condition.left_is_attr == 3 && (condition.right_is_attr == 0 || condition.right_is_attr == 3)) ||
+        (condition.left_is_attr == 0 && condition.right_is_attr == 3)))
+  {
+    return false;
+  }
+
+  table_name.clear();
+  fields.clear();
+  for (int side = 0; side < 2; side++)
+  {
+    bool is_expression = side == 0 ? condition.left_is_attr == 3 : condition.right_is_attr == 3;
+    char *const *expression = side == 0 ? condition.expression : condition.right_expression;
+    int exp_num = side == 0 ? condition.exp_num : condition.right_exp_num;
+    for (int i = 0; is_expression && i < exp_num; i++)
+    {
+      // 和calculate一样，字母开头的是列
+      const char *s = expression[i];
+      if (!((s[0] >= 'a' && s[0] <= 'z') || (s[0] >= 'A' && s[0] <= 'Z')))
+      {
+        continue;
+      }
+      const char *dot = strchr(s, '.');
+      if (nullptr == dot)
+      {
+        return false;
+      }
+      std::string relation(s, dot - s);
+      if (!table_name.empty() && table_name != relation)
+      {
+        return false;
+      }
+      table_name = relation;
+      fields.emplace_back(dot + 1);
+    }
+  }
+  return !table_name.empty();
+}
+
+// 按照where中的表达式条件过滤result，表达式按float计算
+static RC filter_by_expression(const Condition &condition, TupleSet &result)
+{
+  std::vector<int> is_include(result.size(), 1);
+  TupleSet left_result;
+  TupleSet right_result;
+
+  LOG_INFO("condition.left_is_attr = %d, right_is_attr = %d", condition.left_is_attr, condition.right_is_attr);
+
+  if (condition.left_is_attr == 3)
+  {
+    if (calculate(result, left_result, condition.expression, 0, condition.exp_num, is_include) != RC::SUCCESS)
+    {
+      return RC::GENERIC_ERROR;
+    }
+  }
+
+  if (condition.right_is_attr == 3)
+  {
+    if (calculate(result, right_result, condition.right_expression, 0, condition.right_exp_num, is_include) != RC::SUCCESS)
+    {
+      return RC::GENERIC_ERROR;
+    }
+  }
+
+  if (condition.left_is_attr == 3 && condition.right_is_attr == 0)
+  {
+    // 左表达式右值
+    AttrType right_type = condition.right_value.type;
+    void *right_data = condition.right_value.data;
+
+    if (right_type == NULLS || right_type == CHARS)
+    {
+      return RC::GENERIC_ERROR;
+    }
+
+    TupleSet new_result;
+    new_result.set_schema(result.get_schema());
+
+    for (int j = 0; j < left_result.size(); ++j)
+    {
+      const std::shared_ptr<TupleValue> &left_value = left_result.get(j).get_pointer(0);
+      if (cmp_value(FLOATS, right_type, nullptr, left_value, condition.comp, left_value, right_data) && is_include[j] == 1)
+      {
+        result.copy_ith_to(new_result, j);
+      }
+    }
+
+    result = std::move(new_result);
+  }
+
+  if (condition.left_is_attr == 0 && condition.right_is_attr == 3)
+  {
+    // 右表达式左值
+    AttrType left_type = condition.left_value.type;
+    void *left_data = condition.left_value.data;
+
+    if (left_type == NULLS || left_type == CHARS)
+    {
+      return RC::GENERIC_ERROR;
+    }
+
+    TupleSet new_result;
+    new_result.set_schema(result.get_schema());
+    for (int j = 0; j < right_result.size(); ++j)
+    {
+      const std::shared_ptr<TupleValue> &right_value = right_result.get(j).get_pointer(0);
+      if (cmp_value(left_type, FLOATS, left_data, right_value, condition.comp, right_value, nullptr) && is_include[j] == 1)
+      {
+        result.copy_ith_to(new_result, j);
+      }
+    }
+
+    result = std::move(new_result);
+  }
+
+  if (condition.left_is_attr == 3 && condition.right_is_attr == 3)
+  {
+    // 左右都是表达式
+    TupleSet new_result;
+    new_result.set_schema(result.get_schema());
+    for (int j = 0; j < right_result.size(); ++j)
+    {
+      const std::shared_ptr<TupleValue> &left_value = left_result.get(j).get_pointer(0);
+      const std::shared_ptr<TupleValue> &right_value = right_result.get(j).get_pointer(0);
+      if (cmp_value(FLOATS, FLOATS, nullptr, right_value, condition.comp, left_value, nullptr) && is_include[j] == 1)
+      {
+        result.copy_ith_to(new_result, j);
+      }
+    }
+
+    result = std::move(new_result);
+  }
+  return RC::SUCCESS;
+}
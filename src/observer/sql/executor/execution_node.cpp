@@ -12,10 +12,50 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2021/5/14.
 //
 
+#include <algorithm>
+
 #include "sql/executor/execution_node.h"
 #include "storage/common/table.h"
+#include "storage/common/record_manager.h"
 #include "common/log/log.h"
 
+// 左侧分批输入时每批的元组个数
+#define STREAM_JOIN_BATCH_SIZE 1024
+// 逐条扫描且有batch_filters_时，每批检查的元组个数
+#define SELECT_FILTER_BATCH_SIZE 1024
+
+// 用open/next拉取全部元组。schema在open之后设置，聚合节点open之后才知道输出的列
+static RC pull_all(ExecutionNode &node, TupleSet &tuple_set) {
+  tuple_set.clear();
+  RC rc = node.open();
+  tuple_set.set_schema(node.schema());
+  Tuple tuple;
+  while (rc == RC::SUCCESS && (rc = node.next(tuple)) == RC::SUCCESS) {
+    tuple_set.add(std::move(tuple));
+  }
+  node.close();
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+RC ExecutionNode::open() {
+  buffered_.clear();
+  buffered_pos_ = 0;
+  return execute(buffered_);
+}
+
+RC ExecutionNode::next(Tuple &tuple) {
+  if (buffered_pos_ >= buffered_.size()) {
+    return RC::RECORD_EOF;
+  }
+  tuple = Tuple(buffered_.get(buffered_pos_++));
+  return RC::SUCCESS;
+}
+
+void ExecutionNode::close() {
+  buffered_.clear();
+  buffered_pos_ = 0;
+}
+
 SelectExeNode::SelectExeNode() : table_(nullptr) {
 }
 
@@ -34,20 +74,965 @@ RC SelectExeNode::init(Trx *trx, Table *table, TupleSchema &&tuple_schema, std::
   return RC::SUCCESS;
 }
 
+void SelectExeNode::set_index_order(const char *index_name, bool is_desc) {
+  order_index_name_ = index_name;
+  is_desc_ = is_desc;
+}
+
 void record_reader(const char *data, void *context) {
   TupleRecordConverter *converter = (TupleRecordConverter *)context;
   converter->add_record(data);
 }
 
-RC SelectExeNode::execute(TupleSet &tuple_set) {
-  CompositeConditionFilter condition_filter;
+void SelectExeNode::prepare_scan(CompositeConditionFilter &condition_filter, std::vector<const char *> &field_names) const {
   // 这里的condition_filters_是execution_node中收集到的condition_filters_,是DefaultConditionFilter数组
   // condition_filters_.data() 返回指向第一个元素的指针
   condition_filter.init((const ConditionFilter **)condition_filters_.data(), condition_filters_.size());
 
+  // 告诉存储层要读取哪些字段，这些字段都在某个索引中时可以不读记录文件
+  field_names.clear();
+  for (const TupleField &field : tuple_schema_.fields()) {
+    field_names.push_back(field.field_name());
+  }
+}
+
+RC SelectExeNode::filter_batch(TupleSet &tuple_set) const {
+  for (const BatchFilter &filter : batch_filters_) {
+    RC rc = filter(tuple_set);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC SelectExeNode::execute(TupleSet &tuple_set) {
+  CompositeConditionFilter condition_filter;
+  std::vector<const char *> field_names;
+  prepare_scan(condition_filter, field_names);
+
   tuple_set.clear();
   tuple_set.set_schema(tuple_schema_);
   TupleRecordConverter converter(table_, tuple_set);
 
-  return table_->scan_record(trx_, &condition_filter, -1, (void *)&converter, record_reader);
-}
\ No newline at end of file
+  RC rc = RC::SUCCESS;
+  if (!order_index_name_.empty()) {
+    rc = table_->scan_record_in_index_order(trx_, &condition_filter, order_index_name_.c_str(), is_desc_, limit_,
+                                            (void *)&converter, record_reader, field_names.data(), field_names.size());
+  } else {
+    rc = table_->scan_record(trx_, &condition_filter, limit_, (void *)&converter, record_reader,
+                             field_names.data(), field_names.size());
+  }
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  return filter_batch(tuple_set);
+}
+
+RC SelectExeNode::open() {
+  streaming_ = order_index_name_.empty();
+  if (!streaming_) {
+    return ExecutionNode::open();
+  }
+  filtered_.clear();
+  filtered_.set_schema(tuple_schema_);
+  filtered_pos_ = 0;
+  scan_eof_ = false;
+  prepare_scan(scan_filter_, scan_fields_);
+  return scanner_.open(table_, trx_, &scan_filter_, scan_fields_.data(), scan_fields_.size());
+}
+
+RC SelectExeNode::next(Tuple &tuple) {
+  if (!streaming_) {
+    return ExecutionNode::next(tuple);
+  }
+  if (!batch_filters_.empty()) {
+    return next_filtered(tuple);
+  }
+  Record record;
+  RC rc = scanner_.next(record);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  tuple = Tuple();
+  TupleRecordConverter::record_to_tuple(table_, tuple_schema_, record.data, tuple);
+  return RC::SUCCESS;
+}
+
+// 从扫描中读出一批元组统一过滤，再逐个输出通过过滤的元组
+RC SelectExeNode::next_filtered(Tuple &tuple) {
+  while (filtered_pos_ >= filtered_.size()) {
+    if (scan_eof_) {
+      return RC::RECORD_EOF;
+    }
+    filtered_.clear_tuples();
+    filtered_pos_ = 0;
+    Record record;
+    RC rc = RC::SUCCESS;
+    while (filtered_.size() < SELECT_FILTER_BATCH_SIZE && (rc = scanner_.next(record)) == RC::SUCCESS) {
+      Tuple scanned;
+      TupleRecordConverter::record_to_tuple(table_, tuple_schema_, record.data, scanned);
+      filtered_.add(std::move(scanned));
+    }
+    if (rc == RC::RECORD_EOF) {
+      scan_eof_ = true;
+    } else if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    rc = filter_batch(filtered_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  tuple = Tuple(filtered_.get(filtered_pos_++));
+  return RC::SUCCESS;
+}
+
+void SelectExeNode::close() {
+  if (!streaming_) {
+    ExecutionNode::close();
+  }
+  scanner_.close();
+}
+
+RC SelectExeNode::execute_by_key(const char *field_name, const char *value, TupleSet &tuple_set) {
+  CompositeConditionFilter condition_filter;
+  std::vector<const char *> field_names;
+  prepare_scan(condition_filter, field_names);
+  if (batch_filters_.empty()) {
+    TupleRecordConverter converter(table_, tuple_set);
+    return table_->scan_record_by_key(trx_, &condition_filter, field_name, value, (void *)&converter, record_reader,
+                                      field_names.data(), field_names.size());
+  }
+
+  // 只过滤这次查到的元组，tuple_set中原有的元组不变
+  TupleSet matched(tuple_schema_);
+  TupleRecordConverter converter(table_, matched);
+  RC rc = table_->scan_record_by_key(trx_, &condition_filter, field_name, value, (void *)&converter, record_reader,
+                                     field_names.data(), field_names.size());
+  if (rc == RC::SUCCESS) {
+    rc = filter_batch(matched);
+  }
+  for (Tuple &tuple : matched.release_tuples()) {
+    tuple_set.add(std::move(tuple));
+  }
+  return rc;
+}
+
+bool valueCompare(const TupleValue *value_a, const TupleValue *value_b, CompOp op)
+{
+  bool compare_result = false;
+  switch (op)
+  {
+  case EQUAL_TO:
+    compare_result = (value_a->compare(*value_b) == 0);
+    break;
+  case LESS_EQUAL:
+    compare_result = (value_a->compare(*value_b) <= 0);
+    break;
+  case NOT_EQUAL:
+    compare_result = (value_a->compare(*value_b) != 0);
+    break;
+  case LESS_THAN:
+    compare_result = (value_a->compare(*value_b) < 0);
+    break;
+  case GREAT_EQUAL:
+    compare_result = (value_a->compare(*value_b) >= 0);
+    break;
+  case GREAT_THAN:
+    compare_result = (value_a->compare(*value_b) > 0);
+    break;
+  default:
+    break;
+  }
+  return compare_result;
+}
+
+RC JoinExeNode::init(const TupleSet &left, const TupleSet &right, const Selects &selects) {
+  left_ = &left;
+  right_ = &right;
+  schema_.clear();
+  schema_.append(left.get_schema());
+  schema_.append(right.get_schema());
+  left_keys_.clear();
+  right_keys_.clear();
+  conditions_.clear();
+
+  const int left_size = left.get_schema().size();
+  for (size_t i = 0; i < selects.condition_num; i++) {
+    const Condition &condition = selects.conditions[i];
+    if (condition.left_is_attr != 1 || condition.right_is_attr != 1 ||
+        nullptr == condition.left_attr.relation_name || nullptr == condition.right_attr.relation_name) {
+      continue;
+    }
+    int left_index = schema_.index_of_field(condition.left_attr.relation_name, condition.left_attr.attribute_name);
+    int right_index = schema_.index_of_field(condition.right_attr.relation_name, condition.right_attr.attribute_name);
+    // 两个字段都在左侧时，条件在之前的连接中已经检查过了
+    if (left_index < 0 || right_index < 0 || (left_index < left_size && right_index < left_size)) {
+      continue;
+    }
+
+    // 浮点数按照误差判断相等，哈希值不一定相同，不能作为连接键
+    AttrType left_type = schema_.field(left_index).type();
+    AttrType right_type = schema_.field(right_index).type();
+    if (condition.comp == EQUAL_TO && left_type == right_type && left_type != FLOATS &&
+        (left_index < left_size) != (right_index < left_size)) {
+      left_keys_.push_back(std::min(left_index, right_index));
+      right_keys_.push_back(std::max(left_index, right_index) - left_size);
+      continue;
+    }
+    conditions_.push_back({left_index, right_index, condition.comp});
+  }
+  return RC::SUCCESS;
+}
+
+const TupleValue *JoinExeNode::value_of(const Tuple &left, const Tuple &right, int index) const {
+  const int left_size = left.size();
+  return index < left_size ? left.get_pointer(index).get() : right.get_pointer(index - left_size).get();
+}
+
+// NULL和任何值都不相等，连接键中有NULL的行不会出现在结果中
+bool JoinExeNode::key_has_null(const Tuple &tuple, const std::vector<int> &keys) const {
+  for (int key : keys) {
+    if (tuple.get(key).is_null()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool JoinExeNode::match(const Tuple &left, const Tuple &right) const {
+  for (size_t i = 0; i < left_keys_.size(); i++) {
+    if (!valueCompare(left.get_pointer(left_keys_[i]).get(), right.get_pointer(right_keys_[i]).get(), EQUAL_TO)) {
+      return false;
+    }
+  }
+  return match_conditions(left, right);
+}
+
+// NULL和任何值比较的结果都是未知，不满足条件。归并连接的范围条件同样跳过NULL
+bool JoinExeNode::match_conditions(const Tuple &left, const Tuple &right) const {
+  for (const JoinCondition &condition : conditions_) {
+    const TupleValue *left_value = value_of(left, right, condition.left_index);
+    const TupleValue *right_value = value_of(left, right, condition.right_index);
+    if (left_value->is_null() || right_value->is_null() || !valueCompare(left_value, right_value, condition.comp_op)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void JoinExeNode::emit(const Tuple &left, const Tuple &right, TupleSet &tuple_set) const {
+  Tuple tuple(left);
+  tuple.merge(right);
+  tuple_set.add(std::move(tuple));
+}
+
+RC HashJoinExeNode::init(const TupleSet &left, const TupleSet &right, const Selects &selects) {
+  right_table_built_ = false;
+  right_table_.clear();
+  return JoinExeNode::init(left, right, selects);
+}
+
+RC HashJoinExeNode::execute(TupleSet &tuple_set) {
+  tuple_set.clear();
+  tuple_set.set_schema(schema_);
+  const std::vector<Tuple> &left_tuples = left_->tuples();
+  const std::vector<Tuple> &right_tuples = right_->tuples();
+
+  if (left_keys_.empty()) {
+    for (const Tuple &left : left_tuples) {
+      for (const Tuple &right : right_tuples) {
+        if (match(left, right)) {
+          emit(left, right, tuple_set);
+        }
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  const bool build_left = !keep_right_table_ && left_tuples.size() < right_tuples.size();
+  const std::vector<Tuple> &build_tuples = build_left ? left_tuples : right_tuples;
+  const std::vector<Tuple> &probe_tuples = build_left ? right_tuples : left_tuples;
+  const std::vector<int> &build_keys = build_left ? left_keys_ : right_keys_;
+  const std::vector<int> &probe_keys = build_left ? right_keys_ : left_keys_;
+
+  std::unordered_map<size_t, std::vector<int>> left_table;
+  std::unordered_map<size_t, std::vector<int>> &hash_table = build_left ? left_table : right_table_;
+  if (build_left || !right_table_built_) {
+    hash_table.clear();
+    for (int i = 0; i < (int)build_tuples.size(); i++) {
+      if (!key_has_null(build_tuples[i], build_keys)) {
+        hash_table[build_tuples[i].to_hash(build_keys)].push_back(i);
+      }
+    }
+    // 不分批时右侧可能是下一次连接的另一张表，只有分批时才复用
+    right_table_built_ = !build_left && keep_right_table_;
+  }
+
+  // 在左侧建表时按右侧的顺序探测，匹配的行对要按左侧、右侧的下标重新排序
+  std::vector<std::pair<int, int>> matches;
+  for (int j = 0; j < (int)probe_tuples.size(); j++) {
+    const Tuple &probe = probe_tuples[j];
+    if (key_has_null(probe, probe_keys)) {
+      continue;
+    }
+    auto iter = hash_table.find(probe.to_hash(probe_keys));
+    if (iter == hash_table.end()) {
+      continue;
+    }
+    for (int i : iter->second) {
+      const Tuple &left = build_left ? build_tuples[i] : probe;
+      const Tuple &right = build_left ? probe : build_tuples[i];
+      if (!match(left, right)) {
+        continue;
+      }
+      if (build_left) {
+        matches.emplace_back(i, j);
+      } else {
+        emit(left, right, tuple_set);
+      }
+    }
+  }
+
+  if (build_left) {
+    std::sort(matches.begin(), matches.end());
+    for (const std::pair<int, int> &item : matches) {
+      emit(left_tuples[item.first], right_tuples[item.second], tuple_set);
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC SortMergeJoinExeNode::init(const TupleSet &left, const TupleSet &right, const Selects &selects) {
+  RC rc = JoinExeNode::init(left, right, selects);
+  range_condition_ = {-1, -1, NO_OP};
+  right_ordered_ = -1;
+  right_rows_ready_ = false;
+  right_rows_.clear();
+  if (rc != RC::SUCCESS || has_join_key()) {
+    return rc;
+  }
+
+  // 把一个两侧字段之间的范围条件统一成 左侧字段 comp_op 右侧字段 的形式
+  const int left_size = left.get_schema().size();
+  for (auto iter = conditions_.begin(); iter != conditions_.end(); ++iter) {
+    CompOp comp_op = iter->comp_op;
+    if ((comp_op != LESS_THAN && comp_op != LESS_EQUAL && comp_op != GREAT_THAN && comp_op != GREAT_EQUAL) ||
+        schema_.field(iter->left_index).type() != schema_.field(iter->right_index).type() ||
+        (iter->left_index < left_size) == (iter->right_index < left_size)) {
+      continue;
+    }
+    if (iter->left_index < left_size) {
+      range_condition_ = {iter->left_index, iter->right_index - left_size, comp_op};
+    } else {
+      switch (comp_op) {
+      case LESS_THAN:
+        comp_op = GREAT_THAN;
+        break;
+      case LESS_EQUAL:
+        comp_op = GREAT_EQUAL;
+        break;
+      case GREAT_THAN:
+        comp_op = LESS_THAN;
+        break;
+      default:
+        comp_op = LESS_EQUAL;
+        break;
+      }
+      range_condition_ = {iter->right_index, iter->left_index - left_size, comp_op};
+    }
+    conditions_.erase(iter);
+    break;
+  }
+  return RC::SUCCESS;
+}
+
+int SortMergeJoinExeNode::compare_keys(const Tuple &left, const std::vector<int> &left_keys, const Tuple &right,
+                                       const std::vector<int> &right_keys) const {
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    int result = left.get(left_keys[i]).compare(right.get(right_keys[i]));
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
+
+std::vector<int> SortMergeJoinExeNode::ordered_rows(const std::vector<Tuple> &tuples, const std::vector<int> &keys,
+                                                    bool &sorted) const {
+  std::vector<int> rows;
+  rows.reserve(tuples.size());
+  sorted = true;
+  for (int i = 0; i < (int)tuples.size(); i++) {
+    if (key_has_null(tuples[i], keys)) {
+      continue;
+    }
+    if (sorted && !rows.empty() && compare_keys(tuples[rows.back()], keys, tuples[i], keys) > 0) {
+      sorted = false;
+    }
+    rows.push_back(i);
+  }
+  if (!sorted) {
+    std::stable_sort(rows.begin(), rows.end(), [&](int left, int right) {
+      return compare_keys(tuples[left], keys, tuples[right], keys) < 0;
+    });
+  }
+  return rows;
+}
+
+bool SortMergeJoinExeNode::is_ordered(const std::vector<Tuple> &tuples, const std::vector<int> &keys) const {
+  const Tuple *last = nullptr;
+  for (const Tuple &tuple : tuples) {
+    if (key_has_null(tuple, keys)) {
+      continue;
+    }
+    if (last != nullptr && compare_keys(*last, keys, tuple, keys) > 0) {
+      return false;
+    }
+    last = &tuple;
+  }
+  return true;
+}
+
+bool SortMergeJoinExeNode::inputs_ordered() {
+  if (!has_join_key()) {
+    return false;
+  }
+  if (right_ordered_ < 0) {
+    right_ordered_ = is_ordered(right_->tuples(), right_keys_) ? 1 : 0;
+  }
+  return right_ordered_ == 1 && is_ordered(left_->tuples(), left_keys_);
+}
+
+const std::vector<int> &SortMergeJoinExeNode::right_rows(const std::vector<int> &keys, bool &sorted) {
+  if (!right_rows_ready_) {
+    right_rows_ = ordered_rows(right_->tuples(), keys, right_sorted_);
+    right_rows_ready_ = true;
+  }
+  sorted = right_sorted_;
+  return right_rows_;
+}
+
+RC SortMergeJoinExeNode::execute(TupleSet &tuple_set) {
+  tuple_set.clear();
+  tuple_set.set_schema(schema_);
+  if (has_join_key()) {
+    merge_join(tuple_set);
+  } else if (has_range_key()) {
+    range_join(tuple_set);
+  } else {
+    for (const Tuple &left : left_->tuples()) {
+      for (const Tuple &right : right_->tuples()) {
+        if (match_conditions(left, right)) {
+          emit(left, right, tuple_set);
+        }
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void SortMergeJoinExeNode::merge_join(TupleSet &tuple_set) {
+  const std::vector<Tuple> &left_tuples = left_->tuples();
+  const std::vector<Tuple> &right_tuples = right_->tuples();
+  bool left_sorted = false;
+  bool right_sorted = false;
+  std::vector<int> left_rows = ordered_rows(left_tuples, left_keys_, left_sorted);
+  const std::vector<int> &right_rows = this->right_rows(right_keys_, right_sorted);
+
+  // 稳定排序保证键相同的行保持原来的顺序，左侧本来有序时归并的输出顺序就是嵌套循环的顺序
+  std::vector<std::pair<int, int>> matches;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < left_rows.size() && j < right_rows.size()) {
+    const Tuple &left = left_tuples[left_rows[i]];
+    const Tuple &right = right_tuples[right_rows[j]];
+    int result = compare_keys(left, left_keys_, right, right_keys_);
+    if (result < 0) {
+      i++;
+      continue;
+    }
+    if (result > 0) {
+      j++;
+      continue;
+    }
+
+    size_t left_end = i + 1;
+    while (left_end < left_rows.size() &&
+           compare_keys(left_tuples[left_rows[left_end]], left_keys_, left, left_keys_) == 0) {
+      left_end++;
+    }
+    size_t right_end = j + 1;
+    while (right_end < right_rows.size() &&
+           compare_keys(right_tuples[right_rows[right_end]], right_keys_, right, right_keys_) == 0) {
+      right_end++;
+    }
+    for (size_t left_pos = i; left_pos < left_end; left_pos++) {
+      for (size_t right_pos = j; right_pos < right_end; right_pos++) {
+        if (match_conditions(left_tuples[left_rows[left_pos]], right_tuples[right_rows[right_pos]])) {
+          matches.emplace_back(left_rows[left_pos], right_rows[right_pos]);
+        }
+      }
+    }
+    i = left_end;
+    j = right_end;
+  }
+
+  if (!left_sorted) {
+    std::sort(matches.begin(), matches.end());
+  }
+  for (const std::pair<int, int> &item : matches) {
+    emit(left_tuples[item.first], right_tuples[item.second], tuple_set);
+  }
+}
+
+void SortMergeJoinExeNode::range_join(TupleSet &tuple_set) {
+  const std::vector<Tuple> &left_tuples = left_->tuples();
+  const std::vector<Tuple> &right_tuples = right_->tuples();
+  const int left_key = range_condition_.left_index;
+  const int right_key = range_condition_.right_index;
+  bool right_sorted = false;
+  const std::vector<int> &right_rows = this->right_rows(std::vector<int>{right_key}, right_sorted);
+
+  // 右侧按字段升序，满足 左侧值 < 右侧值 的是一段后缀，满足 左侧值 > 右侧值 的是一段前缀
+  auto value_less = [&](int row, const TupleValue *value) {
+    return right_tuples[row].get(right_key).compare(*value) < 0;
+  };
+  auto less_value = [&](const TupleValue *value, int row) {
+    return value->compare(right_tuples[row].get(right_key)) < 0;
+  };
+
+  std::vector<int> matches;
+  for (const Tuple &left : left_tuples) {
+    const TupleValue *value = left.get_pointer(left_key).get();
+    if (value->is_null()) {
+      continue;
+    }
+    auto begin = right_rows.begin();
+    auto end = right_rows.end();
+    switch (range_condition_.comp_op) {
+    case LESS_THAN:
+      begin = std::upper_bound(right_rows.begin(), right_rows.end(), value, less_value);
+      break;
+    case LESS_EQUAL:
+      begin = std::lower_bound(right_rows.begin(), right_rows.end(), value, value_less);
+      break;
+    case GREAT_THAN:
+      end = std::lower_bound(right_rows.begin(), right_rows.end(), value, value_less);
+      break;
+    default:
+      end = std::upper_bound(right_rows.begin(), right_rows.end(), value, less_value);
+      break;
+    }
+
+    matches.assign(begin, end);
+    if (!right_sorted) {
+      std::sort(matches.begin(), matches.end());
+    }
+    for (int row : matches) {
+      if (match_conditions(left, right_tuples[row])) {
+        emit(left, right_tuples[row], tuple_set);
+      }
+    }
+  }
+}
+
+RC IndexNestedLoopJoinExeNode::init(const TupleSet &left, SelectExeNode &inner, const Selects &selects) {
+  inner_ = &inner;
+  inner_schema_set_.clear();
+  inner_schema_set_.set_schema(inner.schema());
+  RC rc = JoinExeNode::init(left, inner_schema_set_, selects);
+  lookup_key_ = -1;
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  const TableMeta &table_meta = inner.table()->table_meta();
+  for (size_t i = 0; i < right_keys_.size(); i++) {
+    const TupleField &field = inner.schema().field(right_keys_[i]);
+    const FieldMeta *field_meta = table_meta.field(field.field_name());
+    if (nullptr == field_meta || (field_meta->type() != INTS && field_meta->type() != CHARS) ||
+        nullptr == table_meta.find_single_index_by_field(field_meta->name())) {
+      continue;
+    }
+
+    key_type_ = field_meta->type();
+    key_len_ = field_meta->len();
+    key_field_ = field_meta->name();
+    lookup_key_ = i;
+    std::unordered_map<std::string, int> keys;
+    std::string key;
+    for (const Tuple &tuple : left.tuples()) {
+      if (!tuple.get(left_keys_[i]).is_null() && make_key(tuple.get(left_keys_[i]), key)) {
+        keys.emplace(key, 0);
+      }
+    }
+    if (inner.table()->is_key_lookup_cheaper(key_field_.c_str(), keys.size())) {
+      return RC::SUCCESS;
+    }
+  }
+  lookup_key_ = -1;
+  return RC::SUCCESS;
+}
+
+bool IndexNestedLoopJoinExeNode::make_key(const TupleValue &value, std::string &key) const {
+  if (key_type_ == INTS) {
+    const IntValue *int_value = dynamic_cast<const IntValue *>(&value);
+    if (nullptr == int_value) {
+      return false;
+    }
+    int data = int_value->get_value();
+    key.assign((const char *)&data, sizeof(data));
+    return true;
+  }
+  const StringValue *string_value = dynamic_cast<const StringValue *>(&value);
+  if (nullptr == string_value) {
+    return false;
+  }
+  key.assign(key_len_, '\0');
+  strncpy(&key[0], string_value->get_value(), key_len_);
+  return true;
+}
+
+RC IndexNestedLoopJoinExeNode::execute(TupleSet &tuple_set) {
+  tuple_set.clear();
+  tuple_set.set_schema(schema_);
+  if (!can_lookup()) {
+    return RC::GENERIC_ERROR;
+  }
+
+  // 每个不同的连接键只查找一次，查到的内表元组按键缓存
+  const std::vector<Tuple> &left_tuples = left_->tuples();
+  const int key_index = left_keys_[lookup_key_];
+  std::unordered_map<std::string, TupleSet> inner_tuples;
+  std::vector<TupleSet *> matches(left_tuples.size(), nullptr);
+  std::string key;
+  for (size_t i = 0; i < left_tuples.size(); i++) {
+    const TupleValue &value = left_tuples[i].get(key_index);
+    if (value.is_null() || !make_key(value, key)) {
+      continue;
+    }
+    auto iter = inner_tuples.find(key);
+    if (iter == inner_tuples.end()) {
+      iter = inner_tuples.emplace(key, TupleSet(inner_->schema())).first;
+      RC rc = inner_->execute_by_key(key_field_.c_str(), key.data(), iter->second);
+      if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to lookup inner table. rc=%d:%s", rc, strrc(rc));
+        return rc;
+      }
+    }
+    matches[i] = &iter->second;
+  }
+  LOG_INFO("索引嵌套循环连接查找了%d个不同的键", (int)inner_tuples.size());
+
+  for (size_t i = 0; i < left_tuples.size(); i++) {
+    if (nullptr == matches[i]) {
+      continue;
+    }
+    for (const Tuple &right : matches[i]->tuples()) {
+      if (match(left_tuples[i], right)) {
+        emit(left_tuples[i], right, tuple_set);
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC StreamJoinExeNode::init(ExecutionNode *left, SelectExeNode *inner, bool lookup_inner, const Selects *selects) {
+  left_ = left;
+  inner_ = inner;
+  lookup_inner_ = lookup_inner;
+  selects_ = selects;
+  schema_.clear();
+  schema_.append(left->schema());
+  schema_.append(inner->schema());
+  return RC::SUCCESS;
+}
+
+RC StreamJoinExeNode::execute(TupleSet &tuple_set) {
+  return pull_all(*this, tuple_set);
+}
+
+RC StreamJoinExeNode::open() {
+  left_batch_.clear();
+  left_batch_.set_schema(left_->schema());
+  inner_set_.clear();
+  inner_set_.set_schema(inner_->schema());
+  inner_loaded_ = false;
+  left_eof_ = false;
+  join_inited_ = false;
+  output_.clear();
+  output_pos_ = 0;
+  return left_->open();
+}
+
+RC StreamJoinExeNode::next(Tuple &tuple) {
+  while (output_pos_ >= output_.size()) {
+    if (left_eof_) {
+      return RC::RECORD_EOF;
+    }
+    RC rc = join_next_batch();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  tuple = Tuple(output_.get(output_pos_++));
+  return RC::SUCCESS;
+}
+
+void StreamJoinExeNode::close() {
+  left_->close();
+  left_batch_.clear();
+  inner_set_.clear();
+  output_.clear();
+  output_pos_ = 0;
+}
+
+RC StreamJoinExeNode::join_next_batch() {
+  left_batch_.clear_tuples();
+  output_pos_ = 0;
+  RC rc = RC::SUCCESS;
+  Tuple tuple;
+  while (left_batch_.size() < STREAM_JOIN_BATCH_SIZE && (rc = left_->next(tuple)) == RC::SUCCESS) {
+    left_batch_.add(std::move(tuple));
+  }
+  if (rc == RC::RECORD_EOF) {
+    left_eof_ = true;
+  } else if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to fetch tuples from left side of join. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  // 还没有扫描右表时，先看这一批能不能在右表的索引上逐键查找
+  if (lookup_inner_ && !inner_loaded_) {
+    rc = index_node_.init(left_batch_, *inner_, *selects_);
+    if (rc == RC::SUCCESS && index_node_.can_lookup()) {
+      rc = index_node_.execute(output_);
+      LOG_INFO("%s output %d tuples", index_node_.name(), output_.size());
+      return rc;
+    }
+  }
+  if (!inner_loaded_) {
+    rc = inner_->execute(inner_set_);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to prepare inner table of join. rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+    inner_loaded_ = true;
+  }
+  if (!join_inited_) {
+    rc = merge_node_.init(left_batch_, inner_set_, *selects_);
+    if (rc == RC::SUCCESS) {
+      rc = hash_node_.init(left_batch_, inner_set_, *selects_);
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    join_inited_ = true;
+  }
+
+  // 两侧都已经按连接键有序，或者只有范围条件时归并，其它情况用哈希连接。后面还有批次时哈希表建在右侧
+  JoinExeNode *join_node = &merge_node_;
+  if (!(merge_node_.has_join_key() ? merge_node_.inputs_ordered() : merge_node_.has_range_key())) {
+    join_node = &hash_node_;
+    if (!left_eof_) {
+      hash_node_.keep_right_table();
+    }
+  }
+  rc = join_node->execute(output_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to join tuple sets. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+  LOG_INFO("%s output %d tuples", join_node->name(), output_.size());
+  return RC::SUCCESS;
+}
+
+RC TupleSetScanExeNode::execute(TupleSet &tuple_set) {
+  return pull_all(*this, tuple_set);
+}
+
+RC TupleSetScanExeNode::open() {
+  pos_ = 0;
+  return RC::SUCCESS;
+}
+
+RC TupleSetScanExeNode::next(Tuple &tuple) {
+  if (pos_ >= tuple_set_->size()) {
+    return RC::RECORD_EOF;
+  }
+  tuple = Tuple(tuple_set_->get(pos_++));
+  return RC::SUCCESS;
+}
+
+void TupleSetScanExeNode::close() {
+  pos_ = 0;
+}
+
+RC AggregateExeNode::init(ExecutionNode *child, const std::vector<int> &group_index,
+                          const std::vector<AggregateSpec> &specs) {
+  child_ = child;
+  group_index_ = group_index;
+  specs_ = specs;
+  return RC::SUCCESS;
+}
+
+RC AggregateExeNode::execute(TupleSet &tuple_set) {
+  return pull_all(*this, tuple_set);
+}
+
+RC AggregateExeNode::open() {
+  output_.clear();
+  output_pos_ = 0;
+  RC rc = child_->open();
+  HashAggregator aggregator;
+  if (rc == RC::SUCCESS) {
+    rc = aggregator.init(child_->schema(), group_index_, specs_);
+  }
+  Tuple tuple;
+  while (rc == RC::SUCCESS && (rc = child_->next(tuple)) == RC::SUCCESS) {
+    rc = aggregator.add(tuple);
+  }
+  child_->close();
+  if (rc != RC::RECORD_EOF) {
+    LOG_ERROR("Failed to aggregate tuples. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+  return aggregator.finish(output_);
+}
+
+RC AggregateExeNode::next(Tuple &tuple) {
+  if (output_pos_ >= output_.size()) {
+    return RC::RECORD_EOF;
+  }
+  tuple = Tuple(output_.get(output_pos_++));
+  return RC::SUCCESS;
+}
+
+void AggregateExeNode::close() {
+  output_.clear();
+  output_pos_ = 0;
+}
+
+RC ProjectExeNode::init(ExecutionNode *child, const TupleSchema &schema, const std::vector<int> &indexes) {
+  child_ = child;
+  schema_ = schema;
+  indexes_ = indexes;
+  for (int index : indexes_) {
+    if (index < 0 || index >= child_->schema().size()) {
+      LOG_ERROR("Invalid column index of projection. index=%d", index);
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC ProjectExeNode::execute(TupleSet &tuple_set) {
+  return pull_all(*this, tuple_set);
+}
+
+RC ProjectExeNode::open() {
+  return child_->open();
+}
+
+RC ProjectExeNode::next(Tuple &tuple) {
+  Tuple input;
+  RC rc = child_->next(input);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  tuple = Tuple();
+  for (int index : indexes_) {
+    tuple.add(input.get_pointer(index));
+  }
+  return RC::SUCCESS;
+}
+
+void ProjectExeNode::close() {
+  child_->close();
+}
+
+RC SortExeNode::init(ExecutionNode *child, const std::vector<SortKey> &keys, int top_n) {
+  child_ = child;
+  keys_ = keys;
+  top_n_ = top_n;
+  return RC::SUCCESS;
+}
+
+RC SortExeNode::execute(TupleSet &tuple_set) {
+  return pull_all(*this, tuple_set);
+}
+
+RC SortExeNode::open() {
+  output_.clear();
+  output_pos_ = 0;
+  RC rc = child_->open();
+  ExternalSorter sorter;
+  sorter.init(keys_, ORDER_BY_MEMORY_BUDGET, top_n_);
+  Tuple tuple;
+  while (rc == RC::SUCCESS && (rc = child_->next(tuple)) == RC::SUCCESS) {
+    rc = sorter.add(std::move(tuple));
+  }
+  child_->close();
+  if (rc != RC::RECORD_EOF) {
+    LOG_ERROR("Failed to sort tuples. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+  TupleSet sorted;
+  rc = sorter.finish(sorted);
+  output_ = sorted.release_tuples();
+  return rc;
+}
+
+RC SortExeNode::next(Tuple &tuple) {
+  if (output_pos_ >= (int)output_.size()) {
+    return RC::RECORD_EOF;
+  }
+  tuple = std::move(output_[output_pos_++]);
+  return RC::SUCCESS;
+}
+
+void SortExeNode::close() {
+  output_.clear();
+  output_pos_ = 0;
+}
+
+RC LimitExeNode::init(ExecutionNode *child, int offset, int limit) {
+  child_ = child;
+  offset_ = offset;
+  limit_ = limit;
+  return RC::SUCCESS;
+}
+
+RC LimitExeNode::execute(TupleSet &tuple_set) {
+  return pull_all(*this, tuple_set);
+}
+
+RC LimitExeNode::open() {
+  skipped_ = 0;
+  output_num_ = 0;
+  return child_->open();
+}
+
+RC LimitExeNode::next(Tuple &tuple) {
+  if (limit_ >= 0 && output_num_ >= limit_) {
+    return RC::RECORD_EOF;
+  }
+  RC rc = RC::SUCCESS;
+  for (; skipped_ < offset_; skipped_++) {
+    rc = child_->next(tuple);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  rc = child_->next(tuple);
+  if (rc == RC::SUCCESS) {
+    output_num_++;
+  }
+  return rc;
+}
+
+void LimitExeNode::close() {
+  child_->close();
+}
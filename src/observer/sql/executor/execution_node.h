@@ -15,20 +15,40 @@ See the Mulan PSL v2 for more details. */
 #ifndef __OBSERVER_SQL_EXECUTOR_EXECUTION_NODE_H_
 #define __OBSERVER_SQL_EXECUTOR_EXECUTION_NODE_H_
 
+#include <functional>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include "storage/common/condition_filter.h"
+#include "storage/common/table.h"
+#include "sql/executor/external_sorter.h"
+#include "sql/executor/hash_aggregator.h"
 #include "sql/executor/tuple.h"
 
-class Table;
 class Trx;
 
+/**
+ * 执行节点既可以用execute一次输出全部结果，也可以按照迭代器模型使用：open之后反复调用next逐个取出元组，最后close。
+ * 默认的open先调用execute把结果物化，next再逐个输出，能边读边输出的节点重写这三个函数。
+ * 查询由扫描、连接、聚合、投影、排序和limit节点组成一棵树，上层节点通过next从子节点拉取元组。
+ * 子查询和表达式仍然在物化的TupleSet上计算，之后用TupleSetScanExeNode接回后面的节点
+ */
 class ExecutionNode {
 public:
   ExecutionNode() = default;
   virtual ~ExecutionNode() = default;
 
   virtual RC execute(TupleSet &tuple_set) = 0;
+  virtual const TupleSchema &schema() const = 0;
+
+  virtual RC open();
+  // 没有更多元组时返回RC::RECORD_EOF
+  virtual RC next(Tuple &tuple);
+  virtual void close();
+
+private:
+  TupleSet buffered_;
+  int buffered_pos_ = 0;
 };
 
 class SelectExeNode : public ExecutionNode {
@@ -40,11 +60,360 @@ public:
 
   RC execute(TupleSet &tuple_set) override;
 
+  // 逐条扫描表，读到一条满足条件的记录就输出，沿索引顺序输出时仍然先物化
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  void close() override;
+
+  // 沿着索引index_name的顺序输出记录，结果已经有序，不需要再排序
+  void set_index_order(const char *index_name, bool is_desc);
+  // execute最多输出limit条记录，读够之后不再读取后面的页面。小于0表示不限制
+  void set_limit(int limit) {
+    limit_ = limit;
+  }
+
+  // 存储层不能判断的过滤条件(比如只涉及这张表的表达式)，在扫描出的元组上逐批检查，删除不满足条件的元组
+  using BatchFilter = std::function<RC(TupleSet &tuple_set)>;
+  void add_batch_filter(BatchFilter filter) {
+    batch_filters_.push_back(std::move(filter));
+  }
+
+  // 只读取field_name等于value的记录，追加到tuple_set中，value是字段在记录中的格式。用于索引嵌套循环连接
+  RC execute_by_key(const char *field_name, const char *value, TupleSet &tuple_set);
+
+  Table *table() const {
+    return table_;
+  }
+  const TupleSchema &schema() const override {
+    return tuple_schema_;
+  }
+  const std::vector<DefaultConditionFilter *> &condition_filters() const {
+    return condition_filters_;
+  }
+
+private:
+  void prepare_scan(CompositeConditionFilter &condition_filter, std::vector<const char *> &field_names) const;
+  RC filter_batch(TupleSet &tuple_set) const;
+  RC next_filtered(Tuple &tuple);
+
 private:
   Trx *trx_ = nullptr;
   Table  * table_;
   TupleSchema  tuple_schema_;
   std::vector<DefaultConditionFilter *> condition_filters_;
+  std::string order_index_name_;
+  bool is_desc_ = false;
+  int limit_ = -1;
+  std::vector<BatchFilter> batch_filters_;
+
+  // open/next使用的扫描状态
+  CompositeConditionFilter scan_filter_;
+  std::vector<const char *> scan_fields_;
+  TableScanner scanner_;
+  bool streaming_ = false;
+  TupleSet filtered_;           // 有batch_filters_时，next从这一批通过过滤的元组中输出
+  int filtered_pos_ = 0;
+  bool scan_eof_ = false;
+};
+
+bool valueCompare(const TupleValue *value_a, const TupleValue *value_b, CompOp op);
+
+/**
+ * 两个已经物化的TupleSet之间的连接，输出的列是左侧的列后接右侧的列，行的顺序和左侧在外层的嵌套循环相同。
+ * 条件中的字段在init时解析成列下标：两侧字段之间类型相同的等值条件作为连接键，其它作用在两侧字段上的条件在拼接前逐行检查。
+ * 多表连接时把上一次的结果作为下一次的左侧
+ */
+class JoinExeNode : public ExecutionNode {
+public:
+  JoinExeNode() = default;
+  virtual ~JoinExeNode() = default;
+
+  virtual RC init(const TupleSet &left, const TupleSet &right, const Selects &selects);
+  virtual const char *name() const = 0;
+
+  const TupleSchema &schema() const override {
+    return schema_;
+  }
+  bool has_join_key() const {
+    return !left_keys_.empty();
+  }
+
+protected:
+  // 下标是连接后的列下标，小于左侧列数的在左侧元组中
+  struct JoinCondition {
+    int left_index;
+    int right_index;
+    CompOp comp_op;
+  };
+
+  const TupleValue *value_of(const Tuple &left, const Tuple &right, int index) const;
+  bool key_has_null(const Tuple &tuple, const std::vector<int> &keys) const;
+  // 只检查连接键以外的条件
+  bool match_conditions(const Tuple &left, const Tuple &right) const;
+  bool match(const Tuple &left, const Tuple &right) const;
+  void emit(const Tuple &left, const Tuple &right, TupleSet &tuple_set) const;
+
+protected:
+  const TupleSet *left_ = nullptr;
+  const TupleSet *right_ = nullptr;
+  TupleSchema schema_;
+  std::vector<int> left_keys_;    // 连接键在左侧元组中的下标
+  std::vector<int> right_keys_;   // 对应的连接键在右侧元组中的下标
+  std::vector<JoinCondition> conditions_;
+};
+
+/**
+ * 在行数较少的一侧建哈希表，用另一侧探测。没有连接键时退化为嵌套循环。
+ * 左侧分批输入时调用keep_right_table，总是在右侧建表，哈希表在各批之间复用
+ */
+class HashJoinExeNode : public JoinExeNode {
+public:
+  RC init(const TupleSet &left, const TupleSet &right, const Selects &selects) override;
+  RC execute(TupleSet &tuple_set) override;
+
+  const char *name() const override {
+    return has_join_key() ? "Hash join" : "Nested loop join";
+  }
+  void keep_right_table() {
+    keep_right_table_ = true;
+  }
+
+private:
+  bool keep_right_table_ = false;
+  bool right_table_built_ = false;
+  std::unordered_map<size_t, std::vector<int>> right_table_;
+};
+
+/**
+ * 两侧按照连接键排序后归并。已经有序的输入(例如沿着索引顺序扫描的表)不再排序，排序时只对行号排序，不移动元组。
+ * 没有等值连接键时，用一个两侧字段之间的 < <= > >= 条件做范围连接：右侧按字段排序后二分查找每个左侧行的匹配范围。
+ * 左侧按连接键有序时，输出也按连接键有序。
+ * 两侧都是已经物化的TupleSet，排序在内存中进行，不会把有序段溢出到磁盘
+ */
+class SortMergeJoinExeNode : public JoinExeNode {
+public:
+  RC init(const TupleSet &left, const TupleSet &right, const Selects &selects) override;
+  RC execute(TupleSet &tuple_set) override;
+
+  const char *name() const override {
+    return has_join_key() ? "Sort merge join" : "Sort merge range join";
+  }
+
+  bool has_range_key() const {
+    return range_condition_.comp_op != NO_OP;
+  }
+  // 两侧都已经按照连接键有序时，归并比建哈希表划算
+  bool inputs_ordered();
+
+private:
+  int compare_keys(const Tuple &left, const std::vector<int> &left_keys, const Tuple &right,
+                   const std::vector<int> &right_keys) const;
+  bool is_ordered(const std::vector<Tuple> &tuples, const std::vector<int> &keys) const;
+  // 连接键不为NULL的行号，按连接键稳定排序，sorted返回输入本来是否有序
+  std::vector<int> ordered_rows(const std::vector<Tuple> &tuples, const std::vector<int> &keys, bool &sorted) const;
+  // 右侧排好序的行号只计算一次，左侧分批输入时各批共用
+  const std::vector<int> &right_rows(const std::vector<int> &keys, bool &sorted);
+  void merge_join(TupleSet &tuple_set);
+  void range_join(TupleSet &tuple_set);
+
+private:
+  JoinCondition range_condition_{-1, -1, NO_OP};  // left_index在左侧，right_index已经减去左侧列数
+  int right_ordered_ = -1;                         // 右侧是否按连接键有序，-1表示还没有检查
+  bool right_rows_ready_ = false;
+  bool right_sorted_ = false;
+  std::vector<int> right_rows_;
+};
+
+/**
+ * 右侧是还没有执行的select节点，它的表在某个连接键上有索引。
+ * 先收集左侧所有不同的连接键，每个键在索引上查找一次匹配的记录，再按左侧的顺序拼接，右侧不用全表扫描
+ */
+class IndexNestedLoopJoinExeNode : public JoinExeNode {
+public:
+  // 选出内表字段上有索引、并且查找比扫描全表划算的连接键，找不到时can_lookup()为false
+  RC init(const TupleSet &left, SelectExeNode &inner, const Selects &selects);
+  RC execute(TupleSet &tuple_set) override;
+
+  const char *name() const override {
+    return "Index nested loop join";
+  }
+  bool can_lookup() const {
+    return lookup_key_ >= 0;
+  }
+
+private:
+  // 连接键在内表记录中的格式，目前支持整数和定长字符串
+  bool make_key(const TupleValue &value, std::string &key) const;
+
+private:
+  SelectExeNode *inner_ = nullptr;
+  TupleSet inner_schema_set_;   // 只有内表的schema，用来解析条件
+  int lookup_key_ = -1;          // 用来查找的连接键在left_keys_中的下标
+  AttrType key_type_ = UNDEFINED;
+  int key_len_ = 0;
+  std::string key_field_;
+};
+
+/**
+ * 迭代器模型的连接：左侧是一个子节点，每次取出一批元组，和右侧的表连接后逐个输出，左侧不需要整体物化。
+ * lookup_inner为true时，每批先尝试在右表的索引上逐键查找，不划算时才扫描右表，扫描的结果在各批之间复用。
+ * 每批按照和整体连接相同的规则选择归并或者哈希连接，输出顺序也和整体连接相同
+ */
+class StreamJoinExeNode : public ExecutionNode {
+public:
+  RC init(ExecutionNode *left, SelectExeNode *inner, bool lookup_inner, const Selects *selects);
+
+  RC execute(TupleSet &tuple_set) override;
+  const TupleSchema &schema() const override {
+    return schema_;
+  }
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  void close() override;
+
+private:
+  RC join_next_batch();
+
+private:
+  ExecutionNode *left_ = nullptr;
+  SelectExeNode *inner_ = nullptr;
+  bool lookup_inner_ = false;
+  const Selects *selects_ = nullptr;
+  TupleSchema schema_;
+
+  TupleSet left_batch_;
+  TupleSet inner_set_;
+  bool inner_loaded_ = false;
+  bool left_eof_ = false;
+  bool join_inited_ = false;
+  SortMergeJoinExeNode merge_node_;
+  HashJoinExeNode hash_node_;
+  IndexNestedLoopJoinExeNode index_node_;
+  TupleSet output_;
+  int output_pos_ = 0;
+};
+
+/**
+ * 逐个输出一个已经物化的TupleSet，不复制整个集合。
+ * 子查询、表达式这些需要整体处理的步骤完成后，用它把结果重新接到后面的执行节点上
+ */
+class TupleSetScanExeNode : public ExecutionNode {
+public:
+  void init(const TupleSet *tuple_set) {
+    tuple_set_ = tuple_set;
+  }
+
+  RC execute(TupleSet &tuple_set) override;
+  const TupleSchema &schema() const override {
+    return tuple_set_->get_schema();
+  }
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  void close() override;
+
+private:
+  const TupleSet *tuple_set_ = nullptr;
+  int pos_ = 0;
+};
+
+/**
+ * 哈希聚合：open时从子节点逐个拉取元组，交给HashAggregator更新所在分组，输入的元组不保存。
+ * 分组的结果在open中物化，next逐个输出。没有分组列时整个输入是一组，输入为空也输出一行。
+ * 输出的列和类型由第一个分组决定，open之后schema才有意义
+ */
+class AggregateExeNode : public ExecutionNode {
+public:
+  RC init(ExecutionNode *child, const std::vector<int> &group_index, const std::vector<AggregateSpec> &specs);
+
+  RC execute(TupleSet &tuple_set) override;
+  const TupleSchema &schema() const override {
+    return output_.get_schema();
+  }
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  void close() override;
+
+private:
+  ExecutionNode *child_ = nullptr;
+  std::vector<int> group_index_;
+  std::vector<AggregateSpec> specs_;
+  TupleSet output_;
+  int output_pos_ = 0;
+};
+
+/**
+ * 投影：输出的第i列是子节点元组中的第indexes[i]列，每拉取一个元组输出一个，不物化
+ */
+class ProjectExeNode : public ExecutionNode {
+public:
+  RC init(ExecutionNode *child, const TupleSchema &schema, const std::vector<int> &indexes);
+
+  RC execute(TupleSet &tuple_set) override;
+  const TupleSchema &schema() const override {
+    return schema_;
+  }
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  void close() override;
+
+private:
+  ExecutionNode *child_ = nullptr;
+  TupleSchema schema_;
+  std::vector<int> indexes_;
+};
+
+/**
+ * 排序：open时把子节点的元组全部交给ExternalSorter，超过内存预算的部分写入临时文件，
+ * 排好序的结果物化后由next逐个输出。top_n不小于0时只保留前top_n行
+ */
+class SortExeNode : public ExecutionNode {
+public:
+  RC init(ExecutionNode *child, const std::vector<SortKey> &keys, int top_n);
+
+  RC execute(TupleSet &tuple_set) override;
+  const TupleSchema &schema() const override {
+    return child_->schema();
+  }
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  void close() override;
+
+private:
+  ExecutionNode *child_ = nullptr;
+  std::vector<SortKey> keys_;
+  int top_n_ = -1;
+  std::vector<Tuple> output_;
+  int output_pos_ = 0;
+};
+
+/**
+ * 跳过子节点的前offset个元组，最多输出limit个。输出够limit个之后不再从子节点拉取，
+ * 下层的扫描和连接随之停止
+ */
+class LimitExeNode : public ExecutionNode {
+public:
+  RC init(ExecutionNode *child, int offset, int limit);
+
+  RC execute(TupleSet &tuple_set) override;
+  const TupleSchema &schema() const override {
+    return child_->schema();
+  }
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  void close() override;
+
+private:
+  ExecutionNode *child_ = nullptr;
+  int offset_ = 0;
+  int limit_ = -1;
+  int skipped_ = 0;
+  int output_num_ = 0;
 };
 
 #endif //__OBSERVER_SQL_EXECUTOR_EXECUTION_NODE_H_
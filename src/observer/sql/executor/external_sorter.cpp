@@ -0,0 +1,245 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <queue>
+
+#include "sql/executor/external_sorter.h"
+#include "common/log/log.h"
+
+static int compare_key(const std::string &left, const std::string &right) {
+  size_t len = std::min(left.size(), right.size());
+  int result = memcmp(left.data(), right.data(), len);
+  if (result != 0) {
+    return result;
+  }
+  return left.size() < right.size() ? -1 : (left.size() > right.size() ? 1 : 0);
+}
+
+static void append_uint32(std::string &key, uint32_t value) {
+  key.push_back((char)(value >> 24));
+  key.push_back((char)(value >> 16));
+  key.push_back((char)(value >> 8));
+  key.push_back((char)value);
+}
+
+// 元组在内存中大约占用的空间，只用来判断是否超过预算
+static size_t tuple_memory_size(const Tuple &tuple) {
+  size_t size = tuple.size() * (sizeof(std::shared_ptr<TupleValue>) + sizeof(StringValue));
+  for (const std::shared_ptr<TupleValue> &value : tuple.values()) {
+    const StringValue *string_value = dynamic_cast<const StringValue *>(value.get());
+    if (string_value != nullptr) {
+      size += strlen(string_value->get_value());
+    }
+  }
+  return size;
+}
+
+ExternalSorter::~ExternalSorter() {
+  for (FILE *file : runs_) {
+    fclose(file);
+  }
+}
+
+void ExternalSorter::init(const std::vector<SortKey> &keys, size_t memory_budget, int top_n) {
+  keys_ = keys;
+  memory_budget_ = memory_budget;
+  top_n_ = top_n;
+}
+
+bool ExternalSorter::entry_less(const Entry &left, const Entry &right) {
+  int result = compare_key(left.key, right.key);
+  return result != 0 ? result < 0 : left.seq < right.seq;
+}
+
+void ExternalSorter::encode_key(const Tuple &tuple, std::string &key) const {
+  key.clear();
+  for (const SortKey &sort_key : keys_) {
+    size_t start = key.size();
+    const TupleValue *value = tuple.get_pointer(sort_key.index).get();
+    const IntValue *int_value = dynamic_cast<const IntValue *>(value);
+    const FloatValue *float_value = dynamic_cast<const FloatValue *>(value);
+    if (value->is_null()) {
+      key.push_back(0);
+    } else if (int_value != nullptr) {
+      key.push_back(1);
+      // 翻转符号位后，有符号整数的大小顺序和无符号的字节顺序一致
+      append_uint32(key, (uint32_t)int_value->get_value() ^ 0x80000000u);
+    } else if (float_value != nullptr) {
+      key.push_back(1);
+      float data = float_value->get_value();
+      if (data == 0) {
+        data = 0;   // -0.0和0.0相等
+      }
+      uint32_t bits;
+      memcpy(&bits, &data, sizeof(bits));
+      // 正数翻转符号位，负数按位取反
+      bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+      append_uint32(key, bits);
+    } else {
+      key.push_back(1);
+      // 和StringValue::compare一样按strcmp的顺序比较
+      key.append(static_cast<const StringValue *>(value)->get_value());
+      key.push_back(0);
+    }
+
+    if (sort_key.is_desc) {
+      for (size_t i = start; i < key.size(); i++) {
+        key[i] = ~key[i];
+      }
+    }
+  }
+}
+
+RC ExternalSorter::add(Tuple &&tuple) {
+  if (0 == top_n_) {
+    return RC::SUCCESS;
+  }
+  Entry entry;
+  encode_key(tuple, entry.key);
+  entry.seq = seq_++;
+  entry.memory = sizeof(Entry) + entry.key.size() + tuple_memory_size(tuple);
+  entry.tuple = std::move(tuple);
+
+  // 写过临时文件后不再维护堆，只在输出时截断
+  if (top_n_ > 0 && runs_.empty()) {
+    add_top_n(std::move(entry));
+  } else {
+    memory_size_ += entry.memory;
+    entries_.push_back(std::move(entry));
+  }
+
+  if (memory_size_ > memory_budget_) {
+    return spill();
+  }
+  return RC::SUCCESS;
+}
+
+// entries_是按entry_less排列的大顶堆，堆顶是保留的行中最大的一行
+void ExternalSorter::add_top_n(Entry &&entry) {
+  if ((int)entries_.size() < top_n_) {
+    memory_size_ += entry.memory;
+    entries_.push_back(std::move(entry));
+    std::push_heap(entries_.begin(), entries_.end(), entry_less);
+    return;
+  }
+  if (!entry_less(entry, entries_.front())) {
+    return;
+  }
+  std::pop_heap(entries_.begin(), entries_.end(), entry_less);
+  memory_size_ = memory_size_ - entries_.back().memory + entry.memory;
+  entries_.back() = std::move(entry);
+  std::push_heap(entries_.begin(), entries_.end(), entry_less);
+}
+
+void ExternalSorter::sort_entries() {
+  // 键相同时按输入顺序，和稳定排序的结果相同
+  std::sort(entries_.begin(), entries_.end(), entry_less);
+}
+
+RC ExternalSorter::spill() {
+  if (runs_.empty()) {
+    LOG_INFO("order by排序的数据超过%d字节，排好序的段写入临时文件", (int)memory_budget_);
+  }
+  sort_entries();
+  FILE *file = tmpfile();
+  if (nullptr == file) {
+    LOG_ERROR("Failed to create temporary file for order by. error=%s", strerror(errno));
+    return RC::IOERR_ACCESS;
+  }
+  runs_.push_back(file);
+
+  for (const Entry &entry : entries_) {
+    int len = entry.key.size();
+    if (fwrite(&len, sizeof(len), 1, file) != 1 || (int)fwrite(entry.key.data(), 1, len, file) != len ||
+        entry.tuple.write_to(file) != RC::SUCCESS) {
+      LOG_ERROR("Failed to write temporary file for order by. error=%s", strerror(errno));
+      return RC::IOERR_WRITE;
+    }
+  }
+  entries_.clear();
+  memory_size_ = 0;
+  return RC::SUCCESS;
+}
+
+RC ExternalSorter::read_entry(FILE *file, Entry &entry) {
+  int len = 0;
+  if (fread(&len, sizeof(len), 1, file) != 1) {
+    return feof(file) ? RC::RECORD_EOF : RC::IOERR_READ;
+  }
+  if (len <= 0) {
+    return RC::IOERR_READ;
+  }
+  entry.key.resize(len);
+  if ((int)fread(&entry.key[0], 1, len, file) != len) {
+    return RC::IOERR_READ;
+  }
+  RC rc = entry.tuple.read_from(file);
+  return rc == RC::RECORD_EOF ? RC::IOERR_READ : rc;
+}
+
+RC ExternalSorter::finish(TupleSet &result) {
+  if (runs_.empty()) {
+    sort_entries();
+    for (size_t i = 0; i < entries_.size() && (top_n_ < 0 || (int)i < top_n_); i++) {
+      result.add(std::move(entries_[i].tuple));
+    }
+    entries_.clear();
+    return RC::SUCCESS;
+  }
+
+  if (!entries_.empty()) {
+    RC rc = spill();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  LOG_INFO("order by归并%d个有序段", (int)runs_.size());
+  return merge_runs(result);
+}
+
+RC ExternalSorter::merge_runs(TupleSet &result) {
+  std::vector<Run> runs(runs_.size());
+  // 键相同时先输出前面的段，保证排序稳定
+  auto greater = [&runs](int left, int right) {
+    int result = compare_key(runs[left].head.key, runs[right].head.key);
+    return result != 0 ? result > 0 : left > right;
+  };
+  std::priority_queue<int, std::vector<int>, decltype(greater)> heap(greater);
+
+  for (size_t i = 0; i < runs_.size(); i++) {
+    runs[i].file = runs_[i];
+    rewind(runs[i].file);
+    RC rc = read_entry(runs[i].file, runs[i].head);
+    if (rc == RC::SUCCESS) {
+      heap.push(i);
+    } else if (rc != RC::RECORD_EOF) {
+      LOG_ERROR("Failed to read temporary file for order by. rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+  }
+
+  for (int output_num = 0; !heap.empty() && (top_n_ < 0 || output_num < top_n_); output_num++) {
+    int i = heap.top();
+    heap.pop();
+    result.add(std::move(runs[i].head.tuple));
+    RC rc = read_entry(runs[i].file, runs[i].head);
+    if (rc == RC::SUCCESS) {
+      heap.push(i);
+    } else if (rc != RC::RECORD_EOF) {
+      LOG_ERROR("Failed to read temporary file for order by. rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,77 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_SQL_EXECUTOR_EXTERNAL_SORTER_H_
+#define __OBSERVER_SQL_EXECUTOR_EXTERNAL_SORTER_H_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "rc.h"
+#include "sql/executor/tuple.h"
+
+// 内存中排序的数据量上限(字节)，超过后把排好序的一段写入临时文件
+#define ORDER_BY_MEMORY_BUDGET (64 * 1024 * 1024)
+
+struct SortKey {
+  int index;      // 排序列在元组中的下标
+  bool is_desc;
+};
+
+/**
+ * ORDER BY的外部归并排序。元组的排序列编码成一个二进制键，键之间直接用memcmp比较：
+ * 整数和浮点数转成大端的无符号形式，字符串以'\0'结尾，NULL排在最前，降序的列把编码按位取反。
+ * 内存中的数据量超过预算时，把排好序的一段写入临时文件，最后对所有段做k路归并。
+ * 排序是稳定的，排序列相同的元组保持输入的顺序。
+ * 只需要前top_n行时(ORDER BY ... LIMIT)，内存中用大小为top_n的大顶堆只保留当前最小的top_n行
+ */
+class ExternalSorter {
+public:
+  ExternalSorter() = default;
+  ~ExternalSorter();
+
+  // keys中第一个是第一排序键，top_n小于0表示输出全部元组
+  void init(const std::vector<SortKey> &keys, size_t memory_budget = ORDER_BY_MEMORY_BUDGET, int top_n = -1);
+  RC add(Tuple &&tuple);
+  // 排好序的元组依次追加到result中
+  RC finish(TupleSet &result);
+
+private:
+  struct Entry {
+    std::string key;
+    size_t seq;       // 输入的顺序，键相同时用来保持稳定
+    size_t memory;    // 大约占用的内存
+    Tuple tuple;
+  };
+  struct Run {
+    FILE *file;
+    Entry head;   // 这一段中下一个要输出的元组
+  };
+
+  void encode_key(const Tuple &tuple, std::string &key) const;
+  static bool entry_less(const Entry &left, const Entry &right);
+  void add_top_n(Entry &&entry);
+  void sort_entries();
+  RC spill();
+  RC merge_runs(TupleSet &result);
+  static RC read_entry(FILE *file, Entry &entry);
+
+private:
+  std::vector<SortKey> keys_;
+  size_t memory_budget_ = ORDER_BY_MEMORY_BUDGET;
+  int top_n_ = -1;
+  size_t memory_size_ = 0;
+  size_t seq_ = 0;
+  std::vector<Entry> entries_;
+  std::vector<FILE *> runs_;
+};
+
+#endif //__OBSERVER_SQL_EXECUTOR_EXTERNAL_SORTER_H_
@@ -0,0 +1,249 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <string.h>
+
+#include "sql/executor/hash_aggregator.h"
+#include "common/log/log.h"
+
+HashAggregator::~HashAggregator() {
+  for (FILE *file : partitions_) {
+    if (file != nullptr) {
+      fclose(file);
+    }
+  }
+}
+
+RC HashAggregator::init(const TupleSchema &input_schema, const std::vector<int> &group_index,
+                        const std::vector<AggregateSpec> &specs, int max_groups) {
+  for (const AggregateSpec &spec : specs) {
+    if (spec.func_type == FuncType::AVG && spec.index >= 0 &&
+        (input_schema.field(spec.index).type() == CHARS || input_schema.field(spec.index).type() == DATES)) {
+      // CHARS和DATES不应该计算平均值
+      LOG_ERROR("Cannot compute avg over %s", spec.name.c_str());
+      return RC::GENERIC_ERROR;
+    }
+  }
+  input_schema_ = input_schema;
+  group_index_ = group_index;
+  specs_ = specs;
+  max_groups_ = max_groups;
+  return RC::SUCCESS;
+}
+
+size_t HashAggregator::hash_key(const Tuple &tuple) const {
+  size_t hash = 0;
+  for (int index : group_index_) {
+    // NULL中保存的值没有意义，所有NULL的哈希值都相同，才能落到同一组
+    const TupleValue &value = *tuple.get_pointer(index);
+    hash = hash * 31 + (value.is_null() ? 0 : value.to_hash());
+  }
+  return hash;
+}
+
+// 分组时NULL和NULL算作同一组
+bool HashAggregator::key_equal(const Group &group, const Tuple &tuple) const {
+  for (size_t i = 0; i < group_index_.size(); i++) {
+    const TupleValue &left = *group.key[i];
+    const TupleValue &right = *tuple.get_pointer(group_index_[i]);
+    if (left.is_null() || right.is_null()) {
+      if (left.is_null() != right.is_null()) {
+        return false;
+      }
+    } else if (left.compare(right) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashAggregator::update(Group &group, const Tuple &tuple) const {
+  group.row_num++;
+  for (size_t i = 0; i < specs_.size(); i++) {
+    const AggregateSpec &spec = specs_[i];
+    if (spec.index < 0) {
+      continue;
+    }
+    Accumulator &accumulator = group.accumulators[i];
+    const std::shared_ptr<TupleValue> &value = tuple.get_pointer(spec.index);
+    if (spec.func_type == FuncType::NOFUNC) {
+      if (!accumulator.value) {
+        accumulator.value = value;
+      }
+      continue;
+    }
+    if (value->is_null()) {
+      continue;
+    }
+
+    switch (spec.func_type) {
+    case FuncType::COUNT:
+      accumulator.count++;
+      break;
+    case FuncType::AVG: {
+      const IntValue *int_value = dynamic_cast<const IntValue *>(value.get());
+      const FloatValue *float_value = dynamic_cast<const FloatValue *>(value.get());
+      if (int_value != nullptr) {
+        accumulator.sum += int_value->get_value();
+        accumulator.count++;
+      } else if (float_value != nullptr) {
+        accumulator.sum += float_value->get_value();
+        accumulator.count++;
+      }
+    }
+    break;
+    case FuncType::MAX:
+      if (!accumulator.value || value->compare(*accumulator.value) > 0) {
+        accumulator.value = value;
+      }
+      break;
+    default:
+      if (!accumulator.value || value->compare(*accumulator.value) < 0) {
+        accumulator.value = value;
+      }
+      break;
+    }
+  }
+}
+
+RC HashAggregator::add(const Tuple &tuple) {
+  size_t hash = hash_key(tuple);
+  auto iter = buckets_.find(hash);
+  if (iter != buckets_.end()) {
+    for (int group_index : iter->second) {
+      if (key_equal(groups_[group_index], tuple)) {
+        update(groups_[group_index], tuple);
+        return RC::SUCCESS;
+      }
+    }
+  }
+
+  if ((int)groups_.size() >= max_groups_ && level_ < GROUP_BY_MAX_SPILL_LEVEL) {
+    return spill(tuple, hash);
+  }
+  Group group;
+  for (int index : group_index_) {
+    group.key.push_back(tuple.get_pointer(index));
+  }
+  group.accumulators.resize(specs_.size());
+  update(group, tuple);
+  buckets_[hash].push_back(groups_.size());
+  groups_.push_back(std::move(group));
+  return RC::SUCCESS;
+}
+
+RC HashAggregator::spill(const Tuple &tuple, size_t hash) {
+  if (partitions_.empty()) {
+    LOG_INFO("分组个数超过%d，新分组的行写入临时文件. level=%d", max_groups_, level_);
+    partitions_.assign(GROUP_BY_SPILL_PARTITIONS, nullptr);
+  }
+  int partition = (hash >> (level_ * 4)) % GROUP_BY_SPILL_PARTITIONS;
+  if (nullptr == partitions_[partition]) {
+    partitions_[partition] = tmpfile();
+    if (nullptr == partitions_[partition]) {
+      LOG_ERROR("Failed to create temporary file for group by. error=%s", strerror(errno));
+      return RC::IOERR_ACCESS;
+    }
+  }
+  if (tuple.write_to(partitions_[partition]) != RC::SUCCESS) {
+    LOG_ERROR("Failed to write temporary file for group by. error=%s", strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  spilled_num_++;
+  return RC::SUCCESS;
+}
+
+void HashAggregator::output(const Group &group, TupleSet &result) const {
+  TupleSchema schema;
+  Tuple tuple;
+  for (size_t i = 0; i < specs_.size(); i++) {
+    const AggregateSpec &spec = specs_[i];
+    const Accumulator &accumulator = group.accumulators[i];
+    AttrType type = spec.index >= 0 ? input_schema_.field(spec.index).type() : INTS;
+    if (spec.index < 0) {
+      tuple.add(group.row_num);
+    } else if (spec.func_type == FuncType::COUNT) {
+      tuple.add(accumulator.count);
+      type = INTS;
+    } else if (spec.func_type == FuncType::AVG) {
+      if (accumulator.count == 0) {
+        tuple.add("NULL", 4);
+        type = CHARS;
+      } else {
+        tuple.add(accumulator.sum / accumulator.count);
+        type = FLOATS;
+      }
+    } else if (!accumulator.value) {
+      tuple.add("NULL", 4);
+      type = CHARS;
+    } else {
+      tuple.add(accumulator.value);
+    }
+    schema.add_if_not_exists(type, "", spec.name.c_str());
+  }
+  if (result.get_schema().size() == 0) {
+    result.set_schema(schema);
+  }
+  result.add(std::move(tuple));
+}
+
+RC HashAggregator::finish(TupleSet &result) {
+  if (group_index_.empty() && groups_.empty() && 0 == spilled_num_) {
+    // 没有分组列时整个输入是一组，没有输入时COUNT是0，其它聚合函数是NULL
+    Group group;
+    group.accumulators.resize(specs_.size());
+    groups_.push_back(std::move(group));
+  }
+  for (const Group &group : groups_) {
+    output(group, result);
+  }
+  groups_.clear();
+  buckets_.clear();
+  if (spilled_num_ > 0) {
+    LOG_INFO("group by溢出了%d行，逐个分区聚合. level=%d", (int)spilled_num_, level_);
+  }
+
+  for (FILE *&file : partitions_) {
+    if (nullptr == file) {
+      continue;
+    }
+    RC rc = aggregate_partition(file, result);
+    fclose(file);
+    file = nullptr;
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC HashAggregator::aggregate_partition(FILE *file, TupleSet &result) {
+  rewind(file);
+  HashAggregator partition;
+  RC rc = partition.init(input_schema_, group_index_, specs_, max_groups_);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  partition.level_ = level_ + 1;
+
+  Tuple tuple;
+  while ((rc = tuple.read_from(file)) == RC::SUCCESS) {
+    rc = partition.add(tuple);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_ERROR("Failed to read temporary file for group by. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+  return partition.finish(result);
+}
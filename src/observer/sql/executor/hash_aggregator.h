@@ -0,0 +1,84 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_SQL_EXECUTOR_HASH_AGGREGATOR_H_
+#define __OBSERVER_SQL_EXECUTOR_HASH_AGGREGATOR_H_
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rc.h"
+#include "sql/executor/tuple.h"
+
+// 内存中最多保存的分组个数，超过后新分组的行按哈希值分区写入临时文件
+#define GROUP_BY_MAX_GROUPS 65536
+// 溢出时的分区个数，每层用哈希值的4位选择分区
+#define GROUP_BY_SPILL_PARTITIONS 16
+#define GROUP_BY_MAX_SPILL_LEVEL 8
+
+struct AggregateSpec {
+  FuncType func_type;
+  int index;          // 在输入元组中的下标，-1表示COUNT(*)
+  std::string name;   // 输出的列名
+};
+
+/**
+ * 聚合函数的哈希聚合，GROUP BY和不分组的聚合都用它计算。按分组键的哈希值找到候选分组，再逐个比较键的值，哈希冲突的行不会被合并。
+ * 每来一行就更新所在分组的聚合值，内存只和分组个数有关，输入的行不需要保存。
+ * 分组个数超过上限时，属于新分组的行写入按哈希值分区的临时文件，内存中的分组输出后再逐个分区聚合。
+ * 聚合函数的值是NULL时输出字符串NULL，类型是CHARS。分组按第一次出现的顺序输出，没有分组列时即使没有输入也输出一行
+ */
+class HashAggregator {
+public:
+  HashAggregator() = default;
+  ~HashAggregator();
+
+  RC init(const TupleSchema &input_schema, const std::vector<int> &group_index, const std::vector<AggregateSpec> &specs,
+          int max_groups = GROUP_BY_MAX_GROUPS);
+  RC add(const Tuple &tuple);
+  // 输出所有分组，result的schema为空时由第一个分组决定
+  RC finish(TupleSet &result);
+
+private:
+  struct Accumulator {
+    int count = 0;
+    float sum = 0;
+    std::shared_ptr<TupleValue> value;   // 分组列的值，或者MIN/MAX的当前值
+  };
+  struct Group {
+    std::vector<std::shared_ptr<TupleValue>> key;
+    int row_num = 0;
+    std::vector<Accumulator> accumulators;
+  };
+
+  size_t hash_key(const Tuple &tuple) const;
+  bool key_equal(const Group &group, const Tuple &tuple) const;
+  void update(Group &group, const Tuple &tuple) const;
+  void output(const Group &group, TupleSet &result) const;
+  RC spill(const Tuple &tuple, size_t hash);
+  RC aggregate_partition(FILE *file, TupleSet &result);
+
+private:
+  TupleSchema input_schema_;
+  std::vector<int> group_index_;
+  std::vector<AggregateSpec> specs_;
+  int max_groups_ = GROUP_BY_MAX_GROUPS;
+  int level_ = 0;
+
+  std::unordered_map<size_t, std::vector<int>> buckets_;   // 分组键的哈希值 -> groups_中的下标
+  std::vector<Group> groups_;
+  std::vector<FILE *> partitions_;
+  size_t spilled_num_ = 0;
+};
+
+#endif //__OBSERVER_SQL_EXECUTOR_HASH_AGGREGATOR_H_
@@ -0,0 +1,205 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <math.h>
+#include <string.h>
+#include <functional>
+#include <string>
+
+#include "sql/executor/semi_join.h"
+
+bool ValueIndex::numeric_value(const TupleValue &value, float &data) {
+  const IntValue *int_value = dynamic_cast<const IntValue *>(&value);
+  if (int_value != nullptr) {
+    data = int_value->get_value();
+    return true;
+  }
+  const FloatValue *float_value = dynamic_cast<const FloatValue *>(&value);
+  if (float_value != nullptr) {
+    data = float_value->get_value();
+    return true;
+  }
+  return false;
+}
+
+// 和cmp_value相同，数值转成float后差的绝对值小于1e-3算相等
+bool ValueIndex::value_equal(const TupleValue &left, const TupleValue &right) {
+  if (left.is_null() || right.is_null()) {
+    return false;
+  }
+  float left_data;
+  float right_data;
+  bool left_numeric = numeric_value(left, left_data);
+  bool right_numeric = numeric_value(right, right_data);
+  if (left_numeric != right_numeric) {
+    return false;
+  }
+  if (left_numeric) {
+    float diff = left_data - right_data;
+    return diff > -1e-3 && diff < 1e-3;
+  }
+  return strcmp(static_cast<const StringValue &>(left).get_value(),
+                static_cast<const StringValue &>(right).get_value()) == 0;
+}
+
+// 类型相同并且值完全相同，insert只合并这样的值
+bool ValueIndex::value_identical(const TupleValue &left, const TupleValue &right) {
+  const IntValue *left_int = dynamic_cast<const IntValue *>(&left);
+  const IntValue *right_int = dynamic_cast<const IntValue *>(&right);
+  if (left_int != nullptr || right_int != nullptr) {
+    return left_int != nullptr && right_int != nullptr && left_int->get_value() == right_int->get_value();
+  }
+  const FloatValue *left_float = dynamic_cast<const FloatValue *>(&left);
+  const FloatValue *right_float = dynamic_cast<const FloatValue *>(&right);
+  if (left_float != nullptr || right_float != nullptr) {
+    return left_float != nullptr && right_float != nullptr && left_float->get_value() == right_float->get_value();
+  }
+  return value_equal(left, right);
+}
+
+// 相等的两个数值落在同一个或者相邻的桶里
+size_t ValueIndex::bucket_of(const TupleValue &value, int neighbor) {
+  float data;
+  if (numeric_value(value, data)) {
+    return std::hash<double>()(floor((double)data * 500) + neighbor);
+  }
+  return std::hash<std::string>()(static_cast<const StringValue &>(value).get_value());
+}
+
+template <typename Visitor>
+void ValueIndex::visit_equal(const TupleValue &value, Visitor visitor) const {
+  if (value.is_null()) {
+    return;
+  }
+  float data;
+  const int neighbor_num = numeric_value(value, data) ? 1 : 0;
+  for (int neighbor = -neighbor_num; neighbor <= neighbor_num; neighbor++) {
+    auto iter = buckets_.find(bucket_of(value, neighbor));
+    if (iter == buckets_.end()) {
+      continue;
+    }
+    for (int index : iter->second) {
+      if (value_equal(*values_[index], value) && !visitor(index)) {
+        return;
+      }
+    }
+  }
+}
+
+int ValueIndex::find(const TupleValue &value) const {
+  int found = -1;
+  visit_equal(value, [&found](int index) {
+    found = index;
+    return false;
+  });
+  return found;
+}
+
+void ValueIndex::find_all(const TupleValue &value, std::vector<int> &indexes) const {
+  indexes.clear();
+  visit_equal(value, [&indexes](int index) {
+    indexes.push_back(index);
+    return true;
+  });
+}
+
+int ValueIndex::insert(const std::shared_ptr<TupleValue> &value) {
+  if (value->is_null()) {
+    return -1;
+  }
+  std::vector<int> &bucket = buckets_[bucket_of(*value)];
+  for (int index : bucket) {
+    if (value_identical(*values_[index], *value)) {
+      return index;
+    }
+  }
+  int index = values_.size();
+  bucket.push_back(index);
+  values_.push_back(value);
+  return index;
+}
+
+void HashSemiJoin::build(const TupleSet &sub_res, int value_index, int key_index,
+                         const std::shared_ptr<TupleValue> &missing_value) {
+  missing_value_ = missing_value;
+  if (key_index < 0 && sub_res.size() > 0) {
+    groups_.emplace_back();
+  }
+  for (const Tuple &tuple : sub_res.tuples()) {
+    int group_index = 0;
+    if (key_index >= 0) {
+      // 关联列是NULL的行和主查询的任何行都不相等
+      group_index = keys_.insert(tuple.get_pointer(key_index));
+      if (group_index < 0) {
+        continue;
+      }
+      if (group_index == (int)groups_.size()) {
+        groups_.emplace_back();
+      }
+    }
+
+    Group &group = groups_[group_index];
+    const std::shared_ptr<TupleValue> &value = tuple.get_pointer(value_index);
+    if (value->is_null()) {
+      group.has_null = true;
+    } else {
+      group.values.insert(value);
+    }
+  }
+}
+
+InResult HashSemiJoin::probe(const TupleValue &value, const TupleValue *key) const {
+  std::vector<int> group_indexes;
+  if (key != nullptr) {
+    keys_.find_all(*key, group_indexes);
+  } else if (!groups_.empty()) {
+    group_indexes.push_back(0);
+  }
+  if (group_indexes.empty() && key != nullptr && missing_value_) {
+    // 关联的COUNT子查询对这一行的结果只有0
+    if (value.is_null()) {
+      return InResult::UNKNOWN;
+    }
+    return ValueIndex::value_equal(value, *missing_value_) ? InResult::MATCH : InResult::NO_MATCH;
+  }
+  if (group_indexes.empty()) {
+    // 子查询的结果为空
+    return InResult::NO_MATCH;
+  }
+  if (value.is_null()) {
+    return InResult::UNKNOWN;
+  }
+
+  bool has_null = false;
+  for (int group_index : group_indexes) {
+    const Group &group = groups_[group_index];
+    if (group.values.find(value) >= 0) {
+      return InResult::MATCH;
+    }
+    has_null = has_null || group.has_null;
+  }
+  return has_null ? InResult::UNKNOWN : InResult::NO_MATCH;
+}
+
+void ScalarSubqueryGroups::build(const TupleSet &sub_res, int value_index, int key_index,
+                                 const std::shared_ptr<TupleValue> &missing_value) {
+  missing_value_ = missing_value;
+  for (const Tuple &tuple : sub_res.tuples()) {
+    // 分组后关联列的值互不相同，关联列是NULL的组和主查询的任何行都不相等
+    if (keys_.insert(tuple.get_pointer(key_index)) == (int)values_.size()) {
+      values_.push_back(tuple.get_pointer(value_index));
+    }
+  }
+}
+
+const std::shared_ptr<TupleValue> &ScalarSubqueryGroups::find(const TupleValue &key) const {
+  int index = keys_.find(key);
+  return index < 0 ? missing_value_ : values_[index];
+}
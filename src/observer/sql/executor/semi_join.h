@@ -0,0 +1,103 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_SQL_EXECUTOR_SEMI_JOIN_H_
+#define __OBSERVER_SQL_EXECUTOR_SEMI_JOIN_H_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "sql/executor/tuple.h"
+
+/**
+ * 按子查询比较的语义对值建立的哈希索引：整数和浮点数之间差的绝对值小于1e-3算相等，
+ * 字符串和日期逐字节相等。这种相等不满足传递性，所以只合并完全相同的值，其它的值都单独保存。
+ * 数值按宽度为2e-3的区间分桶，查找时检查所在的桶和相邻的两个桶，再逐个比较候选的值。
+ * NULL不会被加入，也查不到
+ */
+class ValueIndex {
+public:
+  // 返回和value完全相同的已有值的编号，没有时加入value并返回新的编号。value是NULL时返回-1
+  int insert(const std::shared_ptr<TupleValue> &value);
+  // 返回任意一个和value相等的值的编号，没有时返回-1
+  int find(const TupleValue &value) const;
+  // 所有和value相等的值的编号
+  void find_all(const TupleValue &value, std::vector<int> &indexes) const;
+  int size() const {
+    return values_.size();
+  }
+
+  static bool value_equal(const TupleValue &left, const TupleValue &right);
+
+private:
+  static bool numeric_value(const TupleValue &value, float &data);
+  static bool value_identical(const TupleValue &left, const TupleValue &right);
+  // 值所在的桶，数值的neighbor为-1、1时返回相邻的桶
+  static size_t bucket_of(const TupleValue &value, int neighbor = 0);
+  // 依次检查可能有相等值的桶，visitor返回false时停止
+  template <typename Visitor>
+  void visit_equal(const TupleValue &value, Visitor visitor) const;
+
+private:
+  std::unordered_map<size_t, std::vector<int>> buckets_;
+  std::vector<std::shared_ptr<TupleValue>> values_;
+};
+
+enum class InResult {
+  MATCH,      // IN成立
+  NO_MATCH,   // NOT IN成立
+  UNKNOWN,    // 结果是NULL，IN和NOT IN都不成立
+};
+
+/**
+ * IN/NOT IN子查询的哈希半连接/反连接。子查询的结果只读一遍，建成哈希表后主查询的每一行探测一次。
+ * 关联子查询去关联后，结果中带有关联列，按关联列的值分组，每组是主查询中关联列等于该值的行对应的子查询结果；
+ * 非关联子查询只有一组。主查询的一行可能和多个组的关联列相等，这时子查询的结果是这些组的并集。
+ * 没有对应组的行，子查询的结果为空；关联的COUNT子查询则是只有missing_value(0)的集合。
+ * NULL的处理和SQL相同：集合为空时IN不成立、NOT IN成立；否则左侧是NULL，或者没有匹配而集合中有NULL时，结果未知
+ */
+class HashSemiJoin {
+public:
+  // sub_res中第value_index列是子查询的值，key_index是关联列，非关联子查询为-1
+  void build(const TupleSet &sub_res, int value_index, int key_index,
+             const std::shared_ptr<TupleValue> &missing_value = nullptr);
+  // key是主查询中关联列的值，非关联子查询传nullptr
+  InResult probe(const TupleValue &value, const TupleValue *key) const;
+
+private:
+  struct Group {
+    ValueIndex values;
+    bool has_null = false;
+  };
+
+  ValueIndex keys_;   // 关联列的值的编号就是groups_中的下标
+  std::vector<Group> groups_;
+  std::shared_ptr<TupleValue> missing_value_;
+};
+
+/**
+ * 比较运算的关联子查询去关联后按关联列分组，每组一行，主查询的行按关联列找到对应的组。
+ * 找不到组说明子查询对这一行没有输入行，这时COUNT的值是0，其它聚合函数的值是NULL，
+ * 由build时传入的missing_value决定，NULL用nullptr表示
+ */
+class ScalarSubqueryGroups {
+public:
+  void build(const TupleSet &sub_res, int value_index, int key_index, const std::shared_ptr<TupleValue> &missing_value);
+  // 关联列等于key的组的值，没有对应的组时返回missing_value
+  const std::shared_ptr<TupleValue> &find(const TupleValue &key) const;
+
+private:
+  ValueIndex keys_;   // 关联列的值的编号就是values_中的下标
+  std::vector<std::shared_ptr<TupleValue>> values_;
+  std::shared_ptr<TupleValue> missing_value_;
+};
+
+#endif //__OBSERVER_SQL_EXECUTOR_SEMI_JOIN_H_
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2021/5/14.
 //
 #include <string>
+#include <string.h>
 #include <stdio.h>
 #include "sql/executor/tuple.h"
 #include "storage/common/table.h"
@@ -68,6 +69,107 @@ void Tuple::add(const char *s, int len, bool is_null)
   add(new StringValue(s, len, is_null));
 }
 
+// 临时文件中每个元组的格式：列数，然后每列依次为值的种类、是否为NULL和数据，字符串的数据是长度加内容
+enum SpillValueKind
+{
+  SPILL_INT_VALUE,
+  SPILL_FLOAT_VALUE,
+  SPILL_STRING_VALUE
+};
+
+RC Tuple::write_to(FILE *file) const
+{
+  int value_num = values_.size();
+  if (fwrite(&value_num, sizeof(value_num), 1, file) != 1)
+  {
+    return RC::IOERR_WRITE;
+  }
+  for (const std::shared_ptr<TupleValue> &value : values_)
+  {
+    char header[2] = {SPILL_STRING_VALUE, value->is_null()};
+    const IntValue *int_value = dynamic_cast<const IntValue *>(value.get());
+    const FloatValue *float_value = dynamic_cast<const FloatValue *>(value.get());
+    bool ok = true;
+    if (int_value != nullptr)
+    {
+      header[0] = SPILL_INT_VALUE;
+      int data = int_value->get_value();
+      ok = fwrite(header, sizeof(header), 1, file) == 1 && fwrite(&data, sizeof(data), 1, file) == 1;
+    }
+    else if (float_value != nullptr)
+    {
+      header[0] = SPILL_FLOAT_VALUE;
+      float data = float_value->get_value();
+      ok = fwrite(header, sizeof(header), 1, file) == 1 && fwrite(&data, sizeof(data), 1, file) == 1;
+    }
+    else
+    {
+      const char *data = static_cast<const StringValue *>(value.get())->get_value();
+      int len = strlen(data);
+      ok = fwrite(header, sizeof(header), 1, file) == 1 && fwrite(&len, sizeof(len), 1, file) == 1 &&
+           (int)fwrite(data, 1, len, file) == len;
+    }
+    if (!ok)
+    {
+      return RC::IOERR_WRITE;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC Tuple::read_from(FILE *file)
+{
+  int value_num = 0;
+  if (fread(&value_num, sizeof(value_num), 1, file) != 1)
+  {
+    return feof(file) ? RC::RECORD_EOF : RC::IOERR_READ;
+  }
+  values_.clear();
+  values_.reserve(value_num);
+  std::string data;
+  for (int i = 0; i < value_num; i++)
+  {
+    char header[2];
+    if (fread(header, sizeof(header), 1, file) != 1)
+    {
+      return RC::IOERR_READ;
+    }
+    if (header[0] == SPILL_INT_VALUE)
+    {
+      int value = 0;
+      if (fread(&value, sizeof(value), 1, file) != 1)
+      {
+        return RC::IOERR_READ;
+      }
+      add(value, header[1] != 0);
+    }
+    else if (header[0] == SPILL_FLOAT_VALUE)
+    {
+      float value = 0;
+      if (fread(&value, sizeof(value), 1, file) != 1)
+      {
+        return RC::IOERR_READ;
+      }
+      add(value, header[1] != 0);
+    }
+    else
+    {
+      int len = 0;
+      if (fread(&len, sizeof(len), 1, file) != 1 || len < 0)
+      {
+        return RC::IOERR_READ;
+      }
+      data.resize(len);
+      if ((int)fread(&data[0], 1, len, file) != len)
+      {
+        return RC::IOERR_READ;
+      }
+      add(new StringValue(data.c_str(), header[1] != 0));
+    }
+  }
+  return RC::SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 std::string TupleField::to_string() const
@@ -301,9 +403,14 @@ void num2date(int n,char *str)
 
 void TupleRecordConverter::add_record(const char *record)
 {
-  const TupleSchema &schema = tuple_set_.schema();
   Tuple tuple;
-  const TableMeta &table_meta = table_->table_meta();
+  record_to_tuple(table_, tuple_set_.schema(), record, tuple);
+  tuple_set_.add(std::move(tuple));
+}
+
+void TupleRecordConverter::record_to_tuple(const Table *table, const TupleSchema &schema, const char *record, Tuple &tuple)
+{
+  const TableMeta &table_meta = table->table_meta();
 
   auto last_field = table_meta.field(table_meta.field_num() - 1);
   int null_field_index = last_field->offset() + last_field->len();
@@ -374,6 +481,4 @@ void TupleRecordConverter::add_record(const char *record)
       }
     }
   }
-
-  tuple_set_.add(std::move(tuple));
 }
@@ -22,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 #include <algorithm>
 #include <iostream>
 
+#include "rc.h"
 #include "sql/parser/parse.h"
 #include "sql/executor/value.h"
 
@@ -96,6 +97,10 @@ public:
     return values_[index];
   }
 
+  // 写入临时文件和从临时文件读回，用于group by和order by的溢出。读到文件末尾时返回RC::RECORD_EOF
+  RC write_to(FILE *file) const;
+  RC read_from(FILE *file);
+
   size_t to_hash(const std::vector<int>& idx) const {
     size_t ans = 0;
     for (const int &i : idx) {
@@ -246,6 +251,13 @@ public:
     tuples_.clear();
   }
 
+  // 取出所有元组，TupleSet中只保留schema
+  std::vector<Tuple> release_tuples() {
+    std::vector<Tuple> tuples;
+    tuples.swap(tuples_);
+    return tuples;
+  }
+
 public:
   const TupleSchema &schema() const
   {
@@ -257,6 +269,9 @@ private:
   TupleSchema schema_;
 };
 
+// 日期的数字形式转成"yyyy-mm-dd"，str至少有10个字节
+void num2date(int n, char *str);
+
 class TupleRecordConverter
 {
 public:
@@ -264,6 +279,9 @@ public:
 
   void add_record(const char *record);
 
+  // 按照schema中的字段把一条记录转换成元组
+  static void record_to_tuple(const Table *table, const TupleSchema &schema, const char *record, Tuple &tuple);
+
 private:
   Table *table_;
   TupleSet &tuple_set_;
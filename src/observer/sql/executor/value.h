@@ -62,7 +62,7 @@ public:
     return value_ - int_other.value_;
   }
 
-  int get_value()
+  int get_value() const
   {
     return value_;
   }
@@ -146,7 +146,7 @@ public:
     return 0;
   }
 
-  float get_value()
+  float get_value() const
   {
     return value_;
   }
@@ -219,7 +219,7 @@ public:
     return strcmp(value_.c_str(), string_other.value_.c_str());
   }
 
-  const char *get_value()
+  const char *get_value() const
   {
     return value_.c_str();
   }
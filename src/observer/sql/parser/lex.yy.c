@@ -592,6 +592,7 @@ static const flex_int16_t yy_chk[422] =
 #line 1 "lex_sql.l"
 #line 2 "lex_sql.l"
 #include<string.h>
+#include<strings.h>
 #include<stdio.h>
 
 struct ParserContext;
@@ -607,10 +608,36 @@ extern double atof();
 #endif // YYDEBUG
 
 #define RETURN_TOKEN(token) debug_printf("%s\n",#token);return token
-#line 611 "lex.yy.c"
+
+// 没有单独写词法规则的关键字：先按ID匹配，再查表得到对应的token
+typedef struct {
+  const char *word;
+  int token;
+} Keyword;
+
+static const Keyword keywords[] = {
+  {"include", INCLUDE},
+  {"using", USING},
+  {"hash", HASH},
+  {"analyze", ANALYZE},
+  {"bitmap", BITMAP},
+  {"limit", LIMIT},
+  {"offset", OFFSET},
+};
+
+static int keyword_token(const char *text)
+{
+  for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
+    if (0 == strcasecmp(text, keywords[i].word)) {
+      return keywords[i].token;
+    }
+  }
+  return 0;
+}
+#line 637 "lex.yy.c"
 /* Prevent the need for linking with -lfl */
 
-#line 614 "lex.yy.c"
+#line 640 "lex.yy.c"
 
 #define INITIAL 0
 #define STR 1
@@ -885,10 +912,10 @@ YY_DECL
 		}
 
 	{
-#line 32 "lex_sql.l"
+#line 58 "lex_sql.l"
 
 
-#line 892 "lex.yy.c"
+#line 918 "lex.yy.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -947,351 +974,351 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 34 "lex_sql.l"
+#line 60 "lex_sql.l"
 // ignore whitespace
 	YY_BREAK
 case 2:
 /* rule 2 can match eol */
 YY_RULE_SETUP
-#line 35 "lex_sql.l"
+#line 61 "lex_sql.l"
 ;
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 37 "lex_sql.l"
+#line 63 "lex_sql.l"
 yylval->number=atoi(yytext); RETURN_TOKEN(NUMBER);
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 38 "lex_sql.l"
+#line 64 "lex_sql.l"
 yylval->floats=(float)(atof(yytext)); RETURN_TOKEN(FLOAT);
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 40 "lex_sql.l"
+#line 66 "lex_sql.l"
 RETURN_TOKEN(SEMICOLON);
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 41 "lex_sql.l"
+#line 67 "lex_sql.l"
 RETURN_TOKEN(DOT);
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 42 "lex_sql.l"
+#line 68 "lex_sql.l"
 yylval->string=strdup(yytext); RETURN_TOKEN(STAR);
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 43 "lex_sql.l"
+#line 69 "lex_sql.l"
 RETURN_TOKEN(EXIT);
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 44 "lex_sql.l"
+#line 70 "lex_sql.l"
 RETURN_TOKEN(HELP);
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 45 "lex_sql.l"
+#line 71 "lex_sql.l"
 RETURN_TOKEN(DESC);
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 46 "lex_sql.l"
+#line 72 "lex_sql.l"
 RETURN_TOKEN(CREATE);
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 47 "lex_sql.l"
+#line 73 "lex_sql.l"
 RETURN_TOKEN(DROP);
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 48 "lex_sql.l"
+#line 74 "lex_sql.l"
 RETURN_TOKEN(TABLE);
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 49 "lex_sql.l"
+#line 75 "lex_sql.l"
 RETURN_TOKEN(TABLES);
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 50 "lex_sql.l"
+#line 76 "lex_sql.l"
 RETURN_TOKEN(INDEX);
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 51 "lex_sql.l"
+#line 77 "lex_sql.l"
 RETURN_TOKEN(ON);
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 52 "lex_sql.l"
+#line 78 "lex_sql.l"
 RETURN_TOKEN(SHOW);
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 53 "lex_sql.l"
+#line 79 "lex_sql.l"
 RETURN_TOKEN(SYNC);
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 54 "lex_sql.l"
+#line 80 "lex_sql.l"
 RETURN_TOKEN(SELECT);
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 55 "lex_sql.l"
+#line 81 "lex_sql.l"
 RETURN_TOKEN(FROM);
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 56 "lex_sql.l"
+#line 82 "lex_sql.l"
 RETURN_TOKEN(WHERE);
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 57 "lex_sql.l"
+#line 83 "lex_sql.l"
 RETURN_TOKEN(AND);
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 58 "lex_sql.l"
+#line 84 "lex_sql.l"
 RETURN_TOKEN(INSERT);
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 59 "lex_sql.l"
+#line 85 "lex_sql.l"
 RETURN_TOKEN(INTO);
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 60 "lex_sql.l"
+#line 86 "lex_sql.l"
 RETURN_TOKEN(VALUES);
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 61 "lex_sql.l"
+#line 87 "lex_sql.l"
 RETURN_TOKEN(DELETE);
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 62 "lex_sql.l"
+#line 88 "lex_sql.l"
 RETURN_TOKEN(UPDATE);
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 63 "lex_sql.l"
+#line 89 "lex_sql.l"
 RETURN_TOKEN(SET);
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 64 "lex_sql.l"
+#line 90 "lex_sql.l"
 RETURN_TOKEN(TRX_BEGIN);
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 65 "lex_sql.l"
+#line 91 "lex_sql.l"
 RETURN_TOKEN(TRX_COMMIT);
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 66 "lex_sql.l"
+#line 92 "lex_sql.l"
 RETURN_TOKEN(TRX_ROLLBACK);
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 67 "lex_sql.l"
+#line 93 "lex_sql.l"
 RETURN_TOKEN(INT_T);
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 68 "lex_sql.l"
+#line 94 "lex_sql.l"
 RETURN_TOKEN(STRING_T);
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 69 "lex_sql.l"
+#line 95 "lex_sql.l"
 RETURN_TOKEN(FLOAT_T);
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 70 "lex_sql.l"
+#line 96 "lex_sql.l"
 RETURN_TOKEN(ORDER);
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 71 "lex_sql.l"
+#line 97 "lex_sql.l"
 RETURN_TOKEN(ASC);
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 72 "lex_sql.l"
+#line 98 "lex_sql.l"
 RETURN_TOKEN(BY);
 	YY_BREAK
 case 38:
 YY_RULE_SETUP
-#line 73 "lex_sql.l"
+#line 99 "lex_sql.l"
 RETURN_TOKEN(DATE_T);
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
-#line 74 "lex_sql.l"
+#line 100 "lex_sql.l"
 RETURN_TOKEN(UNIQUE);
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 75 "lex_sql.l"
+#line 101 "lex_sql.l"
 RETURN_TOKEN(LOAD);
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 76 "lex_sql.l"
+#line 102 "lex_sql.l"
 RETURN_TOKEN(DATA);
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 77 "lex_sql.l"
+#line 103 "lex_sql.l"
 RETURN_TOKEN(INFILE);
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 78 "lex_sql.l"
+#line 104 "lex_sql.l"
 RETURN_TOKEN(NULLABLE);
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 79 "lex_sql.l"
+#line 105 "lex_sql.l"
 RETURN_TOKEN(NOT);
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 80 "lex_sql.l"
+#line 106 "lex_sql.l"
 RETURN_TOKEN(NULL_T);
 	YY_BREAK
 case 46:
 YY_RULE_SETUP
-#line 81 "lex_sql.l"
+#line 107 "lex_sql.l"
 yylval->string=strdup(yytext); RETURN_TOKEN(COUNT);
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 82 "lex_sql.l"
+#line 108 "lex_sql.l"
 yylval->string=strdup(yytext); RETURN_TOKEN(OTHER_FUNCTION_TYPE);
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 83 "lex_sql.l"
+#line 109 "lex_sql.l"
 RETURN_TOKEN(INNER);
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 84 "lex_sql.l"
+#line 110 "lex_sql.l"
 RETURN_TOKEN(JOIN);
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 85 "lex_sql.l"
+#line 111 "lex_sql.l"
 RETURN_TOKEN(IS);
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 86 "lex_sql.l"
+#line 112 "lex_sql.l"
 RETURN_TOKEN(GROUP);
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 87 "lex_sql.l"
+#line 113 "lex_sql.l"
 RETURN_TOKEN(IN);
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 88 "lex_sql.l"
+#line 114 "lex_sql.l"
 RETURN_TOKEN(TEXT_T);
 	YY_BREAK
 case 54:
 YY_RULE_SETUP
-#line 89 "lex_sql.l"
-yylval->string=strdup(yytext); RETURN_TOKEN(ID);
+#line 115 "lex_sql.l"
+{ int token = keyword_token(yytext); if (token != 0) { RETURN_TOKEN(token); } yylval->string=strdup(yytext); RETURN_TOKEN(ID); }
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 90 "lex_sql.l"
+#line 116 "lex_sql.l"
 RETURN_TOKEN(LBRACE);
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 91 "lex_sql.l"
+#line 117 "lex_sql.l"
 RETURN_TOKEN(RBRACE);
 	YY_BREAK
 case 57:
 YY_RULE_SETUP
-#line 92 "lex_sql.l"
+#line 118 "lex_sql.l"
 RETURN_TOKEN(COMMA);
 	YY_BREAK
 case 58:
 YY_RULE_SETUP
-#line 93 "lex_sql.l"
+#line 119 "lex_sql.l"
 RETURN_TOKEN(EQ);
 	YY_BREAK
 case 59:
 YY_RULE_SETUP
-#line 94 "lex_sql.l"
+#line 120 "lex_sql.l"
 RETURN_TOKEN(LE);
 	YY_BREAK
 case 60:
 YY_RULE_SETUP
-#line 95 "lex_sql.l"
+#line 121 "lex_sql.l"
 RETURN_TOKEN(NE);
 	YY_BREAK
 case 61:
 YY_RULE_SETUP
-#line 96 "lex_sql.l"
+#line 122 "lex_sql.l"
 RETURN_TOKEN(LT);
 	YY_BREAK
 case 62:
 YY_RULE_SETUP
-#line 97 "lex_sql.l"
+#line 123 "lex_sql.l"
 RETURN_TOKEN(GE);
 	YY_BREAK
 case 63:
 YY_RULE_SETUP
-#line 98 "lex_sql.l"
+#line 124 "lex_sql.l"
 RETURN_TOKEN(GT);
 	YY_BREAK
 case 64:
 YY_RULE_SETUP
-#line 99 "lex_sql.l"
+#line 125 "lex_sql.l"
 RETURN_TOKEN(PLUS);
 	YY_BREAK
 case 65:
 YY_RULE_SETUP
-#line 100 "lex_sql.l"
+#line 126 "lex_sql.l"
 RETURN_TOKEN(DIV);
 	YY_BREAK
 case 66:
 YY_RULE_SETUP
-#line 101 "lex_sql.l"
+#line 127 "lex_sql.l"
 RETURN_TOKEN(MINUS);
 	YY_BREAK
 case 67:
 YY_RULE_SETUP
-#line 102 "lex_sql.l"
+#line 128 "lex_sql.l"
 yylval->string=strdup(yytext); RETURN_TOKEN(SSS);
 	YY_BREAK
 case 68:
 YY_RULE_SETUP
-#line 104 "lex_sql.l"
+#line 130 "lex_sql.l"
 printf("Unknown character [%c]\n",yytext[0]); return yytext[0];
 	YY_BREAK
 case 69:
 YY_RULE_SETUP
-#line 105 "lex_sql.l"
+#line 131 "lex_sql.l"
 ECHO;
 	YY_BREAK
-#line 1295 "lex.yy.c"
+#line 1321 "lex.yy.c"
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(STR):
 	yyterminate();
@@ -2473,7 +2500,7 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 105 "lex_sql.l"
+#line 131 "lex_sql.l"
 
 
 void scan_string(const char *str, yyscan_t scanner) {
@@ -717,6 +717,13 @@ void value_init_string_with_text(Value *value, const char *v, int is_null, int l
     selects->condition_num += condition_num;
   }
 
+  void selects_set_limit(Selects *selects, int limit, int offset)
+  {
+    selects->has_limit = 1;
+    selects->limit = limit;
+    selects->offset = offset;
+  }
+
   void selects_destroy(Selects *selects)
   {
     for (size_t i = 0; i < selects->attr_num; i++)
@@ -760,6 +767,7 @@ void value_init_string_with_text(Value *value, const char *v, int is_null, int l
       selects->exp_num[j] = 0;
     }
     selects->total_exp = 0;
+    selects->has_limit = 0;
   }
 
   void inserts_init(Inserts *inserts, const char *relation_name, Value values[], size_t value_num, size_t index)
@@ -895,20 +903,49 @@ void value_init_string_with_text(Value *value, const char *v, int is_null, int l
   {
     create_index->attribute_name[create_index->attr_num++] = strdup(attr_name);
   }
+  void create_index_append_include(CreateIndex *create_index, const char *attr_name)
+  {
+    create_index->include_attribute_name[create_index->include_num++] = strdup(attr_name);
+  }
+  void create_index_set_type(CreateIndex *create_index, IndexType index_type)
+  {
+    create_index->index_type = index_type;
+  }
+  void create_index_set_conditions(CreateIndex *create_index, Condition *conditions)
+  {
+    Condition *cond = conditions;
+
+    for (; cond->comp != NO_OP; ++cond)
+    {
+      create_index->conditions[create_index->condition_num++] = *cond;
+    }
+  }
 
   void create_index_destroy(CreateIndex *create_index)
   {
     free(create_index->index_name);
     free(create_index->relation_name);
-    free(create_index->attribute_name);
 
     create_index->index_name = nullptr;
     create_index->relation_name = nullptr;
     for (size_t i = 0; i < create_index->attr_num; i++)
     {
+      free(create_index->attribute_name[i]);
       create_index->attribute_name[i] = nullptr;
     }
     create_index->attr_num = 0;
+    for (size_t i = 0; i < create_index->include_num; i++)
+    {
+      free(create_index->include_attribute_name[i]);
+      create_index->include_attribute_name[i] = nullptr;
+    }
+    create_index->include_num = 0;
+    for (size_t i = 0; i < create_index->condition_num; i++)
+    {
+      condition_destroy(&create_index->conditions[i]);
+    }
+    create_index->condition_num = 0;
+    create_index->index_type = INDEX_TYPE_BTREE;
   }
 
   void drop_index_init(DropIndex *drop_index, const char *index_name)
@@ -957,6 +994,17 @@ void value_init_string_with_text(Value *value, const char *v, int is_null, int l
     load_data->file_name = nullptr;
   }
 
+  void analyze_init(Analyze *analyze, const char *relation_name)
+  {
+    analyze->relation_name = strdup(relation_name);
+  }
+
+  void analyze_destroy(Analyze *analyze)
+  {
+    free((char *)analyze->relation_name);
+    analyze->relation_name = nullptr;
+  }
+
   void query_init(Query *query)
   {
     query->flag = SCF_ERROR;
@@ -1039,6 +1087,12 @@ void value_init_string_with_text(Value *value, const char *v, int is_null, int l
       load_data_destroy(&query->sstr.load_data);
     }
     break;
+
+    case SCF_ANALYZE:
+    {
+      analyze_destroy(&query->sstr.analyze);
+    }
+    break;
     case SCF_BEGIN:
     case SCF_COMMIT:
     case SCF_ROLLBACK:
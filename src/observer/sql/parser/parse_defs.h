@@ -126,6 +126,10 @@ struct _Selects
   size_t exp_num[MAX_NUM];
   size_t total_exp;
   char *expression[MAX_NUM][50]; // 表达式
+
+  int has_limit;                 // 是否有limit子句
+  int limit;                     // 最多输出的行数
+  int offset;                    // 跳过开头的行数
 };
 
 
@@ -179,15 +183,27 @@ typedef struct
   char *relation_name; // Relation name
 } DropTable;
 
+typedef enum
+{
+  INDEX_TYPE_BTREE,
+  INDEX_TYPE_HASH,
+  INDEX_TYPE_BITMAP
+} IndexType;
+
 // struct of create_index
 typedef struct
 {
   int is_unique;           // unique =1 means unique index
+  IndexType index_type;    // USING HASH/USING BITMAP指定，默认为B+树
   char *index_name;     // Index name
   char *relation_name;  // Relation name
   // char *attribute_name; // Attribute name
   char *attribute_name[MAX_NUM];  // Attribute name   char指针数组
   size_t attr_num;         // for multi-index 
+  char *include_attribute_name[MAX_NUM];  // INCLUDE子句中的字段，只保存在叶子中，不参与比较
+  size_t include_num;
+  size_t condition_num;           // WHERE子句中的条件，只有满足条件的记录才进入索引(部分索引)
+  Condition conditions[MAX_NUM];
 } CreateIndex;
 
 // struct of  drop_index
@@ -207,6 +223,12 @@ typedef struct
   const char *file_name;
 } LoadData;
 
+// struct of analyze
+typedef struct
+{
+  const char *relation_name;
+} Analyze;
+
 union Queries
 {
   Selects selection;
@@ -219,6 +241,7 @@ union Queries
   DropIndex drop_index;
   DescTable desc_table;
   LoadData load_data;
+  Analyze analyze;
   char *errors;
 };
 
@@ -242,7 +265,8 @@ enum SqlCommandFlag
   SCF_ROLLBACK,
   SCF_LOAD_DATA,
   SCF_HELP,
-  SCF_EXIT
+  SCF_EXIT,
+  SCF_ANALYZE
 };
 // struct of flag and sql_struct
 typedef struct Query
@@ -287,6 +311,7 @@ extern "C"
   void selects_append_conditions(Selects *selects, Condition *conditions);
   void selects_append_order(Selects *selects, RelAttr *rel_attr);
   void selects_append_groups(Selects *selects, RelAttr *rel_attr);
+  void selects_set_limit(Selects *selects, int limit, int offset);
   void selects_destroy(Selects *selects);
   void print_num(int num);
   void print_str(const char *s);
@@ -311,7 +336,10 @@ extern "C"
 
   void create_index_init(
       CreateIndex *create_index, const char *index_name, const char *relation_name, int is_unique);
-  void create_index_append(CreateIndex *create_index,const char *attr_name);
+  void create_index_append_attribute(CreateIndex *create_index, const char *attr_name);
+  void create_index_append_include(CreateIndex *create_index, const char *attr_name);
+  void create_index_set_type(CreateIndex *create_index, IndexType index_type);
+  void create_index_set_conditions(CreateIndex *create_index, Condition *conditions);
   void create_index_destroy(CreateIndex *create_index);
 
   void drop_index_init(DropIndex *drop_index, const char *index_name);
@@ -323,6 +351,9 @@ extern "C"
   void load_data_init(LoadData *load_data, const char *relation_name, const char *file_name);
   void load_data_destroy(LoadData *load_data);
 
+  void analyze_init(Analyze *analyze, const char *relation_name);
+  void analyze_destroy(Analyze *analyze);
+
   void query_init(Query *query);
   Query *query_create(); // create and init
   void query_reset(Query *query);
@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -41,14 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.5.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -150,7 +151,7 @@ ParserContext *get_context(yyscan_t scanner)
 #define CONTEXT get_context(scanner)
 
 
-#line 154 "yacc_sql.tab.c"
+#line 155 "yacc_sql.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -173,135 +174,162 @@ ParserContext *get_context(yyscan_t scanner)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* Use api.header.include to #include this header
-   instead of duplicating it here.  */
-#ifndef YY_YY_YACC_SQL_TAB_H_INCLUDED
-# define YY_YY_YACC_SQL_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 1
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    SEMICOLON = 258,
-    CREATE = 259,
-    DROP = 260,
-    TABLE = 261,
-    TABLES = 262,
-    INDEX = 263,
-    SELECT = 264,
-    DESC = 265,
-    SHOW = 266,
-    SYNC = 267,
-    INSERT = 268,
-    DELETE = 269,
-    UPDATE = 270,
-    LBRACE = 271,
-    RBRACE = 272,
-    COMMA = 273,
-    TRX_BEGIN = 274,
-    TRX_COMMIT = 275,
-    TRX_ROLLBACK = 276,
-    INT_T = 277,
-    STRING_T = 278,
-    FLOAT_T = 279,
-    ORDER = 280,
-    ASC = 281,
-    BY = 282,
-    DATE_T = 283,
-    UNIQUE = 284,
-    HELP = 285,
-    EXIT = 286,
-    DOT = 287,
-    INTO = 288,
-    VALUES = 289,
-    FROM = 290,
-    WHERE = 291,
-    AND = 292,
-    SET = 293,
-    ON = 294,
-    LOAD = 295,
-    DATA = 296,
-    INFILE = 297,
-    NULLABLE = 298,
-    GROUP = 299,
-    IS = 300,
-    NOT = 301,
-    EQ = 302,
-    LT = 303,
-    GT = 304,
-    LE = 305,
-    GE = 306,
-    NE = 307,
-    PLUS = 308,
-    DIV = 309,
-    NULL_T = 310,
-    INNER = 311,
-    JOIN = 312,
-    IN = 313,
-    MINUS = 314,
-    TEXT_T = 315,
-    NUMBER = 316,
-    FLOAT = 317,
-    ID = 318,
-    PATH = 319,
-    SSS = 320,
-    STAR = 321,
-    STRING_V = 322,
-    COUNT = 323,
-    OTHER_FUNCTION_TYPE = 324,
-    Column = 325,
-    LOWER_THAN_BRACE = 326,
-    GR = 327
-  };
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-union YYSTYPE
+#include "yacc_sql.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-#line 149 "yacc_sql.y"
-
-  struct _Attr *attr;
-  struct _Condition *condition1;
-  struct _Value *value1;
-  char *string;
-  //char *date;
-  int number;
-  float floats;
-  char *position;
-  const char **relation;
-  struct _RelAttr *relattr1;
-  struct _Selects *selnode;
-
-#line 293 "yacc_sql.tab.c"
-
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_SEMICOLON = 3,                  /* SEMICOLON  */
+  YYSYMBOL_CREATE = 4,                     /* CREATE  */
+  YYSYMBOL_DROP = 5,                       /* DROP  */
+  YYSYMBOL_TABLE = 6,                      /* TABLE  */
+  YYSYMBOL_TABLES = 7,                     /* TABLES  */
+  YYSYMBOL_INDEX = 8,                      /* INDEX  */
+  YYSYMBOL_SELECT = 9,                     /* SELECT  */
+  YYSYMBOL_DESC = 10,                      /* DESC  */
+  YYSYMBOL_SHOW = 11,                      /* SHOW  */
+  YYSYMBOL_SYNC = 12,                      /* SYNC  */
+  YYSYMBOL_INSERT = 13,                    /* INSERT  */
+  YYSYMBOL_DELETE = 14,                    /* DELETE  */
+  YYSYMBOL_UPDATE = 15,                    /* UPDATE  */
+  YYSYMBOL_LBRACE = 16,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 17,                    /* RBRACE  */
+  YYSYMBOL_COMMA = 18,                     /* COMMA  */
+  YYSYMBOL_TRX_BEGIN = 19,                 /* TRX_BEGIN  */
+  YYSYMBOL_TRX_COMMIT = 20,                /* TRX_COMMIT  */
+  YYSYMBOL_TRX_ROLLBACK = 21,              /* TRX_ROLLBACK  */
+  YYSYMBOL_INT_T = 22,                     /* INT_T  */
+  YYSYMBOL_STRING_T = 23,                  /* STRING_T  */
+  YYSYMBOL_FLOAT_T = 24,                   /* FLOAT_T  */
+  YYSYMBOL_ORDER = 25,                     /* ORDER  */
+  YYSYMBOL_ASC = 26,                       /* ASC  */
+  YYSYMBOL_BY = 27,                        /* BY  */
+  YYSYMBOL_DATE_T = 28,                    /* DATE_T  */
+  YYSYMBOL_UNIQUE = 29,                    /* UNIQUE  */
+  YYSYMBOL_HELP = 30,                      /* HELP  */
+  YYSYMBOL_EXIT = 31,                      /* EXIT  */
+  YYSYMBOL_DOT = 32,                       /* DOT  */
+  YYSYMBOL_INTO = 33,                      /* INTO  */
+  YYSYMBOL_VALUES = 34,                    /* VALUES  */
+  YYSYMBOL_FROM = 35,                      /* FROM  */
+  YYSYMBOL_WHERE = 36,                     /* WHERE  */
+  YYSYMBOL_AND = 37,                       /* AND  */
+  YYSYMBOL_SET = 38,                       /* SET  */
+  YYSYMBOL_ON = 39,                        /* ON  */
+  YYSYMBOL_LOAD = 40,                      /* LOAD  */
+  YYSYMBOL_DATA = 41,                      /* DATA  */
+  YYSYMBOL_INFILE = 42,                    /* INFILE  */
+  YYSYMBOL_NULLABLE = 43,                  /* NULLABLE  */
+  YYSYMBOL_GROUP = 44,                     /* GROUP  */
+  YYSYMBOL_IS = 45,                        /* IS  */
+  YYSYMBOL_NOT = 46,                       /* NOT  */
+  YYSYMBOL_EQ = 47,                        /* EQ  */
+  YYSYMBOL_LT = 48,                        /* LT  */
+  YYSYMBOL_GT = 49,                        /* GT  */
+  YYSYMBOL_LE = 50,                        /* LE  */
+  YYSYMBOL_GE = 51,                        /* GE  */
+  YYSYMBOL_NE = 52,                        /* NE  */
+  YYSYMBOL_PLUS = 53,                      /* PLUS  */
+  YYSYMBOL_DIV = 54,                       /* DIV  */
+  YYSYMBOL_NULL_T = 55,                    /* NULL_T  */
+  YYSYMBOL_INNER = 56,                     /* INNER  */
+  YYSYMBOL_JOIN = 57,                      /* JOIN  */
+  YYSYMBOL_IN = 58,                        /* IN  */
+  YYSYMBOL_MINUS = 59,                     /* MINUS  */
+  YYSYMBOL_TEXT_T = 60,                    /* TEXT_T  */
+  YYSYMBOL_INCLUDE = 61,                   /* INCLUDE  */
+  YYSYMBOL_USING = 62,                     /* USING  */
+  YYSYMBOL_HASH = 63,                      /* HASH  */
+  YYSYMBOL_ANALYZE = 64,                   /* ANALYZE  */
+  YYSYMBOL_BITMAP = 65,                    /* BITMAP  */
+  YYSYMBOL_LIMIT = 66,                     /* LIMIT  */
+  YYSYMBOL_OFFSET = 67,                    /* OFFSET  */
+  YYSYMBOL_NUMBER = 68,                    /* NUMBER  */
+  YYSYMBOL_FLOAT = 69,                     /* FLOAT  */
+  YYSYMBOL_ID = 70,                        /* ID  */
+  YYSYMBOL_PATH = 71,                      /* PATH  */
+  YYSYMBOL_SSS = 72,                       /* SSS  */
+  YYSYMBOL_STAR = 73,                      /* STAR  */
+  YYSYMBOL_STRING_V = 74,                  /* STRING_V  */
+  YYSYMBOL_COUNT = 75,                     /* COUNT  */
+  YYSYMBOL_OTHER_FUNCTION_TYPE = 76,       /* OTHER_FUNCTION_TYPE  */
+  YYSYMBOL_Column = 77,                    /* Column  */
+  YYSYMBOL_78_ = 78,                       /* '-'  */
+  YYSYMBOL_LOWER_THAN_BRACE = 79,          /* LOWER_THAN_BRACE  */
+  YYSYMBOL_GR = 80,                        /* GR  */
+  YYSYMBOL_YYACCEPT = 81,                  /* $accept  */
+  YYSYMBOL_commands = 82,                  /* commands  */
+  YYSYMBOL_command = 83,                   /* command  */
+  YYSYMBOL_exit = 84,                      /* exit  */
+  YYSYMBOL_help = 85,                      /* help  */
+  YYSYMBOL_sync = 86,                      /* sync  */
+  YYSYMBOL_begin = 87,                     /* begin  */
+  YYSYMBOL_commit = 88,                    /* commit  */
+  YYSYMBOL_rollback = 89,                  /* rollback  */
+  YYSYMBOL_drop_table = 90,                /* drop_table  */
+  YYSYMBOL_show_tables = 91,               /* show_tables  */
+  YYSYMBOL_desc_table = 92,                /* desc_table  */
+  YYSYMBOL_analyze = 93,                   /* analyze  */
+  YYSYMBOL_create_index = 94,              /* create_index  */
+  YYSYMBOL_Column_list = 95,               /* Column_list  */
+  YYSYMBOL_Column_def = 96,                /* Column_def  */
+  YYSYMBOL_index_type_def = 97,            /* index_type_def  */
+  YYSYMBOL_include_def = 98,               /* include_def  */
+  YYSYMBOL_include_list = 99,              /* include_list  */
+  YYSYMBOL_include_attr = 100,             /* include_attr  */
+  YYSYMBOL_drop_index = 101,               /* drop_index  */
+  YYSYMBOL_create_table = 102,             /* create_table  */
+  YYSYMBOL_attr_def_list = 103,            /* attr_def_list  */
+  YYSYMBOL_attr_def = 104,                 /* attr_def  */
+  YYSYMBOL_opt_null = 105,                 /* opt_null  */
+  YYSYMBOL_number = 106,                   /* number  */
+  YYSYMBOL_type = 107,                     /* type  */
+  YYSYMBOL_ID_get = 108,                   /* ID_get  */
+  YYSYMBOL_insert = 109,                   /* insert  */
+  YYSYMBOL_multi_values = 110,             /* multi_values  */
+  YYSYMBOL_value_list = 111,               /* value_list  */
+  YYSYMBOL_value_with_neg = 112,           /* value_with_neg  */
+  YYSYMBOL_value = 113,                    /* value  */
+  YYSYMBOL_delete = 114,                   /* delete  */
+  YYSYMBOL_update = 115,                   /* update  */
+  YYSYMBOL_select = 116,                   /* select  */
+  YYSYMBOL_select_attr = 117,              /* select_attr  */
+  YYSYMBOL_select_param = 118,             /* select_param  */
+  YYSYMBOL_expression = 119,               /* expression  */
+  YYSYMBOL_exp_list = 120,                 /* exp_list  */
+  YYSYMBOL_lbrace = 121,                   /* lbrace  */
+  YYSYMBOL_rbrace = 122,                   /* rbrace  */
+  YYSYMBOL_exp = 123,                      /* exp  */
+  YYSYMBOL_minus = 124,                    /* minus  */
+  YYSYMBOL_op = 125,                       /* op  */
+  YYSYMBOL_id_type = 126,                  /* id_type  */
+  YYSYMBOL_attr_list = 127,                /* attr_list  */
+  YYSYMBOL_join_list = 128,                /* join_list  */
+  YYSYMBOL_window_function = 129,          /* window_function  */
+  YYSYMBOL_opt_star = 130,                 /* opt_star  */
+  YYSYMBOL_from_rel = 131,                 /* from_rel  */
+  YYSYMBOL_rel_list = 132,                 /* rel_list  */
+  YYSYMBOL_where = 133,                    /* where  */
+  YYSYMBOL_on = 134,                       /* on  */
+  YYSYMBOL_condition_list = 135,           /* condition_list  */
+  YYSYMBOL_condition = 136,                /* condition  */
+  YYSYMBOL_sub_comOp = 137,                /* sub_comOp  */
+  YYSYMBOL_comOp = 138,                    /* comOp  */
+  YYSYMBOL_sub_select = 139,               /* sub_select  */
+  YYSYMBOL_group_by = 140,                 /* group_by  */
+  YYSYMBOL_group_list = 141,               /* group_list  */
+  YYSYMBOL_order_by = 142,                 /* order_by  */
+  YYSYMBOL_limit = 143,                    /* limit  */
+  YYSYMBOL_sort_list = 144,                /* sort_list  */
+  YYSYMBOL_sort_attr = 145,                /* sort_attr  */
+  YYSYMBOL_opt_asc = 146,                  /* opt_asc  */
+  YYSYMBOL_load_data = 147                 /* load_data  */
 };
-typedef union YYSTYPE YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
-
-
-
-int yyparse (void *scanner);
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-#endif /* !YY_YY_YACC_SQL_TAB_H_INCLUDED  */
 
 
 
@@ -342,6 +370,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -401,6 +441,7 @@ typedef int yytype_uint16;
 
 #define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
+
 /* Stored state numbers (used for stacks). */
 typedef yytype_int16 yy_state_t;
 
@@ -419,6 +460,7 @@ typedef int yy_state_fast_t;
 # endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
 # if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
 #  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
@@ -437,17 +479,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -476,7 +524,7 @@ typedef int yy_state_fast_t;
 
 #define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -541,8 +589,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -607,25 +654,27 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  2
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   294
+#define YYLAST   320
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  74
+#define YYNTOKENS  81
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  61
+#define YYNNTS  67
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  143
+#define YYNRULES  157
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  282
+#define YYNSTATES  312
 
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   327
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   334
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
@@ -635,7 +684,7 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,    71,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,    78,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -663,336 +712,356 @@ static const yytype_int8 yytranslate[] =
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
       55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-      65,    66,    67,    68,    69,    70,    72,    73
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    77,    79,    80
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   203,   203,   205,   209,   210,   211,   212,   213,   214,
-     215,   216,   217,   218,   219,   220,   221,   222,   223,   224,
-     225,   229,   234,   239,   245,   251,   257,   263,   269,   275,
-     282,   288,   295,   297,   299,   300,   305,   312,   322,   324,
-     328,   339,   349,   352,   355,   361,   367,   371,   375,   379,
-     382,   387,   396,   413,   420,   428,   430,   436,   439,   442,
-     448,   454,   460,   465,   476,   488,   501,   525,   535,   545,
-     551,   559,   568,   577,   596,   597,   598,   599,   603,   609,
-     615,   616,   645,   651,   655,   659,   660,   667,   676,   685,
-     696,   698,   701,   703,   710,   718,   728,   738,   748,   758,
-     771,   772,   773,   777,   787,   788,   794,   798,   815,   817,
-     827,   829,   835,   841,   851,   865,   883,   891,   898,   899,
-     900,   901,   902,   903,   904,   905,   906,   907,   911,   932,
-     933,   942,   945,   965,   967,   972,   975,   978,   983,   988,
-     993,   999,  1001,  1004
+       0,   210,   210,   212,   216,   217,   218,   219,   220,   221,
+     222,   223,   224,   225,   226,   227,   228,   229,   230,   231,
+     232,   233,   237,   242,   247,   253,   259,   265,   271,   277,
+     283,   290,   294,   301,   311,   321,   323,   325,   326,   330,
+     332,   335,   339,   341,   343,   345,   348,   353,   360,   370,
+     372,   376,   387,   397,   400,   403,   409,   415,   419,   423,
+     427,   430,   435,   444,   461,   468,   476,   478,   484,   487,
+     490,   496,   502,   508,   513,   524,   536,   549,   573,   583,
+     593,   599,   607,   616,   625,   644,   645,   646,   647,   651,
+     657,   663,   664,   693,   699,   703,   707,   708,   715,   724,
+     733,   744,   746,   749,   751,   758,   766,   776,   786,   796,
+     806,   819,   820,   821,   825,   835,   836,   842,   846,   863,
+     865,   875,   877,   883,   889,   899,   913,   931,   939,   946,
+     947,   948,   949,   950,   951,   952,   953,   954,   955,   959,
+     980,   981,   990,   993,  1013,  1015,  1019,  1021,  1024,  1030,
+    1033,  1036,  1041,  1046,  1051,  1057,  1059,  1062
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "SEMICOLON", "CREATE", "DROP", "TABLE",
-  "TABLES", "INDEX", "SELECT", "DESC", "SHOW", "SYNC", "INSERT", "DELETE",
-  "UPDATE", "LBRACE", "RBRACE", "COMMA", "TRX_BEGIN", "TRX_COMMIT",
-  "TRX_ROLLBACK", "INT_T", "STRING_T", "FLOAT_T", "ORDER", "ASC", "BY",
-  "DATE_T", "UNIQUE", "HELP", "EXIT", "DOT", "INTO", "VALUES", "FROM",
-  "WHERE", "AND", "SET", "ON", "LOAD", "DATA", "INFILE", "NULLABLE",
-  "GROUP", "IS", "NOT", "EQ", "LT", "GT", "LE", "GE", "NE", "PLUS", "DIV",
-  "NULL_T", "INNER", "JOIN", "IN", "MINUS", "TEXT_T", "NUMBER", "FLOAT",
-  "ID", "PATH", "SSS", "STAR", "STRING_V", "COUNT", "OTHER_FUNCTION_TYPE",
-  "Column", "'-'", "LOWER_THAN_BRACE", "GR", "$accept", "commands",
-  "command", "exit", "help", "sync", "begin", "commit", "rollback",
-  "drop_table", "show_tables", "desc_table", "create_index", "Column_list",
-  "Column_def", "drop_index", "create_table", "attr_def_list", "attr_def",
-  "opt_null", "number", "type", "ID_get", "insert", "multi_values",
-  "value_list", "value_with_neg", "value", "delete", "update", "select",
-  "select_attr", "select_param", "expression", "exp_list", "lbrace",
-  "rbrace", "exp", "minus", "op", "id_type", "attr_list", "join_list",
-  "window_function", "opt_star", "from_rel", "rel_list", "where", "on",
-  "condition_list", "condition", "sub_comOp", "comOp", "sub_select",
-  "group_by", "group_list", "order_by", "sort_list", "sort_attr",
-  "opt_asc", "load_data", YY_NULLPTR
+  "\"end of file\"", "error", "\"invalid token\"", "SEMICOLON", "CREATE",
+  "DROP", "TABLE", "TABLES", "INDEX", "SELECT", "DESC", "SHOW", "SYNC",
+  "INSERT", "DELETE", "UPDATE", "LBRACE", "RBRACE", "COMMA", "TRX_BEGIN",
+  "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "STRING_T", "FLOAT_T", "ORDER",
+  "ASC", "BY", "DATE_T", "UNIQUE", "HELP", "EXIT", "DOT", "INTO", "VALUES",
+  "FROM", "WHERE", "AND", "SET", "ON", "LOAD", "DATA", "INFILE",
+  "NULLABLE", "GROUP", "IS", "NOT", "EQ", "LT", "GT", "LE", "GE", "NE",
+  "PLUS", "DIV", "NULL_T", "INNER", "JOIN", "IN", "MINUS", "TEXT_T",
+  "INCLUDE", "USING", "HASH", "ANALYZE", "BITMAP", "LIMIT", "OFFSET",
+  "NUMBER", "FLOAT", "ID", "PATH", "SSS", "STAR", "STRING_V", "COUNT",
+  "OTHER_FUNCTION_TYPE", "Column", "'-'", "LOWER_THAN_BRACE", "GR",
+  "$accept", "commands", "command", "exit", "help", "sync", "begin",
+  "commit", "rollback", "drop_table", "show_tables", "desc_table",
+  "analyze", "create_index", "Column_list", "Column_def", "index_type_def",
+  "include_def", "include_list", "include_attr", "drop_index",
+  "create_table", "attr_def_list", "attr_def", "opt_null", "number",
+  "type", "ID_get", "insert", "multi_values", "value_list",
+  "value_with_neg", "value", "delete", "update", "select", "select_attr",
+  "select_param", "expression", "exp_list", "lbrace", "rbrace", "exp",
+  "minus", "op", "id_type", "attr_list", "join_list", "window_function",
+  "opt_star", "from_rel", "rel_list", "where", "on", "condition_list",
+  "condition", "sub_comOp", "comOp", "sub_select", "group_by",
+  "group_list", "order_by", "limit", "sort_list", "sort_attr", "opt_asc",
+  "load_data", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312,   313,   314,
-     315,   316,   317,   318,   319,   320,   321,   322,   323,   324,
-     325,    45,   326,   327
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF (-213)
+#define YYPACT_NINF (-222)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-68)
+#define YYTABLE_NINF (-79)
 
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-    -213,   160,  -213,    14,    50,    31,   -40,    30,    54,    -5,
-      27,    18,   124,   125,   128,   132,   136,   102,  -213,  -213,
-    -213,  -213,  -213,  -213,  -213,  -213,  -213,  -213,  -213,  -213,
-    -213,  -213,  -213,  -213,  -213,  -213,   100,   104,   170,   120,
-     121,  -213,  -213,  -213,  -213,  -213,  -213,  -213,   153,  -213,
-     151,   171,   177,  -213,   164,   184,  -213,  -213,    48,   123,
-    -213,    43,  -213,  -213,   202,   203,  -213,   145,   146,   172,
-    -213,  -213,  -213,  -213,  -213,   169,   196,   174,   152,   211,
-     213,   -18,   -45,   154,   155,   163,    79,  -213,   123,  -213,
-    -213,   133,   123,  -213,  -213,  -213,   186,   185,   159,   158,
-     145,   161,   187,  -213,  -213,  -213,  -213,  -213,   193,  -213,
-     210,    12,   212,   175,   185,   184,   214,   123,    48,  -213,
-     217,    10,   225,   182,   201,   218,    -9,   219,   176,   -11,
-    -213,  -213,    25,   178,  -213,   179,   194,  -213,  -213,   123,
-     214,   214,   142,    21,   228,    71,   206,    71,  -213,   142,
-     234,   145,   227,  -213,  -213,  -213,  -213,  -213,    -8,   183,
-     229,   230,   231,   232,   233,   212,   215,   224,   235,  -213,
-     123,   123,   237,  -213,    40,  -213,   236,    31,   207,   198,
-    -213,  -213,  -213,  -213,  -213,  -213,  -213,    10,  -213,    10,
-    -213,    91,   185,   195,   218,   254,   200,  -213,   204,  -213,
-    -213,   244,   183,  -213,  -213,  -213,  -213,  -213,    10,   163,
-      96,   238,   260,  -213,  -213,   142,   247,  -213,  -213,   142,
-     164,  -213,  -213,  -213,  -213,   206,   228,  -213,  -213,  -213,
-     263,   264,  -213,  -213,  -213,   251,  -213,   183,   252,   244,
-     206,  -213,  -213,   253,   209,  -213,   237,  -213,   237,   185,
-    -213,  -213,  -213,    34,   244,   267,   256,  -213,    96,    -1,
-     257,  -213,  -213,   259,   261,  -213,  -213,  -213,   271,  -213,
-    -213,  -213,   216,  -213,   209,  -213,  -213,  -213,     7,  -213,
-    -213,  -213
+    -222,     9,  -222,    38,    42,    39,   -39,    54,   103,    41,
+      92,    69,   142,   147,   148,   149,   150,   113,     2,  -222,
+    -222,  -222,  -222,  -222,  -222,  -222,  -222,  -222,  -222,  -222,
+    -222,  -222,  -222,  -222,  -222,  -222,  -222,  -222,    85,    89,
+     154,    98,    99,  -222,  -222,  -222,  -222,  -222,  -222,  -222,
+     138,  -222,   140,   157,   158,  -222,   141,   159,  -222,  -222,
+      66,    71,  -222,   -10,  -222,  -222,   175,   180,  -222,   119,
+     120,   153,  -222,  -222,  -222,  -222,  -222,   151,   125,   193,
+     181,   160,   146,   207,   209,    30,    -4,   156,   162,   171,
+      88,  -222,    71,  -222,  -222,   139,    71,  -222,  -222,  -222,
+     194,   179,   163,   164,   226,  -222,   119,   165,   191,  -222,
+    -222,  -222,  -222,  -222,   202,  -222,   220,    19,   221,   183,
+     179,   159,   224,    71,    66,  -222,   222,   112,   239,   196,
+     211,  -222,   227,    62,   230,   177,    32,  -222,  -222,    40,
+     178,  -222,   182,   205,  -222,  -222,    71,   224,   224,   145,
+      34,   241,   173,   214,   173,  -222,   145,   247,   119,   237,
+    -222,  -222,  -222,  -222,  -222,    11,   185,   240,   242,   243,
+     244,   245,   221,   218,   231,   238,  -222,    71,    71,   246,
+    -222,    49,  -222,   249,    39,   223,   208,  -222,  -222,  -222,
+    -222,  -222,  -222,  -222,   112,  -222,   112,  -222,    27,   179,
+     197,   227,   265,   203,  -222,   215,  -222,  -222,   254,   185,
+    -222,  -222,  -222,  -222,  -222,   112,   171,   133,   248,   210,
+    -222,  -222,   145,   256,  -222,  -222,   145,   141,  -222,  -222,
+    -222,  -222,   214,   241,  -222,  -222,  -222,   271,   274,  -222,
+    -222,  -222,   261,  -222,   185,   262,   254,   214,  -222,  -222,
+     263,   212,   216,   277,   246,  -222,   246,   179,  -222,  -222,
+    -222,    80,   254,   225,   266,  -222,   133,     0,   267,  -222,
+     219,  -222,  -222,   272,   273,  -222,  -222,    15,   232,   225,
+    -222,  -222,  -222,   228,  -222,   212,   229,  -222,  -222,  -222,
+    -222,   275,   179,   232,     7,  -222,  -222,   233,   285,   179,
+    -222,  -222,  -222,   276,  -222,   289,   233,   278,  -222,   276,
+    -222,  -222
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
 static const yytype_uint8 yydefact[] =
 {
-       2,     0,     1,     0,     0,    74,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     3,    20,
-      19,    14,    15,    16,    17,     9,    10,    11,    12,    13,
-       8,     5,     7,     6,     4,    18,     0,     0,     0,     0,
-       0,    78,    84,    86,    62,    82,    60,    61,    87,    63,
-      83,     0,     0,    81,     0,    90,    70,    72,     0,    74,
-      85,     0,    80,    69,     0,     0,    23,     0,     0,     0,
-      24,    25,    26,    22,    21,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,    92,    74,    68,    74,    83,
-      71,     0,    74,    29,    28,    51,     0,   106,     0,     0,
-       0,     0,     0,    27,    36,    88,    89,   101,   102,   100,
-       0,     0,   104,     0,   106,    90,     0,    74,     0,    76,
-       0,    74,     0,     0,     0,    38,     0,     0,     0,     0,
-      94,    97,     0,     0,   103,     0,   129,    91,    79,    74,
-       0,     0,     0,     0,    78,     0,   110,     0,    64,     0,
-       0,     0,     0,    46,    47,    48,    49,    50,    42,    34,
-       0,     0,     0,     0,     0,   104,   108,     0,   133,    73,
-      74,    74,    55,    57,     0,    52,     0,    74,   126,     0,
-     118,   119,   120,   121,   122,   123,   124,    74,   117,    74,
-     107,     0,   106,     0,    38,     0,     0,    44,     0,    41,
-      35,    32,    34,    95,    96,    98,    99,   105,    74,    92,
-      74,     0,     0,    75,    77,     0,     0,    58,    59,     0,
-       0,   127,   125,   112,   113,   110,     0,   114,   115,   116,
-       0,     0,    39,    37,    45,     0,    43,    34,     0,    32,
-     110,    93,   131,   130,     0,    66,    55,    53,    55,   106,
-     111,    65,   143,    42,    32,     0,     0,   109,    74,   141,
-     134,   135,    56,     0,     0,    40,    33,    30,     0,   132,
-     138,   142,     0,   137,     0,    54,   128,    31,   141,   136,
-     140,   139
+       2,     0,     1,     0,     0,    85,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     3,
+      21,    20,    14,    15,    16,    17,     9,    10,    11,    19,
+      12,    13,     8,     5,     7,     6,     4,    18,     0,     0,
+       0,     0,     0,    89,    95,    97,    73,    93,    71,    72,
+      98,    74,    94,     0,     0,    92,     0,   101,    81,    83,
+       0,    85,    96,     0,    91,    80,     0,     0,    24,     0,
+       0,     0,    25,    26,    27,    23,    22,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,   103,
+      85,    79,    85,    94,    82,     0,    85,    30,    29,    62,
+       0,   117,     0,     0,     0,    31,     0,     0,     0,    28,
+      47,    99,   100,   112,   113,   111,     0,     0,   115,     0,
+     117,   101,     0,    85,     0,    87,     0,    85,     0,     0,
+       0,    32,    49,     0,     0,     0,     0,   105,   108,     0,
+       0,   114,     0,   140,   102,    90,    85,     0,     0,     0,
+       0,    89,     0,   121,     0,    75,     0,     0,     0,     0,
+      57,    58,    59,    60,    61,    53,    37,     0,     0,     0,
+       0,     0,   115,   119,     0,   144,    84,    85,    85,    66,
+      68,     0,    63,     0,    85,   137,     0,   129,   130,   131,
+     132,   133,   134,   135,    85,   128,    85,   118,     0,   117,
+       0,    49,     0,     0,    55,     0,    52,    38,    35,    37,
+     106,   107,   109,   110,   116,    85,   103,    85,     0,   146,
+      86,    88,     0,     0,    69,    70,     0,     0,   138,   136,
+     123,   124,   121,     0,   125,   126,   127,     0,     0,    50,
+      48,    56,     0,    54,    37,     0,    35,   121,   104,   142,
+     141,     0,     0,     0,    66,    64,    66,   117,   122,    76,
+     157,    53,    35,    39,     0,   120,    85,   155,   145,   149,
+     147,    77,    67,     0,     0,    51,    36,     0,    42,    39,
+     143,   152,   156,     0,   151,     0,     0,    65,   139,    40,
+      41,     0,   117,    42,   155,   150,   148,     0,     0,   117,
+     154,   153,    46,    44,    33,     0,     0,     0,    34,    44,
+      43,    45
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -213,  -213,  -213,  -213,  -213,  -213,  -213,  -213,  -213,  -213,
-    -213,  -213,  -213,  -212,  -196,  -213,  -213,    83,   129,    28,
-    -213,  -213,   220,  -213,  -213,   -80,  -145,  -137,  -213,  -213,
-    -213,   105,   197,  -121,   -56,   223,   -16,   -51,   -89,  -213,
-      94,   173,    77,  -213,  -213,    69,   126,  -113,  -213,  -191,
-    -178,   143,  -213,  -141,  -213,  -213,  -213,  -213,    19,    16,
-    -213
+    -222,  -222,  -222,  -222,  -222,  -222,  -222,  -222,  -222,  -222,
+    -222,  -222,  -222,  -222,  -221,  -202,    17,     6,    -9,    -5,
+    -222,  -222,   101,   152,    43,  -222,  -222,   236,  -222,  -222,
+    -108,  -151,  -145,  -222,  -222,  -222,   122,   217,  -126,   -58,
+     250,   -16,   -48,   -93,  -222,   110,   188,    95,  -222,  -222,
+      87,   143,  -120,  -222,  -131,  -180,   166,  -222,  -111,  -222,
+    -222,  -222,  -222,  -222,    31,    18,  -222
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
+/* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int16 yydefgoto[] =
 {
-      -1,     1,    18,    19,    20,    21,    22,    23,    24,    25,
-      26,    27,    28,   238,   201,    29,    30,   152,   125,   199,
-     235,   158,   126,    31,   143,   216,   172,    53,    32,    33,
-      34,    54,    55,    56,    57,    58,   139,    59,    60,    61,
-      62,    87,   114,    63,   110,    85,   134,   122,   209,   190,
-     146,   187,   188,   147,   168,   243,   212,   260,   261,   273,
-      35
+       0,     1,    19,    20,    21,    22,    23,    24,    25,    26,
+      27,    28,    29,    30,   245,   208,   278,   292,   307,   303,
+      31,    32,   159,   132,   206,   242,   165,   133,    33,   150,
+     223,   179,    55,    34,    35,    36,    56,    57,    58,    59,
+      60,   146,    61,    62,    63,    64,    91,   120,    65,   116,
+      89,   141,   128,   216,   197,   153,   194,   195,   154,   175,
+     250,   219,   253,   268,   269,   284,    37
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-     145,   136,   118,    90,   192,   173,   239,    88,   196,   270,
-      92,   225,   173,   153,   154,   155,   107,   280,   108,   156,
-      36,   109,    37,    64,   175,   271,   144,   256,    67,   131,
-     240,   272,   116,   271,   250,   197,   119,    65,   198,   176,
-     117,   254,   266,    38,   132,   105,   224,    41,   106,   257,
-     229,   157,   161,   174,   227,   162,    39,    66,    40,    41,
-     174,   140,    68,    42,    43,    44,   223,   141,   145,    45,
-     246,    46,    47,    48,   248,    49,    89,   197,   173,   230,
-     198,    69,   173,   169,    42,    43,    44,   145,   163,   242,
-      45,   164,    46,    47,    48,    41,    49,    50,    44,    51,
-      52,   217,   218,    44,    46,    47,    48,   226,    49,    46,
-      47,    48,    41,    49,   213,   214,   178,   179,   180,   181,
-     182,   183,   184,   185,   170,   171,   174,    70,    71,   186,
-     174,    72,    42,    43,    44,    73,   264,   269,    45,    74,
-      46,    47,    48,    75,    49,    89,    44,    51,    52,    42,
-      43,    44,    46,    47,    48,    45,    49,    46,    47,    48,
-       2,    49,    89,    76,     3,     4,   262,    77,   263,     5,
-       6,     7,     8,     9,    10,    11,    42,    43,    78,    12,
-      13,    14,    45,    79,    80,    81,   -67,    82,    44,    89,
-      15,    16,    45,    83,    46,    47,    48,    44,    49,    84,
-      17,    45,    86,    46,    47,    93,    94,    49,    95,    97,
-      98,    99,   100,   101,   103,   102,   104,   111,   112,   113,
-     120,   121,   123,   124,   127,   129,   128,   130,   148,   149,
-     133,   138,   135,   142,   150,   159,   151,   177,   167,   160,
-     193,   165,   166,   189,   195,   202,   200,   203,   204,   205,
-     206,   210,   219,   221,   208,   215,   222,   233,   231,   236,
-     211,   234,   237,   245,   247,   244,   251,   252,   253,   255,
-     267,   258,   259,   268,   277,   274,   275,   232,   276,   278,
-     194,   265,   220,   115,    91,   228,   241,    96,   137,   249,
-     191,   207,     0,   279,   281
+     143,   152,   124,    94,   180,   199,    43,   246,    78,     2,
+     281,   180,    92,     3,     4,    96,   232,   300,     5,     6,
+       7,     8,     9,    10,    11,   264,   282,   203,    12,    13,
+      14,    66,   283,   282,   122,   247,   138,   182,   125,    15,
+      16,   276,   262,   233,    38,    46,    39,   123,    41,    17,
+      42,   139,   183,   234,   204,    43,   181,   205,    48,    49,
+      50,    67,    51,   181,   113,   147,   114,    40,   230,   115,
+     152,   254,    79,    18,    69,   256,   148,   180,   289,   237,
+     290,   180,    46,   231,   160,   161,   162,   236,   176,   152,
+     163,   249,    44,    45,    46,    48,    49,    50,    47,    51,
+     111,   258,   168,   112,    43,   169,    68,    48,    49,    50,
+     170,    51,    52,   171,    53,    54,   265,   224,   225,   220,
+     221,    46,   164,   204,    44,    45,   205,    70,   151,   181,
+      47,   177,   178,   181,    48,    49,    50,   274,    51,    71,
+     280,    44,    45,    46,    93,    72,   272,    47,   273,    43,
+      73,    74,    75,    76,    77,    80,    48,    49,    50,    81,
+      51,    93,    82,    53,    54,    44,    45,    46,    83,    84,
+      85,    47,   298,    86,    87,   -78,    88,    90,    97,   305,
+      48,    49,    50,    98,    51,    93,    44,    45,    46,    99,
+     101,   102,    47,   103,    46,   104,   105,   106,    47,   107,
+      46,    48,    49,    50,    47,    51,    93,    48,    49,    50,
+     109,    51,   110,    48,    49,   127,   108,    51,   185,   186,
+     187,   188,   189,   190,   191,   192,   117,   119,   126,   131,
+     135,   193,   118,   129,   136,   134,   130,   137,   149,   140,
+     142,   145,   155,   156,   157,   158,   166,   167,   172,   174,
+     184,   196,   173,   200,   202,   207,   209,   215,   217,   210,
+     211,   212,   213,   218,   222,   226,   229,   238,   240,   228,
+     243,   241,   244,   255,   259,   251,   252,   260,   261,   263,
+     271,   266,   267,   279,   270,   285,   286,   277,   304,   287,
+     288,   297,   308,   291,   306,   310,   293,   296,   294,   299,
+     311,   309,   239,   302,   275,   100,   227,   121,   235,   144,
+     201,   248,   301,    95,   257,   214,   295,     0,     0,     0,
+     198
 };
 
 static const yytype_int16 yycheck[] =
 {
-     121,   114,    91,    59,   149,   142,   202,    58,    16,    10,
-      61,   189,   149,    22,    23,    24,    61,    10,    63,    28,
-       6,    66,     8,    63,     3,    26,    16,   239,    33,    17,
-     208,    32,    88,    26,   225,    43,    92,     7,    46,    18,
-      91,   237,   254,    29,    32,    63,   187,    16,    66,   240,
-     191,    60,    63,   142,   191,    66,     6,     3,     8,    16,
-     149,   117,    35,    53,    54,    55,   187,   118,   189,    59,
-     215,    61,    62,    63,   219,    65,    66,    43,   215,   192,
-      46,    63,   219,   139,    53,    54,    55,   208,    63,   210,
-      59,    66,    61,    62,    63,    16,    65,    66,    55,    68,
-      69,    61,    62,    55,    61,    62,    63,    16,    65,    61,
-      62,    63,    16,    65,   170,   171,    45,    46,    47,    48,
-      49,    50,    51,    52,   140,   141,   215,     3,     3,    58,
-     219,     3,    53,    54,    55,     3,   249,   258,    59,     3,
-      61,    62,    63,    41,    65,    66,    55,    68,    69,    53,
-      54,    55,    61,    62,    63,    59,    65,    61,    62,    63,
-       0,    65,    66,    63,     4,     5,   246,    63,   248,     9,
-      10,    11,    12,    13,    14,    15,    53,    54,     8,    19,
-      20,    21,    59,    63,    63,    32,    35,    16,    55,    66,
-      30,    31,    59,    16,    61,    62,    63,    55,    65,    35,
-      40,    59,    18,    61,    62,     3,     3,    65,    63,    63,
-      38,    42,    16,    39,     3,    63,     3,    63,    63,    56,
-      34,    36,    63,    65,    63,    32,    39,    17,     3,    47,
-      18,    17,    57,    16,    33,    16,    18,     9,    44,    63,
-       6,    63,    63,    37,    17,    16,    63,    17,    17,    17,
-      17,    27,    16,    46,    39,    18,    58,     3,    63,    55,
-      25,    61,    18,     3,    17,    27,     3,     3,    17,    17,
-       3,    18,    63,    17,     3,    18,    17,   194,    17,    63,
-     151,   253,   177,    86,    61,   191,   209,    67,   115,   220,
-     147,   165,    -1,   274,   278
+     120,   127,    95,    61,   149,   156,    16,   209,     6,     0,
+      10,   156,    60,     4,     5,    63,   196,    10,     9,    10,
+      11,    12,    13,    14,    15,   246,    26,    16,    19,    20,
+      21,    70,    32,    26,    92,   215,    17,     3,    96,    30,
+      31,   262,   244,    16,     6,    55,     8,    95,     6,    40,
+       8,    32,    18,   198,    43,    16,   149,    46,    68,    69,
+      70,     7,    72,   156,    68,   123,    70,    29,   194,    73,
+     196,   222,    70,    64,    33,   226,   124,   222,    63,   199,
+      65,   226,    55,   194,    22,    23,    24,   198,   146,   215,
+      28,   217,    53,    54,    55,    68,    69,    70,    59,    72,
+      70,   232,    70,    73,    16,    73,     3,    68,    69,    70,
+      70,    72,    73,    73,    75,    76,   247,    68,    69,   177,
+     178,    55,    60,    43,    53,    54,    46,    35,    16,   222,
+      59,   147,   148,   226,    68,    69,    70,   257,    72,    70,
+     266,    53,    54,    55,    73,     3,   254,    59,   256,    16,
+       3,     3,     3,     3,    41,    70,    68,    69,    70,    70,
+      72,    73,     8,    75,    76,    53,    54,    55,    70,    70,
+      32,    59,   292,    16,    16,    35,    35,    18,     3,   299,
+      68,    69,    70,     3,    72,    73,    53,    54,    55,    70,
+      70,    38,    59,    42,    55,    70,     3,    16,    59,    39,
+      55,    68,    69,    70,    59,    72,    73,    68,    69,    70,
+       3,    72,     3,    68,    69,    36,    70,    72,    45,    46,
+      47,    48,    49,    50,    51,    52,    70,    56,    34,     3,
+      39,    58,    70,    70,    32,    70,    72,    17,    16,    18,
+      57,    17,     3,    47,    33,    18,    16,    70,    70,    44,
+       9,    37,    70,     6,    17,    70,    16,    39,    27,    17,
+      17,    17,    17,    25,    18,    16,    58,    70,     3,    46,
+      55,    68,    18,    17,     3,    27,    66,     3,    17,    17,
+       3,    18,    70,    17,    68,    18,    67,    62,     3,    17,
+      17,    16,     3,    61,    18,    17,   279,    68,    70,   293,
+     309,   306,   201,    70,   261,    69,   184,    90,   198,   121,
+     158,   216,   294,    63,   227,   172,   285,    -1,    -1,    -1,
+     154
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
 static const yytype_uint8 yystos[] =
 {
-       0,    75,     0,     4,     5,     9,    10,    11,    12,    13,
-      14,    15,    19,    20,    21,    30,    31,    40,    76,    77,
-      78,    79,    80,    81,    82,    83,    84,    85,    86,    89,
-      90,    97,   102,   103,   104,   134,     6,     8,    29,     6,
-       8,    16,    53,    54,    55,    59,    61,    62,    63,    65,
-      66,    68,    69,   101,   105,   106,   107,   108,   109,   111,
-     112,   113,   114,   117,    63,     7,     3,    33,    35,    63,
-       3,     3,     3,     3,     3,    41,    63,    63,     8,    63,
-      63,    32,    16,    16,    35,   119,    18,   115,   111,    66,
-     108,   109,   111,     3,     3,    63,    96,    63,    38,    42,
-      16,    39,    63,     3,     3,    63,    66,    61,    63,    66,
-     118,    63,    63,    56,   116,   106,   108,   111,   112,   108,
-      34,    36,   121,    63,    65,    92,    96,    63,    39,    32,
-      17,    17,    32,    18,   120,    57,   121,   115,    17,   110,
-     108,   111,    16,    98,    16,   107,   124,   127,     3,    47,
-      33,    18,    91,    22,    23,    24,    28,    60,    95,    16,
-      63,    63,    66,    63,    66,    63,    63,    44,   128,   108,
-     110,   110,   100,   101,   112,     3,    18,     9,    45,    46,
-      47,    48,    49,    50,    51,    52,    58,   125,   126,    37,
-     123,   125,   100,     6,    92,    17,    16,    43,    46,    93,
-      63,    88,    16,    17,    17,    17,    17,   120,    39,   122,
-      27,    25,   130,   108,   108,    18,    99,    61,    62,    16,
-     105,    46,    58,   107,   127,   124,    16,   101,   114,   127,
-     121,    63,    91,     3,    61,    94,    55,    18,    87,    88,
-     124,   116,   107,   129,    27,     3,   100,    17,   100,   119,
-     123,     3,     3,    17,    88,    17,    87,   123,    18,    63,
-     131,   132,    99,    99,   121,    93,    87,     3,    17,   107,
-      10,    26,    32,   133,    18,    17,    17,     3,    63,   132,
-      10,   133
+       0,    82,     0,     4,     5,     9,    10,    11,    12,    13,
+      14,    15,    19,    20,    21,    30,    31,    40,    64,    83,
+      84,    85,    86,    87,    88,    89,    90,    91,    92,    93,
+      94,   101,   102,   109,   114,   115,   116,   147,     6,     8,
+      29,     6,     8,    16,    53,    54,    55,    59,    68,    69,
+      70,    72,    73,    75,    76,   113,   117,   118,   119,   120,
+     121,   123,   124,   125,   126,   129,    70,     7,     3,    33,
+      35,    70,     3,     3,     3,     3,     3,    41,     6,    70,
+      70,    70,     8,    70,    70,    32,    16,    16,    35,   131,
+      18,   127,   123,    73,   120,   121,   123,     3,     3,    70,
+     108,    70,    38,    42,    70,     3,    16,    39,    70,     3,
+       3,    70,    73,    68,    70,    73,   130,    70,    70,    56,
+     128,   118,   120,   123,   124,   120,    34,    36,   133,    70,
+      72,     3,   104,   108,    70,    39,    32,    17,    17,    32,
+      18,   132,    57,   133,   127,    17,   122,   120,   123,    16,
+     110,    16,   119,   136,   139,     3,    47,    33,    18,   103,
+      22,    23,    24,    28,    60,   107,    16,    70,    70,    73,
+      70,    73,    70,    70,    44,   140,   120,   122,   122,   112,
+     113,   124,     3,    18,     9,    45,    46,    47,    48,    49,
+      50,    51,    52,    58,   137,   138,    37,   135,   137,   112,
+       6,   104,    17,    16,    43,    46,   105,    70,    96,    16,
+      17,    17,    17,    17,   132,    39,   134,    27,    25,   142,
+     120,   120,    18,   111,    68,    69,    16,   117,    46,    58,
+     119,   139,   136,    16,   113,   126,   139,   133,    70,   103,
+       3,    68,   106,    55,    18,    95,    96,   136,   128,   119,
+     141,    27,    66,   143,   112,    17,   112,   131,   135,     3,
+       3,    17,    96,    17,    95,   135,    18,    70,   144,   145,
+      68,     3,   111,   111,   133,   105,    95,    62,    97,    17,
+     119,    10,    26,    32,   146,    18,    67,    17,    17,    63,
+      65,    61,    98,    97,    70,   145,    68,    16,   133,    98,
+      10,   146,    70,   100,     3,   133,    18,    99,     3,   100,
+      17,    99
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_uint8 yyr1[] =
 {
-       0,    74,    75,    75,    76,    76,    76,    76,    76,    76,
-      76,    76,    76,    76,    76,    76,    76,    76,    76,    76,
-      76,    77,    78,    79,    80,    81,    82,    83,    84,    85,
-      86,    86,    87,    87,    88,    88,    89,    90,    91,    91,
-      92,    92,    93,    93,    93,    94,    95,    95,    95,    95,
-      95,    96,    97,    98,    98,    99,    99,   100,   100,   100,
-     101,   101,   101,   101,   102,   103,   104,   105,   105,   106,
-     106,   107,   107,   107,   108,   108,   108,   108,   109,   110,
-     111,   111,   112,   113,   113,   113,   113,   114,   114,   114,
-     115,   115,   116,   116,   117,   117,   117,   117,   117,   117,
-     118,   118,   118,   119,   120,   120,   121,   121,   122,   122,
-     123,   123,   124,   124,   124,   124,   124,   125,   126,   126,
-     126,   126,   126,   126,   126,   126,   126,   126,   127,   128,
-     128,   129,   129,   130,   130,   131,   131,   132,   132,   132,
-     132,   133,   133,   134
+       0,    81,    82,    82,    83,    83,    83,    83,    83,    83,
+      83,    83,    83,    83,    83,    83,    83,    83,    83,    83,
+      83,    83,    84,    85,    86,    87,    88,    89,    90,    91,
+      92,    93,    93,    94,    94,    95,    95,    96,    96,    97,
+      97,    97,    98,    98,    99,    99,   100,   101,   102,   103,
+     103,   104,   104,   105,   105,   105,   106,   107,   107,   107,
+     107,   107,   108,   109,   110,   110,   111,   111,   112,   112,
+     112,   113,   113,   113,   113,   114,   115,   116,   117,   117,
+     118,   118,   119,   119,   119,   120,   120,   120,   120,   121,
+     122,   123,   123,   124,   125,   125,   125,   125,   126,   126,
+     126,   127,   127,   128,   128,   129,   129,   129,   129,   129,
+     129,   130,   130,   130,   131,   132,   132,   133,   133,   134,
+     134,   135,   135,   136,   136,   136,   136,   136,   137,   138,
+     138,   138,   138,   138,   138,   138,   138,   138,   138,   139,
+     140,   140,   141,   141,   142,   142,   143,   143,   143,   144,
+     144,   145,   145,   145,   145,   146,   146,   147
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     0,     2,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     2,     2,     2,     2,     2,     2,     4,     3,     3,
-      10,    11,     0,     3,     0,     1,     4,     8,     0,     3,
-       6,     3,     0,     2,     1,     1,     1,     1,     1,     1,
-       1,     1,     6,     4,     6,     0,     3,     1,     2,     2,
-       1,     1,     1,     1,     5,     8,     8,     1,     2,     1,
-       1,     2,     1,     5,     0,     6,     3,     6,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     3,     3,
-       0,     3,     0,     5,     4,     6,     6,     4,     6,     6,
-       1,     1,     1,     3,     0,     3,     0,     3,     0,     3,
-       0,     3,     3,     3,     3,     3,     3,     1,     1,     1,
-       1,     1,     1,     1,     1,     2,     1,     2,     6,     0,
-       3,     1,     3,     0,     3,     1,     3,     2,     2,     4,
-       4,     0,     1,     8
+       1,     1,     2,     2,     2,     2,     2,     2,     4,     3,
+       3,     3,     4,    13,    14,     0,     3,     0,     1,     0,
+       2,     2,     0,     5,     0,     3,     1,     4,     8,     0,
+       3,     6,     3,     0,     2,     1,     1,     1,     1,     1,
+       1,     1,     1,     6,     4,     6,     0,     3,     1,     2,
+       2,     1,     1,     1,     1,     5,     8,     9,     1,     2,
+       1,     1,     2,     1,     5,     0,     6,     3,     6,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     3,
+       3,     0,     3,     0,     5,     4,     6,     6,     4,     6,
+       6,     1,     1,     1,     3,     0,     3,     0,     3,     0,
+       3,     0,     3,     3,     3,     3,     3,     3,     1,     1,
+       1,     1,     1,     1,     1,     1,     2,     1,     2,     6,
+       0,     3,     1,     3,     0,     3,     0,     2,     4,     1,
+       3,     2,     2,     4,     4,     0,     1,     8
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -1014,10 +1083,9 @@ static const yytype_int8 yyr2[] =
       }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 
 /* Enable debugging if requested.  */
@@ -1034,19 +1102,16 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, scanner); \
+                  Kind, Value, scanner); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -1057,19 +1122,16 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, void *scanner)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
-  YYUSE (scanner);
+  YY_USE (yyoutput);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yytype], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -1079,12 +1141,13 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, vo
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, void *scanner)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner)
 {
   YYFPRINTF (yyo, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyo, yytype, yyvaluep, scanner);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, scanner);
   YYFPRINTF (yyo, ")");
 }
 
@@ -1117,7 +1180,8 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule, void *scanner)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, void *scanner)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1129,9 +1193,8 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule, void *scanner)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[+yyssp[yyi + 1 - yynrhs]],
-                       &yyvsp[(yyi + 1) - (yynrhs)]
-                                              , scanner);
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1146,8 +1209,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1170,259 +1233,34 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
-#  else
-/* Return the length of YYSTR.  */
-static YYPTRDIFF_T
-yystrlen (const char *yystr)
-{
-  YYPTRDIFF_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
 
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
 
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYPTRDIFF_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYPTRDIFF_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            else
-              goto append;
-
-          append:
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
-
-  if (yyres)
-    return yystpcpy (yyres, yystr) - yyres;
-  else
-    return yystrlen (yystr);
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
-                yy_state_t *yyssp, int yytoken)
-{
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Actual size of YYARG. */
-  int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[+*yyssp];
-      YYPTRDIFF_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-      yysize = yysize0;
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYPTRDIFF_T yysize1
-                    = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-                    yysize = yysize1;
-                  else
-                    return 2;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-    default: /* Avoid compiler warnings. */
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
-
-  {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen (yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
-  }
-
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
-
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          ++yyp;
-          ++yyformat;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, void *scanner)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, void *scanner)
 {
-  YYUSE (yyvaluep);
-  YYUSE (scanner);
+  YY_USE (yyvaluep);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1430,7 +1268,7 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, void *scanner)
 int
 yyparse (void *scanner)
 {
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 
@@ -1441,45 +1279,38 @@ YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
 YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
 
     /* Number of syntax errors so far.  */
-    int yynerrs;
+    int yynerrs = 0;
 
-    yy_state_fast_t yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
     yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss;
-    yy_state_t *yyssp;
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
-
-    YYPTRDIFF_T yystacksize;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1487,16 +1318,10 @@ YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
 
@@ -1518,10 +1343,11 @@ yysetstate:
   YY_IGNORE_USELESS_CAST_BEGIN
   *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1549,7 +1375,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1560,10 +1386,10 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
-# undef YYSTACK_RELOCATE
+#  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
@@ -1582,6 +1408,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1602,18 +1429,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex (&yylval, scanner);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1682,125 +1520,186 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-  case 21:
-#line 229 "yacc_sql.y"
+  case 22: /* exit: EXIT SEMICOLON  */
+#line 237 "yacc_sql.y"
                    {
         CONTEXT->ssql->flag=SCF_EXIT;//"exit";
     }
-#line 1691 "yacc_sql.tab.c"
+#line 1529 "yacc_sql.tab.c"
     break;
 
-  case 22:
-#line 234 "yacc_sql.y"
+  case 23: /* help: HELP SEMICOLON  */
+#line 242 "yacc_sql.y"
                    {
         CONTEXT->ssql->flag=SCF_HELP;//"help";
     }
-#line 1699 "yacc_sql.tab.c"
+#line 1537 "yacc_sql.tab.c"
     break;
 
-  case 23:
-#line 239 "yacc_sql.y"
+  case 24: /* sync: SYNC SEMICOLON  */
+#line 247 "yacc_sql.y"
                    {
       CONTEXT->ssql->flag = SCF_SYNC;
     }
-#line 1707 "yacc_sql.tab.c"
+#line 1545 "yacc_sql.tab.c"
     break;
 
-  case 24:
-#line 245 "yacc_sql.y"
+  case 25: /* begin: TRX_BEGIN SEMICOLON  */
+#line 253 "yacc_sql.y"
                         {
       CONTEXT->ssql->flag = SCF_BEGIN;
     }
-#line 1715 "yacc_sql.tab.c"
+#line 1553 "yacc_sql.tab.c"
     break;
 
-  case 25:
-#line 251 "yacc_sql.y"
+  case 26: /* commit: TRX_COMMIT SEMICOLON  */
+#line 259 "yacc_sql.y"
                          {
       CONTEXT->ssql->flag = SCF_COMMIT;
     }
-#line 1723 "yacc_sql.tab.c"
+#line 1561 "yacc_sql.tab.c"
     break;
 
-  case 26:
-#line 257 "yacc_sql.y"
+  case 27: /* rollback: TRX_ROLLBACK SEMICOLON  */
+#line 265 "yacc_sql.y"
                            {
       CONTEXT->ssql->flag = SCF_ROLLBACK;
     }
-#line 1731 "yacc_sql.tab.c"
+#line 1569 "yacc_sql.tab.c"
     break;
 
-  case 27:
-#line 263 "yacc_sql.y"
+  case 28: /* drop_table: DROP TABLE ID SEMICOLON  */
+#line 271 "yacc_sql.y"
                             {
         CONTEXT->ssql->flag = SCF_DROP_TABLE;//"drop_table";
         drop_table_init(&CONTEXT->ssql->sstr.drop_table, (yyvsp[-1].string));
     }
-#line 1740 "yacc_sql.tab.c"
+#line 1578 "yacc_sql.tab.c"
     break;
 
-  case 28:
-#line 269 "yacc_sql.y"
+  case 29: /* show_tables: SHOW TABLES SEMICOLON  */
+#line 277 "yacc_sql.y"
                           {
       CONTEXT->ssql->flag = SCF_SHOW_TABLES;
     }
-#line 1748 "yacc_sql.tab.c"
+#line 1586 "yacc_sql.tab.c"
     break;
 
-  case 29:
-#line 275 "yacc_sql.y"
+  case 30: /* desc_table: DESC ID SEMICOLON  */
+#line 283 "yacc_sql.y"
                       {
       CONTEXT->ssql->flag = SCF_DESC_TABLE;
       desc_table_init(&CONTEXT->ssql->sstr.desc_table, (yyvsp[-1].string));
     }
-#line 1757 "yacc_sql.tab.c"
+#line 1595 "yacc_sql.tab.c"
     break;
 
-  case 30:
-#line 283 "yacc_sql.y"
+  case 31: /* analyze: ANALYZE ID SEMICOLON  */
+#line 290 "yacc_sql.y"
+                         {
+      CONTEXT->ssql->flag = SCF_ANALYZE;
+      analyze_init(&CONTEXT->ssql->sstr.analyze, (yyvsp[-1].string));
+    }
+#line 1604 "yacc_sql.tab.c"
+    break;
+
+  case 32: /* analyze: ANALYZE TABLE ID SEMICOLON  */
+#line 294 "yacc_sql.y"
+                                 {
+      CONTEXT->ssql->flag = SCF_ANALYZE;
+      analyze_init(&CONTEXT->ssql->sstr.analyze, (yyvsp[-1].string));
+    }
+#line 1613 "yacc_sql.tab.c"
+    break;
+
+  case 33: /* create_index: CREATE INDEX ID ON ID LBRACE Column_def Column_list RBRACE index_type_def include_def where SEMICOLON  */
+#line 302 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag = SCF_CREATE_INDEX;//"create_index";
 			// create_index_init(&CONTEXT->ssql->sstr.create_index, $3, $5, $7, 0);
-			create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-7].string), (yyvsp[-5].string), 0);
+			create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-10].string), (yyvsp[-8].string), 0);
+			// 部分索引的条件
+			if ((yyvsp[-1].condition1) != NULL) {
+				create_index_set_conditions(&CONTEXT->ssql->sstr.create_index, (yyvsp[-1].condition1));
+			}
 		}
-#line 1767 "yacc_sql.tab.c"
+#line 1627 "yacc_sql.tab.c"
     break;
 
-  case 31:
-#line 289 "yacc_sql.y"
+  case 34: /* create_index: CREATE UNIQUE INDEX ID ON ID LBRACE Column_def Column_list RBRACE index_type_def include_def where SEMICOLON  */
+#line 312 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag = SCF_CREATE_INDEX;//"create_index";
 			// create_index_init(&CONTEXT->ssql->sstr.create_index, $4, $6, $8, 1);
-			create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-7].string), (yyvsp[-5].string), 1);
+			create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-10].string), (yyvsp[-8].string), 1);
+			if ((yyvsp[-1].condition1) != NULL) {
+				create_index_set_conditions(&CONTEXT->ssql->sstr.create_index, (yyvsp[-1].condition1));
+			}
 		}
-#line 1777 "yacc_sql.tab.c"
+#line 1640 "yacc_sql.tab.c"
     break;
 
-  case 33:
-#line 297 "yacc_sql.y"
+  case 36: /* Column_list: COMMA Column_def Column_list  */
+#line 323 "yacc_sql.y"
                                        { }
-#line 1783 "yacc_sql.tab.c"
+#line 1646 "yacc_sql.tab.c"
     break;
 
-  case 35:
-#line 300 "yacc_sql.y"
+  case 38: /* Column_def: ID  */
+#line 326 "yacc_sql.y"
              {
 		create_index_append_attribute(&CONTEXT->ssql->sstr.create_index, (yyvsp[0].string));
 	}
-#line 1791 "yacc_sql.tab.c"
+#line 1654 "yacc_sql.tab.c"
+    break;
+
+  case 40: /* index_type_def: USING HASH  */
+#line 332 "yacc_sql.y"
+                     {
+		create_index_set_type(&CONTEXT->ssql->sstr.create_index, INDEX_TYPE_HASH);
+	}
+#line 1662 "yacc_sql.tab.c"
+    break;
+
+  case 41: /* index_type_def: USING BITMAP  */
+#line 335 "yacc_sql.y"
+                       {
+		create_index_set_type(&CONTEXT->ssql->sstr.create_index, INDEX_TYPE_BITMAP);
+	}
+#line 1670 "yacc_sql.tab.c"
+    break;
+
+  case 43: /* include_def: INCLUDE LBRACE include_attr include_list RBRACE  */
+#line 341 "yacc_sql.y"
+                                                          { }
+#line 1676 "yacc_sql.tab.c"
+    break;
+
+  case 45: /* include_list: COMMA include_attr include_list  */
+#line 345 "yacc_sql.y"
+                                          { }
+#line 1682 "yacc_sql.tab.c"
+    break;
+
+  case 46: /* include_attr: ID  */
+#line 348 "yacc_sql.y"
+           {
+		create_index_append_include(&CONTEXT->ssql->sstr.create_index, (yyvsp[0].string));
+	}
+#line 1690 "yacc_sql.tab.c"
     break;
 
-  case 36:
-#line 306 "yacc_sql.y"
+  case 47: /* drop_index: DROP INDEX ID SEMICOLON  */
+#line 354 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag=SCF_DROP_INDEX;//"drop_index";
 			drop_index_init(&CONTEXT->ssql->sstr.drop_index, (yyvsp[-1].string));
 		}
-#line 1800 "yacc_sql.tab.c"
+#line 1699 "yacc_sql.tab.c"
     break;
 
-  case 37:
-#line 313 "yacc_sql.y"
+  case 48: /* create_table: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE SEMICOLON  */
+#line 361 "yacc_sql.y"
                 {
 			CONTEXT->ssql->flag=SCF_CREATE_TABLE;//"create_table";
 			// CONTEXT->ssql->sstr.create_table.attribute_count = CONTEXT->value_length;
@@ -1808,17 +1707,17 @@ yyreduce:
 			//临时变量清零	
 			CONTEXT->value_length = 0;
 		}
-#line 1812 "yacc_sql.tab.c"
+#line 1711 "yacc_sql.tab.c"
     break;
 
-  case 39:
-#line 324 "yacc_sql.y"
+  case 50: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 372 "yacc_sql.y"
                                    {    }
-#line 1818 "yacc_sql.tab.c"
+#line 1717 "yacc_sql.tab.c"
     break;
 
-  case 40:
-#line 329 "yacc_sql.y"
+  case 51: /* attr_def: ID_get type LBRACE number RBRACE opt_null  */
+#line 377 "yacc_sql.y"
                 {
 			AttrInfo attribute;
 			attr_info_init(&attribute, CONTEXT->id, (yyvsp[-4].number), (yyvsp[-2].number), (yyvsp[0].number));
@@ -1829,107 +1728,107 @@ yyreduce:
 			// CONTEXT->ssql->sstr.create_table.attributes[CONTEXT->value_length].length = $4;
 			CONTEXT->value_length++;
 		}
-#line 1833 "yacc_sql.tab.c"
+#line 1732 "yacc_sql.tab.c"
     break;
 
-  case 41:
-#line 340 "yacc_sql.y"
+  case 52: /* attr_def: ID_get type opt_null  */
+#line 388 "yacc_sql.y"
                 {
 			AttrInfo attribute;
 			attr_info_init(&attribute, CONTEXT->id, (yyvsp[-1].number), 4, (yyvsp[0].number));
 			create_table_append_attribute(&CONTEXT->ssql->sstr.create_table, &attribute);
 			CONTEXT->value_length++;
 		}
-#line 1844 "yacc_sql.tab.c"
+#line 1743 "yacc_sql.tab.c"
     break;
 
-  case 42:
-#line 349 "yacc_sql.y"
+  case 53: /* opt_null: %empty  */
+#line 397 "yacc_sql.y"
                   {
 		(yyval.number) = ISFALSE; // 默认允许null
 	}
-#line 1852 "yacc_sql.tab.c"
+#line 1751 "yacc_sql.tab.c"
     break;
 
-  case 43:
-#line 352 "yacc_sql.y"
+  case 54: /* opt_null: NOT NULL_T  */
+#line 400 "yacc_sql.y"
                      {
 		(yyval.number) = ISFALSE;
 	}
-#line 1860 "yacc_sql.tab.c"
+#line 1759 "yacc_sql.tab.c"
     break;
 
-  case 44:
-#line 355 "yacc_sql.y"
+  case 55: /* opt_null: NULLABLE  */
+#line 403 "yacc_sql.y"
                    {
 		(yyval.number) = ISTRUE;
 	}
-#line 1868 "yacc_sql.tab.c"
+#line 1767 "yacc_sql.tab.c"
     break;
 
-  case 45:
-#line 361 "yacc_sql.y"
+  case 56: /* number: NUMBER  */
+#line 409 "yacc_sql.y"
                {
 		(yyval.number) = (yyvsp[0].number);
 	}
-#line 1876 "yacc_sql.tab.c"
+#line 1775 "yacc_sql.tab.c"
     break;
 
-  case 46:
-#line 367 "yacc_sql.y"
+  case 57: /* type: INT_T  */
+#line 415 "yacc_sql.y"
               { 
 		(yyval.number)=INTS; 
 		// printf("CREATE 语句语法解析 type 为 INTS\n");
 	}
-#line 1885 "yacc_sql.tab.c"
+#line 1784 "yacc_sql.tab.c"
     break;
 
-  case 47:
-#line 371 "yacc_sql.y"
+  case 58: /* type: STRING_T  */
+#line 419 "yacc_sql.y"
                   { 
 		   (yyval.number)=CHARS;
 		// printf("CREATE 语句语法解析 type 为 STRING_T\n");
 	}
-#line 1894 "yacc_sql.tab.c"
+#line 1793 "yacc_sql.tab.c"
     break;
 
-  case 48:
-#line 375 "yacc_sql.y"
+  case 59: /* type: FLOAT_T  */
+#line 423 "yacc_sql.y"
                  { 
 		   (yyval.number)=FLOATS;
 		// printf("CREATE 语句语法解析 type 为 FLOAT_T\n");
 	}
-#line 1903 "yacc_sql.tab.c"
+#line 1802 "yacc_sql.tab.c"
     break;
 
-  case 49:
-#line 379 "yacc_sql.y"
+  case 60: /* type: DATE_T  */
+#line 427 "yacc_sql.y"
                     { 
 		   (yyval.number)=DATES;
 		// printf("CREATE 语句语法解析 type 为 DATE_T\n");
 	}
-#line 1912 "yacc_sql.tab.c"
+#line 1811 "yacc_sql.tab.c"
     break;
 
-  case 50:
-#line 382 "yacc_sql.y"
+  case 61: /* type: TEXT_T  */
+#line 430 "yacc_sql.y"
                     {
 	    (yyval.number)=TEXTS;
 	}
-#line 1920 "yacc_sql.tab.c"
+#line 1819 "yacc_sql.tab.c"
     break;
 
-  case 51:
-#line 388 "yacc_sql.y"
+  case 62: /* ID_get: ID  */
+#line 436 "yacc_sql.y"
         {
 		char *temp=(yyvsp[0].string); 
 		snprintf(CONTEXT->id, sizeof(CONTEXT->id), "%s", temp);
 	}
-#line 1929 "yacc_sql.tab.c"
+#line 1828 "yacc_sql.tab.c"
     break;
 
-  case 52:
-#line 397 "yacc_sql.y"
+  case 63: /* insert: INSERT INTO ID_get VALUES multi_values SEMICOLON  */
+#line 445 "yacc_sql.y"
         {
 			// CONTEXT->values[CONTEXT->value_length++] = *$6;
 
@@ -1944,11 +1843,11 @@ yyreduce:
 			//临时变量清零
       		CONTEXT->value_length=0;
     }
-#line 1948 "yacc_sql.tab.c"
+#line 1847 "yacc_sql.tab.c"
     break;
 
-  case 53:
-#line 413 "yacc_sql.y"
+  case 64: /* multi_values: LBRACE value_with_neg value_list RBRACE  */
+#line 461 "yacc_sql.y"
                                                 {
 		// 到此结束一组的插入：存储该组、增加index、value_length清零
 		inserts_init(&CONTEXT->ssql->sstr.insertion, CONTEXT->id, CONTEXT->values, CONTEXT->value_length, CONTEXT->insert_index);
@@ -1956,11 +1855,11 @@ yyreduce:
 		//临时变量清零
       	CONTEXT->value_length=0;
 	}
-#line 1960 "yacc_sql.tab.c"
+#line 1859 "yacc_sql.tab.c"
     break;
 
-  case 54:
-#line 420 "yacc_sql.y"
+  case 65: /* multi_values: multi_values COMMA LBRACE value_with_neg value_list RBRACE  */
+#line 468 "yacc_sql.y"
                                                                     {
 		// 到此结束一组的插入：存储该组、增加index、value_length清零
 		inserts_init(&CONTEXT->ssql->sstr.insertion, CONTEXT->id, CONTEXT->values, CONTEXT->value_length, CONTEXT->insert_index);
@@ -1968,75 +1867,75 @@ yyreduce:
 		//临时变量清零
       	CONTEXT->value_length=0;
 	}
-#line 1972 "yacc_sql.tab.c"
+#line 1871 "yacc_sql.tab.c"
     break;
 
-  case 56:
-#line 430 "yacc_sql.y"
+  case 67: /* value_list: COMMA value_with_neg value_list  */
+#line 478 "yacc_sql.y"
                                        { 
   		// CONTEXT->values[CONTEXT->value_length++] = *$2;
 	  }
-#line 1980 "yacc_sql.tab.c"
+#line 1879 "yacc_sql.tab.c"
     break;
 
-  case 57:
-#line 436 "yacc_sql.y"
+  case 68: /* value_with_neg: value  */
+#line 484 "yacc_sql.y"
               {
 		CONTEXT->exp_length = 0;
 	}
-#line 1988 "yacc_sql.tab.c"
+#line 1887 "yacc_sql.tab.c"
     break;
 
-  case 58:
-#line 439 "yacc_sql.y"
+  case 69: /* value_with_neg: minus NUMBER  */
+#line 487 "yacc_sql.y"
                        {
 		value_init_integer(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].number) * -1, false);
 	}
-#line 1996 "yacc_sql.tab.c"
+#line 1895 "yacc_sql.tab.c"
     break;
 
-  case 59:
-#line 442 "yacc_sql.y"
+  case 70: /* value_with_neg: minus FLOAT  */
+#line 490 "yacc_sql.y"
                       {
 		value_init_float(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].floats) * -1.0, false);
 	}
-#line 2004 "yacc_sql.tab.c"
+#line 1903 "yacc_sql.tab.c"
     break;
 
-  case 60:
-#line 448 "yacc_sql.y"
+  case 71: /* value: NUMBER  */
+#line 496 "yacc_sql.y"
           {	
   		value_init_integer(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].number), false);
 		char exp_name[MAX_NUM];
 		sprintf(exp_name, "%d", (yyvsp[0].number));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2015 "yacc_sql.tab.c"
+#line 1914 "yacc_sql.tab.c"
     break;
 
-  case 61:
-#line 454 "yacc_sql.y"
+  case 72: /* value: FLOAT  */
+#line 502 "yacc_sql.y"
           {
   		value_init_float(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].floats), false);
 		char exp_name[MAX_NUM];
 		sprintf(exp_name, "%f", (yyvsp[0].floats));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2026 "yacc_sql.tab.c"
+#line 1925 "yacc_sql.tab.c"
     break;
 
-  case 62:
-#line 460 "yacc_sql.y"
+  case 73: /* value: NULL_T  */
+#line 508 "yacc_sql.y"
                 {
 		// null不需要加双引号，当作字符串插入
 		value_init_string(&CONTEXT->values[CONTEXT->value_length++], "NULL", true);
 		CONTEXT->exps[CONTEXT->exp_length++] = "NULL";
 	}
-#line 2036 "yacc_sql.tab.c"
+#line 1935 "yacc_sql.tab.c"
     break;
 
-  case 63:
-#line 465 "yacc_sql.y"
+  case 74: /* value: SSS  */
+#line 513 "yacc_sql.y"
          {
         // 没有末位的"\0"
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup((yyvsp[0].string));
@@ -2044,11 +1943,11 @@ yyreduce:
         // 长度大于4就当作tetx来处理
 		value_init_string_with_text(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].string), false, strlen((yyvsp[0].string)));
 	}
-#line 2048 "yacc_sql.tab.c"
+#line 1947 "yacc_sql.tab.c"
     break;
 
-  case 64:
-#line 477 "yacc_sql.y"
+  case 75: /* delete: DELETE FROM ID where SEMICOLON  */
+#line 525 "yacc_sql.y"
         {
 		CONTEXT->ssql->flag = SCF_DELETE;//"delete";
 		deletes_init_relation(&CONTEXT->ssql->sstr.deletion, (yyvsp[-2].string));
@@ -2057,11 +1956,11 @@ yyreduce:
 			deletes_set_conditions(&CONTEXT->ssql->sstr.deletion, (yyvsp[-1].condition1)); // where
 		}
     }
-#line 2061 "yacc_sql.tab.c"
+#line 1960 "yacc_sql.tab.c"
     break;
 
-  case 65:
-#line 489 "yacc_sql.y"
+  case 76: /* update: UPDATE ID SET ID EQ value_with_neg where SEMICOLON  */
+#line 537 "yacc_sql.y"
         {
 		CONTEXT->ssql->flag = SCF_UPDATE;//"update";
 		Value *value = &CONTEXT->values[0];
@@ -2070,22 +1969,22 @@ yyreduce:
 			updates_init_condition(&CONTEXT->ssql->sstr.update, (yyvsp[-1].condition1));
 		}
 	}
-#line 2074 "yacc_sql.tab.c"
+#line 1973 "yacc_sql.tab.c"
     break;
 
-  case 66:
-#line 502 "yacc_sql.y"
+  case 77: /* select: SELECT select_attr from_rel join_list where group_by order_by limit SEMICOLON  */
+#line 550 "yacc_sql.y"
             {
 			CONTEXT->ssql->flag=SCF_SELECT;//"select";
 
-			selects_append_relations(&CONTEXT->ssql->sstr.selection, (yyvsp[-5].relation)); // from_rel
-			if ((yyvsp[-3].condition1) != NULL) {
-				selects_append_conditions(&CONTEXT->ssql->sstr.selection, (yyvsp[-3].condition1)); // where
+			selects_append_relations(&CONTEXT->ssql->sstr.selection, (yyvsp[-6].relation)); // from_rel
+			if ((yyvsp[-4].condition1) != NULL) {
+				selects_append_conditions(&CONTEXT->ssql->sstr.selection, (yyvsp[-4].condition1)); // where
 			}
-			selects_append_attributes(&CONTEXT->ssql->sstr.selection, (yyvsp[-6].relattr1)); // select_attr
+			selects_append_attributes(&CONTEXT->ssql->sstr.selection, (yyvsp[-7].relattr1)); // select_attr
 			// group by
-			if ((yyvsp[-2].relattr1) != NULL) {
-				selects_append_groups(&CONTEXT->ssql->sstr.selection, (yyvsp[-2].relattr1)); 
+			if ((yyvsp[-3].relattr1) != NULL) {
+				selects_append_groups(&CONTEXT->ssql->sstr.selection, (yyvsp[-3].relattr1)); 
 			}
 
 			if (CONTEXT->exps_select_length > 0) {
@@ -2095,11 +1994,11 @@ yyreduce:
 				CONTEXT->exps_select_length = 0;
 			}
 	    }
-#line 2099 "yacc_sql.tab.c"
+#line 1998 "yacc_sql.tab.c"
     break;
 
-  case 67:
-#line 525 "yacc_sql.y"
+  case 78: /* select_attr: STAR  */
+#line 573 "yacc_sql.y"
          {  // select *
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, "*", NULL, 0);
@@ -2110,11 +2009,11 @@ yyreduce:
 		memcpy((yyval.relattr1), CONTEXT->rel_attrs, sizeof(RelAttr) * CONTEXT->rel_attr_length);
 		CONTEXT->rel_attr_length = 0; 
 	}
-#line 2114 "yacc_sql.tab.c"
+#line 2013 "yacc_sql.tab.c"
     break;
 
-  case 68:
-#line 535 "yacc_sql.y"
+  case 79: /* select_attr: select_param attr_list  */
+#line 583 "yacc_sql.y"
                              { 
 		relation_attr_init(&CONTEXT->rel_attrs[CONTEXT->rel_attr_length++] , NULL, "*", NULL, 2);
 
@@ -2122,31 +2021,31 @@ yyreduce:
 		memcpy((yyval.relattr1), CONTEXT->rel_attrs, sizeof(RelAttr) * CONTEXT->rel_attr_length);
 		CONTEXT->rel_attr_length = 0; 
 	}
-#line 2126 "yacc_sql.tab.c"
+#line 2025 "yacc_sql.tab.c"
     break;
 
-  case 69:
-#line 545 "yacc_sql.y"
+  case 80: /* select_param: window_function  */
+#line 593 "yacc_sql.y"
                         {
 		CONTEXT->exps[CONTEXT->exp_length++] = "NULL";
 		// selects_append_expressions(&CONTEXT->ssql->sstr.selection, CONTEXT->exps);
 		memcpy(CONTEXT->exps_for_select[CONTEXT->exps_select_length++], CONTEXT->exps, sizeof(const char *) * CONTEXT->exp_length);
 		CONTEXT->exp_length = 0;
 	}
-#line 2137 "yacc_sql.tab.c"
+#line 2036 "yacc_sql.tab.c"
     break;
 
-  case 70:
-#line 551 "yacc_sql.y"
+  case 81: /* select_param: expression  */
+#line 599 "yacc_sql.y"
                      {
 		// selects_append_expressions(&CONTEXT->ssql->sstr.selection, $1);
 		memcpy(CONTEXT->exps_for_select[CONTEXT->exps_select_length++], (yyvsp[0].relation), sizeof(const char *) * CONTEXT->tmp_len);
 	}
-#line 2146 "yacc_sql.tab.c"
+#line 2045 "yacc_sql.tab.c"
     break;
 
-  case 71:
-#line 559 "yacc_sql.y"
+  case 82: /* expression: exp exp_list  */
+#line 607 "yacc_sql.y"
                      {
 		// 1+2+...
 		CONTEXT->exps[CONTEXT->exp_length++] = "NULL";
@@ -2156,11 +2055,11 @@ yyreduce:
 		CONTEXT->exp_length = 0; // 清空
 		// CONTEXT->value_length = 0;
 	}
-#line 2160 "yacc_sql.tab.c"
+#line 2059 "yacc_sql.tab.c"
     break;
 
-  case 72:
-#line 568 "yacc_sql.y"
+  case 83: /* expression: exp_list  */
+#line 616 "yacc_sql.y"
                    {
 		// -1+2+...
 		CONTEXT->exps[CONTEXT->exp_length++] = "NULL";
@@ -2170,11 +2069,11 @@ yyreduce:
 		CONTEXT->exp_length = 0; // 清空
 		// CONTEXT->value_length = 0;
 	}
-#line 2174 "yacc_sql.tab.c"
+#line 2073 "yacc_sql.tab.c"
     break;
 
-  case 73:
-#line 577 "yacc_sql.y"
+  case 84: /* expression: lbrace exp exp_list rbrace exp_list  */
+#line 625 "yacc_sql.y"
                                               {
 		// (1+2)+...
 		CONTEXT->exps[CONTEXT->exp_length++] = "NULL";
@@ -2183,68 +2082,68 @@ yyreduce:
 		CONTEXT->tmp_len = CONTEXT->exp_length;
 		CONTEXT->exp_length = 0; // 清空
 	}
-#line 2187 "yacc_sql.tab.c"
+#line 2086 "yacc_sql.tab.c"
     break;
 
-  case 74:
-#line 596 "yacc_sql.y"
+  case 85: /* exp_list: %empty  */
+#line 644 "yacc_sql.y"
                   {}
-#line 2193 "yacc_sql.tab.c"
+#line 2092 "yacc_sql.tab.c"
     break;
 
-  case 78:
-#line 603 "yacc_sql.y"
+  case 89: /* lbrace: LBRACE  */
+#line 651 "yacc_sql.y"
                {
 		CONTEXT->exps[CONTEXT->exp_length++] = "(";
 	}
-#line 2201 "yacc_sql.tab.c"
+#line 2100 "yacc_sql.tab.c"
     break;
 
-  case 79:
-#line 609 "yacc_sql.y"
+  case 90: /* rbrace: RBRACE  */
+#line 657 "yacc_sql.y"
                {
 		CONTEXT->exps[CONTEXT->exp_length++] = ")";
 	}
-#line 2209 "yacc_sql.tab.c"
+#line 2108 "yacc_sql.tab.c"
     break;
 
-  case 82:
-#line 645 "yacc_sql.y"
+  case 93: /* minus: MINUS  */
+#line 693 "yacc_sql.y"
               {
 		CONTEXT->exps[CONTEXT->exp_length++] = "-";
 	}
-#line 2217 "yacc_sql.tab.c"
+#line 2116 "yacc_sql.tab.c"
     break;
 
-  case 83:
-#line 651 "yacc_sql.y"
+  case 94: /* op: STAR  */
+#line 699 "yacc_sql.y"
              {
 		// *
 		CONTEXT->exps[CONTEXT->exp_length++] = "*";
 	}
-#line 2226 "yacc_sql.tab.c"
+#line 2125 "yacc_sql.tab.c"
     break;
 
-  case 84:
-#line 655 "yacc_sql.y"
+  case 95: /* op: PLUS  */
+#line 703 "yacc_sql.y"
                {
 		// +
 		CONTEXT->exps[CONTEXT->exp_length++] = "+";
 	}
-#line 2235 "yacc_sql.tab.c"
+#line 2134 "yacc_sql.tab.c"
     break;
 
-  case 86:
-#line 660 "yacc_sql.y"
+  case 97: /* op: DIV  */
+#line 708 "yacc_sql.y"
               {
 		// 除法
 		CONTEXT->exps[CONTEXT->exp_length++] = "/";
 	}
-#line 2244 "yacc_sql.tab.c"
+#line 2143 "yacc_sql.tab.c"
     break;
 
-  case 87:
-#line 667 "yacc_sql.y"
+  case 98: /* id_type: ID  */
+#line 715 "yacc_sql.y"
           { // select age
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, (yyvsp[0].string), NULL, 0);
@@ -2254,11 +2153,11 @@ yyreduce:
 		sprintf(exp_name, "%s", (yyvsp[0].string));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2258 "yacc_sql.tab.c"
+#line 2157 "yacc_sql.tab.c"
     break;
 
-  case 88:
-#line 676 "yacc_sql.y"
+  case 99: /* id_type: ID DOT ID  */
+#line 724 "yacc_sql.y"
                     { // select t1.age
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-2].string), (yyvsp[0].string), NULL, 0);
@@ -2268,11 +2167,11 @@ yyreduce:
 		sprintf(exp_name, "%s.%s", (yyvsp[-2].string), (yyvsp[0].string));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2272 "yacc_sql.tab.c"
+#line 2171 "yacc_sql.tab.c"
     break;
 
-  case 89:
-#line 685 "yacc_sql.y"
+  case 100: /* id_type: ID DOT STAR  */
+#line 733 "yacc_sql.y"
                      { // select t1.*
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-2].string), "*", NULL, 0);
@@ -2282,25 +2181,25 @@ yyreduce:
 		sprintf(exp_name, "%s.*", (yyvsp[-2].string));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2286 "yacc_sql.tab.c"
+#line 2185 "yacc_sql.tab.c"
     break;
 
-  case 91:
-#line 698 "yacc_sql.y"
+  case 102: /* attr_list: COMMA select_param attr_list  */
+#line 746 "yacc_sql.y"
                                    { }
-#line 2292 "yacc_sql.tab.c"
+#line 2191 "yacc_sql.tab.c"
     break;
 
-  case 93:
-#line 703 "yacc_sql.y"
+  case 104: /* join_list: INNER JOIN ID on join_list  */
+#line 751 "yacc_sql.y"
                                  {
 		selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-2].string));
     }
-#line 2300 "yacc_sql.tab.c"
+#line 2199 "yacc_sql.tab.c"
     break;
 
-  case 94:
-#line 711 "yacc_sql.y"
+  case 105: /* window_function: COUNT LBRACE opt_star RBRACE  */
+#line 759 "yacc_sql.y"
         {	// 只有COUNT允许COUNT(*)
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, (yyvsp[-1].string), (yyvsp[-3].string), 0);
@@ -2308,11 +2207,11 @@ yyreduce:
 
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup((yyvsp[-1].string));
 	}
-#line 2312 "yacc_sql.tab.c"
+#line 2211 "yacc_sql.tab.c"
     break;
 
-  case 95:
-#line 719 "yacc_sql.y"
+  case 106: /* window_function: COUNT LBRACE ID DOT ID RBRACE  */
+#line 767 "yacc_sql.y"
         {
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-3].string), (yyvsp[-1].string), (yyvsp[-5].string), 0);
@@ -2322,11 +2221,11 @@ yyreduce:
 		sprintf(exp_name, "%s.%s", (yyvsp[-3].string), (yyvsp[-1].string));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2326 "yacc_sql.tab.c"
+#line 2225 "yacc_sql.tab.c"
     break;
 
-  case 96:
-#line 729 "yacc_sql.y"
+  case 107: /* window_function: COUNT LBRACE ID DOT STAR RBRACE  */
+#line 777 "yacc_sql.y"
         {
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-3].string), (yyvsp[-1].string), (yyvsp[-5].string), 0);
@@ -2336,11 +2235,11 @@ yyreduce:
 		sprintf(exp_name, "%s.*", (yyvsp[-3].string));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2340 "yacc_sql.tab.c"
+#line 2239 "yacc_sql.tab.c"
     break;
 
-  case 97:
-#line 739 "yacc_sql.y"
+  case 108: /* window_function: OTHER_FUNCTION_TYPE LBRACE ID RBRACE  */
+#line 787 "yacc_sql.y"
         {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, (yyvsp[-1].string), (yyvsp[-3].string), 0);
@@ -2350,11 +2249,11 @@ yyreduce:
 		sprintf(exp_name, "%s", (yyvsp[-1].string));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2354 "yacc_sql.tab.c"
+#line 2253 "yacc_sql.tab.c"
     break;
 
-  case 98:
-#line 749 "yacc_sql.y"
+  case 109: /* window_function: OTHER_FUNCTION_TYPE LBRACE ID DOT ID RBRACE  */
+#line 797 "yacc_sql.y"
         {
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-3].string), (yyvsp[-1].string), (yyvsp[-5].string), 0);
@@ -2364,11 +2263,11 @@ yyreduce:
 		sprintf(exp_name, "%s.%s", (yyvsp[-3].string), (yyvsp[-1].string));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2368 "yacc_sql.tab.c"
+#line 2267 "yacc_sql.tab.c"
     break;
 
-  case 99:
-#line 759 "yacc_sql.y"
+  case 110: /* window_function: OTHER_FUNCTION_TYPE LBRACE ID DOT STAR RBRACE  */
+#line 807 "yacc_sql.y"
         {
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-3].string), "*", (yyvsp[-5].string), 0);
@@ -2378,29 +2277,29 @@ yyreduce:
 		sprintf(exp_name, "%s.*", (yyvsp[-3].string));
 		CONTEXT->exps[CONTEXT->exp_length++] = strdup(exp_name);
 	}
-#line 2382 "yacc_sql.tab.c"
+#line 2281 "yacc_sql.tab.c"
     break;
 
-  case 100:
-#line 771 "yacc_sql.y"
+  case 111: /* opt_star: STAR  */
+#line 819 "yacc_sql.y"
              { (yyval.string) = (yyvsp[0].string);}
-#line 2388 "yacc_sql.tab.c"
+#line 2287 "yacc_sql.tab.c"
     break;
 
-  case 101:
-#line 772 "yacc_sql.y"
+  case 112: /* opt_star: NUMBER  */
+#line 820 "yacc_sql.y"
                  {(yyval.string) = number_to_str((yyvsp[0].number));}
-#line 2394 "yacc_sql.tab.c"
+#line 2293 "yacc_sql.tab.c"
     break;
 
-  case 102:
-#line 773 "yacc_sql.y"
+  case 113: /* opt_star: ID  */
+#line 821 "yacc_sql.y"
              {(yyval.string) = (yyvsp[0].string);}
-#line 2400 "yacc_sql.tab.c"
+#line 2299 "yacc_sql.tab.c"
     break;
 
-  case 103:
-#line 777 "yacc_sql.y"
+  case 114: /* from_rel: FROM ID rel_list  */
+#line 825 "yacc_sql.y"
                          {
 		CONTEXT->rels[CONTEXT->rel_length++] = (yyvsp[-1].string);
 		CONTEXT->rels[CONTEXT->rel_length++] = "NULL";
@@ -2408,34 +2307,34 @@ yyreduce:
 		memcpy((yyval.relation), CONTEXT->rels, sizeof(const char*) * CONTEXT->rel_length);
 		CONTEXT->rel_length = 0;
 	}
-#line 2412 "yacc_sql.tab.c"
+#line 2311 "yacc_sql.tab.c"
     break;
 
-  case 104:
-#line 787 "yacc_sql.y"
+  case 115: /* rel_list: %empty  */
+#line 835 "yacc_sql.y"
                 {}
-#line 2418 "yacc_sql.tab.c"
+#line 2317 "yacc_sql.tab.c"
     break;
 
-  case 105:
-#line 788 "yacc_sql.y"
+  case 116: /* rel_list: COMMA ID rel_list  */
+#line 836 "yacc_sql.y"
                         {	
 		CONTEXT->rels[CONTEXT->rel_length++] = (yyvsp[-1].string);
 	}
-#line 2426 "yacc_sql.tab.c"
+#line 2325 "yacc_sql.tab.c"
     break;
 
-  case 106:
-#line 794 "yacc_sql.y"
+  case 117: /* where: %empty  */
+#line 842 "yacc_sql.y"
                 { 
 		(yyval.condition1) = NULL; 
 		CONTEXT->rel_attr_length = 0;
 	}
-#line 2435 "yacc_sql.tab.c"
+#line 2334 "yacc_sql.tab.c"
     break;
 
-  case 107:
-#line 798 "yacc_sql.y"
+  case 118: /* where: WHERE condition condition_list  */
+#line 846 "yacc_sql.y"
                                      {	
 		RelAttr left_attr;
 		relation_attr_init(&left_attr, NULL, "NULL", NULL, 0);
@@ -2451,11 +2350,11 @@ yyreduce:
 		CONTEXT->value_length = 0;
 		CONTEXT->rel_attr_length = 0;
 	}
-#line 2455 "yacc_sql.tab.c"
+#line 2354 "yacc_sql.tab.c"
     break;
 
-  case 109:
-#line 817 "yacc_sql.y"
+  case 120: /* on: ON condition condition_list  */
+#line 865 "yacc_sql.y"
                                   {	
 				// CONTEXT->conditions[CONTEXT->condition_length++]=*$2;
 		selects_append_conditions_with_num(&CONTEXT->ssql->sstr.selection, CONTEXT->conditions, CONTEXT->condition_length);
@@ -2464,30 +2363,30 @@ yyreduce:
 		// 由于select里只有condition涉及到value_length，所以一并在此清零
 		CONTEXT->value_length = 0;
 	}
-#line 2468 "yacc_sql.tab.c"
+#line 2367 "yacc_sql.tab.c"
     break;
 
-  case 111:
-#line 829 "yacc_sql.y"
+  case 122: /* condition_list: AND condition condition_list  */
+#line 877 "yacc_sql.y"
                                    {
 		// CONTEXT->conditions[CONTEXT->condition_length++]=*$2;
 	}
-#line 2476 "yacc_sql.tab.c"
+#line 2375 "yacc_sql.tab.c"
     break;
 
-  case 112:
-#line 835 "yacc_sql.y"
+  case 123: /* condition: expression sub_comOp expression  */
+#line 883 "yacc_sql.y"
                                         {
 		// 左侧表达式，右侧表达式
 		Condition condition;
 		condition_exp(&condition, (yyvsp[-2].relation), (yyvsp[-1].number), (yyvsp[0].relation));
 		CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2487 "yacc_sql.tab.c"
+#line 2386 "yacc_sql.tab.c"
     break;
 
-  case 113:
-#line 841 "yacc_sql.y"
+  case 124: /* condition: expression sub_comOp sub_select  */
+#line 889 "yacc_sql.y"
                                           {
 		RelAttr left_attr;
 		Value left_value;
@@ -2498,11 +2397,11 @@ yyreduce:
 		condition_init(&condition, (yyvsp[-1].number), left_is_attr, &left_attr, &left_value, 2, NULL, NULL, (yyvsp[0].selnode), NULL);
 		CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2502 "yacc_sql.tab.c"
+#line 2401 "yacc_sql.tab.c"
     break;
 
-  case 114:
-#line 851 "yacc_sql.y"
+  case 125: /* condition: sub_select sub_comOp value  */
+#line 899 "yacc_sql.y"
                                      {
 		// 反过来，当作正的解析
 		Value *left_value = &CONTEXT->values[CONTEXT->value_length - 1];
@@ -2517,11 +2416,11 @@ yyreduce:
 		}
 		CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2521 "yacc_sql.tab.c"
+#line 2420 "yacc_sql.tab.c"
     break;
 
-  case 115:
-#line 865 "yacc_sql.y"
+  case 126: /* condition: sub_select sub_comOp id_type  */
+#line 913 "yacc_sql.y"
                                       {
 		// 反过来，当作正的解析
 		// RelAttr left_attr;
@@ -2540,90 +2439,90 @@ yyreduce:
 		}
 		CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2544 "yacc_sql.tab.c"
+#line 2443 "yacc_sql.tab.c"
     break;
 
-  case 116:
-#line 883 "yacc_sql.y"
+  case 127: /* condition: sub_select sub_comOp sub_select  */
+#line 931 "yacc_sql.y"
                                           {
 		Condition condition;
 		condition_init(&condition, (yyvsp[-1].number), 2, NULL, NULL, 2, NULL, NULL, (yyvsp[0].selnode), (yyvsp[-2].selnode));
 		CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2554 "yacc_sql.tab.c"
+#line 2453 "yacc_sql.tab.c"
     break;
 
-  case 117:
-#line 891 "yacc_sql.y"
+  case 128: /* sub_comOp: comOp  */
+#line 939 "yacc_sql.y"
               {
 		CONTEXT->rel_attr_length = 0;
 		(yyval.number) = (yyvsp[0].number);
 	}
-#line 2563 "yacc_sql.tab.c"
+#line 2462 "yacc_sql.tab.c"
     break;
 
-  case 118:
-#line 898 "yacc_sql.y"
+  case 129: /* comOp: EQ  */
+#line 946 "yacc_sql.y"
              { (yyval.number) = 0; }
-#line 2569 "yacc_sql.tab.c"
+#line 2468 "yacc_sql.tab.c"
     break;
 
-  case 119:
-#line 899 "yacc_sql.y"
+  case 130: /* comOp: LT  */
+#line 947 "yacc_sql.y"
          { (yyval.number) = 3; }
-#line 2575 "yacc_sql.tab.c"
+#line 2474 "yacc_sql.tab.c"
     break;
 
-  case 120:
-#line 900 "yacc_sql.y"
+  case 131: /* comOp: GT  */
+#line 948 "yacc_sql.y"
          { (yyval.number) = 5; }
-#line 2581 "yacc_sql.tab.c"
+#line 2480 "yacc_sql.tab.c"
     break;
 
-  case 121:
-#line 901 "yacc_sql.y"
+  case 132: /* comOp: LE  */
+#line 949 "yacc_sql.y"
          { (yyval.number) = 2; }
-#line 2587 "yacc_sql.tab.c"
+#line 2486 "yacc_sql.tab.c"
     break;
 
-  case 122:
-#line 902 "yacc_sql.y"
+  case 133: /* comOp: GE  */
+#line 950 "yacc_sql.y"
          { (yyval.number) = 4; }
-#line 2593 "yacc_sql.tab.c"
+#line 2492 "yacc_sql.tab.c"
     break;
 
-  case 123:
-#line 903 "yacc_sql.y"
+  case 134: /* comOp: NE  */
+#line 951 "yacc_sql.y"
          { (yyval.number) = 1; }
-#line 2599 "yacc_sql.tab.c"
+#line 2498 "yacc_sql.tab.c"
     break;
 
-  case 124:
-#line 904 "yacc_sql.y"
+  case 135: /* comOp: IN  */
+#line 952 "yacc_sql.y"
              { (yyval.number) = 8; }
-#line 2605 "yacc_sql.tab.c"
+#line 2504 "yacc_sql.tab.c"
     break;
 
-  case 125:
-#line 905 "yacc_sql.y"
+  case 136: /* comOp: NOT IN  */
+#line 953 "yacc_sql.y"
                  { (yyval.number) = 9; }
-#line 2611 "yacc_sql.tab.c"
+#line 2510 "yacc_sql.tab.c"
     break;
 
-  case 126:
-#line 906 "yacc_sql.y"
+  case 137: /* comOp: IS  */
+#line 954 "yacc_sql.y"
              {(yyval.number) = 6;}
-#line 2617 "yacc_sql.tab.c"
+#line 2516 "yacc_sql.tab.c"
     break;
 
-  case 127:
-#line 907 "yacc_sql.y"
+  case 138: /* comOp: IS NOT  */
+#line 955 "yacc_sql.y"
                  {(yyval.number) = 7;}
-#line 2623 "yacc_sql.tab.c"
+#line 2522 "yacc_sql.tab.c"
     break;
 
-  case 128:
-#line 911 "yacc_sql.y"
+  case 139: /* sub_select: LBRACE SELECT select_attr from_rel where RBRACE  */
+#line 959 "yacc_sql.y"
                                                         {
 		(yyval.selnode) = (Selects*)malloc(sizeof(Selects));
 		// 结构体malloc，后面要不跟上memcpy要不用memset全部默认初始化
@@ -2642,120 +2541,136 @@ yyreduce:
 			CONTEXT->exps_select_length = 0;
 		}
 	}
-#line 2646 "yacc_sql.tab.c"
+#line 2545 "yacc_sql.tab.c"
     break;
 
-  case 129:
-#line 932 "yacc_sql.y"
+  case 140: /* group_by: %empty  */
+#line 980 "yacc_sql.y"
                   {(yyval.relattr1) = NULL;}
-#line 2652 "yacc_sql.tab.c"
+#line 2551 "yacc_sql.tab.c"
     break;
 
-  case 130:
-#line 933 "yacc_sql.y"
+  case 141: /* group_by: GROUP BY group_list  */
+#line 981 "yacc_sql.y"
                               {
 		relation_attr_init(&CONTEXT->rel_attrs[CONTEXT->rel_attr_length++] , NULL, "*", NULL, 2);
 		(yyval.relattr1) = (RelAttr *)malloc(sizeof(RelAttr) * CONTEXT->rel_attr_length);
 		memcpy((yyval.relattr1), CONTEXT->rel_attrs, sizeof(RelAttr) * CONTEXT->rel_attr_length);
 		CONTEXT->rel_attr_length = 0; 
 	}
-#line 2663 "yacc_sql.tab.c"
+#line 2562 "yacc_sql.tab.c"
     break;
 
-  case 131:
-#line 942 "yacc_sql.y"
+  case 142: /* group_list: expression  */
+#line 990 "yacc_sql.y"
                   {
 		selects_append_expressions(&CONTEXT->ssql->sstr.selection, (yyvsp[0].relation));
 	}
-#line 2671 "yacc_sql.tab.c"
+#line 2570 "yacc_sql.tab.c"
     break;
 
-  case 132:
-#line 945 "yacc_sql.y"
+  case 143: /* group_list: group_list COMMA expression  */
+#line 993 "yacc_sql.y"
                                       {
 		selects_append_expressions(&CONTEXT->ssql->sstr.selection, (yyvsp[0].relation));
 	}
-#line 2679 "yacc_sql.tab.c"
+#line 2578 "yacc_sql.tab.c"
     break;
 
-  case 134:
-#line 967 "yacc_sql.y"
+  case 145: /* order_by: ORDER BY sort_list  */
+#line 1015 "yacc_sql.y"
                              {
 	}
-#line 2686 "yacc_sql.tab.c"
+#line 2585 "yacc_sql.tab.c"
+    break;
+
+  case 147: /* limit: LIMIT NUMBER  */
+#line 1021 "yacc_sql.y"
+                       {
+		selects_set_limit(&CONTEXT->ssql->sstr.selection, (yyvsp[0].number), 0);
+	}
+#line 2593 "yacc_sql.tab.c"
+    break;
+
+  case 148: /* limit: LIMIT NUMBER OFFSET NUMBER  */
+#line 1024 "yacc_sql.y"
+                                     {
+		selects_set_limit(&CONTEXT->ssql->sstr.selection, (yyvsp[-2].number), (yyvsp[0].number));
+	}
+#line 2601 "yacc_sql.tab.c"
     break;
 
-  case 135:
-#line 972 "yacc_sql.y"
+  case 149: /* sort_list: sort_attr  */
+#line 1030 "yacc_sql.y"
                   {
 		// order by A, B, C，实际上加入顺序为C、B、A，方便后面排序
 	}
-#line 2694 "yacc_sql.tab.c"
+#line 2609 "yacc_sql.tab.c"
     break;
 
-  case 136:
-#line 975 "yacc_sql.y"
+  case 150: /* sort_list: sort_list COMMA sort_attr  */
+#line 1033 "yacc_sql.y"
                                     {}
-#line 2700 "yacc_sql.tab.c"
+#line 2615 "yacc_sql.tab.c"
     break;
 
-  case 137:
-#line 978 "yacc_sql.y"
+  case 151: /* sort_attr: ID opt_asc  */
+#line 1036 "yacc_sql.y"
                   {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, (yyvsp[-1].string), NULL, 0);
 		selects_append_order(&CONTEXT->ssql->sstr.selection, &attr);
 	}
-#line 2710 "yacc_sql.tab.c"
+#line 2625 "yacc_sql.tab.c"
     break;
 
-  case 138:
-#line 983 "yacc_sql.y"
+  case 152: /* sort_attr: ID DESC  */
+#line 1041 "yacc_sql.y"
                   {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, (yyvsp[-1].string), NULL, 1);
 		selects_append_order(&CONTEXT->ssql->sstr.selection, &attr);
 	}
-#line 2720 "yacc_sql.tab.c"
+#line 2635 "yacc_sql.tab.c"
     break;
 
-  case 139:
-#line 988 "yacc_sql.y"
+  case 153: /* sort_attr: ID DOT ID opt_asc  */
+#line 1046 "yacc_sql.y"
                             {
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-3].string), (yyvsp[-1].string), NULL, 0);
 		selects_append_order(&CONTEXT->ssql->sstr.selection, &attr);
 	}
-#line 2730 "yacc_sql.tab.c"
+#line 2645 "yacc_sql.tab.c"
     break;
 
-  case 140:
-#line 993 "yacc_sql.y"
+  case 154: /* sort_attr: ID DOT ID DESC  */
+#line 1051 "yacc_sql.y"
                          {
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-3].string), (yyvsp[-1].string), NULL, 1);
 		selects_append_order(&CONTEXT->ssql->sstr.selection, &attr);
 	}
-#line 2740 "yacc_sql.tab.c"
+#line 2655 "yacc_sql.tab.c"
     break;
 
-  case 142:
-#line 1001 "yacc_sql.y"
+  case 156: /* opt_asc: ASC  */
+#line 1059 "yacc_sql.y"
               {}
-#line 2746 "yacc_sql.tab.c"
+#line 2661 "yacc_sql.tab.c"
     break;
 
-  case 143:
-#line 1005 "yacc_sql.y"
+  case 157: /* load_data: LOAD DATA INFILE SSS INTO TABLE ID SEMICOLON  */
+#line 1063 "yacc_sql.y"
                 {
 		  CONTEXT->ssql->flag = SCF_LOAD_DATA;
 			load_data_init(&CONTEXT->ssql->sstr.load_data, (yyvsp[-1].string), (yyvsp[-4].string));
 		}
-#line 2755 "yacc_sql.tab.c"
+#line 2670 "yacc_sql.tab.c"
     break;
 
 
-#line 2759 "yacc_sql.tab.c"
+#line 2674 "yacc_sql.tab.c"
 
       default: break;
     }
@@ -2770,11 +2685,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
@@ -2798,50 +2712,14 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (scanner, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = YY_CAST (char *, YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (scanner, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2874,6 +2752,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2890,13 +2769,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2910,7 +2790,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, scanner);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2922,7 +2802,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2933,7 +2813,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -2941,24 +2821,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (scanner, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2974,20 +2852,18 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[+*yyssp], yyvsp, scanner);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+
   return yyresult;
 }
-#line 1011 "yacc_sql.y"
+
+#line 1069 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
@@ -145,6 +145,13 @@ ParserContext *get_context(yyscan_t scanner)
 		IN
 		MINUS
 		TEXT_T
+		INCLUDE
+		USING
+		HASH
+		ANALYZE
+		BITMAP
+		LIMIT
+		OFFSET
         
 %union {
   struct _Attr *attr;
@@ -221,6 +228,7 @@ command:
 	| commit
 	| rollback
 	| load_data
+	| analyze
 	| help
 	| exit
     ;
@@ -278,18 +286,36 @@ desc_table:
     }
     ;
 
+analyze:
+    ANALYZE ID SEMICOLON {
+      CONTEXT->ssql->flag = SCF_ANALYZE;
+      analyze_init(&CONTEXT->ssql->sstr.analyze, $2);
+    }
+    | ANALYZE TABLE ID SEMICOLON {
+      CONTEXT->ssql->flag = SCF_ANALYZE;
+      analyze_init(&CONTEXT->ssql->sstr.analyze, $3);
+    }
+    ;
+
 create_index:		/*create index 语句的语法解析树*/
-    CREATE INDEX ID ON ID LBRACE Column_def Column_list RBRACE SEMICOLON 
+    CREATE INDEX ID ON ID LBRACE Column_def Column_list RBRACE index_type_def include_def where SEMICOLON 
 		{
 			CONTEXT->ssql->flag = SCF_CREATE_INDEX;//"create_index";
 			// create_index_init(&CONTEXT->ssql->sstr.create_index, $3, $5, $7, 0);
 			create_index_init(&CONTEXT->ssql->sstr.create_index, $3, $5, 0);
+			// 部分索引的条件
+			if ($12 != NULL) {
+				create_index_set_conditions(&CONTEXT->ssql->sstr.create_index, $12);
+			}
 		}
-	| CREATE UNIQUE INDEX ID ON ID LBRACE Column_def Column_list RBRACE SEMICOLON 
+	| CREATE UNIQUE INDEX ID ON ID LBRACE Column_def Column_list RBRACE index_type_def include_def where SEMICOLON 
 		{
 			CONTEXT->ssql->flag = SCF_CREATE_INDEX;//"create_index";
 			// create_index_init(&CONTEXT->ssql->sstr.create_index, $4, $6, $8, 1);
 			create_index_init(&CONTEXT->ssql->sstr.create_index, $4, $6, 1);
+			if ($13 != NULL) {
+				create_index_set_conditions(&CONTEXT->ssql->sstr.create_index, $13);
+			}
 		}
     ;
 Column_list:
@@ -301,6 +327,28 @@ Column_def:
 		create_index_append_attribute(&CONTEXT->ssql->sstr.create_index, $1);
 	}
 	;
+index_type_def:
+	/* empty */
+	| USING HASH {
+		create_index_set_type(&CONTEXT->ssql->sstr.create_index, INDEX_TYPE_HASH);
+	}
+	| USING BITMAP {
+		create_index_set_type(&CONTEXT->ssql->sstr.create_index, INDEX_TYPE_BITMAP);
+	}
+	;
+include_def:
+	/* empty */
+	| INCLUDE LBRACE include_attr include_list RBRACE { }
+	;
+include_list:
+	/* empty */
+	| COMMA include_attr include_list { }
+	;
+include_attr:
+	ID {
+		create_index_append_include(&CONTEXT->ssql->sstr.create_index, $1);
+	}
+	;
 drop_index:			/*drop index 语句的语法解析树*/
     DROP INDEX ID  SEMICOLON 
 		{
@@ -498,7 +546,7 @@ update:			/*  update 语句的语法解析树*/
 
 
 select:				/*  select 语句的语法解析树*/
-    SELECT select_attr from_rel join_list where group_by order_by SEMICOLON
+    SELECT select_attr from_rel join_list where group_by order_by limit SEMICOLON
 	    {
 			CONTEXT->ssql->flag=SCF_SELECT;//"select";
 
@@ -968,6 +1016,16 @@ order_by:
 	}
 	;
 
+limit:
+	/*empty*/
+	| LIMIT NUMBER {
+		selects_set_limit(&CONTEXT->ssql->sstr.selection, $2, 0);
+	}
+	| LIMIT NUMBER OFFSET NUMBER {
+		selects_set_limit(&CONTEXT->ssql->sstr.selection, $2, $4);
+	}
+	;
+
 sort_list:
 	sort_attr {
 		// order by A, B, C，实际上加入顺序为C、B、A，方便后面排序
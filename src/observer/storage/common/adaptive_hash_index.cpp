@@ -0,0 +1,100 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/common/adaptive_hash_index.h"
+
+AdaptiveHashIndex::Stripe &AdaptiveHashIndex::stripe_of(const std::string &key)
+{
+  return stripes_[std::hash<std::string>()(key) % ADAPTIVE_HASH_STRIPE_NUM];
+}
+
+bool AdaptiveHashIndex::lookup(const char *key, int key_length, PageNum *page_num, int *index_in_node)
+{
+  std::string hash_key(key, key_length);
+  Stripe &stripe = stripe_of(hash_key);
+  std::lock_guard<std::mutex> lock_guard(stripe.lock);
+
+  auto iter = stripe.entries.find(hash_key);
+  if (iter != stripe.entries.end())
+  {
+    Entry &entry = iter->second;
+    if (entry.page_num != BP_INVALID_PAGE_NUM)
+    {
+      *page_num = entry.page_num;
+      *index_in_node = entry.index_in_node;
+      hit_count_++;
+      return true;
+    }
+    entry.lookup_count++;
+    return false;
+  }
+
+  // 分片满了之后随便淘汰一个，保证占用的内存有上限
+  if (stripe.entries.size() >= ADAPTIVE_HASH_STRIPE_CAPACITY)
+  {
+    stripe.entries.erase(stripe.entries.begin());
+  }
+  stripe.entries[hash_key].lookup_count = 1;
+  return false;
+}
+
+void AdaptiveHashIndex::record(const char *key, int key_length, PageNum page_num, int index_in_node)
+{
+  std::string hash_key(key, key_length);
+  Stripe &stripe = stripe_of(hash_key);
+  std::lock_guard<std::mutex> lock_guard(stripe.lock);
+
+  auto iter = stripe.entries.find(hash_key);
+  if (iter != stripe.entries.end() && iter->second.lookup_count >= ADAPTIVE_HASH_HOT_THRESHOLD)
+  {
+    iter->second.page_num = page_num;
+    iter->second.index_in_node = index_in_node;
+  }
+}
+
+void AdaptiveHashIndex::invalidate_key(const char *key, int key_length)
+{
+  std::string hash_key(key, key_length);
+  Stripe &stripe = stripe_of(hash_key);
+  std::lock_guard<std::mutex> lock_guard(stripe.lock);
+
+  auto iter = stripe.entries.find(hash_key);
+  if (iter != stripe.entries.end())
+  {
+    iter->second.page_num = BP_INVALID_PAGE_NUM;
+    iter->second.index_in_node = -1;
+  }
+}
+
+void AdaptiveHashIndex::invalidate_page(PageNum page_num)
+{
+  for (Stripe &stripe : stripes_)
+  {
+    std::lock_guard<std::mutex> lock_guard(stripe.lock);
+    for (auto &item : stripe.entries)
+    {
+      if (item.second.page_num == page_num)
+      {
+        item.second.page_num = BP_INVALID_PAGE_NUM;
+        item.second.index_in_node = -1;
+      }
+    }
+  }
+}
+
+void AdaptiveHashIndex::clear()
+{
+  for (Stripe &stripe : stripes_)
+  {
+    std::lock_guard<std::mutex> lock_guard(stripe.lock);
+    stripe.entries.clear();
+  }
+  hit_count_ = 0;
+}
@@ -0,0 +1,73 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_ADAPTIVE_HASH_INDEX_H_
+#define __OBSERVER_STORAGE_COMMON_ADAPTIVE_HASH_INDEX_H_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "storage/default/disk_buffer_pool.h"
+
+#define ADAPTIVE_HASH_STRIPE_NUM 16
+#define ADAPTIVE_HASH_STRIPE_CAPACITY 256  // 每个分片最多保存的key数量，包括还没有变热的候选key
+#define ADAPTIVE_HASH_HOT_THRESHOLD 3      // 同一个key被查找这么多次之后才缓存它在叶子中的位置
+
+/**
+ * B+树上的自适应哈希索引，类似InnoDB的AHI。
+ * 记录经常被等值查找的key，缓存 key -> (叶子页面, 在叶子中的位置)，命中时不需要从根节点向下查找。
+ * 缓存的位置只是一个提示，使用前由BplusTreeHandler在叶子上校验；页面被释放时需要调用invalidate_page。
+ * 按照key的哈希值分成多个分片，每个分片一把锁
+ */
+class AdaptiveHashIndex {
+public:
+  AdaptiveHashIndex() = default;
+
+  /**
+   * 查找key缓存的位置。没有缓存时记录一次查找，返回false
+   */
+  bool lookup(const char *key, int key_length, PageNum *page_num, int *index_in_node);
+
+  /**
+   * 从根节点查找到key的位置之后调用，key足够热时缓存这个位置
+   */
+  void record(const char *key, int key_length, PageNum page_num, int index_in_node);
+
+  void invalidate_key(const char *key, int key_length);
+  void invalidate_page(PageNum page_num);
+  void clear();
+
+  long hit_count() const
+  {
+    return hit_count_;
+  }
+
+private:
+  struct Entry {
+    int lookup_count = 0;
+    PageNum page_num = BP_INVALID_PAGE_NUM;  // 还没有缓存位置时为BP_INVALID_PAGE_NUM
+    int index_in_node = -1;
+  };
+
+  struct Stripe {
+    std::mutex lock;
+    std::unordered_map<std::string, Entry> entries;
+  };
+
+  Stripe &stripe_of(const std::string &key);
+
+private:
+  Stripe stripes_[ADAPTIVE_HASH_STRIPE_NUM];
+  std::atomic<long> hit_count_{0};
+};
+
+#endif  //__OBSERVER_STORAGE_COMMON_ADAPTIVE_HASH_INDEX_H_
@@ -0,0 +1,373 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <string.h>
+#include <fstream>
+
+#include "storage/common/bitmap_index.h"
+#include "storage/common/bplus_tree.h"
+#include "common/log/log.h"
+
+#define BITMAP_INDEX_FILE_MAGIC 0x424d4958  // "BMIX"
+
+struct BitmapIndexFileHeader {
+  int magic;
+  int value_num;
+  int value_length;
+};
+
+BitmapIndex::~BitmapIndex() noexcept
+{
+  close();
+}
+
+RC BitmapIndex::create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+{
+  if (inited_) {
+    LOG_INFO("BitmapIndex::create - RC::RECORD_OPENNED");
+    return RC::RECORD_OPENNED;
+  }
+  RC rc = Index::init(index_meta, field_meta);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  file_name_ = file_name;
+  bitmaps_.clear();
+  row_num_ = 0;
+  rc = save();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  inited_ = true;
+  return RC::SUCCESS;
+}
+
+RC BitmapIndex::open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+{
+  if (inited_) {
+    return RC::RECORD_OPENNED;
+  }
+  RC rc = Index::init(index_meta, field_meta);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  file_name_ = file_name;
+  rc = load();
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to load bitmap index. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+  inited_ = true;
+  return RC::SUCCESS;
+}
+
+RC BitmapIndex::close()
+{
+  if (inited_) {
+    sync();
+    bitmaps_.clear();
+    row_num_ = 0;
+    inited_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+int BitmapIndex::Get_Field_Num() const
+{
+  return 1;
+}
+
+bool BitmapIndex::rid_to_row(const RID &rid, uint32_t *row)
+{
+  if (rid.page_num < 0 || rid.slot_num < 0 || rid.slot_num >= (1 << BITMAP_INDEX_SLOT_BITS) ||
+      rid.page_num >= (1 << (32 - BITMAP_INDEX_SLOT_BITS))) {
+    return false;
+  }
+  *row = ((uint32_t)rid.page_num << BITMAP_INDEX_SLOT_BITS) | (uint32_t)rid.slot_num;
+  return true;
+}
+
+RID BitmapIndex::row_to_rid(uint32_t row)
+{
+  RID rid;
+  rid.page_num = row >> BITMAP_INDEX_SLOT_BITS;
+  rid.slot_num = row & ((1 << BITMAP_INDEX_SLOT_BITS) - 1);
+  return rid;
+}
+
+// 字段值统一为字段长度的字节串。字符串按照strncpy的方式拷贝，条件中的字符串可能比字段短；
+// value为nullptr时是null值，与Table::make_record中填充的值一致
+std::string BitmapIndex::make_value(const char *value) const
+{
+  const FieldMeta &field_meta = fields_meta_[0];
+  std::string result(field_meta.len(), '\0');
+  if (value == nullptr) {
+    if (field_meta.type() == CHARS) {
+      strncpy(&result[0], "NULL", result.size());
+    } else if (field_meta.type() == DATES) {
+      int v = 19700101;
+      memcpy(&result[0], &v, sizeof(v));
+    }
+  } else if (field_meta.type() == CHARS) {
+    strncpy(&result[0], value, result.size());
+  } else {
+    memcpy(&result[0], value, result.size());
+  }
+  return result;
+}
+
+int BitmapIndex::compare_value(const std::string &left, const std::string &right) const
+{
+  return CompareKey(left.data(), right.data(), fields_meta_[0].type(), fields_meta_[0].len());
+}
+
+RC BitmapIndex::insert_entry(const char *record, const RID *rid)
+{
+  uint32_t row = 0;
+  if (!rid_to_row(*rid, &row)) {
+    LOG_ERROR("Rid cannot be stored in bitmap index. rid=%d:%d", rid->page_num, rid->slot_num);
+    return RC::INVALID_ARGUMENT;
+  }
+  // 和B+树索引一样，同一个值和RID的索引项已经存在时返回RECORD_DUPLICATE_KEY，更新记录时依赖这个返回值
+  RoaringBitmap &bitmap = bitmaps_[make_value(record + fields_meta_[0].offset())];
+  if (bitmap.contains(row)) {
+    return RC::RECORD_DUPLICATE_KEY;
+  }
+  bitmap.add(row);
+  row_num_++;
+  dirty_ = true;
+  return RC::SUCCESS;
+}
+
+RC BitmapIndex::delete_entry(const char *record, const RID *rid)
+{
+  uint32_t row = 0;
+  auto iter = bitmaps_.find(make_value(record + fields_meta_[0].offset()));
+  if (!rid_to_row(*rid, &row) || iter == bitmaps_.end() || !iter->second.contains(row)) {
+    return RC::RECORD_INVALID_KEY;
+  }
+  iter->second.remove(row);
+  row_num_--;
+  if (iter->second.empty()) {
+    bitmaps_.erase(iter);
+  }
+  dirty_ = true;
+  return RC::SUCCESS;
+}
+
+RC BitmapIndex::find_rows(CompOp comp_op, const char *value, RoaringBitmap &rows) const
+{
+  if (comp_op == EQUAL_TO || comp_op == IS_NULL) {
+    auto iter = bitmaps_.find(make_value(comp_op == IS_NULL ? nullptr : value));
+    if (iter != bitmaps_.end()) {
+      rows.or_with(iter->second);
+    }
+    return RC::SUCCESS;
+  }
+
+  if (comp_op != NOT_EQUAL && comp_op != LESS_EQUAL && comp_op != LESS_THAN && comp_op != GREAT_EQUAL &&
+      comp_op != GREAT_THAN && comp_op != IS_NOT_NULL) {
+    return RC::INVALID_ARGUMENT;
+  }
+  // 不同的值很少，逐个判断每个值是否满足条件，满足的位图做或运算
+  std::string key = comp_op == IS_NOT_NULL ? std::string() : make_value(value);
+  for (const auto &entry : bitmaps_) {
+    bool match = true;
+    if (comp_op != IS_NOT_NULL) {
+      int result = compare_value(entry.first, key);
+      switch (comp_op) {
+        case NOT_EQUAL: match = result != 0; break;
+        case LESS_EQUAL: match = result <= 0; break;
+        case LESS_THAN: match = result < 0; break;
+        case GREAT_EQUAL: match = result >= 0; break;
+        case GREAT_THAN: match = result > 0; break;
+        default: break;
+      }
+    }
+    if (match) {
+      rows.or_with(entry.second);
+    }
+  }
+  return RC::SUCCESS;
+}
+
+IndexScanner *BitmapIndex::create_scanner(RoaringBitmap &rows)
+{
+  return new BitmapIndexScanner(*this, rows);
+}
+
+IndexScanner *BitmapIndex::create_single_index_scanner(CompOp comp_op, const char *value, int null_field_index)
+{
+  RoaringBitmap rows;
+  if (find_rows(comp_op, value, rows) != RC::SUCCESS) {
+    return nullptr;
+  }
+  return create_scanner(rows);
+}
+
+IndexScanner *BitmapIndex::create_multi_index_scanner(const std::vector<CompOp> &comp_ops, const std::vector<const char *> &values, int &match_num)
+{
+  return nullptr;
+}
+
+IndexScanner *BitmapIndex::create_ordered_scanner(CompOp comp_op, const char *value, bool reverse)
+{
+  return nullptr;
+}
+
+RC BitmapIndex::get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids)
+{
+  std::vector<const char *> sorted_keys(keys);
+  sort_keys(sorted_keys);
+  for (const char *key : sorted_keys) {
+    auto iter = bitmaps_.find(make_value(key));
+    if (iter == bitmaps_.end()) {
+      continue;
+    }
+    RoaringBitmap::Iterator bitmap_iter(iter->second);
+    uint32_t row = 0;
+    while (bitmap_iter.next(&row)) {
+      rids.push_back(row_to_rid(row));
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void BitmapIndex::fill_value(uint32_t row, char *record) const
+{
+  for (const auto &entry : bitmaps_) {
+    if (entry.second.contains(row)) {
+      memcpy(record + fields_meta_[0].offset(), entry.first.data(), entry.first.size());
+      return;
+    }
+  }
+}
+
+RC BitmapIndex::sync()
+{
+  if (!dirty_) {
+    return RC::SUCCESS;
+  }
+  RC rc = save();
+  if (rc == RC::SUCCESS) {
+    dirty_ = false;
+  }
+  return rc;
+}
+
+RC BitmapIndex::get_statistics(int *height, int *leaf_num)
+{
+  *height = 1;
+  *leaf_num = 1;
+  return RC::SUCCESS;
+}
+
+// 先写到临时文件再改名，写到一半出错时不会破坏原来的索引文件
+RC BitmapIndex::save() const
+{
+  std::string tmp_file = file_name_ + ".tmp";
+  std::fstream fs;
+  fs.open(tmp_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!fs.is_open()) {
+    LOG_ERROR("Failed to open bitmap index file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR_ACCESS;
+  }
+  BitmapIndexFileHeader header;
+  header.magic = BITMAP_INDEX_FILE_MAGIC;
+  header.value_num = bitmaps_.size();
+  header.value_length = fields_meta_[0].len();
+  fs.write((const char *)&header, sizeof(header));
+  for (const auto &entry : bitmaps_) {
+    fs.write(entry.first.data(), entry.first.size());
+    entry.second.write(fs);
+  }
+  if (!fs.good()) {
+    LOG_ERROR("Failed to write bitmap index file. file name=%s", tmp_file.c_str());
+    fs.close();
+    return RC::IOERR_WRITE;
+  }
+  fs.close();
+
+  if (rename(tmp_file.c_str(), file_name_.c_str()) != 0) {
+    LOG_ERROR("Failed to rename bitmap index file. %s -> %s, errmsg=%s", tmp_file.c_str(), file_name_.c_str(), strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+RC BitmapIndex::load()
+{
+  std::fstream fs;
+  fs.open(file_name_, std::ios_base::in | std::ios_base::binary);
+  if (!fs.is_open()) {
+    LOG_ERROR("Failed to open bitmap index file. file name=%s, errmsg=%s", file_name_.c_str(), strerror(errno));
+    return RC::IOERR_ACCESS;
+  }
+  BitmapIndexFileHeader header;
+  fs.read((char *)&header, sizeof(header));
+  if (!fs.good() || header.magic != BITMAP_INDEX_FILE_MAGIC || header.value_num < 0 ||
+      header.value_length != fields_meta_[0].len()) {
+    LOG_ERROR("Invalid bitmap index file. file name=%s", file_name_.c_str());
+    fs.close();
+    return RC::IOERR_DATA;
+  }
+
+  bitmaps_.clear();
+  row_num_ = 0;
+  for (int i = 0; i < header.value_num; i++) {
+    std::string value(header.value_length, '\0');
+    fs.read(&value[0], value.size());
+    RoaringBitmap &bitmap = bitmaps_[value];
+    if (!fs.good() || !bitmap.read(fs)) {
+      LOG_ERROR("Failed to read bitmap index file. file name=%s", file_name_.c_str());
+      bitmaps_.clear();
+      fs.close();
+      return RC::IOERR_SHORT_READ;
+    }
+    row_num_ += bitmap.cardinality();
+  }
+  fs.close();
+  return RC::SUCCESS;
+}
+
+BitmapIndexScanner::BitmapIndexScanner(const BitmapIndex &index, RoaringBitmap &rows) : index_(index), iterator_(rows_)
+{
+  rows_.swap(rows);
+}
+
+RC BitmapIndexScanner::next_entry(RID *rid)
+{
+  uint32_t row = 0;
+  if (!iterator_.next(&row)) {
+    return RC::RECORD_EOF;
+  }
+  *rid = BitmapIndex::row_to_rid(row);
+  return RC::SUCCESS;
+}
+
+RC BitmapIndexScanner::next_entry(RID *rid, char *record)
+{
+  uint32_t row = 0;
+  if (!iterator_.next(&row)) {
+    return RC::RECORD_EOF;
+  }
+  *rid = BitmapIndex::row_to_rid(row);
+  index_.fill_value(row, record);
+  return RC::SUCCESS;
+}
+
+RC BitmapIndexScanner::destroy()
+{
+  delete this;
+  return RC::SUCCESS;
+}
@@ -0,0 +1,105 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_BITMAP_INDEX_H_
+#define __OBSERVER_STORAGE_COMMON_BITMAP_INDEX_H_
+
+#include <map>
+#include <string>
+
+#include "storage/common/index.h"
+#include "storage/common/roaring_bitmap.h"
+
+// 行号的低位是槽号。记录至少有4字节的事务字段，一个4K页面中的槽号不会超过1024
+#define BITMAP_INDEX_SLOT_BITS 10
+
+/**
+ * CREATE INDEX ... USING BITMAP 创建的索引，适合取值种类很少的单个字段。
+ * 每个不同的值对应一个压缩位图，记录取这个值的所有行号，行号由RID的页号和槽号拼成。
+ * 位图常驻内存，sync/close时整体写入索引文件，open时读回。
+ * NULL值和B+树索引一样按照填充的默认值保存，由扫描时的过滤条件再判断一次
+ */
+class BitmapIndex : public Index {
+public:
+  BitmapIndex() = default;
+  virtual ~BitmapIndex() noexcept;
+
+  RC create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
+  RC close();
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+  int Get_Field_Num() const override;
+
+  // 位图索引只有一个字段，多字段的条件都由create_single_index_scanner处理，这里总是返回nullptr
+  IndexScanner *create_multi_index_scanner(const std::vector<CompOp> &comp_ops, const std::vector<const char *> &values,int &match_num) override;
+  IndexScanner *create_single_index_scanner(CompOp comp_op, const char *value, int null_field_index) override;
+  // 位图按照行号组织，不能按照字段值的顺序输出，总是返回nullptr
+  IndexScanner *create_ordered_scanner(CompOp comp_op, const char *value, bool reverse) override;
+  RC get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids) override;
+  RC sync() override;
+  // 位图常驻内存，查找不读页面
+  RC get_statistics(int *height, int *leaf_num) override;
+
+  /**
+   * 把满足 字段 comp_op value 的行号合并(OR)到rows中。
+   * 等值条件直接取对应的位图，其它条件把满足条件的各个值的位图按字做或运算。
+   * 不支持的比较符返回RC::INVALID_ARGUMENT
+   */
+  RC find_rows(CompOp comp_op, const char *value, RoaringBitmap &rows) const;
+  // 用计算好的行号集合创建扫描器，rows的内容会被取走
+  IndexScanner *create_scanner(RoaringBitmap &rows);
+  // 索引中的总行数
+  uint64_t row_num() const
+  {
+    return row_num_;
+  }
+
+  // 行号和RID的相互转换
+  static bool rid_to_row(const RID &rid, uint32_t *row);
+  static RID row_to_rid(uint32_t row);
+  // 找到行号所在的位图，把对应的字段值写回到record中，用于索引覆盖扫描
+  void fill_value(uint32_t row, char *record) const;
+
+private:
+  std::string make_value(const char *value) const;
+  int compare_value(const std::string &left, const std::string &right) const;
+  RC save() const;
+  RC load();
+
+private:
+  bool inited_ = false;
+  bool dirty_ = false;
+  std::string file_name_;
+  std::map<std::string, RoaringBitmap> bitmaps_;  // 字段值 -> 行号位图
+  uint64_t row_num_ = 0;
+};
+
+class BitmapIndexScanner : public IndexScanner {
+public:
+  BitmapIndexScanner(const BitmapIndex &index, RoaringBitmap &rows);
+  ~BitmapIndexScanner() noexcept override = default;
+
+  RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, char *record) override;
+  const Index &index() const override
+  {
+    return index_;
+  }
+  RC destroy() override;
+
+private:
+  const BitmapIndex &index_;
+  RoaringBitmap rows_;
+  RoaringBitmap::Iterator iterator_;
+};
+
+#endif  //__OBSERVER_STORAGE_COMMON_BITMAP_INDEX_H_
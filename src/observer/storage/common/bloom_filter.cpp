@@ -0,0 +1,131 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <string.h>
+#include <fstream>
+
+#include "storage/common/bloom_filter.h"
+#include "common/log/log.h"
+
+#define BLOOM_FILE_MAGIC 0x424c4f4d  // "BLOM"
+#define BLOOM_BLOCK_BITS (BLOOM_BLOCK_WORDS * 64)
+
+struct BloomFileHeader {
+  int magic;
+  int block_num;
+  int capacity;
+  int key_num;
+};
+
+void BloomFilter::init(int capacity)
+{
+  if (capacity < BLOOM_MIN_CAPACITY) {
+    capacity = BLOOM_MIN_CAPACITY;
+  }
+  capacity_ = capacity;
+  block_num_ = ((long)capacity * BLOOM_BITS_PER_KEY + BLOOM_BLOCK_BITS - 1) / BLOOM_BLOCK_BITS;
+  key_num_ = 0;
+  words_.assign((size_t)block_num_ * BLOOM_BLOCK_WORDS, 0);
+}
+
+void BloomFilter::clear()
+{
+  words_.clear();
+  block_num_ = 0;
+  capacity_ = 0;
+  key_num_ = 0;
+}
+
+// 高32位选择块，低32位用双重哈希生成块内的各个位
+const uint64_t *BloomFilter::block_of(uint64_t hash) const
+{
+  return &words_[(size_t)((hash >> 32) % block_num_) * BLOOM_BLOCK_WORDS];
+}
+
+void BloomFilter::add(uint64_t hash)
+{
+  uint64_t *block = const_cast<uint64_t *>(block_of(hash));
+  uint32_t h1 = (uint32_t)hash;
+  uint32_t h2 = (h1 >> 17) | 1;
+  for (int i = 0; i < BLOOM_PROBE_NUM; i++) {
+    uint32_t bit = (h1 + i * h2) % BLOOM_BLOCK_BITS;
+    block[bit / 64] |= (uint64_t)1 << (bit % 64);
+  }
+  key_num_++;
+}
+
+bool BloomFilter::may_contain(uint64_t hash) const
+{
+  const uint64_t *block = block_of(hash);
+  uint32_t h1 = (uint32_t)hash;
+  uint32_t h2 = (h1 >> 17) | 1;
+  for (int i = 0; i < BLOOM_PROBE_NUM; i++) {
+    uint32_t bit = (h1 + i * h2) % BLOOM_BLOCK_BITS;
+    if ((block[bit / 64] & ((uint64_t)1 << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC BloomFilter::save(const char *file_name) const
+{
+  std::fstream fs;
+  fs.open(file_name, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!fs.is_open()) {
+    LOG_ERROR("Failed to open bloom filter file for write. file name=%s, errmsg=%s", file_name, strerror(errno));
+    return RC::IOERR_ACCESS;
+  }
+  BloomFileHeader header;
+  header.magic = BLOOM_FILE_MAGIC;
+  header.block_num = block_num_;
+  header.capacity = capacity_;
+  header.key_num = key_num_;
+  fs.write((const char *)&header, sizeof(header));
+  fs.write((const char *)words_.data(), words_.size() * sizeof(uint64_t));
+  if (!fs.good()) {
+    LOG_ERROR("Failed to write bloom filter file. file name=%s", file_name);
+    fs.close();
+    return RC::IOERR_WRITE;
+  }
+  fs.close();
+  return RC::SUCCESS;
+}
+
+RC BloomFilter::load(const char *file_name)
+{
+  std::fstream fs;
+  fs.open(file_name, std::ios_base::in | std::ios_base::binary);
+  if (!fs.is_open()) {
+    return RC::IOERR_ACCESS;
+  }
+  BloomFileHeader header;
+  fs.read((char *)&header, sizeof(header));
+  if (!fs.good() || header.magic != BLOOM_FILE_MAGIC || header.block_num <= 0 || header.capacity <= 0) {
+    LOG_WARN("Invalid bloom filter file. file name=%s", file_name);
+    fs.close();
+    return RC::IOERR_DATA;
+  }
+  std::vector<uint64_t> words((size_t)header.block_num * BLOOM_BLOCK_WORDS);
+  fs.read((char *)words.data(), words.size() * sizeof(uint64_t));
+  if (!fs.good()) {
+    LOG_WARN("Failed to read bloom filter file. file name=%s", file_name);
+    fs.close();
+    return RC::IOERR_SHORT_READ;
+  }
+  fs.close();
+
+  words_.swap(words);
+  block_num_ = header.block_num;
+  capacity_ = header.capacity;
+  key_num_ = header.key_num;
+  return RC::SUCCESS;
+}
@@ -0,0 +1,65 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_BLOOM_FILTER_H_
+#define __OBSERVER_STORAGE_COMMON_BLOOM_FILTER_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "rc.h"
+
+#define BLOOM_BLOCK_WORDS 8     // 每个块64字节，正好是一个cache line
+#define BLOOM_PROBE_NUM 6       // 每个key在块内设置的位数
+#define BLOOM_BITS_PER_KEY 10   // 按照每个key 10位分配空间，误判率约1%
+#define BLOOM_MIN_CAPACITY 1024
+
+/**
+ * 分块的Bloom filter。一个key的所有位都落在同一个64字节的块中，判断时只访问一个cache line。
+ * 只能添加不能删除，添加的key数量超过capacity后误判率会升高，需要调用者重建
+ */
+class BloomFilter {
+public:
+  // 按照能容纳capacity个key分配空间，清空已有的内容
+  void init(int capacity);
+  void clear();
+
+  bool initialized() const
+  {
+    return !words_.empty();
+  }
+  int capacity() const
+  {
+    return capacity_;
+  }
+  // 添加过的key的个数，包括重复添加的
+  int key_num() const
+  {
+    return key_num_;
+  }
+
+  void add(uint64_t hash);
+  // 返回false时这个key一定没有添加过，返回true时可能添加过
+  bool may_contain(uint64_t hash) const;
+
+  RC save(const char *file_name) const;
+  RC load(const char *file_name);
+
+private:
+  const uint64_t *block_of(uint64_t hash) const;
+
+private:
+  std::vector<uint64_t> words_;
+  int block_num_ = 0;
+  int capacity_ = 0;
+  int key_num_ = 0;
+};
+
+#endif  //__OBSERVER_STORAGE_COMMON_BLOOM_FILTER_H_
@@ -17,6 +17,12 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "sql/parser/parse_defs.h"
 
+#include <climits>
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
 int float_compare(float f1, float f2)
 {
   float result = f1 - f2;
@@ -37,6 +43,36 @@ IndexNode *BplusTreeHandler::get_index_node(char *page_data) const
 
 RC BplusTreeHandler::sync()
 {
+  RC rc = merge_change_buffer();
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  // 根节点变化后要写回第一页的文件头，否则重新打开时从旧的根节点查找
+  if (header_dirty_)
+  {
+    BPPageHandle page_handle;
+    char *pdata;
+    rc = disk_buffer_pool_->get_this_page(file_id_, 1, &page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS)
+    {
+      disk_buffer_pool_->unpin_page(&page_handle);
+      return rc;
+    }
+    memcpy(pdata, &file_header_, sizeof(IndexFileHeader));
+    disk_buffer_pool_->mark_dirty(&page_handle);
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    header_dirty_ = false;
+  }
   return disk_buffer_pool_->flush_all_pages(file_id_);
 }
 
@@ -87,7 +123,7 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_
   file_header->total_attr_length = attr_length;
   file_header->key_length = attr_length + sizeof(RID);
   file_header->attr_type[0] = attr_type;
-  file_header->node_num = 1;
+  file_header->version = BPLUS_TREE_FILE_VERSION;
   file_header->order = ((int)BP_PAGE_DATA_SIZE - sizeof(IndexFileHeader) - sizeof(IndexNode)) / (attr_length + 2 * sizeof(RID));
   file_header->root_page = page_num;
   file_header->unique = is_unique;
@@ -117,15 +153,35 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_
   memcpy(&file_header_, pdata, sizeof(file_header_));
   header_dirty_ = false;
 
+  // 新建的索引是空的，可能存在的旧Bloom filter文件已经失效
+  bloom_file_ = std::string(file_name) + BPLUS_TREE_BLOOM_SUFFIX;
+  ::unlink(bloom_file_.c_str());
+  bloom_filter_.clear();
+  if (bloom_filter_enabled())
+  {
+    bloom_filter_.init(BLOOM_MIN_CAPACITY);
+  }
+
   return SUCCESS;
 }
 // 创建以file_name为名称的index文件
-RC BplusTreeHandler::create(const char *file_name, AttrType attr_type[], int attr_length[],int field_num, int is_unique)
+RC BplusTreeHandler::create(const char *file_name, AttrType attr_type[], int attr_length[],int field_num, int is_unique, int include_length)
 {
   BPPageHandle page_handle;
   IndexNode *root;
   char *pdata;
   RC rc;
+  // INCLUDE字段很多时键会很长，一个节点至少要放下几个键才能正常分裂和合并
+  int max_key_length = sizeof(RID) + include_length;
+  for (int i = 0; i < field_num; i++)
+  {
+    max_key_length += attr_length[i];
+  }
+  if (((int)BP_PAGE_DATA_SIZE - (int)sizeof(IndexFileHeader) - (int)sizeof(IndexNode)) / (max_key_length + (int)sizeof(RID)) < 4)
+  {
+    LOG_ERROR("Index key is too long to fit in a node. file name=%s, key length=%d", file_name, max_key_length);
+    return RC::INVALID_ARGUMENT;
+  }
   DiskBufferPool *disk_buffer_pool = theGlobalDiskBufferPool();
   rc = disk_buffer_pool->create_file(file_name);
   if (rc != SUCCESS)
@@ -169,13 +225,13 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type[], int att
     file_header->attr_length[i] = attr_length[i];
     total_attr_length += attr_length[i];
   }
-  file_header->key_length = total_attr_length+sizeof(RID);
+  file_header->key_length = total_attr_length + sizeof(RID) + include_length;
   file_header->total_attr_length = total_attr_length;
   for(int i = 0; i < field_num; i++){
     file_header->attr_type[i] = attr_type[i];
   }
-  file_header->node_num = 1;
-  file_header->order = ((int)BP_PAGE_DATA_SIZE - sizeof(IndexFileHeader) - sizeof(IndexNode)) / (total_attr_length + 2 * sizeof(RID));
+  file_header->version = BPLUS_TREE_FILE_VERSION;
+  file_header->order = ((int)BP_PAGE_DATA_SIZE - sizeof(IndexFileHeader) - sizeof(IndexNode)) / (file_header->key_length + sizeof(RID));
   file_header->root_page = page_num;
   file_header->unique = is_unique;
 
@@ -204,6 +260,15 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type[], int att
   memcpy(&file_header_, pdata, sizeof(file_header_));
   header_dirty_ = false;
 
+  // 新建的索引是空的，可能存在的旧Bloom filter文件已经失效
+  bloom_file_ = std::string(file_name) + BPLUS_TREE_BLOOM_SUFFIX;
+  ::unlink(bloom_file_.c_str());
+  bloom_filter_.clear();
+  if (bloom_filter_enabled())
+  {
+    bloom_filter_.init(BLOOM_MIN_CAPACITY);
+  }
+
   return SUCCESS;
 }
 
@@ -244,12 +309,50 @@ RC BplusTreeHandler::open(const char *file_name)
   {
     return rc;
   }
+
+  // 版本2之前的叶子在rids[order - 1].slot_num中保存的是-1，没有前驱指针，反向扫描会停在第一个叶子
+  if (file_header_.version < BPLUS_TREE_FILE_VERSION)
+  {
+    LOG_INFO("Upgrade index file %s from version %d, rebuild links to previous leaves", file_name, file_header_.version);
+    rc = rebuild_prev_links();
+    if (rc != SUCCESS)
+    {
+      LOG_ERROR("Failed to rebuild links to previous leaves. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+      disk_buffer_pool_->close_file(file_id_);
+      disk_buffer_pool_ = nullptr;
+      file_id_ = -1;
+      return rc;
+    }
+    file_header_.version = BPLUS_TREE_FILE_VERSION;
+    header_dirty_ = true;
+  }
+
+  // 加载上次正常关闭时保存的Bloom filter，然后马上删除文件。
+  // 异常退出时没有这个文件，第一次插入前会扫描叶子重新构造，不会漏掉已有的key
+  bloom_file_ = std::string(file_name) + BPLUS_TREE_BLOOM_SUFFIX;
+  bloom_filter_.clear();
+  if (bloom_filter_enabled() && bloom_filter_.load(bloom_file_.c_str()) == SUCCESS)
+  {
+    if (::unlink(bloom_file_.c_str()) != 0)
+    {
+      LOG_WARN("Failed to remove bloom filter file %s, errmsg=%s", bloom_file_.c_str(), strerror(errno));
+      bloom_filter_.clear();
+    }
+  }
   return SUCCESS;
 }
 
 RC BplusTreeHandler::close()
 {
+  adaptive_hash_index_.clear();
   sync();
+  if (bloom_filter_.initialized())
+  {
+    bloom_filter_.save(bloom_file_.c_str());
+    bloom_filter_.clear();
+  }
+  rightmost_leaf_ = -1;
+  append_run_ = 0;
   disk_buffer_pool_->close_file(file_id_);
   file_id_ = -1;
   disk_buffer_pool_ = nullptr;
@@ -440,6 +543,7 @@ RC BplusTreeHandler::insert_into_leaf(PageNum leaf_page, const char *pkey, const
       tmp = CmpKey(file_header_.attr_type, file_header_.attr_length, pkey, node->keys + insert_pos * file_header_.key_length, file_header_.field_num, file_header_.total_attr_length);
       if (tmp == 0) {
         // 当key和rid完全相同时才会返回这个错误，就表示没有必要插入，因为是同一个key与同一个rid，表示的相同的数据
+        disk_buffer_pool_->unpin_page(&page_handle);
         return RC::RECORD_DUPLICATE_KEY; // 不能直接当插入成功了 后面需要进行删除处理
       }
       if(tmp < 0)
@@ -517,7 +621,7 @@ RC BplusTreeHandler::insert_into_leaf_after_split(PageNum leaf_page, const char
   RC rc;
   BPPageHandle page_handle1, page_handle2;
   IndexNode *leaf, *new_node;
-  PageNum new_page, parent_page;
+  PageNum new_page, parent_page, next_leaf;
   RID *temp_pointers, tmprid;
   char *temp_keys, *new_key;
   char *pdata;
@@ -593,7 +697,12 @@ RC BplusTreeHandler::insert_into_leaf_after_split(PageNum leaf_page, const char
   memcpy(temp_keys + insert_pos * file_header_.key_length, pkey, file_header_.key_length);
   memcpy(temp_pointers + insert_pos, rid, sizeof(RID));
 
+  next_leaf = leaf->rids[file_header_.order - 1].page_num;
   split = file_header_.order / 2;
+  if (appending_ && next_leaf <= 0 && insert_pos == leaf->key_num)
+  {
+    split = append_split_position(file_header_.order);
+  }
 
   for (i = 0; i < split; i++)
   {
@@ -612,10 +721,15 @@ RC BplusTreeHandler::insert_into_leaf_after_split(PageNum leaf_page, const char
   free(temp_pointers);
   free(temp_keys);
 
-  memcpy(new_node->rids + file_header_.order - 1, leaf->rids + file_header_.order - 1, sizeof(RID));
-  tmprid.page_num = new_page;
-  tmprid.slot_num = -1;
-  memcpy(leaf->rids + file_header_.order - 1, &tmprid, sizeof(RID));
+  // 新叶子插在leaf和它原来的后继之间，前驱指针存放在rids[order - 1].slot_num中
+  tmprid.page_num = next_leaf;
+  tmprid.slot_num = leaf_page;
+  memcpy(new_node->rids + file_header_.order - 1, &tmprid, sizeof(RID));
+  leaf->rids[file_header_.order - 1].page_num = new_page;
+  if (next_leaf <= 0)
+  {
+    rightmost_leaf_ = new_page;
+  }
 
   new_key = (char *)malloc(file_header_.key_length);
   if (new_key == nullptr)
@@ -652,6 +766,13 @@ RC BplusTreeHandler::insert_into_leaf_after_split(PageNum leaf_page, const char
     return rc;
   }
 
+  rc = set_prev_leaf(next_leaf, new_page);
+  if (rc != SUCCESS)
+  {
+    free(new_key);
+    return rc;
+  }
+
   rc = insert_into_parent(parent_page, leaf_page, new_key, new_page); // 插入失败，应该回滚之前的叶子节点
   if (rc != SUCCESS)
   {
@@ -805,7 +926,12 @@ RC BplusTreeHandler::insert_intern_node_after_split(PageNum inter_page, PageNum
   memcpy(temp_keys + insert_pos * file_header_.key_length, pkey, file_header_.key_length);
   memcpy(temp_pointers + insert_pos + 1, &tmprid, sizeof(RID));
 
+  // 左边保留split - 1个key，第split - 1个key上移到父节点
   split = (file_header_.order + 1) / 2;
+  if (appending_ && insert_pos == inter_node->key_num)
+  {
+    split = append_split_position(file_header_.order);
+  }
 
   for (i = 0; i < split - 1; i++)
   {
@@ -1059,6 +1185,7 @@ RC BplusTreeHandler::is_key_duplicate(PageNum leaf_page,const char *pkey)
   for(int i = 0; i < node->key_num; i++){
     tmp = CompareKeys( pkey, node->keys + i * file_header_.key_length,file_header_.attr_type, file_header_.attr_length, file_header_.field_num);
     if (tmp==0) {
+      disk_buffer_pool_->unpin_page(&page_handle);
       return RC::INDEX_DUPLICATED;
     }
     /*   确定运行成功了将这个注释去掉  作为一个小优化
@@ -1074,11 +1201,213 @@ RC BplusTreeHandler::is_key_duplicate(PageNum leaf_page,const char *pkey)
   }
   return SUCCESS;
 }
+bool BplusTreeHandler::is_right_append(const char *pkey)
+{
+  if (rightmost_leaf_ <= 0)
+  {
+    return false;
+  }
+  BPPageHandle page_handle;
+  char *pdata;
+  RC rc = disk_buffer_pool_->get_this_page(file_id_, rightmost_leaf_, &page_handle);
+  if (rc != SUCCESS)
+  {
+    rightmost_leaf_ = -1;
+    return false;
+  }
+  bool append = false;
+  if (disk_buffer_pool_->get_data(&page_handle, &pdata) == SUCCESS)
+  {
+    IndexNode *node = get_index_node(pdata);
+    append = node->is_leaf && node->key_num > 0 && node->rids[file_header_.order - 1].page_num <= 0 &&
+             CmpKey(file_header_.attr_type, file_header_.attr_length, pkey,
+                    node->keys + (node->key_num - 1) * file_header_.key_length,
+                    file_header_.field_num, file_header_.total_attr_length) > 0;
+  }
+  disk_buffer_pool_->unpin_page(&page_handle);
+  return append;
+}
+
+// 递增插入时左边的节点不会再有插入，尽量装满；右边的节点只会继续被追加，留下10%
+int BplusTreeHandler::append_split_position(int total) const
+{
+  int right = total / 10;
+  return total - (right > 0 ? right : 1);
+}
+
+bool BplusTreeHandler::bloom_filter_enabled() const
+{
+  if (file_header_.unique != 1)
+  {
+    return false;
+  }
+  for (int i = 0; i < file_header_.field_num; i++)
+  {
+    if (file_header_.attr_type[i] == FLOATS)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 64位FNV-1a。字符串只计算'\0'之前的部分，和strncmp的比较规则保持一致
+uint64_t BplusTreeHandler::hash_key_attrs(const char *pkey) const
+{
+  uint64_t hash = 14695981039346656037ull;
+  int offset = 0;
+  for (int i = 0; i < file_header_.field_num; i++)
+  {
+    const char *value = pkey + offset;
+    int length = file_header_.attr_type[i] == CHARS ? (int)strnlen(value, file_header_.attr_length[i])
+                                                    : file_header_.attr_length[i];
+    for (int j = 0; j < length; j++)
+    {
+      hash ^= (unsigned char)value[j];
+      hash *= 1099511628211ull;
+    }
+    // 字段之间加入分隔，避免("ab","c")和("a","bc")的哈希值相同
+    hash ^= 0xff;
+    hash *= 1099511628211ull;
+    offset += file_header_.attr_length[i];
+  }
+  return hash;
+}
+
+RC BplusTreeHandler::build_bloom_filter()
+{
+  bloom_filter_.clear();
+  PageNum page_num;
+  RC rc = get_first_leaf_page(&page_num);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  std::vector<uint64_t> hashes;
+  BPPageHandle page_handle;
+  char *pdata;
+  while (page_num > 0)
+  {
+    rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS)
+    {
+      disk_buffer_pool_->unpin_page(&page_handle);
+      return rc;
+    }
+    IndexNode *node = get_index_node(pdata);
+    for (int i = 0; i < node->key_num; i++)
+    {
+      hashes.push_back(hash_key_attrs(node->keys + i * file_header_.key_length));
+    }
+    page_num = node->rids[file_header_.order - 1].page_num;
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+  }
+
+  bloom_filter_.init((int)hashes.size() * 2);
+  for (uint64_t hash : hashes)
+  {
+    bloom_filter_.add(hash);
+  }
+  LOG_INFO("Build bloom filter with %d keys, capacity=%d", (int)hashes.size(), bloom_filter_.capacity());
+  return SUCCESS;
+}
+
 int BplusTreeHandler::get_key_total_length() const
 {
   return file_header_.key_length;
 }
+RC BplusTreeHandler::get_statistics(int *height, int *leaf_num)
+{
+  RC rc = merge_change_buffer();
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  BPPageHandle page_handle;
+  char *pdata;
+  IndexNode *node;
+  PageNum page_num = file_header_.root_page;
+
+  // 沿着最左边的路径向下，得到树的高度
+  *height = 0;
+  while (true)
+  {
+    rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS)
+    {
+      disk_buffer_pool_->unpin_page(&page_handle);
+      return rc;
+    }
+    node = get_index_node(pdata);
+    (*height)++;
+    bool is_leaf = node->is_leaf;
+    page_num = node->rids[is_leaf ? file_header_.order - 1 : 0].page_num;
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    if (is_leaf)
+    {
+      break;
+    }
+  }
+
+  // 沿着叶子节点的后继指针数出叶子节点的个数
+  *leaf_num = 1;
+  while (page_num > 0)
+  {
+    (*leaf_num)++;
+    rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS)
+    {
+      disk_buffer_pool_->unpin_page(&page_handle);
+      return rc;
+    }
+    page_num = get_index_node(pdata)->rids[file_header_.order - 1].page_num;
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+  }
+  return SUCCESS;
+}
 RC BplusTreeHandler::insert_entry(const char *pkey, const RID *rid)
+{
+  if (nullptr == disk_buffer_pool_)
+  {
+    return RC::RECORD_CLOSED;
+  }
+  bool buffered = false;
+  RC rc = buffer_change(pkey, rid, true, &buffered);
+  if (rc != SUCCESS || buffered)
+  {
+    return rc;
+  }
+  return insert_entry_into_tree(pkey, rid);
+}
+
+RC BplusTreeHandler::insert_entry_into_tree(const char *pkey, const RID *rid)
 {
   LOG_INFO("调用bplustree handler中的insert_entry");
   RC rc;
@@ -1090,6 +1419,14 @@ RC BplusTreeHandler::insert_entry(const char *pkey, const RID *rid)
   {
     return RC::RECORD_CLOSED;
   }
+  if (bloom_filter_enabled() && !bloom_filter_.initialized())
+  {
+    rc = build_bloom_filter();
+    if (rc != SUCCESS)
+    {
+      LOG_WARN("Failed to build bloom filter. rc=%d:%s", rc, strrc(rc));
+    }
+  }
   key = (char *)malloc(file_header_.key_length);
   if (key == nullptr)
   {
@@ -1103,11 +1440,27 @@ RC BplusTreeHandler::insert_entry(const char *pkey, const RID *rid)
   memcpy(key, pkey, file_header_.total_attr_length);
   memcpy(key + file_header_.total_attr_length, rid, sizeof(*rid));
   // key={attr1+attr2+rid}   rid表示实际存储的位置
-  rc = find_leaf(key, &leaf_page,file_header_.field_num);
-  if (rc != SUCCESS)
+  // 有INCLUDE字段时，pkey中RID后面紧跟着INCLUDE字段的值
+  int include_length = file_header_.key_length - file_header_.total_attr_length - sizeof(RID);
+  if (include_length > 0)
   {
-    free(key);
-    return rc;
+    memcpy(key + file_header_.total_attr_length + sizeof(RID), pkey + file_header_.total_attr_length + sizeof(RID), include_length);
+  }
+  // 递增插入时key总是落在最右边的叶子上，不需要从根节点向下查找
+  bool right_edge = is_right_append(key);
+  if (right_edge)
+  {
+    leaf_page = rightmost_leaf_;
+    right_append_count_++;
+  }
+  else
+  {
+    rc = find_leaf(key, &leaf_page,file_header_.field_num);
+    if (rc != SUCCESS)
+    {
+      free(key);
+      return rc;
+    }
   }
 
   rc = disk_buffer_pool_->get_this_page(file_id_, leaf_page, &page_handle);
@@ -1124,13 +1477,38 @@ RC BplusTreeHandler::insert_entry(const char *pkey, const RID *rid)
     return rc;
   }
   leaf = (IndexNode *)(pdata + sizeof(IndexFileHeader));
+  if (leaf->rids[file_header_.order - 1].page_num <= 0)
+  {
+    rightmost_leaf_ = leaf_page;
+    right_edge = leaf->key_num == 0 ||
+                 CmpKey(file_header_.attr_type, file_header_.attr_length, key,
+                        leaf->keys + (leaf->key_num - 1) * file_header_.key_length,
+                        file_header_.field_num, file_header_.total_attr_length) > 0;
+  }
+  append_run_ = right_edge ? append_run_ + 1 : 0;
+  appending_ = append_run_ >= BPLUS_TREE_APPEND_RUN;
   // 首先进行unique index 判断如果是unique 是否重复 提前进行判断在insert_into_leaf中便不再进行判断
+  // Bloom filter判定key一定不存在时不需要扫描叶子，误判时仍然走原来的检查
+  uint64_t hash = 0;
+  bool use_bloom = bloom_filter_.initialized();
+  if (use_bloom)
+  {
+    hash = hash_key_attrs(key);
+  }
   if (file_header_.unique==1){
-    rc = is_key_duplicate(leaf_page,key);
-    if (rc != SUCCESS)
+    if (use_bloom && !bloom_filter_.may_contain(hash))
     {
-      free(key);
-      return rc;
+      bloom_skip_count_++;
+    }
+    else
+    {
+      rc = is_key_duplicate(leaf_page,key);
+      if (rc != SUCCESS)
+      {
+        disk_buffer_pool_->unpin_page(&page_handle);
+        free(key);
+        return rc;
+      }
     }
   }
   if (leaf->key_num < file_header_.order - 1)
@@ -1162,6 +1540,15 @@ RC BplusTreeHandler::insert_entry(const char *pkey, const RID *rid)
     rc = insert_into_leaf_after_split(leaf_page, key, rid);
     free(key);
   }
+  if (use_bloom)
+  {
+    bloom_filter_.add(hash);
+    // 超过容量后误判率升高，按照现在的key数量重建，同时清掉已删除key留下的位
+    if (bloom_filter_.key_num() > bloom_filter_.capacity() && build_bloom_filter() != SUCCESS)
+    {
+      LOG_WARN("Failed to rebuild bloom filter, it will be rebuilt before next insert");
+    }
+  }
   // print();
   return SUCCESS;
 }
@@ -1175,6 +1562,12 @@ RC BplusTreeHandler::get_entry(const char *pkey, RID *rid)
   char *pdata, *key;
   IndexNode *leaf;
 
+  rc = merge_change_buffer();
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+
   key = (char *)malloc(file_header_.key_length);
   if (key == nullptr)
   {
@@ -1250,6 +1643,7 @@ RC BplusTreeHandler::delete_entry_from_node(PageNum node_page, const char *pkey)
   }
   if (delete_index >= node->key_num)
   {
+    disk_buffer_pool_->unpin_page(&page_handle);
     return RC::RECORD_INVALID_KEY;
   }
   i = delete_index;
@@ -1286,7 +1680,7 @@ RC BplusTreeHandler::coalesce_node(PageNum leaf_page, PageNum right_page)
   BPPageHandle left_handle, right_handle, parent_handle, tmphandle;
   IndexNode *left, *right, *parent, *node;
   char *pdata, *tmp_key;
-  PageNum parent_page;
+  PageNum parent_page, next_leaf = -1;
   RC rc;
   int i, j, k, start;
 
@@ -1351,7 +1745,11 @@ RC BplusTreeHandler::coalesce_node(PageNum leaf_page, PageNum right_page)
   }
 
   if (left->is_leaf)
-    memcpy(left->rids + file_header_.order - 1, right->rids + file_header_.order - 1, sizeof(RID));
+  {
+    // 只接管right的后继，left自己的前驱不变
+    next_leaf = right->rids[file_header_.order - 1].page_num;
+    left->rids[file_header_.order - 1].page_num = next_leaf;
+  }
   else
   {
     memcpy(left->rids + i, right->rids + j, sizeof(RID));
@@ -1410,12 +1808,19 @@ RC BplusTreeHandler::coalesce_node(PageNum leaf_page, PageNum right_page)
     free(tmp_key);
     return rc;
   }
+  adaptive_hash_index_.invalidate_page(right_page);
   rc = disk_buffer_pool_->dispose_page(file_id_, right_page);
   if (rc != SUCCESS)
   {
     free(tmp_key);
     return rc;
   }
+  rc = set_prev_leaf(next_leaf, leaf_page);
+  if (rc != SUCCESS)
+  {
+    free(tmp_key);
+    return rc;
+  }
 
   rc = disk_buffer_pool_->unpin_page(&parent_handle);
   if (rc != SUCCESS)
@@ -1511,6 +1916,7 @@ RC BplusTreeHandler::redistribute_nodes(PageNum leaf_page, PageNum right_page)
         memcpy(right->rids + i, right->rids + i - 1, sizeof(RID));
       }
       memcpy(right->keys, left->keys + (left->key_num - 1) * file_header_.key_length, file_header_.key_length);
+      memcpy(right->rids, left->rids + left->key_num - 1, sizeof(RID));
 
       left->key_num--;
       right->key_num++;
@@ -1532,6 +1938,8 @@ RC BplusTreeHandler::redistribute_nodes(PageNum leaf_page, PageNum right_page)
         memcpy(right->keys + i * file_header_.key_length, right->keys + (i + 1) * file_header_.key_length, file_header_.key_length);
         memcpy(right->rids + i, right->rids + i + 1, sizeof(RID));
       }
+      // 中间节点的指针比key多一个，最后一个指针也要左移
+      memcpy(right->rids + i, right->rids + i + 1, sizeof(RID));
       right->key_num--;
 
       rc = disk_buffer_pool_->get_this_page(file_id_, left->rids[left->key_num].page_num, &tmphandle);
@@ -1559,6 +1967,8 @@ RC BplusTreeHandler::redistribute_nodes(PageNum leaf_page, PageNum right_page)
     }
     else
     {
+      // 中间节点的指针比key多一个，最后一个指针也要右移
+      memcpy(right->rids + right->key_num + 1, right->rids + right->key_num, sizeof(RID));
       for (i = right->key_num; i > 0; i--)
       {
         memcpy(right->keys + i * file_header_.key_length, right->keys + (i - 1) * file_header_.key_length, file_header_.key_length);
@@ -1693,6 +2103,7 @@ RC BplusTreeHandler::delete_entry_internal(PageNum page_num, const char *pkey)
       {
         return rc;
       }
+      adaptive_hash_index_.invalidate_page(page_num);
       rc = disk_buffer_pool_->dispose_page(file_id_, page_num);
       if (rc != SUCCESS)
       {
@@ -1858,28 +2269,195 @@ RC BplusTreeHandler::delete_entry_internal(PageNum page_num, const char *pkey)
 // 
 RC BplusTreeHandler::delete_entry(const char *data, const RID *rid)
 {
-  RC rc;
-  PageNum leaf_page;
-  char *pkey;
-  pkey = (char *)malloc(file_header_.key_length);
-  if (nullptr == pkey)
+  if (nullptr == disk_buffer_pool_)
   {
-    LOG_ERROR("Failed to alloc memory for key. size=%d", file_header_.key_length);
-    return RC::NOMEM;
+    return RC::RECORD_CLOSED;
   }
-  // key已经包含了rid
-  memcpy(pkey, data, file_header_.total_attr_length);
-  memcpy(pkey + file_header_.total_attr_length, rid, sizeof(*rid));
- 
-  // memcpy(pkey, data, file_header_.key_length);
-  
-  rc = find_leaf(pkey, &leaf_page,file_header_.field_num);
-  if (rc != SUCCESS)
+  bool buffered = false;
+  RC rc = buffer_change(data, rid, false, &buffered);
+  if (rc != SUCCESS || buffered)
   {
-    free(pkey);
     return rc;
   }
-  rc = delete_entry_internal(leaf_page, pkey);
+  return delete_entry_from_tree(data, rid);
+}
+
+// 非唯一、没有INCLUDE字段的索引才缓冲修改：唯一索引插入时必须马上检查重复，
+// 而更新INCLUDE字段的值依赖于插入已经存在的索引项时返回RECORD_DUPLICATE_KEY
+bool BplusTreeHandler::change_buffer_enabled() const
+{
+  return file_header_.unique == 0 && file_header_.key_length == file_header_.total_attr_length + (int)sizeof(RID);
+}
+
+RC BplusTreeHandler::buffer_change(const char *pkey, const RID *rid, bool is_insert, bool *buffered)
+{
+  *buffered = false;
+  if (!change_buffer_enabled())
+  {
+    return SUCCESS;
+  }
+  std::string key(pkey, file_header_.total_attr_length);
+  key.append((const char *)rid, sizeof(RID));
+  int operation = change_buffer_.operation(key);
+  if (!is_insert)
+  {
+    // 只有缓冲区中有这个索引项的插入时，才能不读叶子就确定索引项存在。
+    // 已经缓冲了删除的索引项不存在，和直接删除一样返回RECORD_INVALID_KEY；没有缓冲的修改时直接删除叶子中的索引项
+    if (operation == ChangeBuffer::DELETE)
+    {
+      return RC::RECORD_INVALID_KEY;
+    }
+    if (operation == 0)
+    {
+      return SUCCESS;
+    }
+  }
+  // 这个索引项上已经有缓冲的修改时，后面的修改也要进入缓冲区，保证先后顺序
+  if (operation == 0)
+  {
+    bool resident = false;
+    RC rc = is_leaf_resident(key.data(), &resident);
+    if (rc != SUCCESS || resident)
+    {
+      return rc;
+    }
+  }
+  change_buffer_.add(key, is_insert);
+  buffered_change_count_++;
+  *buffered = true;
+  if (change_buffer_.size() >= CHANGE_BUFFER_CAPACITY)
+  {
+    return merge_change_buffer();
+  }
+  return SUCCESS;
+}
+
+RC BplusTreeHandler::merge_change_buffer()
+{
+  if (change_buffer_.empty())
+  {
+    return SUCCESS;
+  }
+  std::vector<std::pair<std::string, int>> changes;
+  change_buffer_.take(changes);
+  // 按照key的顺序合并，相邻的修改大多落在同一个叶子上
+  std::sort(changes.begin(), changes.end(), [this](const std::pair<std::string, int> &c1, const std::pair<std::string, int> &c2) {
+    return CmpKey(file_header_.attr_type, file_header_.attr_length, c1.first.data(), c2.first.data(),
+                  file_header_.field_num, file_header_.total_attr_length) < 0;
+  });
+
+  RC rc = SUCCESS;
+  size_t i = 0;
+  for (; i < changes.size() && rc == SUCCESS; i++)
+  {
+    const char *key = changes[i].first.data();
+    const RID *rid = (const RID *)(key + file_header_.total_attr_length);
+    if (changes[i].second & ChangeBuffer::DELETE)
+    {
+      rc = delete_entry_from_tree(key, rid);
+      if (rc == RC::RECORD_INVALID_KEY)
+      {
+        rc = SUCCESS;
+      }
+    }
+    if (rc == SUCCESS && (changes[i].second & ChangeBuffer::INSERT))
+    {
+      rc = insert_entry_into_tree(key, rid);
+      if (rc == RC::RECORD_DUPLICATE_KEY)
+      {
+        rc = SUCCESS;
+      }
+    }
+  }
+  if (rc != SUCCESS)
+  {
+    LOG_ERROR("Failed to merge change buffer. rc=%d:%s", rc, strrc(rc));
+    // 没有合并的修改放回缓冲区，下次再试
+    for (size_t j = i - 1; j < changes.size(); j++)
+    {
+      if (changes[j].second & ChangeBuffer::DELETE)
+      {
+        change_buffer_.add(changes[j].first, false);
+      }
+      if (changes[j].second & ChangeBuffer::INSERT)
+      {
+        change_buffer_.add(changes[j].first, true);
+      }
+    }
+  }
+  return rc;
+}
+
+// 和find_leaf一样从根节点向下查找，遇到不在buffer pool中的页面就停下来，不会从磁盘读取页面
+RC BplusTreeHandler::is_leaf_resident(const char *pkey, bool *resident)
+{
+  BPPageHandle page_handle;
+  char *pdata;
+  PageNum page_num = file_header_.root_page;
+  while (true)
+  {
+    if (!disk_buffer_pool_->is_page_resident(file_id_, page_num))
+    {
+      *resident = false;
+      return SUCCESS;
+    }
+    RC rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    disk_buffer_pool_->get_data(&page_handle, &pdata);
+    IndexNode *node = get_index_node(pdata);
+    if (node->is_leaf)
+    {
+      *resident = true;
+      return disk_buffer_pool_->unpin_page(&page_handle);
+    }
+    int i;
+    for (i = 0; i < node->key_num; i++)
+    {
+      if (CmpKey(file_header_.attr_type, file_header_.attr_length, pkey, node->keys + i * file_header_.key_length,
+                 file_header_.field_num, file_header_.total_attr_length) < 0)
+      {
+        break;
+      }
+    }
+    page_num = node->rids[i].page_num;
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+  }
+}
+
+RC BplusTreeHandler::delete_entry_from_tree(const char *data, const RID *rid)
+{
+  RC rc;
+  PageNum leaf_page;
+  char *pkey;
+  // 合并节点时叶子页面可能被释放，不再使用缓存的最右叶子
+  rightmost_leaf_ = -1;
+  append_run_ = 0;
+  pkey = (char *)malloc(file_header_.key_length);
+  if (nullptr == pkey)
+  {
+    LOG_ERROR("Failed to alloc memory for key. size=%d", file_header_.key_length);
+    return RC::NOMEM;
+  }
+  // key已经包含了rid
+  memcpy(pkey, data, file_header_.total_attr_length);
+  memcpy(pkey + file_header_.total_attr_length, rid, sizeof(*rid));
+ 
+  // memcpy(pkey, data, file_header_.key_length);
+  
+  rc = find_leaf(pkey, &leaf_page,file_header_.field_num);
+  if (rc != SUCCESS)
+  {
+    free(pkey);
+    return rc;
+  }
+  rc = delete_entry_internal(leaf_page, pkey);
   if (rc != SUCCESS)
   {
     free(pkey);
@@ -1974,49 +2552,24 @@ RC BplusTreeHandler::print_tree()
 
 
 
-RC BplusTreeHandler::find_first_index_satisfied_single(CompOp compop, const char *key, PageNum *page_num, int *rididx)
+// 找到第一个严格大于pkey的索引项(比较前cmp_attr_num个属性，属性相同时比较RID)
+// pkey中的RID可以填(-1,-1)或(INT_MAX,INT_MAX)来表示"大于等于"或"严格大于"属性前缀
+RC BplusTreeHandler::find_first_index_satisfied(const char *pkey, int cmp_attr_num, PageNum *page_num, int *rididx)
 {
-  // 因为是单个index,所以对应的IndexFileHeader中对应的数组内容只有一个元素
-  // 凡是涉及数组访问均取第一个元素
   BPPageHandle page_handle;
   IndexNode *node;
   PageNum leaf_page, next;
-  char *pdata, *pkey;
+  char *pdata;
   RC rc;
-  int i, tmp;
-  RID rid;
-  if (compop == LESS_THAN || compop == LESS_EQUAL || compop == NOT_EQUAL || compop == IS_NOT_NULL)
-  {
-    rc = get_first_leaf_page(page_num);
-    if (rc != SUCCESS)
-    {
-      return rc;
-    }
-    *rididx = 0;
-    return SUCCESS;
-  }
-  rid.page_num = -1;
-  rid.slot_num = -1;
-  pkey = (char *)malloc(file_header_.key_length);
-  if (pkey == nullptr)
-  {
-    LOG_ERROR("Failed to alloc memory for key. size=%d", file_header_.key_length);
-    return RC::NOMEM;
-  }
-  
-  memcpy(pkey, key, file_header_.total_attr_length);
-  memcpy(pkey + file_header_.total_attr_length, &rid, sizeof(RID));
-  // 因为是single_index, 所以这里attr_num = 1
-  rc = find_leaf(pkey, &leaf_page,1);   // 返回的叶子就是包含刚好比给定value大的key，现在只关心>,>=与=
+  int i;
+
+  rc = find_leaf(pkey, &leaf_page, cmp_attr_num);
   if (rc != SUCCESS)
   {
-    free(pkey);
     return rc;
   }
-  free(pkey);
 
   next = leaf_page;
-
   while (next > 0)
   {
     rc = disk_buffer_pool_->get_this_page(file_id_, next, &page_handle);
@@ -2027,251 +2580,195 @@ RC BplusTreeHandler::find_first_index_satisfied_single(CompOp compop, const char
     rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
     if (rc != SUCCESS)
     {
+      disk_buffer_pool_->unpin_page(&page_handle);
       return rc;
     }
 
     node = get_index_node(pdata);
     for (i = 0; i < node->key_num; i++)
     {
-      if (compop == IS_NULL)
-      {
-        // 找出所有可能是null的值
-        // 实际上是否为null依靠add_record判断
-        switch (file_header_.attr_type[0])
-        {
-        case INTS:
-        {
-          int v = 0;
-          tmp = CompareKey(node->keys + i * file_header_.key_length, (const char *)(&v), file_header_.attr_type[0], file_header_.attr_length[0]);
-        }
-        break;
-        case CHARS:
-        {
-          const char *v = "NULL";
-          tmp = CompareKey(node->keys + i * file_header_.key_length, v, file_header_.attr_type[0], file_header_.attr_length[0]);
-        }
-        break;
-        case FLOATS:
-        {
-          float v = 0.0;
-          tmp = CompareKey(node->keys + i * file_header_.key_length, (const char *)(&v), file_header_.attr_type[0], file_header_.attr_length[0]);
-        }
-        break;
-        case DATES:
-        {
-          int v = 19700101;
-          tmp = CompareKey(node->keys + i * file_header_.key_length, (const char *)(&v), file_header_.attr_type[0], file_header_.attr_length[0]);
-        }
-        break;
-        default:
-          LOG_ERROR("Error type");
-          break;
-        }
-        if (tmp >= 0) {
-          rc = disk_buffer_pool_->get_page_num(&page_handle, page_num);
-          if (rc != SUCCESS)
-          {
-            return rc;
-          }
-          *rididx = i;
-          rc = disk_buffer_pool_->unpin_page(&page_handle);
-          if (rc != SUCCESS)
-          {
-            return rc;
-          }
-        }
-      }
-
-      tmp = CompareKeys(node->keys + i * file_header_.key_length, key, file_header_.attr_type, file_header_.attr_length, file_header_.field_num);
-      if (compop == EQUAL_TO || compop == GREAT_EQUAL)
-      {
-        if (tmp >= 0)
-        {
-          rc = disk_buffer_pool_->get_page_num(&page_handle, page_num);
-          if (rc != SUCCESS)
-          {
-            return rc;
-          }
-          *rididx = i;
-          rc = disk_buffer_pool_->unpin_page(&page_handle);
-          if (rc != SUCCESS)
-          {
-            return rc;
-          }
-        }
-      }
-
-      if (compop == GREAT_THAN)
+      if (CmpKey(file_header_.attr_type, file_header_.attr_length, node->keys + i * file_header_.key_length, pkey, cmp_attr_num, file_header_.total_attr_length) > 0)
       {
-        if (tmp > 0)
-        {
-          rc = disk_buffer_pool_->get_page_num(&page_handle, page_num);
-          if (rc != SUCCESS)
-          {
-            return rc;
-          }
-          *rididx = i;
-          rc = disk_buffer_pool_->unpin_page(&page_handle);
-          if (rc != SUCCESS)
-          {
-            return rc;
-          }
-          return SUCCESS;
-        }
+        *page_num = next;
+        *rididx = i;
+        return disk_buffer_pool_->unpin_page(&page_handle);
       }
     }
+
+    // 当前叶子中的key都不满足，沿着兄弟指针继续找
     next = node->rids[file_header_.order - 1].page_num;
-  }
-  rc = disk_buffer_pool_->unpin_page(&page_handle);
-  if (rc != SUCCESS)
-  {
-    return rc;
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
   }
   return RC::RECORD_EOF;
 }
 
-RC BplusTreeHandler::find_first_index_satisfied_multi(std::vector<CompOp> comp_ops, std::vector<const char *>key, PageNum *page_num, int *rididx)
+RC BplusTreeHandler::find_first_equal_index(const char *pkey, PageNum *page_num, int *rididx)
 {
-  // comp_ops中元素形式为 = ... = x 前几个为=，最后一个不为= 比如a=x,b=y,c>=z CompOp = 0表示为“=”
-  int cmp_size = comp_ops.size(); 
-  CompOp compop = CompOp::EQUAL_TO;
-  for(int i = 0; i < comp_ops.size(); i++){
-    if(comp_ops[i] != CompOp::EQUAL_TO){
-      compop = comp_ops[i];
-      cmp_size = i+1;
-      break;
-    }
-  }
-  //CompOp compop = comp_ops[cmp_size-1];
-  BPPageHandle page_handle;
-  IndexNode *node;
-  PageNum leaf_page, next;
-  char *pdata, *pkey;
-  RC rc;
-  int i, tmp;
-  RID rid;
-  if (compop == LESS_THAN || compop == LESS_EQUAL || compop == NOT_EQUAL)
+  const int attr_length = file_header_.total_attr_length;
+  PageNum cached_page;
+  int cached_index;
+  if (adaptive_hash_index_.lookup(pkey, attr_length, &cached_page, &cached_index))
   {
-    if(cmp_size==1){
-      rc = get_first_leaf_page(page_num);
-      if (rc != SUCCESS)
-      {
-        return rc;
-      }
-      *rididx = 0;
+    if (is_first_equal_entry(cached_page, cached_index, pkey))
+    {
+      *page_num = cached_page;
+      *rididx = cached_index;
       return SUCCESS;
-    }else{
-      // 因为前几个条件是=，将前几个=当做一个key来执行 a=x b=y 相当于寻找满足a=x b=y的第一个index
-      cmp_size-=1;
-      // compop = comp_ops[cmp_size];
-      compop = EQUAL_TO;
-    }  
-  }
-  rid.page_num = -1;
-  rid.slot_num = -1;
-  
-  pkey = (char *)malloc(file_header_.key_length);
-  if (pkey == nullptr)
-  {
-    LOG_ERROR("Failed to alloc memory for key. size=%d", file_header_.key_length);
-    return RC::NOMEM;
+    }
+    adaptive_hash_index_.invalidate_key(pkey, attr_length);
   }
-  // 这里因为截断的原因key.size() <= file_header_.field_num 导致pkey在rid前面可能有一段是空闲的
-  for(int i =0;i<key.size() ; i++){
-    memcpy(pkey, key[i], file_header_.attr_length[i]);
+
+  RC rc = find_first_index_satisfied(pkey, file_header_.field_num, page_num, rididx);
+  if (rc == SUCCESS && is_first_equal_entry(*page_num, *rididx, pkey))
+  {
+    adaptive_hash_index_.record(pkey, attr_length, *page_num, *rididx);
   }
-  memcpy(pkey + file_header_.total_attr_length, &rid, sizeof(RID));
+  return rc;
+}
 
-  rc = find_leaf(pkey, &leaf_page, cmp_size);   
-  if (rc != SUCCESS)   // 2180
+RC BplusTreeHandler::get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids)
+{
+  RC rc = merge_change_buffer();
+  if (rc != SUCCESS)
   {
-    free(pkey);
     return rc;
   }
-  free(pkey);
-  next = leaf_page;
-  while (next > 0)
+  const int key_length = file_header_.key_length;
+  const int total_attr_length = file_header_.total_attr_length;
+  char *search_key = (char *)malloc(key_length);
+  if (nullptr == search_key)
   {
-    rc = disk_buffer_pool_->get_this_page(file_id_, next, &page_handle);
-    if (rc != SUCCESS)
+    LOG_ERROR("Failed to alloc memory for search key. size=%d", key_length);
+    return RC::NOMEM;
+  }
+  // RID取最小值，找到的是第一个索引字段不小于key的位置
+  RID min_rid;
+  min_rid.page_num = min_rid.slot_num = -1;
+  memcpy(search_key + total_attr_length, &min_rid, sizeof(RID));
+
+  BPPageHandle page_handle;
+  char *pdata;
+  IndexNode *node = nullptr;
+  bool pinned = false;
+  bool eof = false;
+  int index = 0;
+  const char *last_key = nullptr;
+  for (size_t k = 0; k < keys.size() && !eof && rc == SUCCESS; k++)
+  {
+    const char *key = keys[k];
+    if (last_key != nullptr && 0 == CompareKeys(last_key, key, file_header_.attr_type, file_header_.attr_length, file_header_.field_num))
     {
-      LOG_DEBUG("Failed to get_this_page. rc=%d:%s", rc, strrc(rc));
-      return rc;
+      continue;
     }
-    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
-    if (rc != SUCCESS)
+    last_key = key;
+
+    // 当前叶子中最大的key都比key小时，key只能在后面的叶子中，重新从根节点查找
+    if (pinned && (node->key_num == 0 ||
+        CompareKeys(node->keys + (node->key_num - 1) * key_length, key, file_header_.attr_type, file_header_.attr_length, file_header_.field_num) < 0))
     {
-      LOG_DEBUG("Failed to get_data. rc=%d:%s", rc, strrc(rc));
-      return rc;
+      disk_buffer_pool_->unpin_page(&page_handle);
+      pinned = false;
     }
-    node = get_index_node(pdata);
-    for (i = 0; i < node->key_num; i++)
+    if (!pinned)
     {
-      // 相比于上面的single_index内容，这里不再考虑null的内容
-      char *key_ = (char *)malloc(file_header_.key_length);
-      if (key_ == nullptr)
+      PageNum page_num;
+      memcpy(search_key, key, total_attr_length);
+      rc = find_first_index_satisfied(search_key, file_header_.field_num, &page_num, &index);
+      if (rc == RC::RECORD_EOF)
       {
-        LOG_ERROR("Failed to alloc memory for key. size=%d", file_header_.key_length);
-        return RC::NOMEM;
+        // 索引中所有的key都比key小，后面的key也不会有匹配
+        rc = SUCCESS;
+        break;
       }
-      int offset = 0;
-      for(int i = 0; i < key.size(); i++){
-        memcpy(key_+offset, key[i], file_header_.attr_length[i]);
-        offset += file_header_.attr_length[i];
+      if (rc != SUCCESS)
+      {
+        break;
       }
-      memcpy(key_ + file_header_.total_attr_length, &rid, sizeof(RID));
-
-      tmp = CmpKey(file_header_.attr_type, file_header_.attr_length, node->keys + i * file_header_.key_length, key_, cmp_size, file_header_.total_attr_length );
-      
-      if (compop == EQUAL_TO || compop == GREAT_EQUAL)
+      rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+      if (rc != SUCCESS)
       {
-        if (tmp >= 0)
-        {
-          // 当i=0时，这里没有问题,当i=1时这里会产生BUFFERPOOL_CLOSED的问题，需要思考下这里需不需要还循环
-          rc = disk_buffer_pool_->get_page_num(&page_handle, page_num);
-          if (rc != SUCCESS)
-          {
-            LOG_DEBUG("Failed to get_page_num. rc=%d:%s", rc, strrc(rc));
-            return rc;
-          }
-          *rididx = i;
-          rc = disk_buffer_pool_->unpin_page(&page_handle);
-          if (rc != SUCCESS)
-          {
-            LOG_DEBUG("Failed to unpin_page. rc=%d:%s", rc, strrc(rc));
-            return rc;
-          }
-          return SUCCESS;
-        }
+        break;
       }
+      pinned = true;
+      disk_buffer_pool_->get_data(&page_handle, &pdata);
+      node = get_index_node(pdata);
+    }
 
-      if (compop == GREAT_THAN)
+    while (index < node->key_num &&
+           CompareKeys(node->keys + index * key_length, key, file_header_.attr_type, file_header_.attr_length, file_header_.field_num) < 0)
+    {
+      index++;
+    }
+    // 相同的key可能跨越多个叶子
+    while (true)
+    {
+      if (index >= node->key_num)
       {
-        if (tmp > 0)
+        PageNum next = node->rids[file_header_.order - 1].page_num;
+        disk_buffer_pool_->unpin_page(&page_handle);
+        pinned = false;
+        if (next <= 0)
+        {
+          eof = true;
+          break;
+        }
+        rc = disk_buffer_pool_->get_this_page(file_id_, next, &page_handle);
+        if (rc != SUCCESS)
         {
-          rc = disk_buffer_pool_->get_page_num(&page_handle, page_num);
-          if (rc != SUCCESS)
-          {
-            return rc;
-          }
-          *rididx = i;
-          rc = disk_buffer_pool_->unpin_page(&page_handle);
-          if (rc != SUCCESS)
-          {
-            return rc;
-          }
-          return SUCCESS;
+          break;
         }
+        pinned = true;
+        disk_buffer_pool_->get_data(&page_handle, &pdata);
+        node = get_index_node(pdata);
+        index = 0;
+        continue;
+      }
+      if (0 != CompareKeys(node->keys + index * key_length, key, file_header_.attr_type, file_header_.attr_length, file_header_.field_num))
+      {
+        break;
       }
+      rids.push_back(node->rids[index]);
+      index++;
     }
-    next = node->rids[file_header_.order - 1].page_num;
   }
-  rc = disk_buffer_pool_->unpin_page(&page_handle);
-  if (rc != SUCCESS)
+
+  if (pinned)
   {
-    return rc;
+    disk_buffer_pool_->unpin_page(&page_handle);
   }
-  return RC::RECORD_EOF;
+  free(search_key);
+  return rc;
+}
+
+/**
+ * 检查叶子page_num的第rididx个key是不是第一个索引字段等于pkey的key。
+ * 前一个key也在这个叶子中并且比pkey小时才能确定，所以叶子中的第一个key总是返回false。
+ * 自适应哈希索引中缓存的位置在叶子被修改之后可能失效，使用前都要经过这个检查
+ */
+bool BplusTreeHandler::is_first_equal_entry(PageNum page_num, int rididx, const char *pkey)
+{
+  if (rididx <= 0)
+  {
+    return false;
+  }
+  BPPageHandle page_handle;
+  char *pdata;
+  if (disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle) != SUCCESS)
+  {
+    return false;
+  }
+  disk_buffer_pool_->get_data(&page_handle, &pdata);
+  IndexNode *node = get_index_node(pdata);
+  const int key_length = file_header_.key_length;
+  bool result = node->is_leaf && rididx < node->key_num &&
+                0 == CompareKeys(node->keys + rididx * key_length, pkey, file_header_.attr_type, file_header_.attr_length, file_header_.field_num) &&
+                CompareKeys(node->keys + (rididx - 1) * key_length, pkey, file_header_.attr_type, file_header_.attr_length, file_header_.field_num) < 0;
+  disk_buffer_pool_->unpin_page(&page_handle);
+  return result;
 }
 
 RC BplusTreeHandler::get_first_leaf_page(PageNum *leaf_page)
@@ -2330,241 +2827,597 @@ RC BplusTreeHandler::get_first_leaf_page(PageNum *leaf_page)
   return SUCCESS;
 }
 
-BplusTreeScanner::BplusTreeScanner(BplusTreeHandler &index_handler,int match_num) : index_handler_(index_handler)
-{
-  match_num_ = match_num;
-}
-// 在bplus_tree_index.cpp的create_scanner函数中进行调用
-RC BplusTreeScanner::open_single_index(CompOp comp_op, const char *value, int null_index)
+RC BplusTreeHandler::get_last_leaf_page(PageNum *leaf_page)
 {
   RC rc;
-  if (opened_)
-  {
-    return RC::RECORD_OPENNED;
-  }
-
-  //comp_op_ = comp_op;
-  comp_ops_.push_back(comp_op);
-  null_index_ = null_index;
+  BPPageHandle page_handle;
+  PageNum page_num;
+  IndexNode *node;
+  char *pdata;
 
-  char *value_copy = (char *)malloc(index_handler_.file_header_.total_attr_length);
-  if (value_copy == nullptr)
+  rc = disk_buffer_pool_->get_this_page(file_id_, file_header_.root_page, &page_handle);
+  if (rc != SUCCESS)
   {
-    LOG_ERROR("Failed to alloc memory for value. size=%d", index_handler_.file_header_.total_attr_length);
-    return RC::NOMEM;
+    return rc;
   }
-  memcpy(value_copy, value, index_handler_.file_header_.total_attr_length);
-  values_.push_back(value_copy); // free value_
-  rc = index_handler_.find_first_index_satisfied_single(comp_op, value, &next_page_num_, &index_in_node_);
+  rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
   if (rc != SUCCESS)
   {
-    if (rc == RC::RECORD_EOF)
+    return rc;
+  }
+
+  node = get_index_node(pdata);
+
+  while (node->is_leaf == false)
+  {
+    // 内部节点有key_num + 1个孩子
+    page_num = node->rids[node->key_num].page_num;
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
     {
-      next_page_num_ = -1;
-      index_in_node_ = -1;
+      return rc;
     }
-    else
+
+    rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (rc != SUCCESS)
+    {
       return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+
+    node = get_index_node(pdata);
   }
-  num_fixed_pages_ = 1;
-  next_index_of_page_handle_ = 0;
-  pinned_page_count_ = 0;
-  opened_ = true;
-  return SUCCESS;
+  rc = disk_buffer_pool_->get_page_num(&page_handle, leaf_page);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  return disk_buffer_pool_->unpin_page(&page_handle);
 }
 
-RC BplusTreeScanner::open_multi_index(std::vector<CompOp> comp_ops, std::vector<const char *> values)
+// 找到最后一个严格小于pkey的索引项，RID的约定与find_first_index_satisfied相同
+RC BplusTreeHandler::find_last_index_satisfied(const char *pkey, int cmp_attr_num, PageNum *page_num, int *rididx)
 {
+  BPPageHandle page_handle;
+  IndexNode *node;
+  PageNum leaf_page, prev;
+  char *pdata;
   RC rc;
-  if (opened_)
+  int i;
+
+  rc = find_leaf(pkey, &leaf_page, cmp_attr_num);
+  if (rc != SUCCESS)
   {
-    return RC::RECORD_OPENNED;
+    return rc;
   }
-  condition_num = values.size();  //没什么用这个参数
-  // for(const auto &value : values){
-  values_.clear();
-  comp_ops_.clear();
-  for( int i = 0; i< match_num_; i++){
-    // int length = index_handler_.file_header_.attr_length[i]+sizeof(RID);
-    int length = index_handler_.file_header_.attr_length[i];
-    char *value_copy = (char *)malloc(length);
-    if (value_copy == nullptr)
+
+  prev = leaf_page;
+  while (prev > 0)
+  {
+    rc = disk_buffer_pool_->get_this_page(file_id_, prev, &page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS)
+    {
+      disk_buffer_pool_->unpin_page(&page_handle);
+      return rc;
+    }
+
+    node = get_index_node(pdata);
+    for (i = node->key_num - 1; i >= 0; i--)
     {
-      LOG_ERROR("Failed to alloc memory for value. size=%d", length);
-      return RC::NOMEM;
+      if (CmpKey(file_header_.attr_type, file_header_.attr_length, node->keys + i * file_header_.key_length, pkey, cmp_attr_num, file_header_.total_attr_length) < 0)
+      {
+        *page_num = prev;
+        *rididx = i;
+        return disk_buffer_pool_->unpin_page(&page_handle);
+      }
+    }
+
+    // 当前叶子中的key都不满足，沿着前驱指针继续找
+    prev = node->rids[file_header_.order - 1].slot_num;
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
     }
-    memcpy(value_copy, values[i], length);  
-    values_.push_back(value_copy);
-    comp_ops_.push_back(comp_ops[i]);
   }
-  // 在find_first_index_satisfied根据comp_op是否为=来确定需要比较多少attr_num
-  rc = index_handler_.find_first_index_satisfied_multi(comp_ops_, values_, &next_page_num_, &index_in_node_);
+  return RC::RECORD_EOF;
+}
+
+RC BplusTreeHandler::rebuild_prev_links()
+{
+  BPPageHandle page_handle;
+  IndexNode *node;
+  PageNum leaf_page, prev_page = -1;
+  char *pdata;
+  RC rc;
+
+  rc = get_first_leaf_page(&leaf_page);
   if (rc != SUCCESS)
   {
-    if (rc == RC::RECORD_EOF)
+    return rc;
+  }
+  while (leaf_page > 0)
+  {
+    rc = disk_buffer_pool_->get_this_page(file_id_, leaf_page, &page_handle);
+    if (rc != SUCCESS)
     {
-      LOG_DEBUG(" result of find_first_index_satisfied_multi is rc = RECORD_EOF");
-      next_page_num_ = -1;
-      index_in_node_ = -1;
+      return rc;
     }
-    else{
-      LOG_DEBUG("Failed to find_first_index_satisfied_multi. rc=%d:%s", rc, strrc(rc));
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS)
+    {
+      disk_buffer_pool_->unpin_page(&page_handle);
       return rc;
     }
+    node = get_index_node(pdata);
+    node->rids[file_header_.order - 1].slot_num = prev_page;
+    PageNum next_page = node->rids[file_header_.order - 1].page_num;
+    rc = disk_buffer_pool_->mark_dirty(&page_handle);
+    if (rc != SUCCESS)
+    {
+      disk_buffer_pool_->unpin_page(&page_handle);
+      return rc;
+    }
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    prev_page = leaf_page;
+    leaf_page = next_page;
   }
-  num_fixed_pages_ = 1;
-  next_index_of_page_handle_ = 0;
-  pinned_page_count_ = 0;
-  opened_ = true;
   return SUCCESS;
 }
 
-RC BplusTreeScanner::close()
+RC BplusTreeHandler::set_prev_leaf(PageNum leaf_page, PageNum prev_page)
 {
-  if (!opened_)
+  BPPageHandle page_handle;
+  IndexNode *node;
+  char *pdata;
+  RC rc;
+
+  if (leaf_page <= 0)
   {
-    return RC::RECORD_SCANCLOSED;
+    return SUCCESS;
   }
-  for(auto &value : values_){
-    free((void *)value);
-    value =nullptr; 
+
+  rc = disk_buffer_pool_->get_this_page(file_id_, leaf_page, &page_handle);
+  if (rc != SUCCESS)
+  {
+    return rc;
   }
-  opened_ = false;
-  return RC::SUCCESS;
+  rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+  if (rc != SUCCESS)
+  {
+    disk_buffer_pool_->unpin_page(&page_handle);
+    return rc;
+  }
+  node = get_index_node(pdata);
+  node->rids[file_header_.order - 1].slot_num = prev_page;
+  rc = disk_buffer_pool_->mark_dirty(&page_handle);
+  if (rc != SUCCESS)
+  {
+    disk_buffer_pool_->unpin_page(&page_handle);
+    return rc;
+  }
+  return disk_buffer_pool_->unpin_page(&page_handle);
 }
 
-RC BplusTreeScanner::next_entry(RID *rid)
+BplusTreeScanner::BplusTreeScanner(BplusTreeHandler &index_handler,int match_num) : index_handler_(index_handler)
 {
-  RC rc;
-  if (!opened_)
+  match_num_ = match_num;
+}
+
+BplusTreeScanner::~BplusTreeScanner()
+{
+  close();
+}
+
+// null值在索引中的存放方式与Table::make_record一致
+static void fill_null_value(char *buf, AttrType attr_type, int attr_length)
+{
+  memset(buf, 0, attr_length);
+  switch (attr_type)
   {
-    return RC::RECORD_CLOSED;
+  case CHARS:
+    strncpy(buf, "NULL", attr_length);
+    break;
+  case DATES:
+  {
+    int v = 19700101;
+    memcpy(buf, &v, sizeof(v));
+  }
+  break;
+  default:
+    break;
+  }
+}
+
+RC BplusTreeScanner::copy_condition_value(CompOp comp_op, const char *value, int idx)
+{
+  AttrType attr_type = index_handler_.file_header_.attr_type[idx];
+  int attr_length = index_handler_.file_header_.attr_length[idx];
+  char *value_copy = (char *)malloc(attr_length);
+  if (value_copy == nullptr)
+  {
+    LOG_ERROR("Failed to alloc memory for value. size=%d", attr_length);
+    return RC::NOMEM;
   }
-  rc = get_next_idx_in_memory(rid); //和RM中一样，有可能有错误，一次只查当前页和当前页的下一页，有待确定
-  if (rc == RC::RECORD_NO_MORE_IDX_IN_MEM)
+  if (comp_op == IS_NULL || value == nullptr)
   {
-    rc = find_idx_pages();
-    if (rc != SUCCESS)
-    {
-      LOG_DEBUG("rc = find_idx_pages() != success 是%d:%s",rc,strrc(rc));
-      return rc;
-    }
-    return get_next_idx_in_memory(rid);
+    fill_null_value(value_copy, attr_type, attr_length);
+  }
+  else if (attr_type == CHARS)
+  {
+    // 条件中的字符串可能比字段短，不能直接按字段长度拷贝
+    strncpy(value_copy, value, attr_length);
   }
   else
   {
+    memcpy(value_copy, value, attr_length);
+  }
+  comp_ops_.push_back(comp_op);
+  values_.push_back(value_copy);
+  return SUCCESS;
+}
+
+// 在bplus_tree_index.cpp的create_scanner函数中进行调用
+RC BplusTreeScanner::open_single_index(CompOp comp_op, const char *value, int null_index, bool reverse)
+{
+  if (opened_)
+  {
+    return RC::RECORD_OPENNED;
+  }
+
+  match_num_ = 1;
+  reverse_ = reverse;
+  null_index_ = null_index;
+  RC rc = copy_condition_value(comp_op, value, 0);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  return open_range();
+}
+
+RC BplusTreeScanner::open_multi_index(std::vector<CompOp> comp_ops, std::vector<const char *> values, bool reverse)
+{
+  if (opened_)
+  {
+    return RC::RECORD_OPENNED;
+  }
+  condition_num = values.size();
+  reverse_ = reverse;
+  for (int i = 0; i < match_num_; i++)
+  {
+    RC rc = copy_condition_value(comp_ops[i], values[i], i);
     if (rc != SUCCESS)
     {
       return rc;
     }
   }
-  return SUCCESS;
+  return open_range();
 }
 
-RC BplusTreeScanner::find_idx_pages()
+/**
+ * 根据条件计算扫描的上下界，并定位到第一个可能满足条件的位置。
+ * 条件按照索引字段的顺序排列，形如 a = x, b = y, c > z：
+ * 前面连续的等值条件和第一个范围条件决定扫描区间，其余条件只在next_entry中逐条过滤。
+ */
+RC BplusTreeScanner::open_range()
 {
-  RC rc;
-  if (!opened_)
+  const IndexFileHeader &file_header = index_handler_.file_header_;
+  RC rc = index_handler_.merge_change_buffer();
+  if (rc != SUCCESS)
   {
-    return RC::RECORD_CLOSED;
+    return rc;
   }
-  if (pinned_page_count_ > 0)
+
+  lower_key_ = (char *)malloc(file_header.key_length);
+  upper_key_ = (char *)malloc(file_header.key_length);
+  last_key_ = (char *)malloc(file_header.key_length);
+  if (lower_key_ == nullptr || upper_key_ == nullptr || last_key_ == nullptr)
   {
-    for (int i = 0; i < pinned_page_count_; i++)
+    LOG_ERROR("Failed to alloc memory for scan keys. size=%d", file_header.key_length);
+    return RC::NOMEM;
+  }
+  memset(lower_key_, 0, file_header.key_length);
+  memset(upper_key_, 0, file_header.key_length);
+
+  int eq_num = 0;
+  int offset = 0;
+  for (; eq_num < match_num_; eq_num++)
+  {
+    if (comp_ops_[eq_num] != EQUAL_TO && comp_ops_[eq_num] != IS_NULL)
     {
-      rc = index_handler_.disk_buffer_pool_->unpin_page(page_handles_ + i);
-      if (rc != SUCCESS)
-      {
-        return rc;
-      }
+      break;
     }
+    memcpy(lower_key_ + offset, values_[eq_num], file_header.attr_length[eq_num]);
+    memcpy(upper_key_ + offset, values_[eq_num], file_header.attr_length[eq_num]);
+    offset += file_header.attr_length[eq_num];
   }
-  next_index_of_page_handle_ = 0;
-  pinned_page_count_ = 0;
 
-  for (int i = 0; i < num_fixed_pages_; i++)
+  // 下界的RID取最小值表示可以取等，上界的RID取最大值表示可以取等
+  lower_attr_num_ = eq_num;
+  lower_exclusive_ = false;
+  upper_attr_num_ = eq_num;
+  upper_inclusive_ = true;
+
+  if (eq_num < match_num_)
   {
-    if (next_page_num_ <= 0)
+    switch (comp_ops_[eq_num])
+    {
+    case GREAT_EQUAL:
+    case GREAT_THAN:
+      memcpy(lower_key_ + offset, values_[eq_num], file_header.attr_length[eq_num]);
+      lower_attr_num_ = eq_num + 1;
+      lower_exclusive_ = comp_ops_[eq_num] == GREAT_THAN;
       break;
-    rc = index_handler_.disk_buffer_pool_->get_this_page(index_handler_.file_id_, next_page_num_, page_handles_ + i);
-    if (rc != SUCCESS)
+    case LESS_EQUAL:
+    case LESS_THAN:
+      memcpy(upper_key_ + offset, values_[eq_num], file_header.attr_length[eq_num]);
+      upper_attr_num_ = eq_num + 1;
+      upper_inclusive_ = comp_ops_[eq_num] == LESS_EQUAL;
+      break;
+    default:
+      break;
+    }
+  }
+  RID lower_rid, upper_rid;
+  lower_rid.page_num = lower_rid.slot_num = lower_exclusive_ ? INT_MAX : -1;
+  upper_rid.page_num = upper_rid.slot_num = upper_inclusive_ ? INT_MAX : -1;
+  memcpy(lower_key_ + file_header.total_attr_length, &lower_rid, sizeof(RID));
+  memcpy(upper_key_ + file_header.total_attr_length, &upper_rid, sizeof(RID));
+
+  if (!reverse_)
+  {
+    if (lower_attr_num_ == 0)
     {
-      return rc;
+      rc = index_handler_.get_first_leaf_page(&current_page_);
+      index_in_node_ = 0;
     }
-    char *pdata;
-    rc = index_handler_.disk_buffer_pool_->get_data(page_handles_ + i, &pdata);
-    if (rc != SUCCESS)
+    else if (lower_attr_num_ == file_header.field_num && !lower_exclusive_)
     {
-      return rc;
+      rc = index_handler_.find_first_equal_index(lower_key_, &current_page_, &index_in_node_);
+    }
+    else
+    {
+      rc = index_handler_.find_first_index_satisfied(lower_key_, lower_attr_num_, &current_page_, &index_in_node_);
+    }
+  }
+  else
+  {
+    if (upper_attr_num_ == 0)
+    {
+      // 叶子中key的数量要在固定页面之后才知道，next_entry中会截断到最后一个key
+      rc = index_handler_.get_last_leaf_page(&current_page_);
+      index_in_node_ = INT_MAX;
     }
+    else
+    {
+      rc = index_handler_.find_last_index_satisfied(upper_key_, upper_attr_num_, &current_page_, &index_in_node_);
+    }
+  }
 
-    IndexNode *node = index_handler_.get_index_node(pdata);
-    pinned_page_count_++;
-    next_page_num_ = node->rids[index_handler_.file_header_.order - 1].page_num;
+  if (rc == RC::RECORD_EOF)
+  {
+    eof_ = true;
   }
-  if (pinned_page_count_ > 0)
-    return SUCCESS;
-  return RC::RECORD_EOF;
+  else if (rc != SUCCESS)
+  {
+    LOG_ERROR("Failed to locate the first index entry. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  has_last_key_ = false;
+  opened_ = true;
+  return SUCCESS;
 }
 
-RC BplusTreeScanner::get_next_idx_in_memory(RID *rid)
+RC BplusTreeScanner::close()
 {
-  char *pdata;
-  IndexNode *node;
-  RC rc;
-  if (next_index_of_page_handle_ >= pinned_page_count_)
+  if (!opened_ && values_.empty() && lower_key_ == nullptr)
+  {
+    return RC::RECORD_SCANCLOSED;
+  }
+  for (auto &value : values_)
   {
-    return RC::RECORD_NO_MORE_IDX_IN_MEM;
+    free((void *)value);
   }
+  values_.clear();
+  comp_ops_.clear();
+  free(lower_key_);
+  free(upper_key_);
+  free(last_key_);
+  lower_key_ = nullptr;
+  upper_key_ = nullptr;
+  last_key_ = nullptr;
+  opened_ = false;
+  return RC::SUCCESS;
+}
 
-  if (next_page_num_ == -1 && index_in_node_ == -1)
+bool BplusTreeScanner::reach_upper_bound(const char *pkey) const
+{
+  if (upper_attr_num_ == 0)
   {
-    return RC::RECORD_EOF;
+    return false;
   }
+  const IndexFileHeader &file_header = index_handler_.file_header_;
+  int tmp = CompareKeys(pkey, upper_key_, (AttrType *)file_header.attr_type, (int *)file_header.attr_length, upper_attr_num_);
+  return upper_inclusive_ ? tmp > 0 : tmp >= 0;
+}
 
-  for (; next_index_of_page_handle_ < pinned_page_count_; next_index_of_page_handle_++)
+bool BplusTreeScanner::reach_lower_bound(const char *pkey) const
+{
+  if (lower_attr_num_ == 0)
   {
-    //根据pdata获取更新的node
-    rc = index_handler_.disk_buffer_pool_->get_data(page_handles_ + next_index_of_page_handle_, &pdata);
+    return false;
+  }
+  const IndexFileHeader &file_header = index_handler_.file_header_;
+  int tmp = CompareKeys(pkey, lower_key_, (AttrType *)file_header.attr_type, (int *)file_header.attr_length, lower_attr_num_);
+  return lower_exclusive_ ? tmp <= 0 : tmp < 0;
+}
+
+/**
+ * 两次next_entry之间不持有任何页面，同一条语句中的更新/删除可能会修改甚至释放当前叶子。
+ * 重新进入时检查上一次返回的key是否还在原位置，不在的话从根节点重新定位到它之后的第一个key。
+ */
+RC BplusTreeScanner::pin_current_leaf(BPPageHandle *page_handle, IndexNode **node)
+{
+  const IndexFileHeader &file_header = index_handler_.file_header_;
+  DiskBufferPool *disk_buffer_pool = index_handler_.disk_buffer_pool_;
+  char *pdata;
+
+  RC rc = disk_buffer_pool->get_this_page(index_handler_.file_id_, current_page_, page_handle);
+  if (rc == SUCCESS)
+  {
+    rc = disk_buffer_pool->get_data(page_handle, &pdata);
     if (rc != SUCCESS)
     {
-      LOG_ERROR("Failed to get data from disk buffer pool. rc=%s", strrc);
+      disk_buffer_pool->unpin_page(page_handle);
       return rc;
     }
+    *node = index_handler_.get_index_node(pdata);
+    if (!has_last_key_)
+    {
+      return SUCCESS;
+    }
+    // 正向扫描时上一次返回的key在index_in_node_ - 1，反向扫描时在index_in_node_ + 1
+    int last_index = reverse_ ? index_in_node_ + 1 : index_in_node_ - 1;
+    if ((*node)->is_leaf && last_index >= 0 && last_index < (*node)->key_num &&
+        0 == memcmp((*node)->keys + last_index * file_header.key_length, last_key_, file_header.key_length))
+    {
+      return SUCCESS;
+    }
+    disk_buffer_pool->unpin_page(page_handle);
+  }
+  else if (!has_last_key_)
+  {
+    return rc;
+  }
 
-    node = index_handler_.get_index_node(pdata);
-    // 在node内部不断进行扫描比较
-    for (; index_in_node_ < node->key_num; index_in_node_++)
+  LOG_DEBUG("Leaf page %d changed during scan, relocate the cursor", current_page_);
+  if (reverse_)
+  {
+    rc = index_handler_.find_last_index_satisfied(last_key_, file_header.field_num, &current_page_, &index_in_node_);
+  }
+  else
+  {
+    rc = index_handler_.find_first_index_satisfied(last_key_, file_header.field_num, &current_page_, &index_in_node_);
+  }
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  has_last_key_ = false;
+  return pin_current_leaf(page_handle, node);
+}
+
+RC BplusTreeScanner::next_entry(RID *rid)
+{
+  if (!opened_)
+  {
+    return RC::RECORD_CLOSED;
+  }
+  if (eof_)
+  {
+    return RC::RECORD_EOF;
+  }
+
+  const IndexFileHeader &file_header = index_handler_.file_header_;
+  DiskBufferPool *disk_buffer_pool = index_handler_.disk_buffer_pool_;
+  BPPageHandle page_handle;
+  IndexNode *node;
+  char *pdata;
+
+  RC rc = pin_current_leaf(&page_handle, &node);
+  if (rc != SUCCESS)
+  {
+    if (rc == RC::RECORD_EOF)
+    {
+      eof_ = true;
+    }
+    return rc;
+  }
+
+  // 任何时刻只固定一个叶子
+  while (true)
+  {
+    if (reverse_ && index_in_node_ >= node->key_num)
     {
-      if (satisfy_multi_attr_condition(node->keys + index_in_node_ * index_handler_.file_header_.key_length))
+      index_in_node_ = node->key_num - 1;
+    }
+
+    if (index_in_node_ < 0 || index_in_node_ >= node->key_num)
+    {
+      // 正向取后继，反向取前驱
+      PageNum sibling = reverse_ ? node->rids[file_header.order - 1].slot_num : node->rids[file_header.order - 1].page_num;
+      disk_buffer_pool->unpin_page(&page_handle);
+      if (sibling <= 0)
+      {
+        eof_ = true;
+        return RC::RECORD_EOF;
+      }
+
+      rc = disk_buffer_pool->get_this_page(index_handler_.file_id_, sibling, &page_handle);
+      if (rc != SUCCESS)
       {
-        memcpy(rid, node->rids + index_in_node_, sizeof(RID));
-        index_in_node_++;
-        return SUCCESS;
+        return rc;
+      }
+      rc = disk_buffer_pool->get_data(&page_handle, &pdata);
+      if (rc != SUCCESS)
+      {
+        disk_buffer_pool->unpin_page(&page_handle);
+        return rc;
       }
+      node = index_handler_.get_index_node(pdata);
+      current_page_ = sibling;
+      index_in_node_ = reverse_ ? node->key_num - 1 : 0;
+      continue;
     }
 
-    index_in_node_ = 0;
-    // WARNING: 如果什么都没筛选到，会返回no data
+    const char *pkey = node->keys + index_in_node_ * file_header.key_length;
+    if (reverse_ ? reach_lower_bound(pkey) : reach_upper_bound(pkey))
+    {
+      // 已经越过边界，后面的key都不可能满足条件
+      disk_buffer_pool->unpin_page(&page_handle);
+      eof_ = true;
+      return RC::RECORD_EOF;
+    }
+
+    int current_index = index_in_node_;
+    index_in_node_ += reverse_ ? -1 : 1;
+    if (satisfy_multi_attr_condition(pkey))
+    {
+      memcpy(rid, node->rids + current_index, sizeof(RID));
+      memcpy(last_key_, pkey, file_header.key_length);
+      has_last_key_ = true;
+      return disk_buffer_pool->unpin_page(&page_handle);
+    }
   }
-  return RC::RECORD_NO_MORE_IDX_IN_MEM;
 }
+
 bool BplusTreeScanner::satisfy_multi_attr_condition(const char *pkey)
 {
-  bool single_ = true;
-  for(int i = 0; i < match_num_; i++){
+  int offset = 0;
+  for (int i = 0; i < match_num_; i++)
+  {
     AttrType attr_t = index_handler_.file_header_.attr_type[i];
     int attr_len = index_handler_.file_header_.attr_length[i];
-    int offset = 0;
-    if (i == 0){
-      single_ = satisfy_single_attr_condition(pkey + offset, attr_t, attr_len, i);  
-    }else{
-      offset = index_handler_.file_header_.attr_length[i-1];
-      single_ = satisfy_single_attr_condition(pkey + offset, attr_t, attr_len, i);
-    }
-    if(!single_){
+    if (!satisfy_single_attr_condition(pkey + offset, attr_t, attr_len, i))
+    {
       return false;
     }
+    offset += attr_len;
   }
   return true;
 }
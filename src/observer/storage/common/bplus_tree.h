@@ -16,9 +16,21 @@ See the Mulan PSL v2 for more details. */
 
 #include "record_manager.h"
 #include "storage/default/disk_buffer_pool.h"
+#include "storage/common/adaptive_hash_index.h"
+#include "storage/common/change_buffer.h"
+#include "storage/common/bloom_filter.h"
 #include "sql/parser/parse_defs.h"
 
 #define MAX_INDEX_FIELD_NUM 20
+// 唯一索引的Bloom filter在索引正常关闭时保存在"索引文件名.bloom"中
+#define BPLUS_TREE_BLOOM_SUFFIX ".bloom"
+// 连续这么多次插入都追加在最右边的叶子末尾时，认为是递增插入，分裂时左边保留90%
+#define BPLUS_TREE_APPEND_RUN 8
+// 索引文件的格式版本。版本2开始叶子节点维护前驱指针，打开更早的文件时先补上前驱指针
+#define BPLUS_TREE_FILE_VERSION 2
+
+// 比较两个同类型的属性值，小于、等于、大于分别返回负数、0、正数
+int CompareKey(const char *pdata, const char *pkey, AttrType attr_type, int attr_length);
 
 // 在对应cpp文件中的create函数中进行初始化
 struct IndexFileHeader {
@@ -28,11 +40,12 @@ struct IndexFileHeader {
   int key_length;     // 所有attr_length合起来的长度 包含rid的长度
   AttrType attr_type[MAX_INDEX_FIELD_NUM];
   PageNum root_page; // 初始时，root_page一定是1
-  int node_num;
+  int version;        // 文件格式版本，旧文件中这里是从未被读取过的node_num，总是1
   int order;
   int unique;       // 初始化时根据unique命令进行赋值 1->unique index
 };
 
+// 叶子节点的rids[order - 1]保存兄弟指针：page_num为后继叶子，slot_num为前驱叶子
 struct IndexNode {
   int is_leaf;
   int key_num;
@@ -65,7 +78,8 @@ public:
   // RC create(const char *file_name, AttrType attr_type, int attr_length);
   // 重载
   RC create(const char *file_name, AttrType attr_type, int attr_length,int is_unique);
-  RC create(const char *file_name, AttrType attr_type[], int attr_length[],int field_num, int is_unique);
+  // include_length为INCLUDE字段的总长度，这些字段跟在RID后面保存在key中，不参与比较
+  RC create(const char *file_name, AttrType attr_type[], int attr_length[],int field_num, int is_unique, int include_length = 0);
 
   /**
    * 打开名为fileName的索引文件。
@@ -97,17 +111,74 @@ public:
    * @param rid  返回值，记录记录所在的页面号和slot
    */
   RC get_entry(const char *pkey, RID *rid);
+
+  /**
+   * 批量等值查找。keys中每一项是所有索引字段的值，必须已经从小到大排好序。
+   * 只有下一个key不在当前叶子中时才重新从根节点向下查找，否则直接在当前叶子中继续向后找。
+   * 匹配的RID按照keys的顺序追加到rids中，相同的key只查找一次
+   */
+  RC get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids);
   /**
    * 给出接口 返回indexfileheader中的total_key_length
    * 
    * */
   int get_key_total_length() const;
 
+  /**
+   * 统计树的高度(根节点到叶子节点的层数)和叶子节点的个数，用于ANALYZE
+   */
+  RC get_statistics(int *height, int *leaf_num);
+
+  // 等值查找直接命中自适应哈希索引、跳过从根节点向下查找的次数
+  long adaptive_hash_hit_count() const
+  {
+    return adaptive_hash_index_.hit_count();
+  }
+
+  /**
+   * 把修改缓冲区中的插入和删除合并到B+树中。
+   * 读取索引(扫描、查找、统计)之前和sync时都会先合并，保证读到的是最新的数据
+   */
+  RC merge_change_buffer();
+  // 进入过修改缓冲区、没有马上读取叶子页面的插入和删除的次数
+  long buffered_change_count() const
+  {
+    return buffered_change_count_;
+  }
+
+  // key大于最右边叶子的最大key、直接使用缓存的最右叶子跳过从根节点向下查找的次数
+  long right_append_count() const
+  {
+    return right_append_count_;
+  }
+  // 唯一索引插入时Bloom filter判定key一定不存在、跳过重复检查的次数
+  long bloom_skip_count() const
+  {
+    return bloom_skip_count_;
+  }
+
   RC sync();
 public:
   RC print();
   RC print_tree();
 protected:
+  RC insert_entry_into_tree(const char *pkey, const RID *rid);
+  RC delete_entry_from_tree(const char *pkey, const RID *rid);
+  bool change_buffer_enabled() const;
+  // 要修改的叶子不在buffer pool中时把修改放进缓冲区，buffered返回是否放进了缓冲区
+  RC buffer_change(const char *pkey, const RID *rid, bool is_insert, bool *buffered);
+  RC is_leaf_resident(const char *pkey, bool *resident);
+  // 缓存的最右叶子仍然有效并且key大于其中所有的key时返回true
+  bool is_right_append(const char *pkey);
+  // 递增插入使最右边的节点分裂时的分裂位置，total为分裂的节点加上新key的key个数
+  int append_split_position(int total) const;
+
+  // 唯一索引并且没有FLOATS字段时使用Bloom filter。FLOATS按照误差比较，相等的key哈希值可能不同
+  bool bloom_filter_enabled() const;
+  uint64_t hash_key_attrs(const char *pkey) const;
+  // 扫描所有叶子，按照当前key数量的两倍重新构造Bloom filter
+  RC build_bloom_filter();
+
   // for unique index check is a key in the leaf node that is going to insert
   RC is_key_duplicate(PageNum leaf_page,const char *pkey);
   RC find_leaf(const char *pkey, PageNum *leaf_page, int cmp_attr_num);
@@ -123,9 +194,16 @@ protected:
   RC coalesce_node(PageNum leaf_page, PageNum right_page);
   RC redistribute_nodes(PageNum left_page, PageNum right_page);
 
-  RC find_first_index_satisfied_multi(std::vector<CompOp> comp_ops, std::vector<const char *>key, PageNum *page_num, int *rididx);
-  RC find_first_index_satisfied_single(CompOp comp_op, const char *key, PageNum *page_num, int *rididx);
+  RC find_first_index_satisfied(const char *pkey, int cmp_attr_num, PageNum *page_num, int *rididx);
+  // 和find_first_index_satisfied相同，pkey的所有索引字段都参与比较，热点key的位置从自适应哈希索引中获取
+  RC find_first_equal_index(const char *pkey, PageNum *page_num, int *rididx);
+  bool is_first_equal_entry(PageNum page_num, int rididx, const char *pkey);
+  RC find_last_index_satisfied(const char *pkey, int cmp_attr_num, PageNum *page_num, int *rididx);
   RC get_first_leaf_page(PageNum *leaf_page);
+  RC get_last_leaf_page(PageNum *leaf_page);
+  RC set_prev_leaf(PageNum leaf_page, PageNum prev_page);
+  // 沿后继指针遍历所有叶子，重新设置每个叶子的前驱指针
+  RC rebuild_prev_links();
 
 private:
   IndexNode *get_index_node(char *page_data) const;
@@ -135,23 +213,38 @@ private:
   int               file_id_ = -1;
   bool              header_dirty_ = false;
   IndexFileHeader   file_header_;
+  AdaptiveHashIndex adaptive_hash_index_;
+  ChangeBuffer      change_buffer_;
+  long              buffered_change_count_ = 0;
+  BloomFilter       bloom_filter_;      // 没有初始化时在第一次插入前扫描叶子构造
+  std::string       bloom_file_;
+  long              bloom_skip_count_ = 0;
+  PageNum           rightmost_leaf_ = -1;   // 没有后继的叶子，删除时失效，下次插入查找到它时重新缓存
+  int               append_run_ = 0;        // 连续追加在最右叶子末尾的插入次数
+  bool              appending_ = false;     // 当前插入是递增插入，最右边的节点分裂时按照90/10分裂
+  long              right_append_count_ = 0;
 
 private:
   friend class BplusTreeScanner;
 };
 
+/**
+ * B+树上的范围扫描游标。
+ * 任何时刻最多固定一个叶子页面，沿着叶子的兄弟指针扫描，越过边界后立即结束。
+ * reverse为true时从上界开始沿前驱指针反向扫描，用于ORDER BY ... DESC。
+ */
 class BplusTreeScanner {
 public:
   BplusTreeScanner(BplusTreeHandler &index_handler, int match_num);
+  ~BplusTreeScanner();
 
   /**
    * 用于在indexHandle对应的索引上初始化一个基于条件的扫描。
    * compOp和*value指定比较符和比较值，indexScan为初始化后的索引扫描结构指针
-   * 没有带两个边界的范围扫描
+   * 多字段索引的条件按照索引字段的顺序给出，前缀的等值条件加上第一个范围条件决定扫描区间
    */
-  // std::vector<CompOp> comp_ops, std::vector<const char *> values, int null_field_index
-  RC open_single_index(CompOp comp_op, const char *value, int null_index = -1);
-  RC open_multi_index(std::vector<CompOp> comp_ops, std::vector<const char *> values);
+  RC open_single_index(CompOp comp_op, const char *value, int null_index = -1, bool reverse = false);
+  RC open_multi_index(std::vector<CompOp> comp_ops, std::vector<const char *> values, bool reverse = false);
 
   /**
    * 用于继续索引扫描，获得下一个满足条件的索引项，
@@ -160,39 +253,49 @@ public:
   RC next_entry(RID *rid);
 
   /**
-   * 关闭一个索引扫描，释放相应的资源
+   * 上一次next_entry返回的索引项的完整key(索引字段、RID、INCLUDE字段)，
+   * 用于索引覆盖扫描时直接从key中取字段值
    */
-  RC close();
+  const char *current_key() const
+  {
+    return has_last_key_ ? last_key_ : nullptr;
+  }
 
   /**
-   * 获取由fileName指定的B+树索引内容，返回指向B+树的指针。
-   * 此函数提供给测试程序调用，用于检查B+树索引内容的正确性
+   * 关闭一个索引扫描，释放相应的资源
    */
-  // RC getIndexTree(char *fileName, Tree *index);
+  RC close();
 
 private:
-  RC get_next_idx_in_memory(RID *rid);
-  RC find_idx_pages();
+  RC copy_condition_value(CompOp comp_op, const char *value, int idx);
+  RC open_range();
+  RC pin_current_leaf(BPPageHandle *page_handle, IndexNode **node);
+  bool reach_upper_bound(const char *pkey) const;
+  bool reach_lower_bound(const char *pkey) const;
   bool satisfy_multi_attr_condition(const char *key);
   bool satisfy_single_attr_condition(const char *pkey, AttrType attr_type, int attr_length, int idx);
 
 private:
   BplusTreeHandler   & index_handler_;
   bool opened_ = false;
-  // 下面两行仅适用于single index的情况
-  //CompOp comp_op_ = NO_OP;                      // 用于比较的操作符
-  //const char *value_ = nullptr;		              // 与属性行比较的值  就是condition 中的值
   int match_num_ = 0;                                  // 表示与key比较的属性数量，condition与索引match的最大数量
-  int condition_num;
+  int condition_num = 0;
   std::vector<CompOp> comp_ops_;                      // 用于比较的操作符
   std::vector<const char *> values_;		              // 与属性行比较的值  就是condition 中的值
 
-  int num_fixed_pages_ = -1;                    // 固定在缓冲区中的页，与指定的页面固定策略有关
-  int pinned_page_count_ = 0;                   // 实际固定在缓冲区的页面数
-  BPPageHandle page_handles_[BP_BUFFER_SIZE];   // 固定在缓冲区页面所对应的页面操作列表
-  int next_index_of_page_handle_ = -1;          // 当前被扫描页面的操作索引
-  int index_in_node_ = -1;                      // 当前B+ Tree页面上的key index
-  PageNum next_page_num_ = -1;                  // 下一个将要被读入的页面号
+  char *lower_key_ = nullptr;                   // 扫描的下界，只比较前lower_attr_num_个属性
+  int lower_attr_num_ = 0;                      // 0表示没有下界
+  bool lower_exclusive_ = false;                // 下界是否不能取等
+  char *upper_key_ = nullptr;                   // 扫描的上界，只比较前upper_attr_num_个属性
+  int upper_attr_num_ = 0;                      // 0表示没有上界
+  bool upper_inclusive_ = true;                 // 上界是否可以取等
+
+  bool reverse_ = false;                        // 是否反向扫描
+  PageNum current_page_ = -1;                   // 游标所在的叶子页面
+  int index_in_node_ = -1;                      // 下一个要检查的key在叶子中的位置
+  char *last_key_ = nullptr;                    // 上一次返回的key(包含RID)，用于检查叶子是否被修改
+  bool has_last_key_ = false;
+  bool eof_ = false;
   int null_index_ = -1;                         // 仅用于single_index的索引
 };
 
@@ -37,7 +37,8 @@ RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, co
   }
   return rc;
 }
-RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num, int is_unique) 
+RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num, int is_unique,
+                          const FieldMeta *include_meta[], int include_num)
 {
   if (inited_) {
     LOG_INFO("BplusTreeIndex::create - RC::RECORD_OPENNED");
@@ -49,13 +50,17 @@ RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, co
     attr_type[i] = field_meta[i]->type();
     attr_length[i] = field_meta[i]->len();
   }
-  RC rc = Index::init(index_meta, field_meta, field_num);
+  int include_length = 0;
+  for (int i = 0; i < include_num; i++) {
+    include_length += include_meta[i]->len();
+  }
+  RC rc = Index::init(index_meta, field_meta, field_num, include_meta, include_num);
   if (rc != RC::SUCCESS)
   {
     return rc;
   }
        // const char *file_name, AttrType attr_type[], int attr_length[],int field_num, int is_unique
-  rc = index_handler_.create(file_name, attr_type, attr_length, field_num, is_unique);
+  rc = index_handler_.create(file_name, attr_type, attr_length, field_num, is_unique, include_length);
   if (RC::SUCCESS == rc) {
     inited_ = true;
   }
@@ -81,14 +86,15 @@ RC BplusTreeIndex::open(const char *file_name, const IndexMeta &index_meta, cons
   return rc;
 }
 
-RC BplusTreeIndex::open(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num)
+RC BplusTreeIndex::open(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num,
+                        const FieldMeta *include_meta[], int include_num)
 {
   if (inited_)
   {
     return RC::RECORD_OPENNED;
   }
   // RC rc = Index::init(index_meta, field_meta);
-  RC rc = Index::init(index_meta, field_meta, field_num);
+  RC rc = Index::init(index_meta, field_meta, field_num, include_meta, include_num);
   if (rc != RC::SUCCESS)
   {
     return rc;
@@ -121,32 +127,28 @@ int BplusTreeIndex::Get_Key_length() const
 }
 RC BplusTreeIndex::insert_entry(const char *record, const RID *rid)
 {
-  // 这里的field_meta_为index类中的内容
-  // 根据offset确定初始位置 然后根据attr_length确定取内容的长度 这里存在顺序的问题
-  // 在这里即可构造Key
   LOG_INFO("调用bplustree index中的insert_entry");
-  int total_length = Get_Key_length();
-  char *key = (char *)malloc(total_length);
-  int acc_len=0;
-  for(int i=0;i<field_num_;i++){
-    memcpy(key + acc_len,record + fields_meta_[i].offset() , fields_meta_[i].len());
-    acc_len += fields_meta_[i].len();
+  char *key = make_key(record, rid);
+  if (key == nullptr)
+  {
+    return RC::NOMEM;
   }
-  memcpy(key + acc_len, rid, sizeof(*rid));
-  return index_handler_.insert_entry(key, rid);
+  RC rc = index_handler_.insert_entry(key, rid);
+  free(key);
+  return rc;
 }
 
 RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
 {
   //组合 key
-  
-  char *pdata = (char *)malloc(index_handler_.get_key_total_length());
-  int offset = 0;
-  for ( int i = 0; i < fields_meta_.size(); i++){
-    memcpy(pdata + offset,record + fields_meta_[i].offset(),fields_meta_[i].len());
-    offset += fields_meta_[i].len();
+  char *key = make_key(record, rid);
+  if (key == nullptr)
+  {
+    return RC::NOMEM;
   }
-  return index_handler_.delete_entry(pdata, rid);
+  RC rc = index_handler_.delete_entry(key, rid);
+  free(key);
+  return rc;
 }
 // 这里和multi_index的差别主要是将null值分开
 IndexScanner *BplusTreeIndex::create_single_index_scanner(CompOp comp_op, const char *value, int null_field_index)
@@ -161,7 +163,7 @@ IndexScanner *BplusTreeIndex::create_single_index_scanner(CompOp comp_op, const
     return nullptr;
   }
 
-  BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(bplus_tree_scanner);
+  BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(*this, bplus_tree_scanner);
   return index_scanner;
 }
 
@@ -177,15 +179,42 @@ IndexScanner *BplusTreeIndex::create_multi_index_scanner(const std::vector<CompO
     return nullptr;
   }
 
-  BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(bplus_tree_scanner);
+  BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(*this, bplus_tree_scanner);
+  return index_scanner;
+}
+
+IndexScanner *BplusTreeIndex::create_ordered_scanner(CompOp comp_op, const char *value, bool reverse)
+{
+  BplusTreeScanner *bplus_tree_scanner = new BplusTreeScanner(index_handler_, 1);
+  RC rc = bplus_tree_scanner->open_multi_index({comp_op}, {value}, reverse);
+  if (rc != RC::SUCCESS)
+  {
+    LOG_ERROR("Failed to open index scanner. rc=%d:%s", rc, strrc(rc));
+    delete bplus_tree_scanner;
+    return nullptr;
+  }
+
+  BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(*this, bplus_tree_scanner);
   return index_scanner;
 }
 
+RC BplusTreeIndex::get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids)
+{
+  std::vector<const char *> sorted_keys(keys);
+  sort_keys(sorted_keys);
+  return index_handler_.get_entries(sorted_keys, rids);
+}
+
 RC BplusTreeIndex::sync()
 {
   return index_handler_.sync();
 }
-BplusTreeIndexScanner::BplusTreeIndexScanner(BplusTreeScanner *tree_scanner) : tree_scanner_(tree_scanner)
+RC BplusTreeIndex::get_statistics(int *height, int *leaf_num)
+{
+  return index_handler_.get_statistics(height, leaf_num);
+}
+BplusTreeIndexScanner::BplusTreeIndexScanner(const BplusTreeIndex &index, BplusTreeScanner *tree_scanner)
+    : index_(index), tree_scanner_(tree_scanner)
 {
 }
 
@@ -200,6 +229,16 @@ RC BplusTreeIndexScanner::next_entry(RID *rid)
   return tree_scanner_->next_entry(rid);
 }
 
+RC BplusTreeIndexScanner::next_entry(RID *rid, char *record)
+{
+  RC rc = tree_scanner_->next_entry(rid);
+  if (rc == RC::SUCCESS)
+  {
+    index_.fill_record(tree_scanner_->current_key(), record);
+  }
+  return rc;
+}
+
 RC BplusTreeIndexScanner::destroy()
 {
   delete this;
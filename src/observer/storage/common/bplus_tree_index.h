@@ -25,10 +25,12 @@ public:
   int Get_Key_length() const;
   // create函数重载
   RC create(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta, int is_unique);
-  RC create(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num, int is_unique);
+  RC create(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num, int is_unique,
+            const FieldMeta *include_meta[] = nullptr, int include_num = 0);
   
   RC open(const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta);
-  RC open(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num);
+  RC open(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num,
+          const FieldMeta *include_meta[] = nullptr, int include_num = 0);
   RC close();
 
   RC insert_entry(const char *record, const RID *rid) override;
@@ -37,7 +39,11 @@ public:
 
   IndexScanner *create_multi_index_scanner(const std::vector<CompOp> &comp_ops, const std::vector<const char *> &values,int &match_num) override;
   IndexScanner *create_single_index_scanner(CompOp comp_op, const char *value, int null_field_index) override;
+  IndexScanner *create_ordered_scanner(CompOp comp_op, const char *value, bool reverse) override;
+  // 先把keys排序，再在B+树上按顺序一次查完
+  RC get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids) override;
   RC sync() override;
+  RC get_statistics(int *height, int *leaf_num) override;
 
 private:
   bool inited_ = false;
@@ -46,12 +52,18 @@ private:
 
 class BplusTreeIndexScanner : public IndexScanner {
 public:
-  BplusTreeIndexScanner(BplusTreeScanner *tree_scanner);
+  BplusTreeIndexScanner(const BplusTreeIndex &index, BplusTreeScanner *tree_scanner);
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, char *record) override;
+  const Index &index() const override
+  {
+    return index_;
+  }
   RC destroy() override;
 private:
+  const BplusTreeIndex & index_;
   BplusTreeScanner * tree_scanner_;
 };
 
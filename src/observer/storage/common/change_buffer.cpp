@@ -0,0 +1,43 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/common/change_buffer.h"
+
+bool ChangeBuffer::contains(const std::string &key) const
+{
+  return changes_.find(key) != changes_.end();
+}
+
+int ChangeBuffer::operation(const std::string &key) const
+{
+  auto iter = changes_.find(key);
+  return iter == changes_.end() ? 0 : iter->second;
+}
+
+void ChangeBuffer::add(const std::string &key, bool is_insert)
+{
+  auto iter = changes_.find(key);
+  if (iter == changes_.end()) {
+    changes_.emplace(key, is_insert ? INSERT : DELETE);
+  } else if (is_insert) {
+    iter->second |= INSERT;
+  } else if (iter->second == INSERT) {
+    // 插入的索引项还没有进入B+树，直接丢掉
+    changes_.erase(iter);
+  } else {
+    iter->second = DELETE;
+  }
+}
+
+void ChangeBuffer::take(std::vector<std::pair<std::string, int>> &changes)
+{
+  changes.assign(changes_.begin(), changes_.end());
+  changes_.clear();
+}
@@ -0,0 +1,60 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_CHANGE_BUFFER_H_
+#define __OBSERVER_STORAGE_COMMON_CHANGE_BUFFER_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define CHANGE_BUFFER_CAPACITY 1024  // 缓冲的修改达到这个数量时合并到B+树中
+
+/**
+ * 非唯一索引的修改缓冲区，类似InnoDB的change buffer。
+ * 插入、删除索引项时，如果要修改的叶子不在buffer pool中，先把修改记在这里，不去读叶子；
+ * 下次读这个索引或者缓冲的修改足够多时，再按照key的顺序一次合并到B+树中。
+ * key为 索引字段 | RID，同一个key上的多次修改合并成一个：
+ * 先插入后删除相互抵消，先删除后插入需要在合并时依次执行。
+ * 删除只有在缓冲区中已经有这个索引项的插入时才缓冲，其它删除直接读取叶子，这样索引项不存在时能马上报错。
+ * 缓冲区只保存在内存中：sync和close时会合并，但是合并之前进程崩溃，缓冲的修改会丢失，
+ * 索引中会缺少插入的索引项、留下删除的索引项，需要重建索引
+ */
+class ChangeBuffer {
+public:
+  enum Operation {
+    DELETE = 1,
+    INSERT = 2,
+    DELETE_INSERT = DELETE | INSERT,  // 先删除再插入
+  };
+
+  bool contains(const std::string &key) const;
+  // key上缓冲的修改，没有时返回0
+  int operation(const std::string &key) const;
+  void add(const std::string &key, bool is_insert);
+
+  // 取出所有缓冲的修改并清空缓冲区
+  void take(std::vector<std::pair<std::string, int>> &changes);
+
+  int size() const
+  {
+    return (int)changes_.size();
+  }
+  bool empty() const
+  {
+    return changes_.empty();
+  }
+
+private:
+  std::map<std::string, int> changes_;
+};
+
+#endif  //__OBSERVER_STORAGE_COMMON_CHANGE_BUFFER_H_
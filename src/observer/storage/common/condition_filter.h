@@ -64,6 +64,14 @@ public:
     return comp_op_;
   }
 
+  AttrType attr_type() const {
+    return attr_type_;
+  }
+
+  AttrType another_attr_type() const {
+    return another_attr_type_;
+  }
+
 private:
   ConDesc  left_;
   ConDesc  right_;
@@ -24,6 +24,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/table_meta.h"
 #include "storage/common/table.h"
 #include "storage/common/meta_util.h"
+#include "storage/common/bplus_tree.h"
 
 Db::~Db()
 {
@@ -93,6 +94,7 @@ RC Db::drop_table(const char *table_name)
 
   // 删除index文件
   std::vector<const char *> index_names = table->get_index_names();
+  std::vector<std::string> bloom_files;
   int n = index_names.size();
   for (int i = 0; i < n; ++i)
   {
@@ -105,6 +107,7 @@ RC Db::drop_table(const char *table_name)
       LOG_ERROR("Failed to remove table file: %s", indexfile_path.c_str());
       return RC::IOERR;
     }
+    bloom_files.push_back(indexfile_path + BPLUS_TREE_BLOOM_SUFFIX);
   }
 
   // 删除table_meta文件
@@ -127,6 +130,12 @@ RC Db::drop_table(const char *table_name)
 
   delete table; // 释放表
 
+  // 关闭唯一索引时会保存Bloom filter，表删除后一起删掉
+  for (const std::string &bloom_file : bloom_files)
+  {
+    ::remove(bloom_file.c_str());
+  }
+
   return RC::SUCCESS;
 }
 
@@ -0,0 +1,622 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <string.h>
+
+#include "storage/common/extendible_hash.h"
+#include "common/log/log.h"
+
+static HashBucket *get_bucket(char *pdata)
+{
+  return (HashBucket *)pdata;
+}
+
+static char *bucket_entry(char *pdata, int index, int key_length)
+{
+  return pdata + sizeof(HashBucket) + index * key_length;
+}
+
+static void init_bucket(char *pdata, int local_depth)
+{
+  HashBucket *bucket = get_bucket(pdata);
+  bucket->local_depth = local_depth;
+  bucket->entry_num = 0;
+  bucket->overflow_page = BP_INVALID_PAGE_NUM;
+}
+
+ExtendibleHashHandler::~ExtendibleHashHandler()
+{
+  if (disk_buffer_pool_ != nullptr)
+  {
+    close();
+  }
+}
+
+RC ExtendibleHashHandler::create(const char *file_name, AttrType attr_type[], int attr_length[], int field_num,
+                                 int is_unique, int include_length)
+{
+  if (field_num <= 0 || field_num > MAX_INDEX_FIELD_NUM)
+  {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  DiskBufferPool *disk_buffer_pool = theGlobalDiskBufferPool();
+  RC rc = disk_buffer_pool->create_file(file_name);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+
+  int file_id;
+  rc = disk_buffer_pool->open_file(file_name, &file_id);
+  if (rc != SUCCESS)
+  {
+    LOG_ERROR("Failed to open file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  memset(&file_header_, 0, sizeof(file_header_));
+  file_header_.field_num = field_num;
+  int total_attr_length = 0;
+  for (int i = 0; i < field_num; i++)
+  {
+    file_header_.attr_type[i] = attr_type[i];
+    file_header_.attr_length[i] = attr_length[i];
+    total_attr_length += attr_length[i];
+  }
+  file_header_.total_attr_length = total_attr_length;
+  file_header_.key_length = total_attr_length + sizeof(RID) + include_length;
+  file_header_.unique = is_unique;
+  file_header_.bucket_capacity = ((int)BP_PAGE_DATA_SIZE - (int)sizeof(HashBucket)) / file_header_.key_length;
+  file_header_.global_depth = 0;
+
+  // 第一个页面保存文件头和目录，第二个页面是初始的桶
+  BPPageHandle header_handle;
+  rc = disk_buffer_pool->allocate_page(file_id, &header_handle);
+  if (rc != SUCCESS)
+  {
+    LOG_ERROR("Failed to allocate page. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    disk_buffer_pool->close_file(file_id);
+    return rc;
+  }
+  disk_buffer_pool->get_page_num(&header_handle, &header_page_);
+
+  BPPageHandle bucket_handle;
+  rc = disk_buffer_pool->allocate_page(file_id, &bucket_handle);
+  if (rc != SUCCESS)
+  {
+    LOG_ERROR("Failed to allocate page. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    disk_buffer_pool->unpin_page(&header_handle);
+    disk_buffer_pool->close_file(file_id);
+    return rc;
+  }
+  char *pdata;
+  disk_buffer_pool->get_data(&bucket_handle, &pdata);
+  init_bucket(pdata, 0);
+  disk_buffer_pool->get_page_num(&bucket_handle, &file_header_.directory[0]);
+  disk_buffer_pool->mark_dirty(&bucket_handle);
+  disk_buffer_pool->unpin_page(&bucket_handle);
+
+  disk_buffer_pool->get_data(&header_handle, &pdata);
+  memcpy(pdata, &file_header_, sizeof(file_header_));
+  disk_buffer_pool->mark_dirty(&header_handle);
+  disk_buffer_pool->unpin_page(&header_handle);
+
+  disk_buffer_pool_ = disk_buffer_pool;
+  file_id_ = file_id;
+  return SUCCESS;
+}
+
+RC ExtendibleHashHandler::open(const char *file_name)
+{
+  if (disk_buffer_pool_ != nullptr)
+  {
+    return RC::RECORD_OPENNED;
+  }
+
+  DiskBufferPool *disk_buffer_pool = theGlobalDiskBufferPool();
+  int file_id;
+  RC rc = disk_buffer_pool->open_file(file_name, &file_id);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+
+  BPPageHandle page_handle;
+  rc = disk_buffer_pool->get_this_page(file_id, 1, &page_handle);
+  if (rc != SUCCESS)
+  {
+    disk_buffer_pool->close_file(file_id);
+    return rc;
+  }
+  char *pdata;
+  disk_buffer_pool->get_data(&page_handle, &pdata);
+  memcpy(&file_header_, pdata, sizeof(file_header_));
+  disk_buffer_pool->unpin_page(&page_handle);
+
+  header_page_ = 1;
+  disk_buffer_pool_ = disk_buffer_pool;
+  file_id_ = file_id;
+  return SUCCESS;
+}
+
+RC ExtendibleHashHandler::close()
+{
+  if (disk_buffer_pool_ == nullptr)
+  {
+    return RC::SUCCESS;
+  }
+  sync();
+  disk_buffer_pool_->close_file(file_id_);
+  file_id_ = -1;
+  disk_buffer_pool_ = nullptr;
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::sync()
+{
+  return disk_buffer_pool_->flush_all_pages(file_id_);
+}
+
+int ExtendibleHashHandler::bucket_num() const
+{
+  // 多个目录项可能指向同一个桶，去重后就是桶的个数
+  std::vector<PageNum> pages(file_header_.directory, file_header_.directory + (1 << file_header_.global_depth));
+  std::sort(pages.begin(), pages.end());
+  return (int)(std::unique(pages.begin(), pages.end()) - pages.begin());
+}
+
+// 字符串只计算'\0'之前的部分，和strncmp的比较规则保持一致
+static unsigned int hash_attr(unsigned int hash, const char *value, AttrType attr_type, int attr_length)
+{
+  int length = attr_type == CHARS ? (int)strnlen(value, attr_length) : attr_length;
+  // FNV-1a
+  for (int i = 0; i < length; i++)
+  {
+    hash ^= (unsigned char)value[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static bool attr_equal(const char *value1, const char *value2, AttrType attr_type, int attr_length)
+{
+  if (attr_type == CHARS)
+  {
+    return 0 == strncmp(value1, value2, attr_length);
+  }
+  return 0 == memcmp(value1, value2, attr_length);
+}
+
+unsigned int ExtendibleHashHandler::hash_values(const char *const values[]) const
+{
+  unsigned int hash = 2166136261u;
+  for (int i = 0; i < file_header_.field_num; i++)
+  {
+    hash = hash_attr(hash, values[i], file_header_.attr_type[i], file_header_.attr_length[i]);
+  }
+  return hash;
+}
+
+unsigned int ExtendibleHashHandler::hash_key(const char *key) const
+{
+  unsigned int hash = 2166136261u;
+  int offset = 0;
+  for (int i = 0; i < file_header_.field_num; i++)
+  {
+    hash = hash_attr(hash, key + offset, file_header_.attr_type[i], file_header_.attr_length[i]);
+    offset += file_header_.attr_length[i];
+  }
+  return hash;
+}
+
+bool ExtendibleHashHandler::values_equal(const char *key, const char *const values[]) const
+{
+  int offset = 0;
+  for (int i = 0; i < file_header_.field_num; i++)
+  {
+    if (!attr_equal(key + offset, values[i], file_header_.attr_type[i], file_header_.attr_length[i]))
+    {
+      return false;
+    }
+    offset += file_header_.attr_length[i];
+  }
+  return true;
+}
+
+bool ExtendibleHashHandler::keys_equal(const char *key1, const char *key2) const
+{
+  int offset = 0;
+  for (int i = 0; i < file_header_.field_num; i++)
+  {
+    if (!attr_equal(key1 + offset, key2 + offset, file_header_.attr_type[i], file_header_.attr_length[i]))
+    {
+      return false;
+    }
+    offset += file_header_.attr_length[i];
+  }
+  return true;
+}
+
+RC ExtendibleHashHandler::find_bucket(unsigned int hash, PageNum *page_num) const
+{
+  if (disk_buffer_pool_ == nullptr)
+  {
+    return RC::RECORD_CLOSED;
+  }
+  *page_num = file_header_.directory[hash & ((1u << file_header_.global_depth) - 1)];
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::write_header()
+{
+  BPPageHandle page_handle;
+  RC rc = disk_buffer_pool_->get_this_page(file_id_, header_page_, &page_handle);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  char *pdata;
+  disk_buffer_pool_->get_data(&page_handle, &pdata);
+  memcpy(pdata, &file_header_, sizeof(file_header_));
+  disk_buffer_pool_->mark_dirty(&page_handle);
+  return disk_buffer_pool_->unpin_page(&page_handle);
+}
+
+/**
+ * 把一个没有溢出页的满桶分裂成两个，按照哈希值的第local_depth位重新分配索引项。
+ * 桶的local_depth等于global_depth时，目录先扩大一倍
+ */
+RC ExtendibleHashHandler::split_bucket(PageNum page_num)
+{
+  BPPageHandle old_handle;
+  RC rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &old_handle);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  char *old_data;
+  disk_buffer_pool_->get_data(&old_handle, &old_data);
+  HashBucket *old_bucket = get_bucket(old_data);
+  const int local_depth = old_bucket->local_depth;
+
+  BPPageHandle new_handle;
+  rc = disk_buffer_pool_->allocate_page(file_id_, &new_handle);
+  if (rc != SUCCESS)
+  {
+    disk_buffer_pool_->unpin_page(&old_handle);
+    return rc;
+  }
+  PageNum new_page_num;
+  char *new_data;
+  disk_buffer_pool_->get_page_num(&new_handle, &new_page_num);
+  disk_buffer_pool_->get_data(&new_handle, &new_data);
+  init_bucket(new_data, local_depth + 1);
+  HashBucket *new_bucket = get_bucket(new_data);
+
+  if (local_depth == file_header_.global_depth)
+  {
+    const int dir_size = 1 << file_header_.global_depth;
+    memcpy(file_header_.directory + dir_size, file_header_.directory, dir_size * sizeof(PageNum));
+    file_header_.global_depth++;
+  }
+
+  const int key_length = file_header_.key_length;
+  const unsigned int split_bit = 1u << local_depth;
+  int kept = 0;
+  for (int i = 0; i < old_bucket->entry_num; i++)
+  {
+    char *entry = bucket_entry(old_data, i, key_length);
+    if (hash_key(entry) & split_bit)
+    {
+      memcpy(bucket_entry(new_data, new_bucket->entry_num++, key_length), entry, key_length);
+    }
+    else
+    {
+      if (kept != i)
+      {
+        memcpy(bucket_entry(old_data, kept, key_length), entry, key_length);
+      }
+      kept++;
+    }
+  }
+  old_bucket->entry_num = kept;
+  old_bucket->local_depth = local_depth + 1;
+
+  const int dir_size = 1 << file_header_.global_depth;
+  for (int i = 0; i < dir_size; i++)
+  {
+    if (file_header_.directory[i] == page_num && (i & split_bit))
+    {
+      file_header_.directory[i] = new_page_num;
+    }
+  }
+
+  disk_buffer_pool_->mark_dirty(&new_handle);
+  disk_buffer_pool_->unpin_page(&new_handle);
+  disk_buffer_pool_->mark_dirty(&old_handle);
+  disk_buffer_pool_->unpin_page(&old_handle);
+  LOG_TRACE("Split hash bucket. page=%d, new page=%d, global depth=%d", page_num, new_page_num, file_header_.global_depth);
+  return write_header();
+}
+
+RC ExtendibleHashHandler::append_overflow_page(PageNum last_page_num, PageNum *new_page_num)
+{
+  BPPageHandle new_handle;
+  RC rc = disk_buffer_pool_->allocate_page(file_id_, &new_handle);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  char *pdata;
+  disk_buffer_pool_->get_page_num(&new_handle, new_page_num);
+  disk_buffer_pool_->get_data(&new_handle, &pdata);
+  init_bucket(pdata, -1);
+  disk_buffer_pool_->mark_dirty(&new_handle);
+  disk_buffer_pool_->unpin_page(&new_handle);
+
+  BPPageHandle last_handle;
+  rc = disk_buffer_pool_->get_this_page(file_id_, last_page_num, &last_handle);
+  if (rc != SUCCESS)
+  {
+    return rc;
+  }
+  disk_buffer_pool_->get_data(&last_handle, &pdata);
+  get_bucket(pdata)->overflow_page = *new_page_num;
+  disk_buffer_pool_->mark_dirty(&last_handle);
+  return disk_buffer_pool_->unpin_page(&last_handle);
+}
+
+RC ExtendibleHashHandler::insert_entry(const char *pkey, const RID *rid)
+{
+  if (disk_buffer_pool_ == nullptr)
+  {
+    return RC::RECORD_CLOSED;
+  }
+
+  const int key_length = file_header_.key_length;
+  const int total_attr_length = file_header_.total_attr_length;
+  char *key = (char *)malloc(key_length);
+  if (key == nullptr)
+  {
+    LOG_ERROR("Failed to alloc memory for key. size=%d", key_length);
+    return RC::NOMEM;
+  }
+  memcpy(key, pkey, total_attr_length);
+  memcpy(key + total_attr_length, rid, sizeof(*rid));
+  int include_length = key_length - total_attr_length - sizeof(RID);
+  if (include_length > 0)
+  {
+    memcpy(key + total_attr_length + sizeof(RID), pkey + total_attr_length + sizeof(RID), include_length);
+  }
+  const unsigned int hash = hash_key(key);
+
+  RC rc = RC::SUCCESS;
+  while (true)
+  {
+    PageNum head_page;
+    rc = find_bucket(hash, &head_page);
+    if (rc != SUCCESS)
+    {
+      break;
+    }
+
+    // 遍历桶和它的溢出页，检查重复的同时找一个有空位的页面
+    PageNum page_num = head_page;
+    PageNum free_page = BP_INVALID_PAGE_NUM;
+    PageNum last_page = BP_INVALID_PAGE_NUM;
+    bool has_overflow = false;
+    bool same_hash = true;  // 桶中所有索引项的哈希值是否都和新索引项相同，这时分裂没有用
+    int local_depth = 0;
+    while (page_num != BP_INVALID_PAGE_NUM && rc == SUCCESS)
+    {
+      BPPageHandle page_handle;
+      rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+      if (rc != SUCCESS)
+      {
+        break;
+      }
+      char *pdata;
+      disk_buffer_pool_->get_data(&page_handle, &pdata);
+      HashBucket *bucket = get_bucket(pdata);
+      if (page_num == head_page)
+      {
+        local_depth = bucket->local_depth;
+      }
+      for (int i = 0; i < bucket->entry_num; i++)
+      {
+        const char *entry = bucket_entry(pdata, i, key_length);
+        if (keys_equal(entry, key))
+        {
+          if (file_header_.unique || 0 == memcmp(entry + total_attr_length, rid, sizeof(RID)))
+          {
+            rc = RC::RECORD_DUPLICATE_KEY;
+            break;
+          }
+        }
+        else if (same_hash && hash_key(entry) != hash)
+        {
+          same_hash = false;
+        }
+      }
+      if (free_page == BP_INVALID_PAGE_NUM && bucket->entry_num < file_header_.bucket_capacity)
+      {
+        free_page = page_num;
+      }
+      has_overflow = has_overflow || bucket->overflow_page != BP_INVALID_PAGE_NUM;
+      last_page = page_num;
+      page_num = bucket->overflow_page;
+      disk_buffer_pool_->unpin_page(&page_handle);
+    }
+    if (rc != SUCCESS)
+    {
+      break;
+    }
+
+    if (free_page == BP_INVALID_PAGE_NUM)
+    {
+      bool can_split = !has_overflow && !same_hash &&
+                       (local_depth < file_header_.global_depth || file_header_.global_depth < HASH_MAX_GLOBAL_DEPTH);
+      if (can_split)
+      {
+        rc = split_bucket(head_page);
+        if (rc != SUCCESS)
+        {
+          break;
+        }
+        continue;
+      }
+      rc = append_overflow_page(last_page, &free_page);
+      if (rc != SUCCESS)
+      {
+        break;
+      }
+    }
+
+    BPPageHandle page_handle;
+    rc = disk_buffer_pool_->get_this_page(file_id_, free_page, &page_handle);
+    if (rc != SUCCESS)
+    {
+      break;
+    }
+    char *pdata;
+    disk_buffer_pool_->get_data(&page_handle, &pdata);
+    HashBucket *bucket = get_bucket(pdata);
+    memcpy(bucket_entry(pdata, bucket->entry_num, key_length), key, key_length);
+    bucket->entry_num++;
+    disk_buffer_pool_->mark_dirty(&page_handle);
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    break;
+  }
+
+  free(key);
+  return rc;
+}
+
+RC ExtendibleHashHandler::delete_entry(const char *pkey, const RID *rid)
+{
+  if (disk_buffer_pool_ == nullptr)
+  {
+    return RC::RECORD_CLOSED;
+  }
+
+  const int key_length = file_header_.key_length;
+  const int total_attr_length = file_header_.total_attr_length;
+  PageNum page_num;
+  RC rc = find_bucket(hash_key(pkey), &page_num);
+  while (rc == SUCCESS && page_num != BP_INVALID_PAGE_NUM)
+  {
+    BPPageHandle page_handle;
+    rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (rc != SUCCESS)
+    {
+      return rc;
+    }
+    char *pdata;
+    disk_buffer_pool_->get_data(&page_handle, &pdata);
+    HashBucket *bucket = get_bucket(pdata);
+    for (int i = 0; i < bucket->entry_num; i++)
+    {
+      char *entry = bucket_entry(pdata, i, key_length);
+      if (keys_equal(entry, pkey) && 0 == memcmp(entry + total_attr_length, rid, sizeof(RID)))
+      {
+        // 用最后一个索引项填补空位
+        bucket->entry_num--;
+        if (i != bucket->entry_num)
+        {
+          memcpy(entry, bucket_entry(pdata, bucket->entry_num, key_length), key_length);
+        }
+        disk_buffer_pool_->mark_dirty(&page_handle);
+        return disk_buffer_pool_->unpin_page(&page_handle);
+      }
+    }
+    page_num = bucket->overflow_page;
+    disk_buffer_pool_->unpin_page(&page_handle);
+  }
+  return rc == SUCCESS ? RC::RECORD_INVALID_KEY : rc;
+}
+
+RC ExtendibleHashHandler::find_entries(const std::vector<const char *> &values, std::vector<char> &entries)
+{
+  if ((int)values.size() != file_header_.field_num)
+  {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int key_length = file_header_.key_length;
+  PageNum page_num;
+  RC rc = find_bucket(hash_values(values.data()), &page_num);
+  while (rc == SUCCESS && page_num != BP_INVALID_PAGE_NUM)
+  {
+    BPPageHandle page_handle;
+    rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (rc != SUCCESS)
+    {
+      break;
+    }
+    char *pdata;
+    disk_buffer_pool_->get_data(&page_handle, &pdata);
+    HashBucket *bucket = get_bucket(pdata);
+    for (int i = 0; i < bucket->entry_num; i++)
+    {
+      const char *entry = bucket_entry(pdata, i, key_length);
+      if (values_equal(entry, values.data()))
+      {
+        entries.insert(entries.end(), entry, entry + key_length);
+      }
+    }
+    page_num = bucket->overflow_page;
+    disk_buffer_pool_->unpin_page(&page_handle);
+  }
+  return rc;
+}
+
+ExtendibleHashScanner::ExtendibleHashScanner(ExtendibleHashHandler &handler) : handler_(handler)
+{
+}
+
+RC ExtendibleHashScanner::open(const std::vector<const char *> &values)
+{
+  entries_.clear();
+  next_index_ = 0;
+  RC rc = handler_.find_entries(values, entries_);
+  entry_num_ = rc == SUCCESS ? (int)entries_.size() / handler_.key_length() : 0;
+  return rc;
+}
+
+RC ExtendibleHashScanner::next_entry(RID *rid)
+{
+  if (next_index_ >= entry_num_)
+  {
+    return RC::RECORD_EOF;
+  }
+  const char *entry = entries_.data() + next_index_ * handler_.key_length();
+  memcpy(rid, entry + handler_.total_attr_length(), sizeof(RID));
+  next_index_++;
+  return RC::SUCCESS;
+}
+
+const char *ExtendibleHashScanner::current_key() const
+{
+  if (next_index_ == 0)
+  {
+    return nullptr;
+  }
+  return entries_.data() + (next_index_ - 1) * handler_.key_length();
+}
+
+RC ExtendibleHashScanner::close()
+{
+  entries_.clear();
+  entry_num_ = 0;
+  next_index_ = 0;
+  return RC::SUCCESS;
+}
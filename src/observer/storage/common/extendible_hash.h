@@ -0,0 +1,133 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_EXTENDIBLE_HASH_H_
+#define __OBSERVER_STORAGE_COMMON_EXTENDIBLE_HASH_H_
+
+#include <vector>
+
+#include "storage/common/record_manager.h"
+#include "storage/common/bplus_tree.h"
+#include "storage/default/disk_buffer_pool.h"
+#include "sql/parser/parse_defs.h"
+
+// 目录保存在文件头所在的页面中，最多2^HASH_MAX_GLOBAL_DEPTH个桶，
+// 桶的数量到达上限后，满了的桶通过溢出页链接起来
+#define HASH_MAX_GLOBAL_DEPTH 9
+#define HASH_DIRECTORY_SIZE (1 << HASH_MAX_GLOBAL_DEPTH)
+
+// 可扩展哈希索引文件的第一个页面
+struct HashFileHeader {
+  int field_num;
+  int attr_length[MAX_INDEX_FIELD_NUM];
+  AttrType attr_type[MAX_INDEX_FIELD_NUM];
+  int total_attr_length;
+  int key_length;       // 索引项的长度：索引字段 | RID | INCLUDE字段
+  int unique;
+  int bucket_capacity;  // 每个桶页面能保存的索引项个数
+  int global_depth;
+  PageNum directory[HASH_DIRECTORY_SIZE];  // 哈希值的低global_depth位 -> 桶所在的页面
+};
+
+// 桶页面的头部，后面紧跟着entry_num个索引项
+struct HashBucket {
+  int local_depth;
+  int entry_num;
+  PageNum overflow_page;  // 溢出页，没有时为BP_INVALID_PAGE_NUM
+};
+
+/**
+ * 磁盘上的可扩展哈希表，只支持等值查找。
+ * 查找时只需要访问一个桶页面(目录常驻内存)，不随数据量增长
+ */
+class ExtendibleHashHandler {
+public:
+  ExtendibleHashHandler() = default;
+  ~ExtendibleHashHandler();
+
+  // include_length为INCLUDE字段的总长度，这些字段跟在RID后面保存在索引项中，不参与比较
+  RC create(const char *file_name, AttrType attr_type[], int attr_length[], int field_num, int is_unique, int include_length = 0);
+  RC open(const char *file_name);
+  RC close();
+  RC sync();
+
+  /**
+   * 插入一个索引项。pkey的格式为 索引字段 | RID | INCLUDE字段，没有INCLUDE字段时可以只有索引字段
+   * 相同的索引项(唯一索引时相同的索引字段)已经存在时返回RECORD_DUPLICATE_KEY
+   */
+  RC insert_entry(const char *pkey, const RID *rid);
+
+  /**
+   * 删除索引字段为pkey，记录位置为rid的索引项。找不到时返回RECORD_INVALID_KEY
+   * 空的桶不会合并
+   */
+  RC delete_entry(const char *pkey, const RID *rid);
+
+  /**
+   * 找出索引字段等于values的所有索引项，追加到entries中，每个索引项长度为key_length()
+   * values中每个索引字段一个值
+   */
+  RC find_entries(const std::vector<const char *> &values, std::vector<char> &entries);
+
+  int field_num() const
+  {
+    return file_header_.field_num;
+  }
+  int key_length() const
+  {
+    return file_header_.key_length;
+  }
+  int total_attr_length() const
+  {
+    return file_header_.total_attr_length;
+  }
+  // 目录中不同桶的个数，不包括溢出页
+  int bucket_num() const;
+
+private:
+  unsigned int hash_values(const char *const values[]) const;
+  unsigned int hash_key(const char *key) const;
+  bool values_equal(const char *key, const char *const values[]) const;
+  bool keys_equal(const char *key1, const char *key2) const;
+
+  RC find_bucket(unsigned int hash, PageNum *page_num) const;
+  RC split_bucket(PageNum page_num);
+  RC append_overflow_page(PageNum last_page_num, PageNum *new_page_num);
+  RC write_header();
+
+private:
+  DiskBufferPool *disk_buffer_pool_ = nullptr;
+  int file_id_ = -1;
+  PageNum header_page_ = BP_INVALID_PAGE_NUM;
+  HashFileHeader file_header_;
+};
+
+class ExtendibleHashScanner {
+public:
+  explicit ExtendibleHashScanner(ExtendibleHashHandler &handler);
+
+  /**
+   * 打开一个等值扫描，values中每个索引字段一个值。
+   * 匹配的索引项在打开时一次性读出来，扫描过程中不持有页面
+   */
+  RC open(const std::vector<const char *> &values);
+  RC next_entry(RID *rid);
+  // 最近一次next_entry返回的索引项，格式为 索引字段 | RID | INCLUDE字段
+  const char *current_key() const;
+  RC close();
+
+private:
+  ExtendibleHashHandler &handler_;
+  std::vector<char> entries_;
+  int entry_num_ = 0;
+  int next_index_ = 0;
+};
+
+#endif  //__OBSERVER_STORAGE_COMMON_EXTENDIBLE_HASH_H_
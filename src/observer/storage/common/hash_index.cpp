@@ -0,0 +1,226 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/common/hash_index.h"
+#include "common/log/log.h"
+
+HashIndex::~HashIndex() noexcept
+{
+  close();
+}
+
+RC HashIndex::create(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num, int is_unique,
+                     const FieldMeta *include_meta[], int include_num)
+{
+  if (inited_) {
+    LOG_INFO("HashIndex::create - RC::RECORD_OPENNED");
+    return RC::RECORD_OPENNED;
+  }
+  AttrType attr_type[field_num];
+  int attr_length[field_num];
+  for (int i = 0; i < field_num; i++) {
+    attr_type[i] = field_meta[i]->type();
+    attr_length[i] = field_meta[i]->len();
+  }
+  int include_length = 0;
+  for (int i = 0; i < include_num; i++) {
+    include_length += include_meta[i]->len();
+  }
+  RC rc = Index::init(index_meta, field_meta, field_num, include_meta, include_num);
+  if (rc != RC::SUCCESS)
+  {
+    return rc;
+  }
+
+  rc = index_handler_.create(file_name, attr_type, attr_length, field_num, is_unique, include_length);
+  if (RC::SUCCESS == rc) {
+    inited_ = true;
+  }
+  return rc;
+}
+
+RC HashIndex::open(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num,
+                   const FieldMeta *include_meta[], int include_num)
+{
+  if (inited_)
+  {
+    return RC::RECORD_OPENNED;
+  }
+  RC rc = Index::init(index_meta, field_meta, field_num, include_meta, include_num);
+  if (rc != RC::SUCCESS)
+  {
+    return rc;
+  }
+
+  rc = index_handler_.open(file_name);
+  if (RC::SUCCESS == rc)
+  {
+    inited_ = true;
+  }
+  return rc;
+}
+
+RC HashIndex::close()
+{
+  if (inited_)
+  {
+    index_handler_.close();
+    inited_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+int HashIndex::Get_Field_Num() const
+{
+  return field_num_;
+}
+
+RC HashIndex::insert_entry(const char *record, const RID *rid)
+{
+  char *key = make_key(record, rid);
+  if (key == nullptr)
+  {
+    return RC::NOMEM;
+  }
+  RC rc = index_handler_.insert_entry(key, rid);
+  free(key);
+  return rc;
+}
+
+RC HashIndex::delete_entry(const char *record, const RID *rid)
+{
+  char *key = make_key(record, rid);
+  if (key == nullptr)
+  {
+    return RC::NOMEM;
+  }
+  RC rc = index_handler_.delete_entry(key, rid);
+  free(key);
+  return rc;
+}
+
+IndexScanner *HashIndex::create_equal_scanner(const std::vector<const char *> &values)
+{
+  ExtendibleHashScanner *hash_scanner = new ExtendibleHashScanner(index_handler_);
+  RC rc = hash_scanner->open(values);
+  if (rc != RC::SUCCESS)
+  {
+    LOG_ERROR("Failed to open index scanner. rc=%d:%s", rc, strrc(rc));
+    delete hash_scanner;
+    return nullptr;
+  }
+  return new HashIndexScanner(*this, hash_scanner);
+}
+
+IndexScanner *HashIndex::create_single_index_scanner(CompOp comp_op, const char *value, int null_field_index)
+{
+  if (comp_op != EQUAL_TO || field_num_ != 1)
+  {
+    return nullptr;
+  }
+  return create_equal_scanner({value});
+}
+
+IndexScanner *HashIndex::create_multi_index_scanner(const std::vector<CompOp> &comp_ops, const std::vector<const char *> &values, int &match_num)
+{
+  // 哈希值由所有索引字段算出来，必须每个字段都有等值条件
+  if (match_num != field_num_ || (int)comp_ops.size() < field_num_)
+  {
+    return nullptr;
+  }
+  for (int i = 0; i < field_num_; i++)
+  {
+    if (comp_ops[i] != EQUAL_TO)
+    {
+      return nullptr;
+    }
+  }
+  return create_equal_scanner(std::vector<const char *>(values.begin(), values.begin() + field_num_));
+}
+
+IndexScanner *HashIndex::create_ordered_scanner(CompOp comp_op, const char *value, bool reverse)
+{
+  return nullptr;
+}
+
+RC HashIndex::get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids)
+{
+  // 每个key的查找都只访问一个桶，排序只是为了去掉重复的key
+  const int key_length = index_handler_.key_length();
+  const int total_attr_length = index_handler_.total_attr_length();
+  std::vector<const char *> sorted_keys(keys);
+  sort_keys(sorted_keys);
+  std::vector<const char *> values(field_num_);
+  std::vector<char> entries;
+  for (const char *key : sorted_keys)
+  {
+    int offset = 0;
+    for (int i = 0; i < field_num_; i++)
+    {
+      values[i] = key + offset;
+      offset += fields_meta_[i].len();
+    }
+    entries.clear();
+    RC rc = index_handler_.find_entries(values, entries);
+    if (rc != RC::SUCCESS)
+    {
+      return rc;
+    }
+    for (size_t pos = 0; pos < entries.size(); pos += key_length)
+    {
+      rids.push_back(*(const RID *)(entries.data() + pos + total_attr_length));
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC HashIndex::sync()
+{
+  return index_handler_.sync();
+}
+
+RC HashIndex::get_statistics(int *height, int *leaf_num)
+{
+  *height = 1;
+  *leaf_num = index_handler_.bucket_num();
+  return RC::SUCCESS;
+}
+
+HashIndexScanner::HashIndexScanner(const HashIndex &index, ExtendibleHashScanner *hash_scanner)
+    : index_(index), hash_scanner_(hash_scanner)
+{
+}
+
+HashIndexScanner::~HashIndexScanner() noexcept
+{
+  hash_scanner_->close();
+  delete hash_scanner_;
+}
+
+RC HashIndexScanner::next_entry(RID *rid)
+{
+  return hash_scanner_->next_entry(rid);
+}
+
+RC HashIndexScanner::next_entry(RID *rid, char *record)
+{
+  RC rc = hash_scanner_->next_entry(rid);
+  if (rc == RC::SUCCESS)
+  {
+    index_.fill_record(hash_scanner_->current_key(), record);
+  }
+  return rc;
+}
+
+RC HashIndexScanner::destroy()
+{
+  delete this;
+  return RC::SUCCESS;
+}
@@ -0,0 +1,68 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_HASH_INDEX_H_
+#define __OBSERVER_STORAGE_COMMON_HASH_INDEX_H_
+
+#include "storage/common/index.h"
+#include "storage/common/extendible_hash.h"
+
+// CREATE INDEX ... USING HASH 创建的索引，只能用于所有索引字段上都是等值条件的查询
+class HashIndex : public Index {
+public:
+  HashIndex() = default;
+  virtual ~HashIndex() noexcept;
+
+  RC create(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num, int is_unique,
+            const FieldMeta *include_meta[] = nullptr, int include_num = 0);
+  RC open(const char *file_name, const IndexMeta &index_meta, const FieldMeta *field_meta[], int field_num,
+          const FieldMeta *include_meta[] = nullptr, int include_num = 0);
+  RC close();
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+  int Get_Field_Num() const override;
+
+  // 不是等值条件时返回nullptr，由调用方退回到全表扫描
+  IndexScanner *create_multi_index_scanner(const std::vector<CompOp> &comp_ops, const std::vector<const char *> &values,int &match_num) override;
+  IndexScanner *create_single_index_scanner(CompOp comp_op, const char *value, int null_field_index) override;
+  // 哈希索引没有顺序，总是返回nullptr
+  IndexScanner *create_ordered_scanner(CompOp comp_op, const char *value, bool reverse) override;
+  RC get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids) override;
+  RC sync() override;
+  // 目录常驻内存，一次等值查找只读一个桶页面，高度记为1，桶的个数作为叶子页面数
+  RC get_statistics(int *height, int *leaf_num) override;
+
+private:
+  IndexScanner *create_equal_scanner(const std::vector<const char *> &values);
+
+private:
+  bool inited_ = false;
+  ExtendibleHashHandler index_handler_;
+};
+
+class HashIndexScanner : public IndexScanner {
+public:
+  HashIndexScanner(const HashIndex &index, ExtendibleHashScanner *hash_scanner);
+  ~HashIndexScanner() noexcept override;
+
+  RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, char *record) override;
+  const Index &index() const override
+  {
+    return index_;
+  }
+  RC destroy() override;
+private:
+  const HashIndex & index_;
+  ExtendibleHashScanner * hash_scanner_;
+};
+
+#endif //__OBSERVER_STORAGE_COMMON_HASH_INDEX_H_
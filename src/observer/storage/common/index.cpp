@@ -12,7 +12,13 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2021/5/19.
 //
 
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
 #include "storage/common/index.h"
+#include "storage/common/bplus_tree.h"
+#include "storage/common/condition_filter.h"
 
 RC Index::init(const IndexMeta &index_meta, const FieldMeta &field_meta) {
   field_num_ = 1;
@@ -20,17 +26,133 @@ RC Index::init(const IndexMeta &index_meta, const FieldMeta &field_meta) {
   fields_meta_.push_back(field_meta);
   return RC::SUCCESS;
 }
-RC Index::init(const IndexMeta &index_meta, const FieldMeta *field_meta[],int field_num){
+RC Index::init(const IndexMeta &index_meta, const FieldMeta *field_meta[],int field_num,
+               const FieldMeta *include_meta[], int include_num){
   index_meta_ = index_meta;
   field_num_ = field_num;
   for(int i = 0; i < field_num; i++){
     fields_meta_.push_back(*field_meta[i]);
   }
+  for(int i = 0; i < include_num; i++){
+    include_fields_meta_.push_back(*include_meta[i]);
+  }
   return RC::SUCCESS;
 }
+
+Index::~Index() {
+  delete predicate_filter_;
+}
+
+void Index::set_predicate_filter(ConditionFilter *filter) {
+  delete predicate_filter_;
+  predicate_filter_ = filter;
+}
+
+bool Index::accepts(const char *record) const {
+  if (nullptr == predicate_filter_) {
+    return true;
+  }
+  Record rec;
+  rec.data = (char *)record;
+  return predicate_filter_->filter(rec);
+}
+
+bool Index::covers_field(const char *field_name) const {
+  for (const FieldMeta &field_meta : fields_meta_) {
+    if (0 == strcmp(field_meta.name(), field_name)) {
+      return true;
+    }
+  }
+  for (const FieldMeta &field_meta : include_fields_meta_) {
+    if (0 == strcmp(field_meta.name(), field_name)) {
+      return true;
+    }
+  }
+  return false;
+}
+char *Index::make_key(const char *record, const RID *rid) const {
+  int key_length = sizeof(*rid);
+  for (const FieldMeta &field_meta : fields_meta_) {
+    key_length += field_meta.len();
+  }
+  for (const FieldMeta &field_meta : include_fields_meta_) {
+    key_length += field_meta.len();
+  }
+  char *key = (char *)malloc(key_length);
+  if (key == nullptr) {
+    return nullptr;
+  }
+  int acc_len = 0;
+  for (const FieldMeta &field_meta : fields_meta_) {
+    memcpy(key + acc_len, record + field_meta.offset(), field_meta.len());
+    acc_len += field_meta.len();
+  }
+  memcpy(key + acc_len, rid, sizeof(*rid));
+  acc_len += sizeof(*rid);
+  for (const FieldMeta &field_meta : include_fields_meta_) {
+    memcpy(key + acc_len, record + field_meta.offset(), field_meta.len());
+    acc_len += field_meta.len();
+  }
+  return key;
+}
+
+void Index::fill_record(const char *key, char *record) const {
+  int acc_len = 0;
+  for (const FieldMeta &field_meta : fields_meta_) {
+    memcpy(record + field_meta.offset(), key + acc_len, field_meta.len());
+    acc_len += field_meta.len();
+  }
+  acc_len += sizeof(RID);
+  for (const FieldMeta &field_meta : include_fields_meta_) {
+    memcpy(record + field_meta.offset(), key + acc_len, field_meta.len());
+    acc_len += field_meta.len();
+  }
+}
 /*
 int Index::Get_Field_Num() const
 {
   return field_num_;
 }
-*/
\ No newline at end of file
+*/
+
+void Index::sort_keys(std::vector<const char *> &keys) const {
+  auto compare = [this](const char *k1, const char *k2) {
+    int offset = 0;
+    for (const FieldMeta &field_meta : fields_meta_) {
+      int result = CompareKey(k1 + offset, k2 + offset, field_meta.type(), field_meta.len());
+      if (result != 0) {
+        return result;
+      }
+      offset += field_meta.len();
+    }
+    return 0;
+  };
+  std::sort(keys.begin(), keys.end(), [&compare](const char *k1, const char *k2) {
+    return compare(k1, k2) < 0;
+  });
+  keys.erase(std::unique(keys.begin(), keys.end(), [&compare](const char *k1, const char *k2) {
+    return compare(k1, k2) == 0;
+  }), keys.end());
+}
+
+RidSetScanner::RidSetScanner(const Index &index, std::vector<RID> &rids) : index_(index) {
+  rids_.swap(rids);
+}
+
+RC RidSetScanner::next_entry(RID *rid) {
+  if (pos_ >= rids_.size()) {
+    return RC::RECORD_EOF;
+  }
+  *rid = rids_[pos_++];
+  return RC::SUCCESS;
+}
+
+RC RidSetScanner::next_entry(RID *rid, char *record) {
+  // 没有保存字段值，调用方应该先检查returns_field_values
+  return RC::INVALID_ARGUMENT;
+}
+
+RC RidSetScanner::destroy() {
+  delete this;
+  return RC::SUCCESS;
+}
@@ -31,12 +31,13 @@ public:
 };
 
 class IndexScanner;
+class ConditionFilter;
 
 class Index {
 
 public:
   Index() = default;
-  virtual ~Index() = default;
+  virtual ~Index();
 
   const IndexMeta &index_meta() const {
     return index_meta_;
@@ -45,6 +46,14 @@ public:
     return fields_meta_;
   }
 
+  // 索引中是否保存了这个字段的值(索引字段或INCLUDE字段)
+  bool covers_field(const char *field_name) const;
+
+  // 部分索引的条件由Table根据index_meta中的条件创建，之后由索引负责释放
+  void set_predicate_filter(ConditionFilter *filter);
+  // 记录是否应该进入索引。不是部分索引时总是返回true
+  bool accepts(const char *record) const;
+
   // virtual int get_key_length() const = 0;
   virtual RC insert_entry(const char *record, const RID *rid) = 0;
   virtual RC delete_entry(const char *record, const RID *rid) = 0;
@@ -53,16 +62,36 @@ public:
   // virtual IndexScanner *create_scanner(const std::vector<CompOp> &comp_ops, const std::vector<const char *> &values, int null_field_index) = 0;
   virtual IndexScanner *create_multi_index_scanner(const std::vector<CompOp> &comp_ops, const std::vector<const char *> &values,int &match_num) = 0;
   virtual IndexScanner *create_single_index_scanner(CompOp comp_op, const char *value, int null_field_index) = 0;
+  // 按照索引顺序(reverse为true时逆序)输出，comp_op/value是作用在第一个字段上的条件，可以为NO_OP
+  virtual IndexScanner *create_ordered_scanner(CompOp comp_op, const char *value, bool reverse) = 0;
+  /**
+   * 批量等值查找，keys中每一项是所有索引字段的值依次拼接起来，不要求有序。
+   * 找到的RID追加到rids中，相同的key只返回一次结果。用于IN列表、索引嵌套循环连接等一次查找多个key的场景
+   */
+  virtual RC get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids) = 0;
   virtual RC sync() = 0;
+  // 索引的高度(一次查找需要访问的页面数)和叶子页面数，ANALYZE时记录到表的统计信息中
+  virtual RC get_statistics(int *height, int *leaf_num) = 0;
+
+  // 把索引项中保存的索引字段和INCLUDE字段的值写回到record中对应的位置
+  void fill_record(const char *key, char *record) const;
 
 protected:
+  // 索引项的布局：索引字段 | RID | INCLUDE字段，返回的内存由调用方free
+  char *make_key(const char *record, const RID *rid) const;
+  // 按照索引字段的值从小到大排序并去掉重复的key，key的格式和get_entries的参数相同
+  void sort_keys(std::vector<const char *> &keys) const;
+
   RC init(const IndexMeta &index_meta, const FieldMeta &field_meta);
-  RC init(const IndexMeta &index_meta, const FieldMeta *field_meta[],int field_num );
+  RC init(const IndexMeta &index_meta, const FieldMeta *field_meta[],int field_num,
+          const FieldMeta *include_meta[] = nullptr, int include_num = 0);
   // int Get_Field_Num() const;
 protected:
   IndexMeta   index_meta_;
   int field_num_;
   std::vector<FieldMeta>  fields_meta_;  // for multi-index
+  std::vector<FieldMeta>  include_fields_meta_;
+  ConditionFilter *predicate_filter_ = nullptr;
 };
 
 class IndexScanner {
@@ -71,7 +100,44 @@ public:
   virtual ~IndexScanner() = default;
 
   virtual RC next_entry(RID *rid) = 0;
+  // 除了rid，还把索引中保存的字段值写到record对应的位置上，用于不回表的索引覆盖扫描
+  virtual RC next_entry(RID *rid, char *record) = 0;
+  // 能否取出字段值，不能时只能回表，不能用于索引覆盖扫描
+  virtual bool returns_field_values() const
+  {
+    return true;
+  }
+  // 扫描所使用的索引
+  virtual const Index &index() const = 0;
   virtual RC destroy() = 0;
 };
 
+/**
+ * 输出一组事先算好的RID，用于多个索引的结果求交集之后回表。
+ * RID按照页号、槽号排好序，回表时按页面顺序读取记录。不保存字段值，不能用于索引覆盖扫描
+ */
+class RidSetScanner : public IndexScanner {
+public:
+  // rids的内容会被取走
+  RidSetScanner(const Index &index, std::vector<RID> &rids);
+  ~RidSetScanner() override = default;
+
+  RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, char *record) override;
+  bool returns_field_values() const override
+  {
+    return false;
+  }
+  const Index &index() const override
+  {
+    return index_;
+  }
+  RC destroy() override;
+
+private:
+  const Index &index_;
+  std::vector<RID> rids_;
+  size_t pos_ = 0;
+};
+
 #endif  // __OBSERVER_STORAGE_COMMON_INDEX_H_
\ No newline at end of file
@@ -19,10 +19,18 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "rc.h"
 #include "json/json.h"
+#include <string.h>
 
 const static Json::StaticString FIELD_NAME("name");
 const static Json::StaticString FIELD_FIELD_NAME("field_name");
 const static Json::StaticString FIELD_NUM("field_num");
+const static Json::StaticString FIELD_INCLUDE_FIELD_NAME("include_field_name");
+const static Json::StaticString FIELD_TYPE("type");
+const static Json::StaticString FIELD_WHERE("where");
+const static Json::StaticString FIELD_OP("op");
+const static Json::StaticString FIELD_VALUE("value");
+const static char *INDEX_TYPE_HASH_NAME = "hash";
+const static char *INDEX_TYPE_BITMAP_NAME = "bitmap";
 RC IndexMeta::init(const char *name, const FieldMeta &field)
 {
   if (nullptr == name || common::is_blank(name)) {
@@ -48,6 +56,26 @@ RC IndexMeta::init(const char *name, const FieldMeta *fields[], int field_num)
   return RC::SUCCESS;
 }
 
+void IndexMeta::add_include_field(const FieldMeta &field)
+{
+  include_fields_.push_back(field.name());
+}
+
+void IndexMeta::set_hash(bool is_hash)
+{
+  is_hash_ = is_hash;
+}
+
+void IndexMeta::set_bitmap(bool is_bitmap)
+{
+  is_bitmap_ = is_bitmap;
+}
+
+void IndexMeta::add_predicate(const IndexPredicate &predicate)
+{
+  predicates_.push_back(predicate);
+}
+
 void IndexMeta::to_json(Json::Value &json_value) const {
   json_value[FIELD_NAME] = name_;
   json_value[FIELD_NUM] = field_num_;
@@ -58,6 +86,37 @@ void IndexMeta::to_json(Json::Value &json_value) const {
     fields.append(field);
   }
   json_value[FIELD_FIELD_NAME] = std::move(fields);
+  if (!include_fields_.empty()) {
+    Json::Value include_fields;
+    for (const std::string &include_field : include_fields_) {
+      include_fields.append(include_field);
+    }
+    json_value[FIELD_INCLUDE_FIELD_NAME] = std::move(include_fields);
+  }
+  if (is_hash_) {
+    json_value[FIELD_TYPE] = INDEX_TYPE_HASH_NAME;
+  } else if (is_bitmap_) {
+    json_value[FIELD_TYPE] = INDEX_TYPE_BITMAP_NAME;
+  }
+  if (!predicates_.empty()) {
+    Json::Value predicates;
+    for (const IndexPredicate &predicate : predicates_) {
+      Json::Value predicate_value;
+      predicate_value[FIELD_FIELD_NAME] = predicate.field;
+      predicate_value[FIELD_OP] = (int)predicate.comp_op;
+      if (predicate.comp_op == IS_NULL || predicate.comp_op == IS_NOT_NULL) {
+        // 没有常量
+      } else if (predicate.type == FLOATS) {
+        predicate_value[FIELD_VALUE] = *(const float *)predicate.value.data();
+      } else if (predicate.type == CHARS) {
+        predicate_value[FIELD_VALUE] = predicate.value;
+      } else {
+        predicate_value[FIELD_VALUE] = *(const int *)predicate.value.data();
+      }
+      predicates.append(predicate_value);
+    }
+    json_value[FIELD_WHERE] = std::move(predicates);
+  }
 }
 
 RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, IndexMeta &index) {
@@ -69,8 +128,9 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     return RC::GENERIC_ERROR;
   }
   const FieldMeta *fields[field_num_value.asInt64()];
+  const Json::Value &fields_value = json_value[FIELD_FIELD_NAME];
   for (int i = 0; i < field_num_value.asInt64(); i++){
-    const Json::Value &field_value = json_value[std::to_string(i)];
+    const Json::Value &field_value = fields_value[i][std::to_string(i)];
     if (!field_value.isString()) {
       LOG_ERROR("Field name of index [%s] is not a string. json value=%s",
               name_value.asCString(), field_value.toStyledString().c_str());
@@ -83,7 +143,56 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     }
     fields[i] = field;
   }
-  return index.init(name_value.asCString(), fields, field_num_value.asInt64());
+  RC rc = index.init(name_value.asCString(), fields, field_num_value.asInt64());
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  const Json::Value &include_fields_value = json_value[FIELD_INCLUDE_FIELD_NAME];
+  for (int i = 0; i < (int)include_fields_value.size(); i++) {
+    const Json::Value &field_value = include_fields_value[i];
+    const FieldMeta *field = field_value.isString() ? table.field(field_value.asCString()) : nullptr;
+    if (nullptr == field) {
+      LOG_ERROR("Deserialize index [%s]: invalid include field: %s", name_value.asCString(), field_value.toStyledString().c_str());
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    index.add_include_field(*field);
+  }
+
+  // 没有type的是旧版本的元数据，都是B+树索引
+  const Json::Value &type_value = json_value[FIELD_TYPE];
+  index.set_hash(type_value.isString() && 0 == strcmp(type_value.asCString(), INDEX_TYPE_HASH_NAME));
+  index.set_bitmap(type_value.isString() && 0 == strcmp(type_value.asCString(), INDEX_TYPE_BITMAP_NAME));
+
+  const Json::Value &predicates_value = json_value[FIELD_WHERE];
+  for (int i = 0; i < (int)predicates_value.size(); i++) {
+    const Json::Value &field_value = predicates_value[i][FIELD_FIELD_NAME];
+    const Json::Value &op_value = predicates_value[i][FIELD_OP];
+    const Json::Value &value = predicates_value[i][FIELD_VALUE];
+    const FieldMeta *field = field_value.isString() ? table.field(field_value.asCString()) : nullptr;
+    if (nullptr == field || !op_value.isInt()) {
+      LOG_ERROR("Deserialize index [%s]: invalid where condition: %s",
+                name_value.asCString(), predicates_value[i].toStyledString().c_str());
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    IndexPredicate predicate;
+    predicate.field = field->name();
+    predicate.comp_op = (CompOp)op_value.asInt();
+    predicate.type = field->type();
+    if (value.isNull()) {
+      // IS NULL/IS NOT NULL
+    } else if (field->type() == FLOATS) {
+      float float_value = value.asFloat();
+      predicate.value.assign((const char *)&float_value, sizeof(float_value));
+    } else if (field->type() == CHARS) {
+      predicate.value = value.asString();
+    } else {
+      int int_value = value.asInt();
+      predicate.value.assign((const char *)&int_value, sizeof(int_value));
+    }
+    index.add_predicate(predicate);
+  }
+  return RC::SUCCESS;
 }
 
 const char *IndexMeta::name() const {
@@ -100,6 +209,30 @@ const std::vector<std::string> IndexMeta::fields() const{
 const int &IndexMeta::field_num() const {
   return field_num_;
 }
+
+const char *IndexMeta::include_field(int id) const {
+  return include_fields_[id].c_str();
+}
+
+int IndexMeta::include_field_num() const {
+  return include_fields_.size();
+}
+
+bool IndexMeta::is_hash() const {
+  return is_hash_;
+}
+
+bool IndexMeta::is_bitmap() const {
+  return is_bitmap_;
+}
+
+const std::vector<IndexPredicate> &IndexMeta::predicates() const {
+  return predicates_;
+}
+
+bool IndexMeta::is_partial() const {
+  return !predicates_.empty();
+}
 // 描述只输出第一个field
 void IndexMeta::desc(std::ostream &os) const {
   os << "index name=" << name_
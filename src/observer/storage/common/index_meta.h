@@ -18,6 +18,7 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 #include <vector>
 #include "rc.h"
+#include "sql/parser/parse_defs.h"
 
 class TableMeta;
 class FieldMeta;
@@ -26,18 +27,39 @@ namespace Json {
 class Value;
 } // namespace Json
 
+// 部分索引(CREATE INDEX ... WHERE)的一个条件：字段 comp_op 常量，多个条件之间是AND关系
+struct IndexPredicate {
+  std::string field;
+  CompOp      comp_op;
+  AttrType    type;    // 字段的类型
+  std::string value;   // 和记录中格式相同的常量，IS NULL/IS NOT NULL时为空
+};
+
 class IndexMeta {
 public:
   IndexMeta() = default;
 
   RC init(const char *name, const FieldMeta *fields[], int field_num);
   RC init(const char *name, const FieldMeta &field);
+  void add_include_field(const FieldMeta &field);
+  void set_hash(bool is_hash);
+  void set_bitmap(bool is_bitmap);
+  void add_predicate(const IndexPredicate &predicate);
 
 public:
   const char *name() const;
   const char *field(int id) const;
   const std::vector<std::string> fields() const;
   const int &field_num() const;
+  const char *include_field(int id) const;
+  int include_field_num() const;
+  // 是否为哈希索引(CREATE INDEX ... USING HASH)，只能用于等值查询
+  bool is_hash() const;
+  // 是否为位图索引(CREATE INDEX ... USING BITMAP)，只有一个字段，没有顺序
+  bool is_bitmap() const;
+  const std::vector<IndexPredicate> &predicates() const;
+  // 是否为部分索引，部分索引只包含满足所有条件的记录
+  bool is_partial() const;
   //void set_match_num(int num);
 
   void desc(std::ostream &os) const;
@@ -49,5 +71,9 @@ private:
   std::string       name_;
   int             field_num_;       
   std::vector<std::string>  fields_;
+  std::vector<std::string>  include_fields_;   // INCLUDE字段，只保存在索引叶子中，用于索引覆盖扫描
+  bool              is_hash_ = false;
+  bool              is_bitmap_ = false;
+  std::vector<IndexPredicate> predicates_;
 };
 #endif // __OBSERVER_STORAGE_COMMON_INDEX_META_H__
\ No newline at end of file
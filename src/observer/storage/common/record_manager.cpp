@@ -890,6 +890,11 @@ RC RecordFileScanner::get_next_record(Record *rec, bool& has_text)
   {
     return RC::RECORD_EOF;
   }
+  // 扫描过程中可能有新的页面追加到文件末尾，页面标记要跟着扩展
+  if ((int)scanned_.size() < page_count)
+  {
+    scanned_.resize(page_count, false);
+  }
 
   bool text = false;
   Record final_record;
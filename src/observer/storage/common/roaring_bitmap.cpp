@@ -0,0 +1,349 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <iterator>
+
+#include "storage/common/roaring_bitmap.h"
+
+static inline bool bitset_test(const std::vector<uint64_t> &bitset, uint16_t low)
+{
+  return (bitset[low >> 6] >> (low & 63)) & 1;
+}
+
+bool RoaringBitmap::Container::contains(uint16_t low) const
+{
+  if (is_bitset()) {
+    return bitset_test(bitset, low);
+  }
+  return std::binary_search(array.begin(), array.end(), low);
+}
+
+void RoaringBitmap::Container::to_bitset()
+{
+  bitset.assign(ROARING_BITSET_WORDS, 0);
+  for (uint16_t low : array) {
+    bitset[low >> 6] |= (uint64_t)1 << (low & 63);
+  }
+  std::vector<uint16_t>().swap(array);
+}
+
+void RoaringBitmap::Container::to_array()
+{
+  array.clear();
+  array.reserve(cardinality);
+  for (int i = 0; i < ROARING_BITSET_WORDS; i++) {
+    uint64_t word = bitset[i];
+    while (word != 0) {
+      array.push_back((uint16_t)(i * 64 + __builtin_ctzll(word)));
+      word &= word - 1;
+    }
+  }
+  std::vector<uint64_t>().swap(bitset);
+}
+
+void RoaringBitmap::Container::normalize()
+{
+  if (is_bitset() && cardinality <= ROARING_ARRAY_MAX) {
+    to_array();
+  } else if (!is_bitset() && cardinality > ROARING_ARRAY_MAX) {
+    to_bitset();
+  }
+}
+
+// 返回第一个key不小于给定值的容器下标
+int RoaringBitmap::find_container(uint16_t key) const
+{
+  int left = 0;
+  int right = containers_.size();
+  while (left < right) {
+    int mid = (left + right) / 2;
+    if (containers_[mid].key < key) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+void RoaringBitmap::add(uint32_t value)
+{
+  uint16_t key = value >> 16;
+  uint16_t low = value & 0xFFFF;
+  int index = find_container(key);
+  if (index == (int)containers_.size() || containers_[index].key != key) {
+    Container container;
+    container.key = key;
+    containers_.insert(containers_.begin() + index, std::move(container));
+  }
+
+  Container &container = containers_[index];
+  if (container.is_bitset()) {
+    uint64_t &word = container.bitset[low >> 6];
+    uint64_t mask = (uint64_t)1 << (low & 63);
+    if ((word & mask) == 0) {
+      word |= mask;
+      container.cardinality++;
+    }
+    return;
+  }
+  auto iter = std::lower_bound(container.array.begin(), container.array.end(), low);
+  if (iter != container.array.end() && *iter == low) {
+    return;
+  }
+  container.array.insert(iter, low);
+  container.cardinality++;
+  container.normalize();
+}
+
+void RoaringBitmap::remove(uint32_t value)
+{
+  uint16_t key = value >> 16;
+  uint16_t low = value & 0xFFFF;
+  int index = find_container(key);
+  if (index == (int)containers_.size() || containers_[index].key != key) {
+    return;
+  }
+
+  Container &container = containers_[index];
+  if (container.is_bitset()) {
+    uint64_t &word = container.bitset[low >> 6];
+    uint64_t mask = (uint64_t)1 << (low & 63);
+    if ((word & mask) == 0) {
+      return;
+    }
+    word &= ~mask;
+    container.cardinality--;
+  } else {
+    auto iter = std::lower_bound(container.array.begin(), container.array.end(), low);
+    if (iter == container.array.end() || *iter != low) {
+      return;
+    }
+    container.array.erase(iter);
+    container.cardinality--;
+  }
+
+  if (container.cardinality == 0) {
+    containers_.erase(containers_.begin() + index);
+  } else {
+    container.normalize();
+  }
+}
+
+bool RoaringBitmap::contains(uint32_t value) const
+{
+  uint16_t key = value >> 16;
+  int index = find_container(key);
+  if (index == (int)containers_.size() || containers_[index].key != key) {
+    return false;
+  }
+  return containers_[index].contains(value & 0xFFFF);
+}
+
+uint64_t RoaringBitmap::cardinality() const
+{
+  uint64_t cardinality = 0;
+  for (const Container &container : containers_) {
+    cardinality += container.cardinality;
+  }
+  return cardinality;
+}
+
+void RoaringBitmap::and_container(Container &left, const Container &right)
+{
+  if (left.is_bitset() && right.is_bitset()) {
+    int cardinality = 0;
+    for (int i = 0; i < ROARING_BITSET_WORDS; i++) {
+      left.bitset[i] &= right.bitset[i];
+      cardinality += __builtin_popcountll(left.bitset[i]);
+    }
+    left.cardinality = cardinality;
+    left.normalize();
+    return;
+  }
+
+  // 至少有一边是数组，结果一定不超过数组的大小
+  std::vector<uint16_t> result;
+  if (left.is_bitset()) {
+    for (uint16_t low : right.array) {
+      if (bitset_test(left.bitset, low)) {
+        result.push_back(low);
+      }
+    }
+    std::vector<uint64_t>().swap(left.bitset);
+  } else if (right.is_bitset()) {
+    for (uint16_t low : left.array) {
+      if (bitset_test(right.bitset, low)) {
+        result.push_back(low);
+      }
+    }
+  } else {
+    std::set_intersection(left.array.begin(), left.array.end(), right.array.begin(), right.array.end(),
+                          std::back_inserter(result));
+  }
+  left.array.swap(result);
+  left.cardinality = left.array.size();
+}
+
+void RoaringBitmap::or_container(Container &left, const Container &right)
+{
+  if (!left.is_bitset() && !right.is_bitset()) {
+    std::vector<uint16_t> result;
+    result.reserve(left.array.size() + right.array.size());
+    std::set_union(left.array.begin(), left.array.end(), right.array.begin(), right.array.end(),
+                   std::back_inserter(result));
+    left.array.swap(result);
+    left.cardinality = left.array.size();
+    left.normalize();
+    return;
+  }
+
+  if (!left.is_bitset()) {
+    left.to_bitset();
+  }
+  if (right.is_bitset()) {
+    int cardinality = 0;
+    for (int i = 0; i < ROARING_BITSET_WORDS; i++) {
+      left.bitset[i] |= right.bitset[i];
+      cardinality += __builtin_popcountll(left.bitset[i]);
+    }
+    left.cardinality = cardinality;
+  } else {
+    for (uint16_t low : right.array) {
+      uint64_t &word = left.bitset[low >> 6];
+      uint64_t mask = (uint64_t)1 << (low & 63);
+      if ((word & mask) == 0) {
+        word |= mask;
+        left.cardinality++;
+      }
+    }
+  }
+  left.normalize();
+}
+
+void RoaringBitmap::and_with(const RoaringBitmap &other)
+{
+  std::vector<Container> result;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < containers_.size() && j < other.containers_.size()) {
+    if (containers_[i].key < other.containers_[j].key) {
+      i++;
+    } else if (containers_[i].key > other.containers_[j].key) {
+      j++;
+    } else {
+      and_container(containers_[i], other.containers_[j]);
+      if (containers_[i].cardinality > 0) {
+        result.push_back(std::move(containers_[i]));
+      }
+      i++;
+      j++;
+    }
+  }
+  containers_.swap(result);
+}
+
+void RoaringBitmap::or_with(const RoaringBitmap &other)
+{
+  std::vector<Container> result;
+  result.reserve(containers_.size() + other.containers_.size());
+  size_t i = 0;
+  size_t j = 0;
+  while (i < containers_.size() || j < other.containers_.size()) {
+    if (j == other.containers_.size() || (i < containers_.size() && containers_[i].key < other.containers_[j].key)) {
+      result.push_back(std::move(containers_[i++]));
+    } else if (i == containers_.size() || containers_[i].key > other.containers_[j].key) {
+      result.push_back(other.containers_[j++]);
+    } else {
+      or_container(containers_[i], other.containers_[j]);
+      result.push_back(std::move(containers_[i]));
+      i++;
+      j++;
+    }
+  }
+  containers_.swap(result);
+}
+
+bool RoaringBitmap::Iterator::next(uint32_t *value)
+{
+  const std::vector<Container> &containers = bitmap_.containers_;
+  while (container_ < containers.size()) {
+    const Container &container = containers[container_];
+    if (container.is_bitset()) {
+      // 从pos_所在的字开始，去掉已经输出过的低位
+      for (int word_index = pos_ >> 6; word_index < ROARING_BITSET_WORDS; word_index++) {
+        uint64_t word = container.bitset[word_index];
+        if (word_index == (pos_ >> 6)) {
+          word &= ~(uint64_t)0 << (pos_ & 63);
+        }
+        if (word != 0) {
+          int low = word_index * 64 + __builtin_ctzll(word);
+          *value = ((uint32_t)container.key << 16) | low;
+          pos_ = low + 1;
+          return true;
+        }
+      }
+    } else if (pos_ < (int)container.array.size()) {
+      *value = ((uint32_t)container.key << 16) | container.array[pos_++];
+      return true;
+    }
+    container_++;
+    pos_ = 0;
+  }
+  return false;
+}
+
+// 格式：容器个数，然后每个容器依次为key、基数和数据。基数决定了数据是数组还是位图
+void RoaringBitmap::write(std::ostream &os) const
+{
+  int container_num = containers_.size();
+  os.write((const char *)&container_num, sizeof(container_num));
+  for (const Container &container : containers_) {
+    os.write((const char *)&container.key, sizeof(container.key));
+    os.write((const char *)&container.cardinality, sizeof(container.cardinality));
+    if (container.is_bitset()) {
+      os.write((const char *)container.bitset.data(), ROARING_BITSET_WORDS * sizeof(uint64_t));
+    } else {
+      os.write((const char *)container.array.data(), container.array.size() * sizeof(uint16_t));
+    }
+  }
+}
+
+bool RoaringBitmap::read(std::istream &is)
+{
+  containers_.clear();
+  int container_num = 0;
+  is.read((char *)&container_num, sizeof(container_num));
+  if (!is.good() || container_num < 0 || container_num > 0x10000) {
+    return false;
+  }
+  containers_.resize(container_num);
+  for (Container &container : containers_) {
+    is.read((char *)&container.key, sizeof(container.key));
+    is.read((char *)&container.cardinality, sizeof(container.cardinality));
+    if (!is.good() || container.cardinality <= 0 || container.cardinality > 0x10000) {
+      containers_.clear();
+      return false;
+    }
+    if (container.cardinality > ROARING_ARRAY_MAX) {
+      container.bitset.resize(ROARING_BITSET_WORDS);
+      is.read((char *)container.bitset.data(), ROARING_BITSET_WORDS * sizeof(uint64_t));
+    } else {
+      container.array.resize(container.cardinality);
+      is.read((char *)container.array.data(), container.array.size() * sizeof(uint16_t));
+    }
+    if (!is.good()) {
+      containers_.clear();
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,92 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_ROARING_BITMAP_H_
+#define __OBSERVER_STORAGE_COMMON_ROARING_BITMAP_H_
+
+#include <stdint.h>
+#include <iostream>
+#include <vector>
+
+#define ROARING_ARRAY_MAX 4096       // 超过这个基数的容器由有序数组转为位图
+#define ROARING_BITSET_WORDS 1024    // 位图容器固定 65536 位
+
+/**
+ * Roaring风格的压缩位图，保存32位无符号整数的集合。
+ * 按高16位分成若干容器，容器内的元素较少时用有序的uint16数组保存，较多时用65536位的位图保存。
+ * 交集、并集按容器合并，两个位图容器之间按64位字做与/或运算
+ */
+class RoaringBitmap {
+public:
+  class Iterator {
+  public:
+    explicit Iterator(const RoaringBitmap &bitmap) : bitmap_(bitmap)
+    {}
+    // 按从小到大的顺序输出，没有更多元素时返回false
+    bool next(uint32_t *value);
+
+  private:
+    const RoaringBitmap &bitmap_;
+    size_t container_ = 0;
+    int pos_ = 0;           // 数组容器中的下标，或位图容器中的位号
+  };
+
+public:
+  void add(uint32_t value);
+  void remove(uint32_t value);
+  bool contains(uint32_t value) const;
+  void clear()
+  {
+    containers_.clear();
+  }
+  void swap(RoaringBitmap &other)
+  {
+    containers_.swap(other.containers_);
+  }
+  bool empty() const
+  {
+    return containers_.empty();
+  }
+  uint64_t cardinality() const;
+
+  // 原地求交集/并集
+  void and_with(const RoaringBitmap &other);
+  void or_with(const RoaringBitmap &other);
+
+  void write(std::ostream &os) const;
+  bool read(std::istream &is);
+
+private:
+  struct Container {
+    uint16_t key = 0;                // 元素的高16位
+    int cardinality = 0;
+    std::vector<uint16_t> array;     // 数组容器，有序
+    std::vector<uint64_t> bitset;    // 位图容器，非空时使用位图
+
+    bool is_bitset() const
+    {
+      return !bitset.empty();
+    }
+    bool contains(uint16_t low) const;
+    void to_bitset();
+    void to_array();
+    // 根据基数选择合适的存储方式
+    void normalize();
+  };
+
+  int find_container(uint16_t key) const;
+  static void and_container(Container &left, const Container &right);
+  static void or_container(Container &left, const Container &right);
+
+private:
+  std::vector<Container> containers_;  // 按key有序
+};
+
+#endif  //__OBSERVER_STORAGE_COMMON_ROARING_BITMAP_H_
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include <limits.h>
 #include <string.h>
 #include <algorithm>
+#include <iterator>
 
 #include "storage/common/table.h"
 #include "storage/common/table_meta.h"
@@ -26,6 +27,8 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/meta_util.h"
 #include "storage/common/index.h"
 #include "storage/common/bplus_tree_index.h"
+#include "storage/common/hash_index.h"
+#include "storage/common/bitmap_index.h"
 #include "storage/trx/trx.h"
 
 Table::Table() : data_buffer_pool_(nullptr),
@@ -148,12 +151,36 @@ RC Table::open(const char *meta_file, const char *base_dir)
   const int index_num = table_meta_.index_num();
   for (int i = 0; i < index_num; i++)
   {
-    BplusTreeIndex *index = new BplusTreeIndex();
     const IndexMeta *index_meta = table_meta_.index(i);
     int index_fields_num = index_meta->field_num();
-    if(index_fields_num>1){
+    int include_num = index_meta->include_field_num();
+    if (index_meta->is_hash() || index_meta->is_bitmap())
+    {
+      Index *index = nullptr;
+      rc = index_meta->is_hash() ? open_hash_index(base_dir, *index_meta, index)
+                                 : open_bitmap_index(base_dir, *index_meta, index);
+      if (rc != RC::SUCCESS)
+      {
+        return rc;
+      }
+      indexes_.push_back(index);
+      continue;
+    }
+    BplusTreeIndex *index = new BplusTreeIndex();
+    if(index_fields_num>1 || include_num>0){
       // multi-index
       const FieldMeta *field_metas[index_fields_num];
+      const FieldMeta *include_metas[include_num > 0 ? include_num : 1];
+      for (int j = 0; j < include_num; j++)
+      {
+        include_metas[j] = table_meta_.field(index_meta->include_field(j));
+        if (include_metas[j] == nullptr)
+        {
+          LOG_PANIC("Found invalid index meta info which has a non-exists include field. table=%s, index=%s, field=%s",
+                name(), index_meta->name(), index_meta->include_field(j));
+          return RC::GENERIC_ERROR;
+        }
+      }
       for(int i =0;i<index_fields_num;i++){
 
         const FieldMeta *field_meta= table_meta_.field(index_meta->field(i));
@@ -166,7 +193,7 @@ RC Table::open(const char *meta_file, const char *base_dir)
         field_metas[i] = field_meta;
       } 
       std::string index_file = index_data_file(base_dir, name(), index_meta->name());
-      rc = index->open(index_file.c_str(), *index_meta, field_metas, index_fields_num);
+      rc = index->open(index_file.c_str(), *index_meta, field_metas, index_fields_num, include_metas, include_num);
       if (rc != RC::SUCCESS)
       {
         delete index;
@@ -195,9 +222,83 @@ RC Table::open(const char *meta_file, const char *base_dir)
     }
     indexes_.push_back(index);
   }
+  for (Index *index : indexes_)
+  {
+    rc = init_index_predicate(index);
+    if (rc != RC::SUCCESS)
+    {
+      LOG_ERROR("Failed to init where condition of index %s. table=%s, rc=%d:%s", index->index_meta().name(), name(), rc, strrc(rc));
+      return rc;
+    }
+  }
   return rc;
 }
 
+RC Table::open_hash_index(const char *base_dir, const IndexMeta &index_meta, Index *&index)
+{
+  int field_num = index_meta.field_num();
+  int include_num = index_meta.include_field_num();
+  const FieldMeta *field_metas[field_num];
+  const FieldMeta *include_metas[include_num > 0 ? include_num : 1];
+  for (int i = 0; i < field_num; i++)
+  {
+    field_metas[i] = table_meta_.field(index_meta.field(i));
+    if (field_metas[i] == nullptr)
+    {
+      LOG_PANIC("Found invalid index meta info which has a non-exists field. table=%s, index=%s, field=%s",
+            name(), index_meta.name(), index_meta.field(i));
+      return RC::GENERIC_ERROR;
+    }
+  }
+  for (int i = 0; i < include_num; i++)
+  {
+    include_metas[i] = table_meta_.field(index_meta.include_field(i));
+    if (include_metas[i] == nullptr)
+    {
+      LOG_PANIC("Found invalid index meta info which has a non-exists include field. table=%s, index=%s, field=%s",
+            name(), index_meta.name(), index_meta.include_field(i));
+      return RC::GENERIC_ERROR;
+    }
+  }
+
+  HashIndex *hash_index = new HashIndex();
+  std::string index_file = index_data_file(base_dir, name(), index_meta.name());
+  RC rc = hash_index->open(index_file.c_str(), index_meta, field_metas, field_num, include_metas, include_num);
+  if (rc != RC::SUCCESS)
+  {
+    delete hash_index;
+    LOG_ERROR("Failed to open index. table=%s, index=%s, file=%s, rc=%d:%s",
+            name(), index_meta.name(), index_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+  index = hash_index;
+  return RC::SUCCESS;
+}
+
+RC Table::open_bitmap_index(const char *base_dir, const IndexMeta &index_meta, Index *&index)
+{
+  const FieldMeta *field_meta = table_meta_.field(index_meta.field(0));
+  if (field_meta == nullptr)
+  {
+    LOG_PANIC("Found invalid index meta info which has a non-exists field. table=%s, index=%s, field=%s",
+          name(), index_meta.name(), index_meta.field(0));
+    return RC::GENERIC_ERROR;
+  }
+
+  BitmapIndex *bitmap_index = new BitmapIndex();
+  std::string index_file = index_data_file(base_dir, name(), index_meta.name());
+  RC rc = bitmap_index->open(index_file.c_str(), index_meta, *field_meta);
+  if (rc != RC::SUCCESS)
+  {
+    delete bitmap_index;
+    LOG_ERROR("Failed to open index. table=%s, index=%s, file=%s, rc=%d:%s",
+            name(), index_meta.name(), index_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+  index = bitmap_index;
+  return RC::SUCCESS;
+}
+
 RC Table::commit_insert(Trx *trx, const RID &rid)
 {
   Record record;
@@ -211,17 +312,31 @@ RC Table::commit_insert(Trx *trx, const RID &rid)
   return trx->commit_insert(this, record);
 }
 
-RC Table::rollback_insert(Trx *trx, const RID &rid)
+RC Table::get_record_copy(const RID &rid, Record &record, std::string &data)
 {
-
-  Record record;
   RC rc = record_handler_->get_record(&rid, &record);
   if (rc != RC::SUCCESS)
   {
     return rc;
   }
+  // 记录后面跟着每个字段是否为NULL的标记
+  data.assign(record.data, table_meta_.record_size() + table_meta_.field_num() - table_meta_.sys_field_num());
+  record.data = (char *)data.data();
+  return RC::SUCCESS;
+}
 
+RC Table::rollback_insert(Trx *trx, const RID &rid)
+{
   // remove all indexes
+  std::lock_guard<std::mutex> guard(index_build_mutex_);
+  Record record;
+  std::string data;
+  RC rc = get_record_copy(rid, record, data);
+  if (rc != RC::SUCCESS)
+  {
+    return rc;
+  }
+
   rc = delete_entry_of_indexes(record.data, rid, false);
   if (rc != RC::SUCCESS)
   {
@@ -239,6 +354,7 @@ RC Table::insert_record(Trx *trx, Record *record)
 {
   // 首先insert到record中，再将记录insert到index索引中
   RC rc = RC::SUCCESS;
+  std::lock_guard<std::mutex> guard(index_build_mutex_);
 
   if (trx != nullptr)
   {
@@ -395,8 +511,9 @@ RC Table::make_record(int value_num, const Value *values, char *&record_out)
   LOG_INFO("record_size: %d", record_size);
   const FieldMeta *field = table_meta_.field(value_num - 1 + normal_field_start_index);
   int null_field_index = field->offset() + field->len();
-  // record大小增加value_num个字节，用来存放是否null值
-  char *record = new char[record_size + value_num];
+  // record大小增加value_num个字节，用来存放是否null值。
+  // 记录文件按record_size + field_num()复制，系统字段对应的字节也要分配出来
+  char *record = new char[record_size + table_meta_.field_num()]();
 
   for (int i = 0; i < value_num; i++)
   {
@@ -512,13 +629,156 @@ static RC scan_record_reader_adapter(Record *record, void *context)
   return RC::SUCCESS;
 }
 
-RC Table::scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, void (*record_reader)(const char *data, void *context))
+RC Table::scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, void (*record_reader)(const char *data, void *context),
+                      const char *field_names[], int field_num)
 { //当前scan_record 调用下面的scan_record函数
   RecordReaderScanAdapter adapter(record_reader, context);
-  return scan_record(trx, filter, limit, (void *)&adapter, scan_record_reader_adapter);
+  return scan_record(trx, filter, limit, (void *)&adapter, scan_record_reader_adapter, field_names, field_num);
+}
+
+// 把filter拆成DefaultConditionFilter，不是DefaultConditionFilter的部分放入nullptr
+static void collect_default_filters(const ConditionFilter *filter, std::vector<const DefaultConditionFilter *> &default_filters)
+{
+  if (filter == nullptr)
+  {
+    return;
+  }
+  const CompositeConditionFilter *composite_filter = dynamic_cast<const CompositeConditionFilter *>(filter);
+  if (composite_filter != nullptr)
+  {
+    for (int i = 0; i < composite_filter->filter_num(); i++)
+    {
+      default_filters.push_back(dynamic_cast<const DefaultConditionFilter *>(&composite_filter->filter(i)));
+    }
+  }
+  else
+  {
+    default_filters.push_back(dynamic_cast<const DefaultConditionFilter *>(filter));
+  }
+}
+
+// 部分索引的条件总是字段在左侧。IS NULL/IS NOT NULL的右侧用NULL值，不会去读常量
+static void make_predicate_condition(const IndexPredicate &predicate, Condition &condition)
+{
+  memset(&condition, 0, sizeof(condition));
+  condition.left_is_attr = 1;
+  condition.left_attr.attribute_name = (char *)predicate.field.c_str();
+  condition.comp = predicate.comp_op;
+  condition.right_is_attr = 0;
+  if (predicate.comp_op == IS_NULL || predicate.comp_op == IS_NOT_NULL)
+  {
+    condition.right_value.type = NULLS;
+    condition.right_value.data = (void *)"NULL";
+    condition.right_value.is_null = 1;
+  }
+  else
+  {
+    condition.right_value.type = predicate.type;
+    condition.right_value.data = (void *)predicate.value.data();
+  }
+}
+
+// 值在左、属性在右时，比较符需要反过来才能作用在索引字段上，例如 1 < id 等价于 id > 1
+static CompOp comp_op_for_field(CompOp comp_op, bool field_on_left)
+{
+  if (field_on_left)
+  {
+    return comp_op;
+  }
+  switch (comp_op)
+  {
+  case LESS_THAN:
+    return GREAT_THAN;
+  case LESS_EQUAL:
+    return GREAT_EQUAL;
+  case GREAT_THAN:
+    return LESS_THAN;
+  case GREAT_EQUAL:
+    return LESS_EQUAL;
+  default:
+    return comp_op;
+  }
+}
+
+RC Table::scan_record_in_index_order(Trx *trx, ConditionFilter *filter, const char *index_name, bool is_desc, int limit,
+                                     void *context, void (*record_reader)(const char *data, void *context),
+                                     const char *field_names[], int field_num)
+{
+  if (0 == limit)
+  {
+    return RC::SUCCESS;
+  }
+  if (limit < 0)
+  {
+    limit = INT_MAX;
+  }
+
+  Index *index = find_index(index_name);
+  if (nullptr == index)
+  {
+    LOG_ERROR("No such index. table=%s, index=%s", name(), index_name);
+    return RC::SCHEMA_INDEX_NOT_EXIST;
+  }
+
+  // 如果where中有作用在索引第一个字段上的条件，用它来限定扫描范围
+  CompOp comp_op = NO_OP;
+  const char *value = nullptr;
+  const FieldMeta &first_field = index->fields_meta()[0];
+  std::vector<const DefaultConditionFilter *> default_filters;
+  collect_default_filters(filter, default_filters);
+  for (const DefaultConditionFilter *default_filter : default_filters)
+  {
+    if (default_filter == nullptr)
+    {
+      continue;
+    }
+    bool field_on_left = default_filter->left().is_attr && !default_filter->right().is_attr;
+    bool field_on_right = default_filter->right().is_attr && !default_filter->left().is_attr;
+    const ConDesc *field_cond_desc = field_on_left ? &default_filter->left() : &default_filter->right();
+    const ConDesc *value_cond_desc = field_on_left ? &default_filter->right() : &default_filter->left();
+    if ((field_on_left || field_on_right) && field_cond_desc->attr_offset == first_field.offset())
+    {
+      comp_op = comp_op_for_field(default_filter->comp_op(), field_on_left);
+      value = (const char *)value_cond_desc->value;
+      break;
+    }
+  }
+
+  IndexScanner *index_scanner = index->create_ordered_scanner(comp_op, value, is_desc);
+  if (nullptr == index_scanner)
+  {
+    LOG_ERROR("Failed to create index scanner. table=%s, index=%s", name(), index_name);
+    return RC::GENERIC_ERROR;
+  }
+  RecordReaderScanAdapter adapter(record_reader, context);
+  bool index_only = can_scan_index_only(*index, filter, field_names, field_num);
+  return scan_record_by_index(trx, index_scanner, filter, limit, (void *)&adapter, scan_record_reader_adapter, index_only);
+}
+
+IndexScanner *Table::choose_index_scanner(ConditionFilter *filter, const char *field_names[], int field_num)
+{
+  // 在线建索引会在锁内向indexes_追加索引
+  std::lock_guard<std::mutex> guard(index_build_mutex_);
+  // filter == nullptr，则index_scanner也为nullptr
+  double selectivity = -1;
+  IndexScanner *index_scanner = find_index_for_scan(filter, selectivity);
+  if (index_scanner != nullptr && !can_scan_index_only(*index_scanner, filter, field_names, field_num) &&
+      !is_index_scan_cheaper(index_scanner->index(), selectivity))
+  {
+    LOG_INFO("根据统计信息，索引%s的扫描代价高于全表扫描。selectivity=%lf",
+             index_scanner->index().index_meta().name(), selectivity);
+    index_scanner->destroy();
+    index_scanner = nullptr;
+  }
+  if (index_scanner == nullptr)
+  {
+    index_scanner = find_covering_index_for_scan(filter, field_names, field_num);
+  }
+  return index_scanner;
 }
 
-RC Table::scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context))
+RC Table::scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context),
+                      const char *field_names[], int field_num)
 {
   if (nullptr == record_reader)
   {
@@ -535,12 +795,12 @@ RC Table::scan_record(Trx *trx, ConditionFilter *filter, int limit, void *contex
     limit = INT_MAX;
   }
 
-  // filter == nullptr，则index_scanner也为nullptr
-  IndexScanner *index_scanner = find_index_for_scan(filter);
+  IndexScanner *index_scanner = choose_index_scanner(filter, field_names, field_num);
   if (index_scanner != nullptr)
   {
     LOG_INFO("使用index,scan_record_by_index");
-    return scan_record_by_index(trx, index_scanner, filter, limit, context, record_reader);
+    bool index_only = can_scan_index_only(*index_scanner, filter, field_names, field_num);
+    return scan_record_by_index(trx, index_scanner, filter, limit, context, record_reader, index_only);
   }
   LOG_INFO("没有使用index");
   // filter == nullptr时，scanner会扫描所有元组
@@ -598,16 +858,40 @@ RC Table::scan_record(Trx *trx, ConditionFilter *filter, int limit, void *contex
 }
 
 RC Table::scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter *filter, int limit, void *context,
-                               RC (*record_reader)(Record *, void *))
+                               RC (*record_reader)(Record *, void *), bool index_only)
 {
   RC rc = RC::SUCCESS;
   RID rid;
   Record record;
   int record_count = 0;
+
+  // 索引覆盖扫描：字段值直接从索引项中取出，拼到一个临时记录里，不需要读记录文件
+  // 记录后面跟着每个字段一个字节的null标志，覆盖扫描的字段都不允许为空，全部置0即可
+  char *index_record = nullptr;
+  if (index_only && !scanner->returns_field_values())
+  {
+    LOG_WARN("Index scanner cannot return field values, refuse index only scan. table=%s, index=%s",
+             name(), scanner->index().index_meta().name());
+    scanner->destroy();
+    return RC::INVALID_ARGUMENT;
+  }
+  if (index_only)
+  {
+    int index_record_size = table_meta_.record_size() + table_meta_.field_num();
+    index_record = (char *)malloc(index_record_size);
+    if (nullptr == index_record)
+    {
+      scanner->destroy();
+      return RC::NOMEM;
+    }
+    memset(index_record, 0, index_record_size);
+    LOG_INFO("索引覆盖扫描，不读取记录. table=%s, index=%s", name(), scanner->index().index_meta().name());
+  }
+
   while (record_count < limit)
   {
     // 通过bplustree搜索获取rid
-    rc = scanner->next_entry(&rid);
+    rc = index_only ? scanner->next_entry(&rid, index_record) : scanner->next_entry(&rid);
     if (rc != RC::SUCCESS)
     {
       if (RC::RECORD_EOF == rc || RC::RECORD_NO_MORE_IDX_IN_MEM == rc)
@@ -618,12 +902,20 @@ RC Table::scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter
       LOG_ERROR("Failed to scan table by index. rc=%d:%s", rc, strrc(rc));
       break;
     }
-    // 根据rid获取record
-    rc = record_handler_->get_record(&rid, &record);
-    if (rc != RC::SUCCESS)
+    if (index_only)
     {
-      LOG_ERROR("Failed to fetch record of rid=%d:%d, rc=%d:%s", rid.page_num, rid.slot_num, rc, strrc(rc));
-      break;
+      record.rid = rid;
+      record.data = index_record;
+    }
+    else
+    {
+      // 根据rid获取record
+      rc = record_handler_->get_record(&rid, &record);
+      if (rc != RC::SUCCESS)
+      {
+        LOG_ERROR("Failed to fetch record of rid=%d:%d, rc=%d:%s", rid.page_num, rid.slot_num, rc, strrc(rc));
+        break;
+      }
     }
 
     if ((trx == nullptr || trx->is_visible(this, &record)) && (filter == nullptr || filter->filter(record)))
@@ -634,14 +926,78 @@ RC Table::scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter
         LOG_TRACE("Record reader break the table scanning. rc=%d:%s", rc, strrc(rc));
         break;
       }
+      record_count++;
     }
-    record_count++;
   }
 
+  free(index_record);
   scanner->destroy();
   return rc;
 }
 
+// 查询读取的字段和过滤条件用到的字段都保存在索引中时，可以只扫描索引。
+// 索引中没有空值标记，所以要求这些字段都不允许为空；存在未提交的操作时，需要读取记录判断可见性
+bool Table::can_scan_index_only(const Index &index, const ConditionFilter *filter, const char *field_names[], int field_num) const
+{
+  if (field_num < 0 || uncommitted_operation_num_ > 0)
+  {
+    return false;
+  }
+  for (int i = 0; i < field_num; i++)
+  {
+    const FieldMeta *field_meta = table_meta_.field(field_names[i]);
+    if (nullptr == field_meta || field_meta->nullable() || !index.covers_field(field_names[i]))
+    {
+      return false;
+    }
+  }
+
+  std::vector<const DefaultConditionFilter *> default_filters;
+  collect_default_filters(filter, default_filters);
+  for (const DefaultConditionFilter *default_filter : default_filters)
+  {
+    if (default_filter == nullptr)
+    {
+      return false;
+    }
+    const ConDesc *cond_descs[2] = {&default_filter->left(), &default_filter->right()};
+    for (const ConDesc *cond_desc : cond_descs)
+    {
+      if (!cond_desc->is_attr)
+      {
+        continue;
+      }
+      const FieldMeta *field_meta = table_meta_.find_field_by_offset(cond_desc->attr_offset);
+      if (nullptr == field_meta || field_meta->nullable() || !index.covers_field(field_meta->name()))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool Table::can_scan_index_only(const IndexScanner &scanner, const ConditionFilter *filter, const char *field_names[], int field_num) const
+{
+  return scanner.returns_field_values() && can_scan_index_only(scanner.index(), filter, field_names, field_num);
+}
+
+// 过滤条件用不上索引时，如果有索引覆盖了所有用到的字段，扫描整个索引比扫描记录文件读的页面更少
+IndexScanner *Table::find_covering_index_for_scan(const ConditionFilter *filter, const char *field_names[], int field_num)
+{
+  for (Index *index : indexes_)
+  {
+    // 哈希索引不能遍历，create_ordered_scanner返回nullptr
+    IndexScanner *index_scanner = nullptr;
+    if (!index->index_meta().is_partial() && can_scan_index_only(*index, filter, field_names, field_num) &&
+        (index_scanner = index->create_ordered_scanner(NO_OP, nullptr, false)) != nullptr)
+    {
+      return index_scanner;
+    }
+  }
+  return nullptr;
+}
+
 class IndexInserter
 {
 public:
@@ -651,6 +1007,10 @@ public:
 
   RC insert_index(const Record *record)
   {
+    if (!index_->accepts(record->data))
+    {
+      return RC::SUCCESS;
+    }
     return index_->insert_entry(record->data, &record->rid);
   }
 
@@ -658,124 +1018,379 @@ private:
   Index *index_;
 };
 
-static RC insert_index_record_reader_adapter(Record *record, void *context)
+// 在线建索引期间其它线程对表的一次索引变更，record是变更时记录内容的拷贝
+struct IndexBuildLogEntry
 {
-  IndexInserter &inserter = *(IndexInserter *)context;
-  return inserter.insert_index(record);
-}
+  bool is_insert;
+  RID rid;
+  std::string record;
+};
 
-std::vector<const char *> Table::get_index_names()
+/**
+ * 在线建索引的状态，扫描和写入者都在index_build_mutex_内访问。
+ * 扫描每次在锁内读取一条记录、插入索引，并把scan_pos推进到这条记录；
+ * 写入者在同一次持有锁时修改记录文件和维护索引，只有scan_pos及之前的记录上的变更才记入日志，
+ * 之后的记录等扫描到达时读到的已经是修改后的内容。
+ * 所以每次变更要么已经被扫描看到、要么记在日志中，回放日志时索引的内容和变更前的记录一致
+ */
+struct IndexBuildState
 {
-  std::vector<const char *> res;
-  for (auto idx : indexes_)
-  {
-    LOG_ERROR("index_name = %s", idx->index_meta().name());
-    res.push_back(idx->index_meta().name());
-  }
+  RID scan_pos;                         // 最后扫描到的记录，page_num为-1表示还没有开始扫描
+  std::vector<IndexBuildLogEntry> log;
+};
 
-  return res;
-}
-bool check_attr_name( const int& attr_num, const char *attribute_name[] ){
-  for(int i = 0; i < attr_num; i++ ){
-    if(attribute_name[i] == nullptr || common::is_blank(attribute_name[i])){
-      return true;
-    }
-  }
-  return false;
+static bool rid_less(const RID &left, const RID &right)
+{
+  return left.page_num < right.page_num || (left.page_num == right.page_num && left.slot_num < right.slot_num);
 }
-//重载函数
-RC Table::create_index(Trx *trx, const char *index_name, const int& attr_num, const char *attribute_name[],int is_unique)
+
+// 剩余的旁路日志不超过这个数量时，加锁回放并发布索引
+#define INDEX_BUILD_LOG_TAIL 64
+
+void Table::log_index_change(bool is_insert, const char *record, const RID &rid)
 {
-  if (index_name == nullptr || common::is_blank(index_name) ||
-      check_attr_name(attr_num, attribute_name))
+  // 扫描还没有到达的记录不记日志
+  if (index_build_ != nullptr && !rid_less(index_build_->scan_pos, rid))
   {
-    LOG_ERROR("create_index - INVALID_ARGUMENT");
-    return RC::INVALID_ARGUMENT;
-  }
-  if (table_meta_.index(index_name) != nullptr ||
-      table_meta_.find_multi_index_by_fields_for_check(attribute_name,attr_num))
-  {
-    LOG_ERROR("create_index - SCHEMA_INDEX_EXIST");
-    return RC::SCHEMA_INDEX_EXIST;
+    // 记录后面跟着每个字段是否为NULL的标记，部分索引的条件会用到
+    const int record_size = table_meta_.record_size() + table_meta_.field_num() - table_meta_.sys_field_num();
+    index_build_->log.push_back(IndexBuildLogEntry{is_insert, rid, std::string(record, record_size)});
   }
+}
 
-  const FieldMeta *field_metas[attr_num];
-  for(int i=0;i<attr_num;i++){
-    const FieldMeta *field_meta = table_meta_.field(attribute_name[i]);
-    if (!field_meta)
+RC Table::apply_index_build_log(Index *index, const std::vector<IndexBuildLogEntry> &build_log)
+{
+  for (const IndexBuildLogEntry &entry : build_log)
+  {
+    // 插入前先删除同一个RID的旧索引项，即使同一个变更被回放两次也不会报重复
+    RC rc = index->delete_entry(entry.record.data(), &entry.rid);
+    if (rc != RC::SUCCESS && rc != RC::RECORD_INVALID_KEY)
     {
-      LOG_ERROR("create_index - SCHEMA_FIELD_MISSING");
-      return RC::SCHEMA_FIELD_MISSING;
+      LOG_ERROR("Failed to replay index build log. rid=%d.%d, rc=%d:%s", entry.rid.page_num, entry.rid.slot_num, rc, strrc(rc));
+      return rc;
+    }
+    if (entry.is_insert && index->accepts(entry.record.data()))
+    {
+      rc = index->insert_entry(entry.record.data(), &entry.rid);
+      if (rc != RC::SUCCESS)
+      {
+        LOG_ERROR("Failed to replay index build log. rid=%d.%d, rc=%d:%s", entry.rid.page_num, entry.rid.slot_num, rc, strrc(rc));
+        return rc;
+      }
     }
-    field_metas[i] = field_meta;
-  }
-  IndexMeta new_index_meta;
-  RC rc = new_index_meta.init(index_name, field_metas, attr_num);
-  if (rc != RC::SUCCESS)
-  {
-    LOG_ERROR("fail to init index meta");
-    return rc;
   }
+  return RC::SUCCESS;
+}
 
-  // 创建索引相关数据
-  BplusTreeIndex *index = new BplusTreeIndex();
-  std::string index_file = index_data_file(base_dir_.c_str(), name(), index_name);
-  // 创建对应文件
-  rc = index->create(index_file.c_str(), new_index_meta, field_metas, attr_num, is_unique);
+RC Table::scan_for_index_build(Index *index)
+{
+  RecordFileScanner scanner;
+  RC rc = scanner.open_scan(*data_buffer_pool_, file_id_, nullptr);
   if (rc != RC::SUCCESS)
   {
-    delete index;
-    LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
+    LOG_ERROR("failed to open scanner. file id=%d. rc=%d:%s", file_id_, rc, strrc(rc));
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引  就是对之前的创建index前的数据全部建立索引
+  // 遍历当前的所有数据插入这个索引。不按事务过滤，已有的索引同样包含其它事务未提交的记录
   IndexInserter index_inserter(index);
-  rc = scan_record(trx, nullptr, -1, &index_inserter, insert_index_record_reader_adapter);
-  if (rc != RC::SUCCESS)
+  Record record;
+  bool has_text = false;
+  bool started = false;
+  while (rc == RC::SUCCESS)
   {
-    // rollback
-    delete index;
-    LOG_ERROR("Failed to insert index to all records. table=%s, rc=%d:%s", name(), rc, strrc(rc));
-    return rc;
-  }
-  indexes_.push_back(index);
+    {
+      std::lock_guard<std::mutex> guard(index_build_mutex_);
+      rc = started ? scanner.get_next_record(&record, has_text) : scanner.get_first_record(&record, has_text);
+      started = true;
+      if (rc == RC::RECORD_EOF)
+      {
+        // 扫描结束，之后所有记录上的变更都记入日志
+        index_build_->scan_pos.page_num = INT_MAX;
+        index_build_->scan_pos.slot_num = INT_MAX;
+        rc = RC::SUCCESS;
+        break;
+      }
+      if (rc != RC::SUCCESS)
+      {
+        LOG_ERROR("failed to scan record. file id=%d, rc=%d:%s", file_id_, rc, strrc(rc));
+        break;
+      }
+      index_build_->scan_pos = record.rid;
+      // 和scan_record一样，带TEXT字段的记录拿到的RID是第二页的
+      if (has_text)
+      {
+        record.rid.page_num--;
+      }
+      rc = index_inserter.insert_index(&record);
+    }
+    if (index_build_hook_ != nullptr)
+    {
+      index_build_hook_(index_build_hook_context_);
+    }
+  }
+  scanner.close_scan();
+  return rc;
+}
 
-  TableMeta new_table_meta(table_meta_);
-  rc = new_table_meta.add_index(new_index_meta);
+RC Table::build_index_online(Index *index, const IndexMeta &index_meta)
+{
+  IndexBuildState build_state;
+  build_state.scan_pos.page_num = -1;
+  build_state.scan_pos.slot_num = -1;
+  {
+    std::lock_guard<std::mutex> guard(index_build_mutex_);
+    if (index_build_ != nullptr)
+    {
+      LOG_WARN("Another index is being built on table %s", name());
+      return RC::LOCKED;
+    }
+    index_build_ = &build_state;
+  }
+
+  RC rc = scan_for_index_build(index);
+  int replayed_num = 0;
+  while (rc == RC::SUCCESS)
+  {
+    if (index_build_hook_ != nullptr)
+    {
+      index_build_hook_(index_build_hook_context_);
+    }
+    std::unique_lock<std::mutex> lock(index_build_mutex_);
+    std::vector<IndexBuildLogEntry> pending;
+    pending.swap(build_state.log);
+    replayed_num += pending.size();
+    if (pending.size() > INDEX_BUILD_LOG_TAIL)
+    {
+      // 日志较多时不持有锁回放，写入者只在追加日志时短暂等待
+      lock.unlock();
+      rc = apply_index_build_log(index, pending);
+      continue;
+    }
+
+    rc = apply_index_build_log(index, pending);
+    if (rc != RC::SUCCESS)
+    {
+      break;
+    }
+    TableMeta new_table_meta(table_meta_);
+    rc = new_table_meta.add_index(index_meta);
+    if (rc != RC::SUCCESS)
+    {
+      LOG_ERROR("Failed to add index (%s) on table (%s). error=%d:%s", index_meta.name(), name(), rc, strrc(rc));
+      break;
+    }
+    rc = write_meta_file(new_table_meta);
+    if (rc != RC::SUCCESS)
+    {
+      break;
+    }
+    // 在锁内发布，之后的写入直接维护这个索引。
+    // 只追加索引的元数据，不替换整个table_meta_，其它线程正在使用的字段元数据保持有效
+    indexes_.push_back(index);
+    table_meta_.add_index(index_meta);
+    index_build_ = nullptr;
+    LOG_INFO("Index %s was built online, replayed %d concurrent changes", index_meta.name(), replayed_num);
+    return RC::SUCCESS;
+  }
+
+  std::lock_guard<std::mutex> guard(index_build_mutex_);
+  index_build_ = nullptr;
+  LOG_ERROR("Failed to build index %s on table %s. rc=%d:%s", index_meta.name(), name(), rc, strrc(rc));
+  return rc;
+}
+
+void Table::set_index_build_hook(void (*hook)(void *context), void *context)
+{
+  index_build_hook_ = hook;
+  index_build_hook_context_ = context;
+}
+
+std::vector<const char *> Table::get_index_names()
+{
+  std::vector<const char *> res;
+  for (auto idx : indexes_)
+  {
+    LOG_ERROR("index_name = %s", idx->index_meta().name());
+    res.push_back(idx->index_meta().name());
+  }
+
+  return res;
+}
+bool check_attr_name( const int& attr_num, const char *attribute_name[] ){
+  for(int i = 0; i < attr_num; i++ ){
+    if(attribute_name[i] == nullptr || common::is_blank(attribute_name[i])){
+      return true;
+    }
+  }
+  return false;
+}
+//重载函数
+RC Table::create_index(Trx *trx, const char *index_name, const int& attr_num, const char *attribute_name[],int is_unique,
+                       int include_num, const char *include_attribute_name[], IndexType index_type,
+                       int condition_num, const Condition *conditions)
+{
+  if (index_name == nullptr || common::is_blank(index_name) ||
+      check_attr_name(attr_num, attribute_name))
+  {
+    LOG_ERROR("create_index - INVALID_ARGUMENT");
+    return RC::INVALID_ARGUMENT;
+  }
+  // 部分索引可以和同样字段上的普通索引同时存在
+  if (table_meta_.index(index_name) != nullptr ||
+      (condition_num == 0 && table_meta_.find_multi_index_by_fields_for_check(attribute_name,attr_num)))
+  {
+    LOG_ERROR("create_index - SCHEMA_INDEX_EXIST");
+    return RC::SCHEMA_INDEX_EXIST;
+  }
+  // 位图索引每个值对应一个位图，只支持单个非唯一字段
+  const bool is_hash = index_type == INDEX_TYPE_HASH;
+  const bool is_bitmap = index_type == INDEX_TYPE_BITMAP;
+  if (is_bitmap && (attr_num != 1 || include_num > 0 || is_unique))
+  {
+    LOG_ERROR("create_index - bitmap index must be a non-unique index on one field");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const FieldMeta *field_metas[attr_num];
+  for(int i=0;i<attr_num;i++){
+    const FieldMeta *field_meta = table_meta_.field(attribute_name[i]);
+    if (!field_meta)
+    {
+      LOG_ERROR("create_index - SCHEMA_FIELD_MISSING");
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    // 哈希索引和位图索引按照字节判断相等，浮点数的比较有误差，不能建这两种索引
+    if ((is_hash || is_bitmap) && (field_meta->type() == FLOATS || field_meta->type() == TEXTS))
+    {
+      LOG_ERROR("create_index - field %s cannot be used in %s index", attribute_name[i], is_hash ? "hash" : "bitmap");
+      return RC::INVALID_ARGUMENT;
+    }
+    field_metas[i] = field_meta;
+  }
+  IndexMeta new_index_meta;
+  RC rc = new_index_meta.init(index_name, field_metas, attr_num);
   if (rc != RC::SUCCESS)
   {
-    LOG_ERROR("Failed to add index (%s) on table (%s). error=%d:%s", index_name, name(), rc, strrc(rc));
+    LOG_ERROR("fail to init index meta");
     return rc;
   }
-  // 创建元数据临时文件
-  std::string tmp_file = table_meta_file(base_dir_.c_str(), name()) + ".tmp";
-  std::fstream fs;
-  fs.open(tmp_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-  if (!fs.is_open())
+  new_index_meta.set_hash(is_hash);
+  new_index_meta.set_bitmap(is_bitmap);
+
+  // INCLUDE字段只保存在叶子中，不能与索引字段重复，TEXT字段的内容不在记录中，不能INCLUDE
+  std::vector<const FieldMeta *> include_metas;
+  for (int i = 0; i < include_num; i++)
   {
-    LOG_ERROR("Failed to open file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
-    return RC::IOERR; // 创建索引中途出错，要做还原操作
+    const FieldMeta *field_meta = table_meta_.field(include_attribute_name[i]);
+    if (!field_meta)
+    {
+      LOG_ERROR("create_index - SCHEMA_FIELD_MISSING");
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    if (field_meta->type() == TEXTS)
+    {
+      LOG_ERROR("create_index - invalid include field %s", include_attribute_name[i]);
+      return RC::INVALID_ARGUMENT;
+    }
+    for (int j = 0; j < attr_num; j++)
+    {
+      if (field_metas[j] == field_meta)
+      {
+        LOG_ERROR("create_index - include field %s is already in index key", include_attribute_name[i]);
+        return RC::INVALID_ARGUMENT;
+      }
+    }
+    include_metas.push_back(field_meta);
+    new_index_meta.add_include_field(*field_meta);
   }
-  if (new_table_meta.serialize(fs) < 0)
+  // 部分索引：WHERE中的每个条件都必须是 字段 比较符 常量
+  for (int i = 0; i < condition_num; i++)
   {
-    LOG_ERROR("Failed to dump new table meta to file: %s. sys err=%d:%s", tmp_file.c_str(), errno, strerror(errno));
-    return RC::IOERR;
+    const Condition &condition = conditions[i];
+    const bool field_on_left = condition.left_is_attr == 1 && condition.right_is_attr == 0;
+    const bool field_on_right = condition.left_is_attr == 0 && condition.right_is_attr == 1;
+    if (!(field_on_left || field_on_right) || condition.comp > IS_NOT_NULL)
+    {
+      LOG_ERROR("create_index - unsupported where condition of index %s", index_name);
+      return RC::INVALID_ARGUMENT;
+    }
+    const RelAttr &attr = field_on_left ? condition.left_attr : condition.right_attr;
+    const Value &value = field_on_left ? condition.right_value : condition.left_value;
+    const FieldMeta *field_meta = table_meta_.field(attr.attribute_name);
+    if (!field_meta)
+    {
+      LOG_ERROR("create_index - SCHEMA_FIELD_MISSING");
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    IndexPredicate predicate;
+    predicate.field = field_meta->name();
+    predicate.comp_op = comp_op_for_field(condition.comp, field_on_left);
+    predicate.type = field_meta->type();
+    if (predicate.comp_op != IS_NULL && predicate.comp_op != IS_NOT_NULL)
+    {
+      const bool is_string = value.type == CHARS || value.type == TEXTS;
+      if (field_meta->type() == TEXTS || (field_meta->type() == CHARS ? !is_string : value.type != field_meta->type()))
+      {
+        LOG_ERROR("create_index - where condition on field %s has mismatched value", field_meta->name());
+        return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+      }
+      if (field_meta->type() == CHARS)
+      {
+        predicate.value.assign((const char *)value.data, strnlen((const char *)value.data, field_meta->len()));
+      }
+      else
+      {
+        predicate.value.assign((const char *)value.data, field_meta->len());
+      }
+    }
+    new_index_meta.add_predicate(predicate);
   }
-  fs.close();
 
-  // 覆盖原始元数据文件
-  std::string meta_file = table_meta_file(base_dir_.c_str(), name());
-  int ret = rename(tmp_file.c_str(), meta_file.c_str());
-  if (ret != 0)
+  // 创建索引相关数据
+  Index *index = nullptr;
+  std::string index_file = index_data_file(base_dir_.c_str(), name(), index_name);
+  // 创建对应文件
+  if (is_hash)
   {
-    LOG_ERROR("Failed to rename tmp meta file (%s) to normal meta file (%s) while creating index (%s) on table (%s). "
-              "system error=%d:%s",
-              tmp_file.c_str(), meta_file.c_str(), index_name, name(), errno, strerror(errno));
-    return RC::IOERR;
+    HashIndex *hash_index = new HashIndex();
+    rc = hash_index->create(index_file.c_str(), new_index_meta, field_metas, attr_num, is_unique, include_metas.data(), include_metas.size());
+    index = hash_index;
+  }
+  else if (is_bitmap)
+  {
+    BitmapIndex *bitmap_index = new BitmapIndex();
+    rc = bitmap_index->create(index_file.c_str(), new_index_meta, *field_metas[0]);
+    index = bitmap_index;
+  }
+  else
+  {
+    BplusTreeIndex *bplus_tree_index = new BplusTreeIndex();
+    rc = bplus_tree_index->create(index_file.c_str(), new_index_meta, field_metas, attr_num, is_unique, include_metas.data(), include_metas.size());
+    index = bplus_tree_index;
+  }
+  if (rc != RC::SUCCESS)
+  {
+    delete index;
+    LOG_ERROR("Failed to create %s index. file name=%s, rc=%d:%s",
+              is_hash ? "hash" : (is_bitmap ? "bitmap" : "bplus tree"), index_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+  rc = init_index_predicate(index);
+  if (rc != RC::SUCCESS)
+  {
+    delete index;
+    LOG_ERROR("Failed to init where condition of index %s. rc=%d:%s", index_name, rc, strrc(rc));
+    return rc;
   }
 
-  table_meta_.swap(new_table_meta);
+  rc = build_index_online(index, new_index_meta);
+  if (rc != RC::SUCCESS)
+  {
+    // rollback
+    delete index;
+    return rc;
+  }
 
   LOG_INFO("successfully add a new index (%s) on the table (%s)", index_name, name());
 
@@ -824,57 +1439,173 @@ RC Table::create_index(Trx *trx, const char *index_name, const char *attribute_n
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引  就是对之前的创建index前的数据全部建立索引
-  IndexInserter index_inserter(index);
-  rc = scan_record(trx, nullptr, -1, &index_inserter, insert_index_record_reader_adapter);
+  rc = build_index_online(index, new_index_meta);
   if (rc != RC::SUCCESS)
   {
     // rollback
     delete index;
-    LOG_ERROR("Failed to insert index to all records. table=%s, rc=%d:%s", name(), rc, strrc(rc));
     return rc;
   }
-  indexes_.push_back(index);
+
+  LOG_INFO("successfully add a new index (%s) on the table (%s)", index_name, name());
+
+  return rc;
+}
+
+// 收集每个字段的非NULL取值和NULL值个数，TEXT字段不收集
+class StatsCollector
+{
+public:
+  explicit StatsCollector(const TableMeta &table_meta)
+      : table_meta_(table_meta), values_(table_meta.field_num()), null_nums_(table_meta.field_num(), 0)
+  {
+  }
+
+  RC collect(const Record *record)
+  {
+    row_num_++;
+    const int record_size = table_meta_.record_size();
+    const int sys_field_num = table_meta_.sys_field_num();
+    for (int i = sys_field_num; i < table_meta_.field_num(); i++)
+    {
+      const FieldMeta *field = table_meta_.field(i);
+      if (field->type() == TEXTS)
+      {
+        continue;
+      }
+      if (record->data[record_size + i - sys_field_num] != 0)
+      {
+        null_nums_[i]++;
+        continue;
+      }
+      const char *value = record->data + field->offset();
+      values_[i].insert(values_[i].end(), value, value + field->len());
+    }
+    return RC::SUCCESS;
+  }
+
+  void build(TableStats &stats)
+  {
+    stats.reset(row_num_);
+    for (int i = table_meta_.sys_field_num(); i < table_meta_.field_num(); i++)
+    {
+      const FieldMeta *field = table_meta_.field(i);
+      if (field->type() == TEXTS)
+      {
+        continue;
+      }
+      std::vector<const char *> values;
+      for (size_t pos = 0; pos < values_[i].size(); pos += field->len())
+      {
+        values.push_back(values_[i].data() + pos);
+      }
+      ColumnStats column;
+      column.init(*field, values, null_nums_[i]);
+      stats.add_column(column);
+    }
+  }
+
+private:
+  const TableMeta &table_meta_;
+  int row_num_ = 0;
+  std::vector<std::vector<char>> values_;
+  std::vector<int> null_nums_;
+};
+
+static RC stats_record_reader_adapter(Record *record, void *context)
+{
+  StatsCollector &collector = *(StatsCollector *)context;
+  return collector.collect(record);
+}
+
+RC Table::analyze(Trx *trx)
+{
+  StatsCollector collector(table_meta_);
+  RC rc = scan_record(trx, nullptr, -1, &collector, stats_record_reader_adapter);
+  if (rc != RC::SUCCESS)
+  {
+    LOG_ERROR("Failed to scan records while analyzing table %s. rc=%d:%s", name(), rc, strrc(rc));
+    return rc;
+  }
+
+  TableStats stats;
+  collector.build(stats);
+  for (Index *index : indexes_)
+  {
+    IndexStats index_stats;
+    index_stats.index_name = index->index_meta().name();
+    rc = index->get_statistics(&index_stats.height, &index_stats.leaf_num);
+    if (rc != RC::SUCCESS)
+    {
+      LOG_ERROR("Failed to get statistics of index %s. rc=%d:%s", index->index_meta().name(), rc, strrc(rc));
+      return rc;
+    }
+    stats.add_index(index_stats);
+  }
 
   TableMeta new_table_meta(table_meta_);
-  rc = new_table_meta.add_index(new_index_meta);
+  new_table_meta.set_stats(stats);
+  rc = write_meta_file(new_table_meta);
+  if (rc != RC::SUCCESS)
+  {
+    return rc;
+  }
+  table_meta_.swap(new_table_meta);
+  LOG_INFO("Successfully analyzed table %s. row num=%d", name(), stats.row_num());
+  return RC::SUCCESS;
+}
+
+RC Table::init_index_predicate(Index *index)
+{
+  const std::vector<IndexPredicate> &predicates = index->index_meta().predicates();
+  if (predicates.empty())
+  {
+    return RC::SUCCESS;
+  }
+  // 条件中的常量指向索引元数据中保存的值，和索引的生命周期相同
+  std::vector<Condition> conditions(predicates.size());
+  for (size_t i = 0; i < predicates.size(); i++)
+  {
+    make_predicate_condition(predicates[i], conditions[i]);
+  }
+  CompositeConditionFilter *filter = new CompositeConditionFilter();
+  RC rc = filter->init(*this, conditions.data(), conditions.size());
   if (rc != RC::SUCCESS)
   {
-    LOG_ERROR("Failed to add index (%s) on table (%s). error=%d:%s", index_name, name(), rc, strrc(rc));
+    delete filter;
     return rc;
   }
-  // 创建元数据临时文件
+  index->set_predicate_filter(filter);
+  return RC::SUCCESS;
+}
+
+// 先写临时文件再覆盖原始元数据文件
+RC Table::write_meta_file(const TableMeta &table_meta)
+{
   std::string tmp_file = table_meta_file(base_dir_.c_str(), name()) + ".tmp";
   std::fstream fs;
   fs.open(tmp_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
   if (!fs.is_open())
   {
     LOG_ERROR("Failed to open file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
-    return RC::IOERR; // 创建索引中途出错，要做还原操作
+    return RC::IOERR;
   }
-  if (new_table_meta.serialize(fs) < 0)
+  if (table_meta.serialize(fs) < 0)
   {
     LOG_ERROR("Failed to dump new table meta to file: %s. sys err=%d:%s", tmp_file.c_str(), errno, strerror(errno));
     return RC::IOERR;
   }
   fs.close();
 
-  // 覆盖原始元数据文件
   std::string meta_file = table_meta_file(base_dir_.c_str(), name());
   int ret = rename(tmp_file.c_str(), meta_file.c_str());
   if (ret != 0)
   {
-    LOG_ERROR("Failed to rename tmp meta file (%s) to normal meta file (%s) while creating index (%s) on table (%s). "
-              "system error=%d:%s",
-              tmp_file.c_str(), meta_file.c_str(), index_name, name(), errno, strerror(errno));
+    LOG_ERROR("Failed to rename tmp meta file (%s) to normal meta file (%s) of table (%s). system error=%d:%s",
+              tmp_file.c_str(), meta_file.c_str(), name(), errno, strerror(errno));
     return RC::IOERR;
   }
-
-  table_meta_.swap(new_table_meta);
-
-  LOG_INFO("successfully add a new index (%s) on the table (%s)", index_name, name());
-
-  return rc;
+  return RC::SUCCESS;
 }
 
 class RecordUpdater
@@ -1028,6 +1759,7 @@ RC Table::update_record(Trx *trx, Record *record, const char *attribute_name, co
   memcpy(data, record->data, table_meta_.record_size());
   memcpy(data + field_meta->offset(), value->data, field_meta->len());
 
+  std::lock_guard<std::mutex> guard(index_build_mutex_);
   rc = update_entry_of_indexes(data, record->rid,record->data, record->rid, false);
   if (rc != RC::SUCCESS)
   {
@@ -1064,6 +1796,7 @@ RC Table::commit_update(Trx *trx, const RID &rid, char *new_record_data)
   }
 
   // 删除索引index
+  std::lock_guard<std::mutex> guard(index_build_mutex_);
   rc = delete_entry_of_indexes(record.data, record.rid, false); // 重复代码 refer to commit_delete
   if (rc != RC::SUCCESS)
   {
@@ -1159,6 +1892,7 @@ RC Table::delete_record(Trx *trx, Record *record)
   }
   else
   {
+    std::lock_guard<std::mutex> guard(index_build_mutex_);
     rc = delete_entry_of_indexes(record->data, record->rid, false); // 重复代码 refer to commit_delete
     if (rc != RC::SUCCESS)
     {
@@ -1176,8 +1910,10 @@ RC Table::delete_record(Trx *trx, Record *record)
 RC Table::commit_delete(Trx *trx, const RID &rid)
 {
   RC rc = RC::SUCCESS;
+  std::lock_guard<std::mutex> guard(index_build_mutex_);
   Record record;
-  rc = record_handler_->get_record(&rid, &record);
+  std::string data;
+  rc = get_record_copy(rid, record, data);
   if (rc != RC::SUCCESS)
   {
     return rc;
@@ -1198,6 +1934,11 @@ RC Table::commit_delete(Trx *trx, const RID &rid)
   return rc;
 }
 
+void Table::add_uncommitted_operation_num(int num)
+{
+  uncommitted_operation_num_ += num;
+}
+
 RC Table::rollback_delete(Trx *trx, const RID &rid)
 {
   RC rc = RC::SUCCESS;
@@ -1210,17 +1951,81 @@ RC Table::rollback_delete(Trx *trx, const RID &rid)
 
   return trx->rollback_delete(this, record); // update record in place
 }
-RC Table::update_entry_of_indexes(const char *record_i, const RID &rid_i,
-                                  const char *record_d, const RID &rid_d, bool error_on_not_exists)
+static bool index_key_changed(const Index &index, const char *record_i, const char *record_d)
 {
-  RC rc = RC::SUCCESS;
-  for (Index *index : indexes_)
+  for (const FieldMeta &field_meta : index.fields_meta())
   {
-    rc = index->insert_entry(record_i, &rid_i);
-    if (rc == RC::RECORD_DUPLICATE_KEY){
-      // 已经当前索引保持原样即可, 后面也不要去删除
+    if (0 != memcmp(record_i + field_meta.offset(), record_d + field_meta.offset(), field_meta.len()))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+RC Table::update_entry_of_indexes(const char *record_i, const RID &rid_i,
+                                  const char *record_d, const RID &rid_d, bool error_on_not_exists)
+{
+  RC rc = RC::SUCCESS;
+  const bool same_rid = 0 == memcmp(&rid_i, &rid_d, sizeof(RID));
+  for (Index *index : indexes_)
+  {
+    // 部分索引：更新前后是否满足条件决定了要插入、删除还是更新索引项
+    const bool accept_i = index->accepts(record_i);
+    const bool accept_d = index->accepts(record_d);
+    if (!accept_i && !accept_d)
+    {
+      continue;
+    }
+    if (!accept_i)
+    {
+      rc = index->delete_entry(record_d, &rid_d);
+      if (rc != RC::SUCCESS && rc != RC::RECORD_INVALID_KEY)
+      {
+        LOG_ERROR("Failed to delete indexes of record (rid=%d.%d). rc=%d:%s",
+                  rid_d.page_num, rid_d.slot_num, rc, strrc(rc));
+        break;
+      }
       rc = RC::SUCCESS;
       continue;
+    }
+    rc = index->insert_entry(record_i, &rid_i);
+    if (!accept_d)
+    {
+      if (rc != RC::SUCCESS)
+      {
+        LOG_ERROR("Failed to insert indexes of record (rid=%d.%d). rc=%d:%s",
+                  rid_i.page_num, rid_i.slot_num, rc, strrc(rc));
+        break;
+      }
+      continue;
+    }
+    // 唯一索引中key相同就返回INDEX_DUPLICATED，索引字段没有变化时其实是这条记录自己的索引项
+    if (rc == RC::INDEX_DUPLICATED && same_rid && !index_key_changed(*index, record_i, record_d))
+    {
+      rc = RC::RECORD_DUPLICATE_KEY;
+    }
+    if (rc == RC::RECORD_DUPLICATE_KEY){
+      // 已经当前索引保持原样即可, 后面也不要去删除
+      rc = RC::SUCCESS;
+      // 索引字段没有变化时，INCLUDE字段的值可能变了，要重新插入索引项才能更新叶子中保存的值
+      if (index->index_meta().include_field_num() > 0 && same_rid)
+      {
+        if (!index_key_changed(*index, record_i, record_d))
+        {
+          rc = index->delete_entry(record_d, &rid_d);
+          if (rc == RC::SUCCESS)
+          {
+            rc = index->insert_entry(record_i, &rid_i);
+          }
+          if (rc != RC::SUCCESS)
+          {
+            LOG_ERROR("Failed to refresh include fields of index (rid=%d.%d). rc=%d:%s",
+                      rid_i.page_num, rid_i.slot_num, rc, strrc(rc));
+            break;
+          }
+        }
+      }
+      continue;
     }else if (rc != RC::SUCCESS)
     {
       LOG_ERROR("Failed to insert indexes of record (rid=%d.%d). rc=%d:%s",
@@ -1238,6 +2043,11 @@ RC Table::update_entry_of_indexes(const char *record_i, const RID &rid_i,
       }
     }
   }
+  if (rc == RC::SUCCESS)
+  {
+    log_index_change(false, record_d, rid_d);
+    log_index_change(true, record_i, rid_i);
+  }
   return rc;
 }
 RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
@@ -1245,12 +2055,21 @@ RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
   RC rc = RC::SUCCESS;
   for (Index *index : indexes_)
   {
+    if (!index->accepts(record))
+    {
+      continue;
+    }
     rc = index->insert_entry(record, &rid);
     if (rc != RC::SUCCESS)
     {
       break;
     }
   }
+  // 插入失败时调用者会删除已经插入的索引项，不需要记日志
+  if (rc == RC::SUCCESS)
+  {
+    log_index_change(true, record, rid);
+  }
   return rc;
 }
 
@@ -1259,6 +2078,11 @@ RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error
   RC rc = RC::SUCCESS;
   for (Index *index : indexes_)
   {
+    // 不满足部分索引条件的记录不在索引中
+    if (!index->accepts(record))
+    {
+      continue;
+    }
     rc = index->delete_entry(record, &rid);
     if (rc != RC::SUCCESS)
     {
@@ -1268,19 +2092,17 @@ RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error
       }
     }
   }
+  // 删除在回放时是幂等的，无论成功与否都记下来
+  log_index_change(false, record, rid);
   return rc;
 }
 void Table::find_index_for_update(std::vector<Index *> &index_cover,const char *attr_name) const{
   for (Index *index : indexes_)
   {
-    auto fields = index->index_meta().fields();
-    for(const auto &field : fields){
-      int tmp =strcmp(field.c_str(), attr_name);  
-      if (0 == tmp)
-      {
-        index_cover.push_back(index);
-        break;
-      }
+    // INCLUDE字段的值也保存在索引中，更新时同样需要维护
+    if (index->covers_field(attr_name))
+    {
+      index_cover.push_back(index);
     }
   }
 }
@@ -1297,16 +2119,19 @@ Index *Table::find_index(const char *index_name) const
   }
   return nullptr;
 }
-IndexScanner *Table::find_multi_index_for_scan(const CompositeConditionFilter &filters)
+IndexScanner *Table::find_multi_index_for_scan(const CompositeConditionFilter &filters, double &selectivity)
 {
   int filter_num = filters.filter_num();
-  // std::vector<const ConDesc *> field_cond_descs;
   const char *field_names[filter_num];
   std::vector<CompOp> comp_ops;
   std::vector<const char *> values;
   std::vector<const ConDesc *> field_cond_descs;   // for encounter the single index case with null
   for(int i = 0; i < filter_num; i++){
     const DefaultConditionFilter *default_condition_filter = dynamic_cast<const DefaultConditionFilter *>(&filters.filter(i));
+    if (default_condition_filter == nullptr)
+    {
+      return nullptr;
+    }
     const ConDesc *field_cond_desc = nullptr;
     const ConDesc *value_cond_desc = nullptr;
     if (default_condition_filter->left().is_attr && !default_condition_filter->right().is_attr)
@@ -1331,7 +2156,7 @@ IndexScanner *Table::find_multi_index_for_scan(const CompositeConditionFilter &f
       return nullptr;
     }
     field_names[i] = field_meta->name();
-    comp_ops.push_back(default_condition_filter->comp_op());
+    comp_ops.push_back(comp_op_for_field(default_condition_filter->comp_op(), field_cond_desc == &default_condition_filter->left()));
     values.push_back((char *)value_cond_desc->value);
     field_cond_descs.push_back(field_cond_desc);
   }
@@ -1348,15 +2173,35 @@ IndexScanner *Table::find_multi_index_for_scan(const CompositeConditionFilter &f
   {
     return nullptr;
   }
+
+  // scanner要求条件按照索引字段的顺序排列，where中的条件顺序是任意的
+  std::vector<CompOp> index_comp_ops;
+  std::vector<const char *> index_values;
+  int first_cond = -1;
+  // 假设各个字段上的条件相互独立，选择率相乘
+  selectivity = 1;
+  for (int i = 0; i < match_num; i++) {
+    for (int j = 0; j < filter_num; j++) {
+      if (0 == strcmp(index_meta->field(i), field_names[j])) {
+        index_comp_ops.push_back(comp_ops[j]);
+        index_values.push_back(values[j]);
+        if (i == 0) {
+          first_cond = j;
+        }
+        double field_selectivity = table_meta_.stats().selectivity(field_names[j], comp_ops[j], values[j]);
+        selectivity = (selectivity < 0 || field_selectivity < 0) ? -1 : selectivity * field_selectivity;
+        break;
+      }
+    }
+  }
+
   if (index->Get_Field_Num() == 1){
-    //  (filter.comp_op(), (const char *)value_cond_desc->value, field_cond_desc->null_field_index)
-    return index->create_single_index_scanner(comp_ops[0], values[0], field_cond_descs[0]->null_field_index);
+    return index->create_single_index_scanner(index_comp_ops[0], index_values[0], field_cond_descs[first_cond]->null_field_index);
   }
-                        // (const std::vector<CompOp> &comp_ops, const std::vector<const char *> &values)
-  return index->create_multi_index_scanner(comp_ops, values, match_num);
+  return index->create_multi_index_scanner(index_comp_ops, index_values, match_num);
 }
 
-IndexScanner *Table::find_single_index_for_scan(const DefaultConditionFilter &filter)
+IndexScanner *Table::find_single_index_for_scan(const DefaultConditionFilter &filter, double &selectivity)
 {
   const ConDesc *field_cond_desc = nullptr;
   const ConDesc *value_cond_desc = nullptr;
@@ -1395,21 +2240,166 @@ IndexScanner *Table::find_single_index_for_scan(const DefaultConditionFilter &fi
     return nullptr;
   }
 
-  return index->create_single_index_scanner(filter.comp_op(), (const char *)value_cond_desc->value, field_cond_desc->null_field_index);
+  CompOp comp_op = comp_op_for_field(filter.comp_op(), field_cond_desc == &filter.left());
+  selectivity = table_meta_.stats().selectivity(field_meta->name(), comp_op, (const char *)value_cond_desc->value);
+  return index->create_single_index_scanner(comp_op, (const char *)value_cond_desc->value, field_cond_desc->null_field_index);
+}
+
+/**
+ * 查询中作用在同一字段上的条件 字段 comp_op value 能否保证部分索引的条件成立：
+ * 比较符和常量完全相同；或者查询是等值条件、或与索引条件同方向的范围条件，并且常量本身满足索引条件；
+ * 字段上的任何比较都会排除NULL，因此蕴含IS NOT NULL
+ */
+bool Table::implies_index_predicate(const Index &index, const ConditionFilter *filter)
+{
+  std::vector<const DefaultConditionFilter *> default_filters;
+  collect_default_filters(filter, default_filters);
+  const int record_size = table_meta_.record_size() + table_meta_.field_num() - table_meta_.sys_field_num();
+  char *record = (char *)malloc(record_size);
+  bool implied = true;
+  for (const IndexPredicate &predicate : index.index_meta().predicates())
+  {
+    const FieldMeta *field_meta = table_meta_.field(predicate.field.c_str());
+    implied = false;
+    for (const DefaultConditionFilter *default_filter : default_filters)
+    {
+      if (nullptr == default_filter)
+      {
+        continue;
+      }
+      const ConDesc &left = default_filter->left();
+      const ConDesc &right = default_filter->right();
+      const bool field_on_left = left.is_attr && !right.is_attr && left.attr_offset == field_meta->offset();
+      const bool field_on_right = right.is_attr && !left.is_attr && right.attr_offset == field_meta->offset();
+      if (!field_on_left && !field_on_right)
+      {
+        continue;
+      }
+      CompOp comp_op = comp_op_for_field(default_filter->comp_op(), field_on_left);
+      const char *value = (const char *)(field_on_left ? right.value : left.value);
+      if (predicate.comp_op == IS_NOT_NULL && comp_op <= GREAT_THAN)
+      {
+        implied = true;
+        break;
+      }
+      if (comp_op == predicate.comp_op)
+      {
+        if (comp_op == IS_NULL || comp_op == IS_NOT_NULL ||
+            (field_meta->type() == CHARS ? 0 == strncmp(value, predicate.value.c_str(), field_meta->len())
+                                         : 0 == memcmp(value, predicate.value.data(), field_meta->len())))
+        {
+          implied = true;
+          break;
+        }
+      }
+      const bool lower_bound = (comp_op == GREAT_THAN || comp_op == GREAT_EQUAL) &&
+                               (predicate.comp_op == GREAT_THAN || predicate.comp_op == GREAT_EQUAL);
+      const bool upper_bound = (comp_op == LESS_THAN || comp_op == LESS_EQUAL) &&
+                               (predicate.comp_op == LESS_THAN || predicate.comp_op == LESS_EQUAL);
+      if (!(comp_op == EQUAL_TO && predicate.comp_op <= GREAT_THAN) && !lower_bound && !upper_bound)
+      {
+        continue;
+      }
+      // 把查询中的常量放到一条临时记录里，用索引条件检查一遍
+      memset(record, 0, record_size);
+      if (field_meta->type() == CHARS)
+      {
+        strncpy(record + field_meta->offset(), value, field_meta->len());
+      }
+      else
+      {
+        memcpy(record + field_meta->offset(), value, field_meta->len());
+      }
+      Condition condition;
+      make_predicate_condition(predicate, condition);
+      DefaultConditionFilter predicate_filter;
+      Record rec;
+      rec.data = record;
+      if (predicate_filter.init(*this, condition) == RC::SUCCESS && predicate_filter.filter(rec))
+      {
+        implied = true;
+        break;
+      }
+    }
+    if (!implied)
+    {
+      break;
+    }
+  }
+  free(record);
+  return implied;
+}
+
+IndexScanner *Table::find_partial_index_for_scan(const ConditionFilter *filter, double &selectivity)
+{
+  std::vector<const DefaultConditionFilter *> default_filters;
+  collect_default_filters(filter, default_filters);
+  for (Index *index : indexes_)
+  {
+    if (!index->index_meta().is_partial() || !implies_index_predicate(*index, filter))
+    {
+      continue;
+    }
+
+    const FieldMeta &first_field = index->fields_meta()[0];
+    IndexScanner *index_scanner = nullptr;
+    for (const DefaultConditionFilter *default_filter : default_filters)
+    {
+      if (nullptr == default_filter)
+      {
+        continue;
+      }
+      const ConDesc &left = default_filter->left();
+      const ConDesc &right = default_filter->right();
+      const bool field_on_left = left.is_attr && !right.is_attr && left.attr_offset == first_field.offset();
+      const bool field_on_right = right.is_attr && !left.is_attr && right.attr_offset == first_field.offset();
+      CompOp comp_op = comp_op_for_field(default_filter->comp_op(), field_on_left);
+      if ((field_on_left || field_on_right) && comp_op != NOT_EQUAL && comp_op <= GREAT_THAN)
+      {
+        const ConDesc &field_cond_desc = field_on_left ? left : right;
+        const char *value = (const char *)(field_on_left ? right.value : left.value);
+        selectivity = table_meta_.stats().selectivity(first_field.name(), comp_op, value);
+        index_scanner = index->create_single_index_scanner(comp_op, value, field_cond_desc.null_field_index);
+        break;
+      }
+    }
+    // 查询条件用不上索引字段时扫描整个部分索引，它只包含满足条件的那一部分记录
+    if (nullptr == index_scanner)
+    {
+      selectivity = -1;
+      index_scanner = index->create_ordered_scanner(NO_OP, nullptr, false);
+    }
+    if (index_scanner != nullptr)
+    {
+      LOG_INFO("查询条件蕴含部分索引%s的条件", index->index_meta().name());
+      return index_scanner;
+    }
+  }
+  return nullptr;
 }
 
-IndexScanner *Table::find_index_for_scan(const ConditionFilter *filter)
+IndexScanner *Table::find_index_for_scan(const ConditionFilter *filter, double &selectivity)
 {
+  selectivity = -1;
   if (nullptr == filter)
   {
     return nullptr;
   }
-  IndexScanner * index_scanner=nullptr;
+  IndexScanner * index_scanner = find_partial_index_for_scan(filter, selectivity);
+  if (index_scanner != nullptr)
+  {
+    return index_scanner;
+  }
+  index_scanner = find_bitmap_index_for_scan(filter, selectivity);
+  if (index_scanner != nullptr)
+  {
+    return index_scanner;
+  }
   // remove dynamic_cast
   const DefaultConditionFilter *default_condition_filter = dynamic_cast<const DefaultConditionFilter *>(filter);
   if (default_condition_filter != nullptr)
   {
-    index_scanner =  find_single_index_for_scan(*default_condition_filter);
+    index_scanner =  find_single_index_for_scan(*default_condition_filter, selectivity);
   }
   if (index_scanner != nullptr){
     return index_scanner;
@@ -1418,11 +2408,300 @@ IndexScanner *Table::find_index_for_scan(const ConditionFilter *filter)
   
   if (composite_condition_filter != nullptr)
   {
-    index_scanner =  find_multi_index_for_scan(*composite_condition_filter);
+    index_scanner = find_index_intersection_for_scan(*composite_condition_filter, selectivity);
+    if (index_scanner == nullptr)
+    {
+      index_scanner = find_multi_index_for_scan(*composite_condition_filter, selectivity);
+    }
   }
   return index_scanner;
 }
 
+IndexScanner *Table::find_index_intersection_for_scan(const CompositeConditionFilter &filter, double &selectivity)
+{
+  std::vector<const char *> field_names;
+  std::vector<Index *> indexes;
+  std::vector<const char *> values;
+  std::vector<int> null_field_indexes;
+  for (int i = 0; i < filter.filter_num(); i++)
+  {
+    const DefaultConditionFilter *default_filter = dynamic_cast<const DefaultConditionFilter *>(&filter.filter(i));
+    if (default_filter == nullptr || default_filter->comp_op() != EQUAL_TO)
+    {
+      continue;
+    }
+    bool field_on_left = default_filter->left().is_attr && !default_filter->right().is_attr;
+    bool field_on_right = default_filter->right().is_attr && !default_filter->left().is_attr;
+    if (!field_on_left && !field_on_right)
+    {
+      continue;
+    }
+    const ConDesc *field_cond_desc = field_on_left ? &default_filter->left() : &default_filter->right();
+    const ConDesc *value_cond_desc = field_on_left ? &default_filter->right() : &default_filter->left();
+    const FieldMeta *field_meta = table_meta_.find_field_by_offset(field_cond_desc->attr_offset);
+    if (nullptr == field_meta)
+    {
+      continue;
+    }
+    bool seen = false;
+    for (const char *field_name : field_names)
+    {
+      seen = seen || 0 == strcmp(field_name, field_meta->name());
+    }
+    if (seen)
+    {
+      continue;
+    }
+
+    // 只用单字段、不带INCLUDE的索引，这样每个索引只覆盖一个字段，求交集后一定要回表
+    Index *field_index = nullptr;
+    for (Index *index : indexes_)
+    {
+      const IndexMeta &index_meta = index->index_meta();
+      if (index_meta.field_num() == 1 && index_meta.include_field_num() == 0 && !index_meta.is_bitmap() && !index_meta.is_partial() &&
+          0 == strcmp(index_meta.field(0), field_meta->name()))
+      {
+        field_index = index;
+        break;
+      }
+    }
+    if (nullptr == field_index)
+    {
+      continue;
+    }
+    field_names.push_back(field_meta->name());
+    indexes.push_back(field_index);
+    values.push_back((const char *)value_cond_desc->value);
+    null_field_indexes.push_back(field_cond_desc->null_field_index);
+  }
+
+  if (indexes.size() < 2)
+  {
+    return nullptr;
+  }
+  // 有联合索引能同时用上其中两个以上的条件时，一次索引扫描就够了
+  int match_num = 0;
+  if (table_meta_.find_multi_index_by_fields(field_names.data(), field_names.size(), match_num) != nullptr && match_num >= 2)
+  {
+    return nullptr;
+  }
+
+  std::vector<RID> result;
+  for (size_t i = 0; i < indexes.size(); i++)
+  {
+    IndexScanner *scanner = indexes[i]->create_single_index_scanner(EQUAL_TO, values[i], null_field_indexes[i]);
+    if (nullptr == scanner)
+    {
+      return nullptr;
+    }
+    std::vector<RID> rids;
+    RID rid;
+    RC rc = RC::SUCCESS;
+    while ((rc = scanner->next_entry(&rid)) == RC::SUCCESS)
+    {
+      rids.push_back(rid);
+    }
+    scanner->destroy();
+    if (rc != RC::RECORD_EOF && rc != RC::RECORD_NO_MORE_IDX_IN_MEM)
+    {
+      LOG_WARN("Failed to scan index %s for intersection. rc=%d:%s", indexes[i]->index_meta().name(), rc, strrc(rc));
+      return nullptr;
+    }
+
+    // 排好序的RID集合做归并求交，结果保持页号、槽号的顺序，回表时顺序读取数据页面
+    std::sort(rids.begin(), rids.end(), rid_less);
+    rids.erase(std::unique(rids.begin(), rids.end()), rids.end());
+    if (i == 0)
+    {
+      result.swap(rids);
+    }
+    else
+    {
+      std::vector<RID> intersection;
+      std::set_intersection(result.begin(), result.end(), rids.begin(), rids.end(), std::back_inserter(intersection), rid_less);
+      result.swap(intersection);
+    }
+    if (result.empty())
+    {
+      break;
+    }
+  }
+
+  const TableStats &stats = table_meta_.stats();
+  selectivity = stats.analyzed() && stats.row_num() > 0 ? (double)result.size() / stats.row_num() : -1;
+  LOG_INFO("%d个索引的RID集合求交得到%d行. table=%s", (int)indexes.size(), (int)result.size(), name());
+  return new RidSetScanner(*indexes[0], result);
+}
+
+IndexScanner *Table::find_bitmap_index_for_scan(const ConditionFilter *filter, double &selectivity)
+{
+  std::vector<const DefaultConditionFilter *> default_filters;
+  collect_default_filters(filter, default_filters);
+
+  BitmapIndex *first_index = nullptr;
+  RoaringBitmap rows;
+  int match_num = 0;
+  for (const DefaultConditionFilter *default_filter : default_filters)
+  {
+    if (default_filter == nullptr)
+    {
+      continue;
+    }
+    bool field_on_left = default_filter->left().is_attr && !default_filter->right().is_attr;
+    bool field_on_right = default_filter->right().is_attr && !default_filter->left().is_attr;
+    if (!field_on_left && !field_on_right)
+    {
+      continue;
+    }
+    const ConDesc *field_cond_desc = field_on_left ? &default_filter->left() : &default_filter->right();
+    const ConDesc *value_cond_desc = field_on_left ? &default_filter->right() : &default_filter->left();
+    const FieldMeta *field_meta = table_meta_.find_field_by_offset(field_cond_desc->attr_offset);
+    if (nullptr == field_meta)
+    {
+      continue;
+    }
+
+    BitmapIndex *bitmap_index = nullptr;
+    for (Index *index : indexes_)
+    {
+      if (index->index_meta().is_bitmap() && !index->index_meta().is_partial() &&
+          0 == strcmp(index->index_meta().field(0), field_meta->name()))
+      {
+        bitmap_index = static_cast<BitmapIndex *>(index);
+        break;
+      }
+    }
+    if (nullptr == bitmap_index)
+    {
+      continue;
+    }
+
+    RoaringBitmap field_rows;
+    CompOp comp_op = comp_op_for_field(default_filter->comp_op(), field_on_left);
+    if (bitmap_index->find_rows(comp_op, (const char *)value_cond_desc->value, field_rows) != RC::SUCCESS)
+    {
+      continue;
+    }
+    if (match_num == 0)
+    {
+      rows.swap(field_rows);
+      first_index = bitmap_index;
+    }
+    else
+    {
+      rows.and_with(field_rows);
+    }
+    match_num++;
+  }
+
+  // 只有一个条件时和普通索引一样由find_single_index_for_scan/find_multi_index_for_scan处理
+  if (match_num < 2)
+  {
+    return nullptr;
+  }
+  // 位图的基数就是满足条件的准确行数
+  selectivity = first_index->row_num() == 0 ? 0 : (double)rows.cardinality() / first_index->row_num();
+  LOG_INFO("位图索引求交得到%lu行. table=%s, condition num=%d", (unsigned long)rows.cardinality(), name(), match_num);
+  return first_index->create_scanner(rows);
+}
+
+RC Table::scan_record_by_key(Trx *trx, ConditionFilter *filter, const char *field_name, const char *value,
+                             void *context, void (*record_reader)(const char *data, void *context),
+                             const char *field_names[], int field_num)
+{
+  const IndexMeta *index_meta = table_meta_.find_single_index_by_field(field_name);
+  Index *index = nullptr == index_meta ? nullptr : find_index(index_meta->name());
+  if (nullptr == index)
+  {
+    LOG_ERROR("No index on field. table=%s, field=%s", name(), field_name);
+    return RC::SCHEMA_INDEX_NOT_EXIST;
+  }
+
+  const int field_index = table_meta_.find_field_index_by_name(field_name);
+  const FieldMeta *last_field = table_meta_.field(table_meta_.field_num() - 1);
+  const int null_field_index = last_field->offset() + last_field->len() + field_index - 1;
+  IndexScanner *index_scanner = index->create_single_index_scanner(EQUAL_TO, value, null_field_index);
+  if (nullptr == index_scanner)
+  {
+    LOG_ERROR("Failed to create index scanner. table=%s, index=%s", name(), index_meta->name());
+    return RC::GENERIC_ERROR;
+  }
+
+  // 索引中也有字段为NULL的记录，它们保存的值可能恰好等于value，要和普通的索引扫描一样再检查 字段 = value
+  const FieldMeta *field_meta = table_meta_.field(field_index);
+  ConDesc key_desc = {true, null_field_index, field_meta->len(), field_meta->offset(), nullptr};
+  ConDesc value_desc = {false, 0, 0, 0, (void *)value};
+  DefaultConditionFilter key_filter;
+  key_filter.init(key_desc, value_desc, field_meta->type(), EQUAL_TO, field_meta->type());
+  const ConditionFilter *filters[2] = {&key_filter, filter};
+  CompositeConditionFilter key_and_filter;
+  key_and_filter.init(filters, nullptr == filter ? 1 : 2);
+
+  RecordReaderScanAdapter adapter(record_reader, context);
+  bool index_only = can_scan_index_only(*index, &key_and_filter, field_names, field_num);
+  return scan_record_by_index(trx, index_scanner, &key_and_filter, INT_MAX, (void *)&adapter, scan_record_reader_adapter, index_only);
+}
+
+// 每次查找从根读到叶子，再按每个键平均的行数回表；没有统计信息时按三层、每个键一行估算
+bool Table::is_key_lookup_cheaper(const char *field_name, int key_num) const
+{
+  const IndexMeta *index_meta = table_meta_.find_single_index_by_field(field_name);
+  if (nullptr == index_meta)
+  {
+    return false;
+  }
+  int page_count = 0;
+  if (data_buffer_pool_->get_page_count(file_id_, &page_count) != RC::SUCCESS)
+  {
+    return false;
+  }
+
+  double height = 3;
+  double rows_per_key = 1;
+  const TableStats &stats = table_meta_.stats();
+  if (stats.analyzed())
+  {
+    const IndexStats *index_stats = stats.index(index_meta->name());
+    if (index_stats != nullptr)
+    {
+      height = index_stats->height;
+    }
+    const ColumnStats *column_stats = stats.column(field_name);
+    if (column_stats != nullptr && column_stats->ndv > 0)
+    {
+      rows_per_key = (double)(stats.row_num() - column_stats->null_num) / column_stats->ndv;
+    }
+  }
+  return key_num * (height + rows_per_key) < page_count;
+}
+
+// 代价以读取的页面数计：索引扫描从根查找到叶子，扫描一部分叶子，每一行再回表读一个数据页面；
+// 全表扫描读取所有数据页面。没有统计信息时保持原来的做法，有可用的索引就使用
+bool Table::is_index_scan_cheaper(const Index &index, double selectivity) const
+{
+  const TableStats &stats = table_meta_.stats();
+  if (!stats.analyzed() || selectivity < 0)
+  {
+    return true;
+  }
+  int page_count = 0;
+  if (data_buffer_pool_->get_page_count(file_id_, &page_count) != RC::SUCCESS)
+  {
+    return true;
+  }
+
+  int height = 1;
+  int leaf_num = 1;
+  const IndexStats *index_stats = stats.index(index.index_meta().name());
+  if (index_stats != nullptr)
+  {
+    height = index_stats->height;
+    leaf_num = index_stats->leaf_num;
+  }
+  double index_cost = height + selectivity * leaf_num + selectivity * stats.row_num();
+  return index_cost <= page_count;
+}
+
 RC Table::sync()
 {
   RC rc = data_buffer_pool_->flush_all_pages(file_id_);
@@ -1445,3 +2724,137 @@ RC Table::sync()
   LOG_INFO("Sync table over. table=%s", name());
   return rc;
 }
+
+TableScanner::~TableScanner()
+{
+  close();
+}
+
+RC TableScanner::open(Table *table, Trx *trx, ConditionFilter *filter, const char *field_names[], int field_num)
+{
+  return open(table, trx, filter, filter, field_names, field_num);
+}
+
+RC TableScanner::open(Table *table, Trx *trx, ConditionFilter *filter, ConditionFilter *record_filter,
+                      const char *field_names[], int field_num)
+{
+  close();
+  table_ = table;
+  trx_ = trx;
+  filter_ = filter;
+  index_scanner_ = table->choose_index_scanner(filter, field_names, field_num);
+  if (index_scanner_ != nullptr)
+  {
+    if (table->can_scan_index_only(*index_scanner_, filter, field_names, field_num))
+    {
+      const TableMeta &table_meta = table->table_meta();
+      int index_record_size = table_meta.record_size() + table_meta.field_num();
+      index_record_ = (char *)malloc(index_record_size);
+      if (nullptr == index_record_)
+      {
+        close();
+        return RC::NOMEM;
+      }
+      memset(index_record_, 0, index_record_size);
+    }
+    return RC::SUCCESS;
+  }
+
+  record_scanner_ = new RecordFileScanner();
+  current_ = new Record();
+  RC rc = record_scanner_->open_scan(*table->data_buffer_pool_, table->file_id_, record_filter);
+  if (rc != RC::SUCCESS)
+  {
+    LOG_ERROR("failed to open scanner. file id=%d. rc=%d:%s", table->file_id_, rc, strrc(rc));
+    close();
+  }
+  return rc;
+}
+
+RC TableScanner::next(Record &record)
+{
+  RC rc = RC::SUCCESS;
+  if (index_scanner_ != nullptr)
+  {
+    RID rid;
+    while (true)
+    {
+      rc = index_record_ != nullptr ? index_scanner_->next_entry(&rid, index_record_) : index_scanner_->next_entry(&rid);
+      if (RC::RECORD_NO_MORE_IDX_IN_MEM == rc)
+      {
+        return RC::RECORD_EOF;
+      }
+      if (rc != RC::SUCCESS)
+      {
+        return rc;
+      }
+      if (index_record_ != nullptr)
+      {
+        record.rid = rid;
+        record.data = index_record_;
+      }
+      else
+      {
+        rc = table_->record_handler_->get_record(&rid, &record);
+        if (rc != RC::SUCCESS)
+        {
+          LOG_ERROR("Failed to fetch record of rid=%d:%d, rc=%d:%s", rid.page_num, rid.slot_num, rc, strrc(rc));
+          return rc;
+        }
+      }
+      if ((trx_ == nullptr || trx_->is_visible(table_, &record)) && (filter_ == nullptr || filter_->filter(record)))
+      {
+        return RC::SUCCESS;
+      }
+    }
+  }
+
+  if (nullptr == record_scanner_)
+  {
+    return RC::RECORD_EOF;
+  }
+  // 和scan_record的全表扫描一样，带TEXT字段的记录拿到的RID是第二页的
+  bool has_text = false;
+  rc = started_ ? record_scanner_->get_next_record(current_, has_text) : record_scanner_->get_first_record(current_, has_text);
+  started_ = true;
+  for (; RC::SUCCESS == rc; rc = record_scanner_->get_next_record(current_, has_text))
+  {
+    record = *current_;
+    if (has_text)
+    {
+      record.rid.page_num--;
+    }
+    if (trx_ == nullptr || trx_->is_visible(table_, &record))
+    {
+      return RC::SUCCESS;
+    }
+  }
+  if (rc != RC::RECORD_EOF)
+  {
+    LOG_ERROR("failed to scan record. file id=%d, rc=%d:%s", table_->file_id_, rc, strrc(rc));
+  }
+  return rc;
+}
+
+void TableScanner::close()
+{
+  if (index_scanner_ != nullptr)
+  {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+  if (index_record_ != nullptr)
+  {
+    free(index_record_);
+    index_record_ = nullptr;
+  }
+  if (record_scanner_ != nullptr)
+  {
+    record_scanner_->close_scan();
+    delete record_scanner_;
+    record_scanner_ = nullptr;
+  }
+  delete current_;
+  current_ = nullptr;
+  started_ = false;
+}
@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/condition_filter.h"
 
 #include <cstring>
+#include <mutex>
 
 class DiskBufferPool;
 class RecordFileHandler;
@@ -31,10 +32,14 @@ class Index;
 class IndexScanner;
 class RecordDeleter;
 class Trx;
+class RecordFileScanner;
+struct IndexBuildLogEntry;
+struct IndexBuildState;
 
 class Table
 {
   friend class DefaultStorageStage;
+  friend class TableScanner;
 
 public:
   Table();
@@ -78,14 +83,60 @@ public:
 
   RC delete_record(Trx *trx, ConditionFilter *filter, int *deleted_count);
 
-  RC scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, void (*record_reader)(const char *data, void *context));
+  /**
+   * @brief 扫描满足filter的记录
+   *
+   * @param field_names 调用方会读取的字段，field_num小于0表示不确定。
+   * 如果这些字段和filter用到的字段都保存在某个索引中，就只扫描索引，不再读取记录文件
+   */
+  RC scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, void (*record_reader)(const char *data, void *context),
+                 const char *field_names[] = nullptr, int field_num = -1);
+
+  /**
+   * @brief 沿着索引index_name的顺序扫描记录，输出结果已经按照索引字段有序
+   *
+   * @param is_desc 为true时逆序扫描索引
+   * @param limit 最多输出的记录数，小于0表示不限制
+   */
+  RC scan_record_in_index_order(Trx *trx, ConditionFilter *filter, const char *index_name, bool is_desc, int limit,
+                                void *context, void (*record_reader)(const char *data, void *context),
+                                const char *field_names[] = nullptr, int field_num = -1);
+
+  /**
+   * @brief 索引嵌套循环连接中对内表的一次查找：用第一个字段为field_name的索引找出字段值等于value的记录
+   *
+   * @param value 字段在记录中的格式
+   * @param filter 内表自己的过滤条件
+   */
+  RC scan_record_by_key(Trx *trx, ConditionFilter *filter, const char *field_name, const char *value,
+                        void *context, void (*record_reader)(const char *data, void *context),
+                        const char *field_names[] = nullptr, int field_num = -1);
+
+  /**
+   * @brief 估算在field_name的索引上做key_num次等值查找是否比扫描全表读取的页面少。没有可用的索引时返回false
+   */
+  bool is_key_lookup_cheaper(const char *field_name, int key_num) const;
 
-  RC create_index(Trx *trx, const char *index_name, const int& attr_num, const char *attribute_name[],int is_unique);
+  RC create_index(Trx *trx, const char *index_name, const int& attr_num, const char *attribute_name[],int is_unique,
+                  int include_num = 0, const char *include_attribute_name[] = nullptr, IndexType index_type = INDEX_TYPE_BTREE,
+                  int condition_num = 0, const Condition *conditions = nullptr);
 
   RC create_index(Trx *trx, const char *index_name,const char *attribute_name,int is_unique);
 
   std::vector<const char *> get_index_names();
 
+  /**
+   * @brief 在线建索引每扫描一条记录、每次在锁外回放旁路日志之后调用hook，调用时没有持有表的锁。
+   * 用于在建索引的过程中穿插其它写入，检查扫描位置和旁路日志的配合
+   */
+  void set_index_build_hook(void (*hook)(void *context), void *context);
+
+  /**
+   * @brief 收集表中各个字段和索引的统计信息，保存到表的元数据中。
+   * 之后的查询根据统计信息估算条件的选择率，在索引扫描和全表扫描之间选择代价小的一个
+   */
+  RC analyze(Trx *trx);
+
 public:
   const char *name() const;
 
@@ -100,12 +151,30 @@ public:
   RC rollback_insert(Trx *trx, const RID &rid);
   RC rollback_delete(Trx *trx, const RID &rid);
 
+  // 由事务维护的未提交操作数。存在未提交的操作时，索引项可能对当前事务不可见，不能只扫描索引
+  void add_uncommitted_operation_num(int num);
+
 private:
-  RC scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context));
-  RC scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context));
-  IndexScanner *find_index_for_scan(const ConditionFilter *filter);
-  IndexScanner *find_single_index_for_scan(const DefaultConditionFilter &filter);
-  IndexScanner *find_multi_index_for_scan(const CompositeConditionFilter &filter);
+  RC scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context),
+                 const char *field_names[] = nullptr, int field_num = -1);
+  RC scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context),
+                          bool index_only = false);
+  bool can_scan_index_only(const Index &index, const ConditionFilter *filter, const char *field_names[], int field_num) const;
+  // 另外要求扫描器能取出字段值，RID集合求交得到的扫描器只能回表
+  bool can_scan_index_only(const IndexScanner &scanner, const ConditionFilter *filter, const char *field_names[], int field_num) const;
+  IndexScanner *find_covering_index_for_scan(const ConditionFilter *filter, const char *field_names[], int field_num);
+  // selectivity返回根据统计信息估算的索引条件的选择率，无法估算时为负数
+  IndexScanner *find_index_for_scan(const ConditionFilter *filter, double &selectivity);
+  IndexScanner *find_single_index_for_scan(const DefaultConditionFilter &filter, double &selectivity);
+  IndexScanner *find_multi_index_for_scan(const CompositeConditionFilter &filter, double &selectivity);
+  // 至少两个条件用得上位图索引时，按位与得到满足所有这些条件的行，否则返回nullptr
+  IndexScanner *find_bitmap_index_for_scan(const ConditionFilter *filter, double &selectivity);
+  // 多个字段上的等值条件分别有单字段索引、且没有联合索引可用时，扫描各个索引并对RID集合求交集
+  IndexScanner *find_index_intersection_for_scan(const CompositeConditionFilter &filter, double &selectivity);
+  // 查询条件蕴含部分索引的条件时才能使用部分索引，用得上的条件作用在索引的第一个字段上，否则扫描整个部分索引
+  IndexScanner *find_partial_index_for_scan(const ConditionFilter *filter, double &selectivity);
+  bool implies_index_predicate(const Index &index, const ConditionFilter *filter);
+  bool is_index_scan_cheaper(const Index &index, double selectivity) const;
   // IndexScanner *find_index_multi_for_scan(std::vector<DefaultConditionFilter> &filters);
   // default return the longest index(multi-index) if not multi-index then return single index
   const IndexMeta *find_multi_index_by_Deaultfields(std::vector<const ConDesc *> &field_cond_descs);
@@ -118,15 +187,38 @@ private:
 private:
   friend class RecordUpdater;
   friend class RecordDeleter;
+  // 维护索引的调用者持有index_build_mutex_，并且在同一次持有锁时修改记录文件
   RC update_entry_of_indexes(const char *record_i, const RID &rid_i,const char *record_d, const RID &rid_d, bool error_on_not_exists);
   RC insert_entry_of_indexes(const char *record, const RID &rid);
   RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
+  /**
+   * 读取记录并复制一份。get_record返回的data指向buffer pool中已经解除固定的页面，
+   * 维护索引时会读取其它页面，可能把这个页面换出
+   */
+  RC get_record_copy(const RID &rid, Record &record, std::string &data);
 
 private:
   RC init_record_handler(const char *base_dir);
+  RC open_hash_index(const char *base_dir, const IndexMeta &index_meta, Index *&index);
+  RC open_bitmap_index(const char *base_dir, const IndexMeta &index_meta, Index *&index);
   RC make_record(int value_num, const Value *values, char *&record_out);
+  RC write_meta_file(const TableMeta &table_meta);
+  // 根据索引元数据中的条件为部分索引创建过滤器
+  RC init_index_predicate(Index *index);
+  /**
+   * 在线建索引：扫描全表时不阻塞写入，扫描已经经过的记录上的写入记在旁路日志中，
+   * 扫描结束后回放日志，最后在锁内回放剩余的日志并把索引加入元数据
+   */
+  RC build_index_online(Index *index, const IndexMeta &index_meta);
+  // 逐条在锁内读取记录插入索引，同时推进扫描位置，和写入者对同一条记录的修改互斥
+  RC scan_for_index_build(Index *index);
+  RC apply_index_build_log(Index *index, const std::vector<IndexBuildLogEntry> &build_log);
+  // 写入索引项成功后调用，有索引正在创建时把变更记入旁路日志。调用者持有index_build_mutex_
+  void log_index_change(bool is_insert, const char *record, const RID &rid);
 
 private:
+  // scan_record和TableScanner共用的索引选择：按代价选择过滤条件能用的索引，否则尝试覆盖索引。返回nullptr表示扫描全表
+  IndexScanner *choose_index_scanner(ConditionFilter *filter, const char *field_names[], int field_num);
   void find_index_for_update(std::vector<Index *> &index_cover, const char *attr_name) const;
   Index *find_index(const char *index_name) const;
   RC is_legal(const Value &value, const FieldMeta *field);
@@ -138,6 +230,58 @@ private:
   int file_id_;
   RecordFileHandler *record_handler_; /// 记录操作
   std::vector<Index *> indexes_;
+  int uncommitted_operation_num_ = 0;
+  std::mutex index_build_mutex_;            /// 保护indexes_的发布、建索引的扫描位置和旁路日志
+  IndexBuildState *index_build_ = nullptr;  /// 不为空表示正在在线创建索引
+  void (*index_build_hook_)(void *context) = nullptr;
+  void *index_build_hook_context_ = nullptr;
+};
+
+/**
+ * 拉取式的记录扫描，选择索引的方式和scan_record相同。
+ * 调用方逐条取出满足条件并且对事务可见的记录，用于迭代器模型的执行节点，不需要一次读出整张表
+ */
+class TableScanner
+{
+public:
+  TableScanner() = default;
+  ~TableScanner();
+
+  RC open(Table *table, Trx *trx, ConditionFilter *filter, const char *field_names[] = nullptr, int field_num = -1);
+  /**
+   * 按filter选择索引，选中索引时用filter过滤；扫描全表时只用record_filter过滤，其余条件由调用方自己判断。
+   * 打开后用uses_index()区分这两种情况
+   */
+  RC open(Table *table, Trx *trx, ConditionFilter *filter, ConditionFilter *record_filter, const char *field_names[],
+          int field_num);
+  // 没有更多记录时返回RC::RECORD_EOF。record中的数据在下一次调用next或close之前有效
+  RC next(Record &record);
+  void close();
+
+  bool uses_index() const
+  {
+    return index_scanner_ != nullptr;
+  }
+  // 使用的索引扫描器，扫描全表时为nullptr
+  const IndexScanner *index_scanner() const
+  {
+    return index_scanner_;
+  }
+  // 是否只扫描索引，不读取记录
+  bool index_only() const
+  {
+    return index_record_ != nullptr;
+  }
+
+private:
+  Table *table_ = nullptr;
+  Trx *trx_ = nullptr;
+  ConditionFilter *filter_ = nullptr;
+  IndexScanner *index_scanner_ = nullptr;
+  char *index_record_ = nullptr;             // 覆盖索引扫描时拼出的临时记录
+  RecordFileScanner *record_scanner_ = nullptr;
+  Record *current_ = nullptr;                // 全表扫描的当前位置
+  bool started_ = false;
 };
 
 #endif // __OBSERVER_STORAGE_COMMON_TABLE_H__
\ No newline at end of file
@@ -22,12 +22,14 @@ See the Mulan PSL v2 for more details. */
 static const Json::StaticString FIELD_TABLE_NAME("table_name");
 static const Json::StaticString FIELD_FIELDS("fields");
 static const Json::StaticString FIELD_INDEXES("indexes");
+static const Json::StaticString FIELD_STATISTICS("statistics");
 
 std::vector<FieldMeta> TableMeta::sys_fields_;
 
 TableMeta::TableMeta(const TableMeta &other) : name_(other.name_),
                                                fields_(other.fields_),
                                                indexes_(other.indexes_),
+                                               stats_(other.stats_),
                                                record_size_(other.record_size_)
 {
 }
@@ -37,6 +39,7 @@ void TableMeta::swap(TableMeta &other) noexcept
   name_.swap(other.name_);
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
+  std::swap(stats_, other.stats_);
   std::swap(record_size_, other.record_size_);
 }
 
@@ -195,6 +198,11 @@ const IndexMeta *TableMeta::find_single_index_by_field(const char *field) const
 {
   for (const IndexMeta &index : indexes_)
   {
+    // 部分索引只有满足条件的记录，由Table单独判断查询条件能否用上
+    if (index.is_partial())
+    {
+      continue;
+    }
     if (0 == strcmp(index.field(0), field))
     {
       return &index;
@@ -202,12 +210,35 @@ const IndexMeta *TableMeta::find_single_index_by_field(const char *field) const
   }
   return nullptr;
 }
+// 查找前field_num个字段依次为field_names的index，用于按照索引顺序输出ORDER BY的结果
+const IndexMeta *TableMeta::find_index_by_prefix(const char *field_names[], int field_num) const
+{
+  for (const IndexMeta &index : indexes_)
+  {
+    // 哈希索引和位图索引中的数据没有顺序
+    if (index.is_hash() || index.is_bitmap() || index.is_partial() || index.field_num() < field_num)
+    {
+      continue;
+    }
+    int i = 0;
+    while (i < field_num && 0 == strcmp(index.field(i), field_names[i]))
+    {
+      i++;
+    }
+    if (i == field_num)
+    {
+      return &index;
+    }
+  }
+  return nullptr;
+}
+
 bool TableMeta::find_multi_index_by_fields_for_check(const char *field_names[], int field_num) const
 {
   // 严格按照num是否相等来匹配
   for (const IndexMeta &index : indexes_)
   { 
-    if(index.field_num()!=field_num){
+    if(index.field_num()!=field_num || index.is_partial()){
       continue;
     }
     for(int i = 0; i < field_num; i++){
@@ -238,6 +269,10 @@ const IndexMeta *TableMeta::find_multi_index_by_fields(const char *field_names[]
   }
   for (const IndexMeta &index : indexes_)
   { 
+    if (index.is_partial())
+    {
+      continue;
+    }
     int min_size;
     if(index.field_num()<=field_num){
       min_size = index.field_num();
@@ -303,6 +338,13 @@ int TableMeta::serialize(std::ostream &ss) const
   }
   table_value[FIELD_INDEXES] = std::move(indexes_value);
 
+  if (stats_.analyzed())
+  {
+    Json::Value stats_value;
+    stats_.to_json(stats_value);
+    table_value[FIELD_STATISTICS] = std::move(stats_value);
+  }
+
   Json::StreamWriterBuilder builder;
   Json::StreamWriter *writer = builder.newStreamWriter();
 
@@ -397,6 +439,19 @@ int TableMeta::deserialize(std::istream &is)
     indexes_.swap(indexes);
   }
 
+  const Json::Value &stats_value = table_value[FIELD_STATISTICS];
+  if (!stats_value.isNull())
+  {
+    TableStats stats;
+    rc = TableStats::from_json(fields_, stats_value, stats);
+    if (rc != RC::SUCCESS)
+    {
+      LOG_ERROR("Failed to deserialize table statistics. table name=%s", name_.c_str());
+      return -1;
+    }
+    stats_ = stats;
+  }
+
   return (int)(is.tellg() - old_pos);
 }
 
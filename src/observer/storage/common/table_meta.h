@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include "rc.h"
 #include "storage/common/field_meta.h"
 #include "storage/common/index_meta.h"
+#include "storage/common/table_stats.h"
 #include "common/lang/serializable.h"
 
 class TableMeta : public common::Serializable {
@@ -59,6 +60,7 @@ public:
   bool find_multi_index_by_fields_for_check(const char *field_names[], int field_num) const;
   const IndexMeta * find_multi_index_by_fields(const char *field_names[], int field_num, int &match_num) const;
   const IndexMeta * find_single_index_by_field(const char *field) const;
+  const IndexMeta * find_index_by_prefix(const char *field_names[], int field_num) const;
   const IndexMeta * index(int i) const;
   const std::vector<IndexMeta> get_indexes() const{
     return indexes_;
@@ -67,6 +69,16 @@ public:
 
   int record_size() const;
 
+  // ANALYZE收集的统计信息，没有执行过ANALYZE时analyzed()为false
+  const TableStats &stats() const
+  {
+    return stats_;
+  }
+  void set_stats(const TableStats &stats)
+  {
+    stats_ = stats;
+  }
+
 public:
   int  serialize(std::ostream &os) const override;
   int  deserialize(std::istream &is) override;
@@ -80,6 +92,7 @@ private:
   std::string   name_;
   std::vector<FieldMeta>  fields_; // 包含sys_fields，存储解析后的字段
   std::vector<IndexMeta>  indexes_;
+  TableStats              stats_;
 
   int  record_size_ = 0;
 
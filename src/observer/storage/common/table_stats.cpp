@@ -0,0 +1,333 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+
+#include "storage/common/table_stats.h"
+#include "storage/common/bplus_tree.h"
+#include "common/log/log.h"
+#include "json/json.h"
+
+const static Json::StaticString FIELD_ROW_NUM("row_num");
+const static Json::StaticString FIELD_COLUMNS("columns");
+const static Json::StaticString FIELD_INDEXES("indexes");
+const static Json::StaticString FIELD_NAME("name");
+const static Json::StaticString FIELD_NULL_NUM("null_num");
+const static Json::StaticString FIELD_NDV("ndv");
+const static Json::StaticString FIELD_MIN("min");
+const static Json::StaticString FIELD_MAX("max");
+const static Json::StaticString FIELD_HISTOGRAM("histogram");
+const static Json::StaticString FIELD_HEIGHT("height");
+const static Json::StaticString FIELD_LEAF_NUM("leaf_num");
+
+void ColumnStats::init(const FieldMeta &field, std::vector<const char *> &values, int null_num)
+{
+  field_name = field.name();
+  attr_type = field.type();
+  attr_length = field.len();
+  this->null_num = null_num;
+  ndv = 0;
+  min_value.clear();
+  max_value.clear();
+  bounds.clear();
+  if (values.empty()) {
+    return;
+  }
+
+  AttrType type = attr_type;
+  int length = attr_length;
+  std::sort(values.begin(), values.end(), [type, length](const char *v1, const char *v2) {
+    return CompareKey(v1, v2, type, length) < 0;
+  });
+
+  ndv = 1;
+  for (size_t i = 1; i < values.size(); i++) {
+    if (CompareKey(values[i - 1], values[i], type, length) != 0) {
+      ndv++;
+    }
+  }
+  min_value.assign(values.front(), length);
+  max_value.assign(values.back(), length);
+
+  // 第k个桶的上界是排序后第k*n/B个值，每个桶中的行数大致相同
+  int value_num = (int)values.size();
+  int bucket_num = std::min(value_num, STATS_HISTOGRAM_BUCKETS);
+  for (int k = 1; k <= bucket_num; k++) {
+    int pos = (int)(((long)k * value_num + bucket_num - 1) / bucket_num) - 1;
+    bounds.emplace_back(values[pos], length);
+  }
+}
+
+void TableStats::reset(int row_num)
+{
+  row_num_ = row_num;
+  columns_.clear();
+  indexes_.clear();
+}
+
+void TableStats::add_column(const ColumnStats &column)
+{
+  columns_.push_back(column);
+}
+
+void TableStats::add_index(const IndexStats &index)
+{
+  indexes_.push_back(index);
+}
+
+const ColumnStats *TableStats::column(const char *field_name) const
+{
+  for (const ColumnStats &column : columns_) {
+    if (0 == strcmp(column.field_name.c_str(), field_name)) {
+      return &column;
+    }
+  }
+  return nullptr;
+}
+
+const IndexStats *TableStats::index(const char *index_name) const
+{
+  for (const IndexStats &index : indexes_) {
+    if (0 == strcmp(index.index_name.c_str(), index_name)) {
+      return &index;
+    }
+  }
+  return nullptr;
+}
+
+double TableStats::fraction_less(const ColumnStats &column, const char *value, bool less_equal) const
+{
+  int bucket_num = (int)column.bounds.size();
+  if (bucket_num == 0) {
+    return 0;
+  }
+  int cmp = CompareKey(value, column.min_value.data(), column.attr_type, column.attr_length);
+  if (cmp < 0 || (cmp == 0 && !less_equal)) {
+    return 0;
+  }
+  int count = 0;
+  for (const std::string &bound : column.bounds) {
+    cmp = CompareKey(bound.data(), value, column.attr_type, column.attr_length);
+    if (cmp < 0 || (cmp == 0 && less_equal)) {
+      count++;
+    }
+  }
+  if (count == bucket_num) {
+    return 1;
+  }
+  // value落在第count个桶中，按照半个桶估算
+  return (count + 0.5) / bucket_num;
+}
+
+double TableStats::selectivity(const char *field_name, CompOp comp_op, const char *value) const
+{
+  const ColumnStats *column = analyzed() ? this->column(field_name) : nullptr;
+  if (nullptr == column) {
+    return -1;
+  }
+  if (row_num_ == 0) {
+    return 0;
+  }
+
+  double null_frac = (double)column->null_num / row_num_;
+  if (comp_op == IS_NULL) {
+    return null_frac;
+  }
+  if (comp_op == IS_NOT_NULL) {
+    return 1 - null_frac;
+  }
+  if (nullptr == value) {
+    return -1;
+  }
+  if (column->ndv == 0) {
+    return 0;
+  }
+
+  double fraction;
+  switch (comp_op) {
+    case EQUAL_TO: {
+      if (CompareKey(value, column->min_value.data(), column->attr_type, column->attr_length) < 0 ||
+          CompareKey(value, column->max_value.data(), column->attr_type, column->attr_length) > 0) {
+        fraction = 0;
+      } else {
+        fraction = 1.0 / column->ndv;
+      }
+    } break;
+    case NOT_EQUAL: {
+      fraction = 1 - 1.0 / column->ndv;
+    } break;
+    case LESS_THAN: {
+      fraction = fraction_less(*column, value, false);
+    } break;
+    case LESS_EQUAL: {
+      fraction = fraction_less(*column, value, true);
+    } break;
+    case GREAT_THAN: {
+      fraction = 1 - fraction_less(*column, value, true);
+    } break;
+    case GREAT_EQUAL: {
+      fraction = 1 - fraction_less(*column, value, false);
+    } break;
+    default: {
+      return -1;
+    }
+  }
+  return fraction * (1 - null_frac);
+}
+
+static void value_to_json(const ColumnStats &column, const std::string &value, Json::Value &json_value)
+{
+  switch (column.attr_type) {
+    case INTS:
+    case DATES: {
+      json_value = *(const int *)value.data();
+    } break;
+    case FLOATS: {
+      json_value = *(const float *)value.data();
+    } break;
+    default: {
+      json_value = std::string(value.data(), strnlen(value.data(), value.size()));
+    } break;
+  }
+}
+
+static RC value_from_json(const ColumnStats &column, const Json::Value &json_value, std::string &value)
+{
+  value.assign(column.attr_length, '\0');
+  switch (column.attr_type) {
+    case INTS:
+    case DATES: {
+      if (!json_value.isInt()) {
+        return RC::GENERIC_ERROR;
+      }
+      int v = json_value.asInt();
+      memcpy(&value[0], &v, sizeof(v));
+    } break;
+    case FLOATS: {
+      if (!json_value.isNumeric()) {
+        return RC::GENERIC_ERROR;
+      }
+      float v = json_value.asFloat();
+      memcpy(&value[0], &v, sizeof(v));
+    } break;
+    default: {
+      if (!json_value.isString()) {
+        return RC::GENERIC_ERROR;
+      }
+      std::string v = json_value.asString();
+      memcpy(&value[0], v.data(), std::min((int)v.size(), column.attr_length));
+    } break;
+  }
+  return RC::SUCCESS;
+}
+
+void TableStats::to_json(Json::Value &json_value) const
+{
+  json_value[FIELD_ROW_NUM] = row_num_;
+
+  Json::Value columns_value(Json::arrayValue);
+  for (const ColumnStats &column : columns_) {
+    Json::Value column_value;
+    column_value[FIELD_NAME] = column.field_name;
+    column_value[FIELD_NULL_NUM] = column.null_num;
+    column_value[FIELD_NDV] = column.ndv;
+    if (column.ndv > 0) {
+      value_to_json(column, column.min_value, column_value[FIELD_MIN]);
+      value_to_json(column, column.max_value, column_value[FIELD_MAX]);
+      Json::Value histogram_value(Json::arrayValue);
+      for (const std::string &bound : column.bounds) {
+        Json::Value bound_value;
+        value_to_json(column, bound, bound_value);
+        histogram_value.append(std::move(bound_value));
+      }
+      column_value[FIELD_HISTOGRAM] = std::move(histogram_value);
+    }
+    columns_value.append(std::move(column_value));
+  }
+  json_value[FIELD_COLUMNS] = std::move(columns_value);
+
+  Json::Value indexes_value(Json::arrayValue);
+  for (const IndexStats &index : indexes_) {
+    Json::Value index_value;
+    index_value[FIELD_NAME] = index.index_name;
+    index_value[FIELD_HEIGHT] = index.height;
+    index_value[FIELD_LEAF_NUM] = index.leaf_num;
+    indexes_value.append(std::move(index_value));
+  }
+  json_value[FIELD_INDEXES] = std::move(indexes_value);
+}
+
+RC TableStats::from_json(const std::vector<FieldMeta> &fields, const Json::Value &json_value, TableStats &stats)
+{
+  const Json::Value &row_num_value = json_value[FIELD_ROW_NUM];
+  const Json::Value &columns_value = json_value[FIELD_COLUMNS];
+  const Json::Value &indexes_value = json_value[FIELD_INDEXES];
+  if (!row_num_value.isInt() || !columns_value.isArray() || !indexes_value.isArray()) {
+    LOG_ERROR("Invalid table statistics. json value=%s", json_value.toStyledString().c_str());
+    return RC::GENERIC_ERROR;
+  }
+
+  stats.reset(row_num_value.asInt());
+  for (const Json::Value &column_value : columns_value) {
+    const Json::Value &name_value = column_value[FIELD_NAME];
+    if (!name_value.isString()) {
+      LOG_ERROR("Invalid column statistics. json value=%s", column_value.toStyledString().c_str());
+      return RC::GENERIC_ERROR;
+    }
+    const FieldMeta *field = nullptr;
+    for (const FieldMeta &f : fields) {
+      if (0 == strcmp(f.name(), name_value.asCString())) {
+        field = &f;
+        break;
+      }
+    }
+    if (nullptr == field) {
+      LOG_WARN("Statistics of unknown field %s is ignored", name_value.asCString());
+      continue;
+    }
+
+    ColumnStats column;
+    column.field_name = field->name();
+    column.attr_type = field->type();
+    column.attr_length = field->len();
+    column.null_num = column_value[FIELD_NULL_NUM].asInt();
+    column.ndv = column_value[FIELD_NDV].asInt();
+    if (column.ndv > 0) {
+      RC rc = value_from_json(column, column_value[FIELD_MIN], column.min_value);
+      if (rc == RC::SUCCESS) {
+        rc = value_from_json(column, column_value[FIELD_MAX], column.max_value);
+      }
+      const Json::Value &histogram_value = column_value[FIELD_HISTOGRAM];
+      for (const Json::Value &bound_value : histogram_value) {
+        if (rc != RC::SUCCESS) {
+          break;
+        }
+        std::string bound;
+        rc = value_from_json(column, bound_value, bound);
+        column.bounds.push_back(std::move(bound));
+      }
+      if (rc != RC::SUCCESS) {
+        LOG_ERROR("Invalid column statistics. json value=%s", column_value.toStyledString().c_str());
+        return rc;
+      }
+    }
+    stats.add_column(column);
+  }
+
+  for (const Json::Value &index_value : indexes_value) {
+    IndexStats index;
+    index.index_name = index_value[FIELD_NAME].asString();
+    index.height = index_value[FIELD_HEIGHT].asInt();
+    index.leaf_num = index_value[FIELD_LEAF_NUM].asInt();
+    stats.add_index(index);
+  }
+  return RC::SUCCESS;
+}
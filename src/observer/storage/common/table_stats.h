@@ -0,0 +1,90 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_TABLE_STATS_H__
+#define __OBSERVER_STORAGE_COMMON_TABLE_STATS_H__
+
+#include <string>
+#include <vector>
+
+#include "rc.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/common/field_meta.h"
+
+// 等深直方图的桶数
+#define STATS_HISTOGRAM_BUCKETS 16
+
+// 一个字段的统计信息。取值都按照字段在记录中的格式保存，长度为attr_length
+struct ColumnStats {
+  std::string field_name;
+  AttrType attr_type = UNDEFINED;
+  int attr_length = 0;
+  int null_num = 0;
+  int ndv = 0;                      // 不同的非NULL值个数
+  std::string min_value;
+  std::string max_value;
+  std::vector<std::string> bounds;  // 等深直方图每个桶的上界，从小到大
+
+  /**
+   * 根据一个字段的全部非NULL取值计算统计信息，values会被排序
+   */
+  void init(const FieldMeta &field, std::vector<const char *> &values, int null_num);
+};
+
+// 一个索引的统计信息
+struct IndexStats {
+  std::string index_name;
+  int height = 0;    // 一次查找需要访问的索引页面数
+  int leaf_num = 0;
+};
+
+/**
+ * ANALYZE收集的表的统计信息，随表的元数据一起持久化，用于在索引扫描和全表扫描之间做选择
+ */
+class TableStats {
+public:
+  // 没有执行过ANALYZE时没有统计信息
+  bool analyzed() const
+  {
+    return row_num_ >= 0;
+  }
+  int row_num() const
+  {
+    return row_num_;
+  }
+
+  void reset(int row_num);
+  void add_column(const ColumnStats &column);
+  void add_index(const IndexStats &index);
+
+  const ColumnStats *column(const char *field_name) const;
+  const IndexStats *index(const char *index_name) const;
+
+  /**
+   * 估算"field_name comp_op value"的选择率，即满足条件的行占全表的比例。
+   * 没有这个字段的统计信息或者无法估算时返回负数
+   */
+  double selectivity(const char *field_name, CompOp comp_op, const char *value) const;
+
+public:
+  void to_json(Json::Value &json_value) const;
+  static RC from_json(const std::vector<FieldMeta> &fields, const Json::Value &json_value, TableStats &stats);
+
+private:
+  // 直方图中小于value(less_equal为true时小于等于)的行占非NULL行的比例
+  double fraction_less(const ColumnStats &column, const char *value, bool less_equal) const;
+
+private:
+  int row_num_ = -1;
+  std::vector<ColumnStats> columns_;
+  std::vector<IndexStats> indexes_;
+};
+
+#endif  // __OBSERVER_STORAGE_COMMON_TABLE_STATS_H__
@@ -155,7 +155,9 @@ RC DefaultHandler::drop_table(const char *dbname, const char *relation_name) {
   return db->drop_table(relation_name);
 }
 
-RC DefaultHandler::create_index(Trx *trx, const char *dbname, const char *relation_name, const char *index_name,const int& attr_num, const char *attribute_name[],int is_unique)
+RC DefaultHandler::create_index(Trx *trx, const char *dbname, const char *relation_name, const char *index_name,const int& attr_num, const char *attribute_name[],int is_unique,
+                                int include_num, const char *include_attribute_name[], IndexType index_type,
+                                int condition_num, const Condition *conditions)
 {
   
   Table *table = find_table(dbname, relation_name);
@@ -164,8 +166,10 @@ RC DefaultHandler::create_index(Trx *trx, const char *dbname, const char *relati
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
   // 根据attr_num是否大于1，在这里进行分流一次  unique其实也可以用于multi-index 因为不能让联合索引的key完全相同
-  if(attr_num>1){
-    return table->create_index(trx, index_name, attr_num, attribute_name, is_unique);
+  // 带INCLUDE字段的索引、哈希索引、位图索引和部分索引也走multi-index的流程
+  if(attr_num>1 || include_num>0 || index_type != INDEX_TYPE_BTREE || condition_num > 0){
+    return table->create_index(trx, index_name, attr_num, attribute_name, is_unique, include_num, include_attribute_name, index_type,
+                               condition_num, conditions);
   }
   return table->create_index(trx, index_name, attribute_name[0], is_unique);
 }
@@ -103,9 +103,14 @@ public:
    * @param relName
    * @param attrName
    * @param is_unique
+   * @param include_attribute_name INCLUDE字段，只保存在索引叶子中
+   * @param index_type 索引类型，USING HASH/USING BITMAP时分别为哈希索引和位图索引
+   * @param conditions WHERE子句中的条件，不为空时创建只包含满足条件的记录的部分索引
    * @return
    */
-  RC create_index(Trx *trx, const char *dbname, const char *relation_name, const char *index_name, const int& attr_num, const char *attribute_name[],int is_unique);
+  RC create_index(Trx *trx, const char *dbname, const char *relation_name, const char *index_name, const int& attr_num, const char *attribute_name[],int is_unique,
+                  int include_num = 0, const char *include_attribute_name[] = nullptr, IndexType index_type = INDEX_TYPE_BTREE,
+                  int condition_num = 0, const Condition *conditions = nullptr);
 
   /**
    * 该函数用来删除名为indexName的索引。
@@ -245,7 +245,9 @@ void DefaultStorageStage::handle_event(StageEvent *event)
     // multi-index 命令解析完毕
     CreateIndex &create_index = sql->sstr.create_index;
     rc = handler_->create_index(current_trx, current_db, create_index.relation_name,
-                                create_index.index_name, create_index.attr_num, (const char **)create_index.attribute_name,create_index.is_unique);
+                                create_index.index_name, create_index.attr_num, (const char **)create_index.attribute_name,create_index.is_unique,
+                                create_index.include_num, (const char **)create_index.include_attribute_name,
+                                create_index.index_type, create_index.condition_num, create_index.conditions);
     snprintf(response, sizeof(response), "%s\n", rc == RC::SUCCESS ? "SUCCESS" : "FAILURE");
   }
   break;
@@ -305,6 +307,22 @@ void DefaultStorageStage::handle_event(StageEvent *event)
   }
   break;
 
+  case SCF_ANALYZE:
+  {
+    const char *table_name = sql->sstr.analyze.relation_name;
+    Table *table = handler_->find_table(current_db, table_name);
+    if (table == nullptr)
+    {
+      rc = RC::SCHEMA_TABLE_NOT_EXIST;
+    }
+    else
+    {
+      rc = table->analyze(current_trx);
+    }
+    snprintf(response, sizeof(response), "%s\n", rc == RC::SUCCESS ? "SUCCESS" : "FAILURE");
+  }
+  break;
+
   case SCF_LOAD_DATA:
   {
     /*
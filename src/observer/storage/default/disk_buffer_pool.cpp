@@ -631,6 +631,21 @@ RC DiskBufferPool::check_file_id(int file_id)
   return RC::SUCCESS;
 }
 
+bool DiskBufferPool::is_page_resident(int file_id, PageNum page_num)
+{
+  if (check_file_id(file_id) != RC::SUCCESS) {
+    return false;
+  }
+  BPFileHandle *file_handle = open_list_[file_id];
+  for (int i = 0; i < BP_BUFFER_SIZE; i++) {
+    if (bp_manager_.allocated[i] && bp_manager_.frame[i].file_desc == file_handle->file_desc &&
+        bp_manager_.frame[i].page.page_num == page_num) {
+      return true;
+    }
+  }
+  return false;
+}
+
 RC DiskBufferPool::get_page_count(int file_id, int *page_count)
 {
   RC rc = RC::SUCCESS;
@@ -244,6 +244,11 @@ public:
    */
   RC get_page_count(int file_id, int *page_count);
 
+  /**
+   * 页面是否已经在缓冲区中，不会加载页面，也不会改变页面的访问时间
+   */
+  bool is_page_resident(int file_id, PageNum page_num);
+
   RC flush_all_pages(int file_id);
 
 protected:
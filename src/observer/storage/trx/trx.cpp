@@ -175,7 +175,10 @@ Operation *Trx::find_operation(Table *table, const RID &rid)
 void Trx::insert_operation(Table *table, Operation::Type type, const RID &rid)
 {
   OperationSet &table_operations = operations_[table];
-  table_operations.emplace(type, rid);
+  if (table_operations.emplace(type, rid).second)
+  {
+    table->add_uncommitted_operation_num(1);
+  }
 }
 
 void Trx::delete_operation(Table *table, const RID &rid)
@@ -187,9 +190,8 @@ void Trx::delete_operation(Table *table, const RID &rid)
   }
 
   Operation tmp(Operation::Type::UNDEFINED, rid);
-  int origin_size = table_operations_iter->second.size();
-  table_operations_iter->second.erase(tmp);
-  int delete_size = table_operations_iter->second.size();
+  int delete_size = table_operations_iter->second.erase(tmp);
+  table->add_uncommitted_operation_num(-delete_size);
 }
 
 RC Trx::commit()
@@ -253,6 +255,10 @@ RC Trx::commit()
     }
   }
 
+  for (const auto &table_operations : operations_)
+  {
+    table_operations.first->add_uncommitted_operation_num(-(int)table_operations.second.size());
+  }
   operations_.clear();
   trx_id_ = 0;
   return rc;
@@ -317,6 +323,10 @@ RC Trx::rollback()
     }
   }
 
+  for (const auto &table_operations : operations_)
+  {
+    table_operations.first->add_uncommitted_operation_num(-(int)table_operations.second.size());
+  }
   operations_.clear();
   trx_id_ = 0;
   return rc;
@@ -0,0 +1,538 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Longda on 2021
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "storage/common/bplus_tree.h"
+#include "gtest/gtest.h"
+
+#define INSERT_NUM 1000
+
+static const char *index_name = "bplus_tree_test.index";
+
+static RID make_rid(int i)
+{
+  RID rid;
+  rid.page_num = i / 100 + 1;
+  rid.slot_num = i % 100;
+  return rid;
+}
+
+static void open_int_index(BplusTreeHandler &handler, const char *file_name)
+{
+  unlink(file_name);
+  ASSERT_EQ(RC::SUCCESS, handler.create(file_name, INTS, sizeof(int), 0));
+  for (int i = 1; i <= INSERT_NUM; i++) {
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+}
+
+static std::vector<RID> scan_all(BplusTreeScanner &scanner)
+{
+  std::vector<RID> rids;
+  RID rid;
+  while (scanner.next_entry(&rid) == RC::SUCCESS) {
+    rids.push_back(rid);
+  }
+  return rids;
+}
+
+TEST(test_bplus_tree, test_single_range_scan)
+{
+  BplusTreeHandler handler;
+  open_int_index(handler, index_name);
+
+  int value = 500;
+  BplusTreeScanner equal_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, equal_scanner.open_single_index(EQUAL_TO, (const char *)&value));
+  std::vector<RID> rids = scan_all(equal_scanner);
+  ASSERT_EQ(1, (int)rids.size());
+  ASSERT_EQ(make_rid(500).page_num, rids[0].page_num);
+  ASSERT_EQ(make_rid(500).slot_num, rids[0].slot_num);
+
+  value = 100;
+  BplusTreeScanner less_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, less_scanner.open_single_index(LESS_THAN, (const char *)&value));
+  ASSERT_EQ(99, (int)scan_all(less_scanner).size());
+
+  BplusTreeScanner less_equal_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, less_equal_scanner.open_single_index(LESS_EQUAL, (const char *)&value));
+  ASSERT_EQ(100, (int)scan_all(less_equal_scanner).size());
+
+  value = 990;
+  BplusTreeScanner great_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, great_scanner.open_single_index(GREAT_THAN, (const char *)&value));
+  ASSERT_EQ(10, (int)scan_all(great_scanner).size());
+
+  BplusTreeScanner great_equal_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, great_equal_scanner.open_single_index(GREAT_EQUAL, (const char *)&value));
+  ASSERT_EQ(11, (int)scan_all(great_equal_scanner).size());
+
+  value = INSERT_NUM + 1;
+  BplusTreeScanner empty_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, empty_scanner.open_single_index(EQUAL_TO, (const char *)&value));
+  ASSERT_EQ(0, (int)scan_all(empty_scanner).size());
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_scan_with_leaf_modified)
+{
+  BplusTreeHandler handler;
+  open_int_index(handler, index_name);
+
+  int value = 1;
+  BplusTreeScanner scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, scanner.open_single_index(GREAT_EQUAL, (const char *)&value));
+
+  RID rid;
+  for (int i = 1; i <= 10; i++) {
+    ASSERT_EQ(RC::SUCCESS, scanner.next_entry(&rid));
+  }
+
+  // 删除刚刚返回的key和它后面的一段key，游标需要重新定位
+  for (int i = 10; i <= 20; i++) {
+    RID deleted = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &deleted));
+  }
+
+  ASSERT_EQ(RC::SUCCESS, scanner.next_entry(&rid));
+  ASSERT_EQ(make_rid(21).page_num, rid.page_num);
+  ASSERT_EQ(make_rid(21).slot_num, rid.slot_num);
+  ASSERT_EQ(INSERT_NUM - 21, (int)scan_all(scanner).size());
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_multi_range_scan)
+{
+  BplusTreeHandler handler;
+  unlink(index_name);
+  AttrType attr_type[2] = {INTS, INTS};
+  int attr_length[2] = {sizeof(int), sizeof(int)};
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, attr_type, attr_length, 2, 0));
+  for (int i = 0; i < INSERT_NUM; i++) {
+    int key[2] = {i / 10, i % 10};
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)key, &rid));
+  }
+
+  int a = 50;
+  int b = 3;
+  BplusTreeScanner scanner(handler, 2);
+  ASSERT_EQ(RC::SUCCESS, scanner.open_multi_index({EQUAL_TO, LESS_THAN}, {(const char *)&a, (const char *)&b}));
+  ASSERT_EQ(3, (int)scan_all(scanner).size());
+
+  BplusTreeScanner prefix_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, prefix_scanner.open_multi_index({EQUAL_TO}, {(const char *)&a}));
+  ASSERT_EQ(10, (int)scan_all(prefix_scanner).size());
+
+  BplusTreeScanner great_scanner(handler, 2);
+  ASSERT_EQ(RC::SUCCESS, great_scanner.open_multi_index({EQUAL_TO, GREAT_THAN}, {(const char *)&a, (const char *)&b}));
+  ASSERT_EQ(6, (int)scan_all(great_scanner).size());
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_reverse_scan)
+{
+  BplusTreeHandler handler;
+  open_int_index(handler, index_name);
+
+  BplusTreeScanner all_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, all_scanner.open_single_index(NO_OP, nullptr, -1, true));
+  std::vector<RID> rids = scan_all(all_scanner);
+  ASSERT_EQ(INSERT_NUM, (int)rids.size());
+  for (int i = 0; i < INSERT_NUM; i++) {
+    ASSERT_EQ(make_rid(INSERT_NUM - i).page_num, rids[i].page_num);
+    ASSERT_EQ(make_rid(INSERT_NUM - i).slot_num, rids[i].slot_num);
+  }
+
+  int value = 100;
+  BplusTreeScanner less_equal_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, less_equal_scanner.open_single_index(LESS_EQUAL, (const char *)&value, -1, true));
+  rids = scan_all(less_equal_scanner);
+  ASSERT_EQ(100, (int)rids.size());
+  ASSERT_EQ(make_rid(100).slot_num, rids[0].slot_num);
+
+  value = 990;
+  BplusTreeScanner great_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, great_scanner.open_single_index(GREAT_THAN, (const char *)&value, -1, true));
+  rids = scan_all(great_scanner);
+  ASSERT_EQ(10, (int)rids.size());
+  ASSERT_EQ(make_rid(INSERT_NUM).page_num, rids[0].page_num);
+  ASSERT_EQ(make_rid(INSERT_NUM).slot_num, rids[0].slot_num);
+
+  // 删除一段key触发叶子合并后，向前的指针也要保持正确
+  for (int i = 200; i <= 800; i++) {
+    RID deleted = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &deleted));
+  }
+  BplusTreeScanner after_delete_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, after_delete_scanner.open_single_index(NO_OP, nullptr, -1, true));
+  rids = scan_all(after_delete_scanner);
+  ASSERT_EQ(INSERT_NUM - 601, (int)rids.size());
+  ASSERT_EQ(make_rid(801).slot_num, rids[INSERT_NUM - 800 - 1].slot_num);
+  ASSERT_EQ(make_rid(199).slot_num, rids[INSERT_NUM - 800].slot_num);
+
+  handler.close();
+  unlink(index_name);
+}
+
+// 把索引文件改回版本2之前的样子：文件头中的版本是1，叶子中没有前驱指针
+static void downgrade_to_version_1(const char *file_name)
+{
+  DiskBufferPool *disk_buffer_pool = theGlobalDiskBufferPool();
+  int file_id;
+  ASSERT_EQ(RC::SUCCESS, disk_buffer_pool->open_file(file_name, &file_id));
+  int page_count = 0;
+  ASSERT_EQ(RC::SUCCESS, disk_buffer_pool->get_page_count(file_id, &page_count));
+
+  BPPageHandle page_handle;
+  char *pdata;
+  ASSERT_EQ(RC::SUCCESS, disk_buffer_pool->get_this_page(file_id, 1, &page_handle));
+  ASSERT_EQ(RC::SUCCESS, disk_buffer_pool->get_data(&page_handle, &pdata));
+  IndexFileHeader file_header;
+  memcpy(&file_header, pdata, sizeof(file_header));
+  ((IndexFileHeader *)pdata)->version = 1;
+  disk_buffer_pool->mark_dirty(&page_handle);
+  disk_buffer_pool->unpin_page(&page_handle);
+
+  int leaf_num = 0;
+  for (PageNum page_num = 1; page_num < page_count; page_num++) {
+    ASSERT_EQ(RC::SUCCESS, disk_buffer_pool->get_this_page(file_id, page_num, &page_handle));
+    ASSERT_EQ(RC::SUCCESS, disk_buffer_pool->get_data(&page_handle, &pdata));
+    IndexNode *node = (IndexNode *)(pdata + sizeof(IndexFileHeader));
+    if (node->is_leaf) {
+      RID *rids = (RID *)((char *)node + sizeof(IndexNode) + file_header.order * file_header.key_length);
+      rids[file_header.order - 1].slot_num = -1;
+      disk_buffer_pool->mark_dirty(&page_handle);
+      leaf_num++;
+    }
+    disk_buffer_pool->unpin_page(&page_handle);
+  }
+  ASSERT_LT(1, leaf_num);
+  ASSERT_EQ(RC::SUCCESS, disk_buffer_pool->close_file(file_id));
+}
+
+TEST(test_bplus_tree, test_reverse_scan_on_old_file)
+{
+  BplusTreeHandler handler;
+  open_int_index(handler, index_name);
+  handler.close();
+  downgrade_to_version_1(index_name);
+
+  // 打开旧文件时补上前驱指针，反向扫描可以走完所有叶子
+  ASSERT_EQ(RC::SUCCESS, handler.open(index_name));
+  BplusTreeScanner scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, scanner.open_single_index(NO_OP, nullptr, -1, true));
+  std::vector<RID> rids = scan_all(scanner);
+  scanner.close();
+  ASSERT_EQ(INSERT_NUM, (int)rids.size());
+  for (int i = 0; i < INSERT_NUM; i++) {
+    ASSERT_EQ(make_rid(INSERT_NUM - i).page_num, rids[i].page_num);
+    ASSERT_EQ(make_rid(INSERT_NUM - i).slot_num, rids[i].slot_num);
+  }
+
+  // 升级后的版本号写回文件，再次打开不需要重建
+  handler.close();
+  ASSERT_EQ(RC::SUCCESS, handler.open(index_name));
+  int value = 500;
+  BplusTreeScanner less_scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, less_scanner.open_single_index(LESS_THAN, (const char *)&value, -1, true));
+  ASSERT_EQ(499, (int)scan_all(less_scanner).size());
+  less_scanner.close();
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_include_fields)
+{
+  BplusTreeHandler handler;
+  unlink(index_name);
+  AttrType attr_type[1] = {INTS};
+  int attr_length[1] = {sizeof(int)};
+  // 索引项为 key | RID | INCLUDE，INCLUDE部分不参与比较
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, attr_type, attr_length, 1, 0, sizeof(int)));
+  for (int i = 0; i < INSERT_NUM; i++) {
+    RID rid = make_rid(i);
+    char key[sizeof(int) + sizeof(RID) + sizeof(int)];
+    int include_value = i * 10;
+    memcpy(key, &i, sizeof(int));
+    memcpy(key + sizeof(int), &rid, sizeof(RID));
+    memcpy(key + sizeof(int) + sizeof(RID), &include_value, sizeof(int));
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+  }
+
+  int value = 500;
+  BplusTreeScanner scanner(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, scanner.open_single_index(GREAT_EQUAL, (const char *)&value));
+  RID rid;
+  for (int i = 500; i < INSERT_NUM; i++) {
+    ASSERT_EQ(RC::SUCCESS, scanner.next_entry(&rid));
+    const char *key = scanner.current_key();
+    ASSERT_NE(nullptr, key);
+    ASSERT_EQ(i, *(const int *)key);
+    ASSERT_EQ(i * 10, *(const int *)(key + sizeof(int) + sizeof(RID)));
+  }
+  ASSERT_NE(RC::SUCCESS, scanner.next_entry(&rid));
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_adaptive_hash_index)
+{
+  BplusTreeHandler handler;
+  open_int_index(handler, index_name);
+
+  // 反复查找同一批key，变热之后直接从自适应哈希索引定位到叶子
+  for (int round = 0; round < 10; round++) {
+    for (int i = 100; i < 120; i++) {
+      BplusTreeScanner scanner(handler, 1);
+      ASSERT_EQ(RC::SUCCESS, scanner.open_single_index(EQUAL_TO, (const char *)&i));
+      std::vector<RID> rids = scan_all(scanner);
+      ASSERT_EQ(1, (int)rids.size());
+      ASSERT_EQ(make_rid(i).page_num, rids[0].page_num);
+      ASSERT_EQ(make_rid(i).slot_num, rids[0].slot_num);
+    }
+  }
+  ASSERT_LT(0, handler.adaptive_hash_hit_count());
+
+  // 修改叶子之后，缓存的位置失效也不能返回错误的结果
+  for (int i = 50; i <= 115; i += 2) {
+    RID deleted = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &deleted));
+  }
+  for (int i = 101; i < 120; i += 2) {
+    RID rid = make_rid(i + INSERT_NUM);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+  for (int round = 0; round < 5; round++) {
+    for (int i = 100; i < 120; i++) {
+      BplusTreeScanner scanner(handler, 1);
+      ASSERT_EQ(RC::SUCCESS, scanner.open_single_index(EQUAL_TO, (const char *)&i));
+      int expected = (i <= 115 && i % 2 == 0) ? 0 : (i % 2 == 1 ? 2 : 1);
+      ASSERT_EQ(expected, (int)scan_all(scanner).size());
+    }
+  }
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_get_entries)
+{
+  BplusTreeHandler handler;
+  open_int_index(handler, index_name);
+
+  // key 500的索引项跨越多个叶子
+  int value = 500;
+  for (int i = 0; i < 1000; i++) {
+    RID rid = make_rid(i + INSERT_NUM + 1);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&value, &rid));
+  }
+
+  int values[] = {0, 1, 2, 3, 250, 500, 500, 501, INSERT_NUM, INSERT_NUM + 1};
+  std::vector<const char *> keys;
+  for (int &v : values) {
+    keys.push_back((const char *)&v);
+  }
+  std::vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, handler.get_entries(keys, rids));
+  ASSERT_EQ(7 + 1000, (int)rids.size());
+  ASSERT_EQ(make_rid(1).page_num, rids[0].page_num);
+  ASSERT_EQ(make_rid(1).slot_num, rids[0].slot_num);
+  ASSERT_EQ(make_rid(INSERT_NUM).slot_num, rids.back().slot_num);
+  ASSERT_EQ(make_rid(INSERT_NUM).page_num, rids.back().page_num);
+
+  // 所有key都比索引中的key大
+  int larger[] = {INSERT_NUM + 1, INSERT_NUM + 2};
+  rids.clear();
+  ASSERT_EQ(RC::SUCCESS, handler.get_entries({(const char *)&larger[0], (const char *)&larger[1]}, rids));
+  ASSERT_EQ(0, (int)rids.size());
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_change_buffer)
+{
+  BplusTreeHandler handler;
+  unlink(index_name);
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int), 0));
+
+  // 叶子页面的数量超过buffer pool的容量，乱序插入时大部分叶子都不在内存中
+  const int num = 20000;
+  for (int i = 0; i < num; i++) {
+    int value = (int)((long)i * 7919 % num);
+    RID rid = make_rid(value);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&value, &rid));
+  }
+  ASSERT_LT(0, handler.buffered_change_count());
+  for (int i = 0; i < num; i += 2) {
+    int value = (int)((long)i * 7919 % num);
+    RID rid = make_rid(value);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&value, &rid));
+  }
+  // 删除不存在的索引项和不缓冲时一样报错：已经缓冲了删除的，以及从来没有插入过的
+  for (int i = 0; i < num; i += 2) {
+    int value = (int)((long)i * 7919 % num);
+    RID rid = make_rid(value);
+    ASSERT_EQ(RC::RECORD_INVALID_KEY, handler.delete_entry((const char *)&value, &rid));
+  }
+  for (int i = 0; i < 100; i++) {
+    int value = num + i * 7919;
+    RID rid = make_rid(value);
+    ASSERT_EQ(RC::RECORD_INVALID_KEY, handler.delete_entry((const char *)&value, &rid));
+  }
+
+  // 扫描之前合并缓冲的修改
+  BplusTreeScanner scanner(handler, 1);
+  int lower = 0;
+  ASSERT_EQ(RC::SUCCESS, scanner.open_single_index(GREAT_EQUAL, (const char *)&lower));
+  std::vector<RID> rids = scan_all(scanner);
+  scanner.close();
+  ASSERT_EQ(num / 2, (int)rids.size());
+
+  for (int i = 0; i < num; i += 97) {
+    int value = (int)((long)i * 7919 % num);
+    std::vector<RID> found;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entries({(const char *)&value}, found));
+    ASSERT_EQ(i % 2 == 0 ? 0 : 1, (int)found.size());
+  }
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_unique_bloom_filter)
+{
+  BplusTreeHandler handler;
+  std::string bloom_file = std::string(index_name) + BPLUS_TREE_BLOOM_SUFFIX;
+  unlink(index_name);
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int), 1));
+
+  // 插入的key都不重复，绝大部分可以跳过叶子扫描，期间容量不够会多次重建
+  const int num = 5000;
+  for (int i = 0; i < num; i++) {
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+  ASSERT_LT(num * 9 / 10, handler.bloom_skip_count());
+  int value = 100;
+  RID rid = make_rid(num);
+  ASSERT_EQ(RC::INDEX_DUPLICATED, handler.insert_entry((const char *)&value, &rid));
+
+  // 删除后位还留在filter中，误判时回到原来的检查
+  rid = make_rid(value);
+  ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&value, &rid));
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&value, &rid));
+
+  // 正常关闭时保存，打开时加载后删除文件
+  handler.close();
+  ASSERT_EQ(0, access(bloom_file.c_str(), F_OK));
+  ASSERT_EQ(RC::SUCCESS, handler.open(index_name));
+  ASSERT_NE(0, access(bloom_file.c_str(), F_OK));
+  long skip_count = handler.bloom_skip_count();
+  value = num;
+  rid = make_rid(num);
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&value, &rid));
+  ASSERT_EQ(skip_count + 1, handler.bloom_skip_count());
+  ASSERT_EQ(RC::INDEX_DUPLICATED, handler.insert_entry((const char *)&value, &rid));
+
+  // 没有filter文件(比如异常退出)时扫描叶子重新构造，已有的key仍然会被检查出来
+  handler.close();
+  unlink(bloom_file.c_str());
+  ASSERT_EQ(RC::SUCCESS, handler.open(index_name));
+  for (int i = 0; i <= num; i += 101) {
+    rid = make_rid(num + 1);
+    ASSERT_EQ(RC::INDEX_DUPLICATED, handler.insert_entry((const char *)&i, &rid));
+  }
+
+  handler.close();
+  unlink(bloom_file.c_str());
+  unlink(index_name);
+}
+
+TEST(test_bplus_tree, test_right_append)
+{
+  const int num = 20000;
+  int height, ascending_leaf_num, descending_leaf_num;
+
+  // 递增插入直接追加到最右边的叶子，90/10分裂后叶子接近装满
+  BplusTreeHandler handler;
+  unlink(index_name);
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int), 0));
+  for (int i = 0; i < num; i++) {
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+  ASSERT_LT(num * 9 / 10, handler.right_append_count());
+  ASSERT_EQ(RC::SUCCESS, handler.get_statistics(&height, &ascending_leaf_num));
+
+  BplusTreeScanner scanner(handler, 1);
+  int lower = 0;
+  ASSERT_EQ(RC::SUCCESS, scanner.open_single_index(GREAT_EQUAL, (const char *)&lower));
+  std::vector<RID> rids = scan_all(scanner);
+  scanner.close();
+  ASSERT_EQ(num, (int)rids.size());
+  for (int i = 0; i < num; i++) {
+    ASSERT_EQ(make_rid(i).page_num, rids[i].page_num);
+    ASSERT_EQ(make_rid(i).slot_num, rids[i].slot_num);
+  }
+
+  // 删除之后不再使用缓存的最右叶子，继续插入结果仍然正确
+  for (int i = 0; i < num; i += 3) {
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &rid));
+  }
+  for (int i = num; i < num + 1000; i++) {
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+  BplusTreeScanner scanner2(handler, 1);
+  ASSERT_EQ(RC::SUCCESS, scanner2.open_single_index(GREAT_EQUAL, (const char *)&lower));
+  rids = scan_all(scanner2);
+  scanner2.close();
+  ASSERT_EQ(num - (num + 2) / 3 + 1000, (int)rids.size());
+  handler.close();
+  unlink(index_name);
+
+  // 递减插入总是落在最左边的叶子，仍然对半分裂
+  BplusTreeHandler descending;
+  ASSERT_EQ(RC::SUCCESS, descending.create(index_name, INTS, sizeof(int), 0));
+  for (int i = num - 1; i >= 0; i--) {
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, descending.insert_entry((const char *)&i, &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, descending.get_statistics(&height, &descending_leaf_num));
+  ASSERT_LT(ascending_leaf_num * 3 / 2, descending_leaf_num);
+  descending.close();
+  unlink(index_name);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,299 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <unistd.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sql/executor/column_batch.h"
+#include "sql/executor/execute_stage.h"
+#include "sql/executor/execution_node.h"
+#include "storage/common/table.h"
+#include "storage/common/meta_util.h"
+#include "storage/common/field_meta.h"
+#include "storage/common/record_manager.h"
+#include "gtest/gtest.h"
+
+#define ROW_NUM 3000
+
+static void remove_table(const char *table_name)
+{
+  unlink(table_meta_file(".", table_name).c_str());
+  unlink((std::string("./") + table_name + TABLE_DATA_SUFFIX).c_str());
+  unlink(index_data_file(".", table_name, "i_b").c_str());
+}
+
+// 表t(a int null, f float null, b int)，a、f中有NULL，第一行都是NULL，行数超过一个批次
+static void create_table(Table &table, const char *table_name)
+{
+  remove_table(table_name);
+
+  AttrInfo attrs[3];
+  const char *names[3] = {"a", "f", "b"};
+  AttrType types[3] = {INTS, FLOATS, INTS};
+  for (int i = 0; i < 3; i++) {
+    attrs[i].name = (char *)names[i];
+    attrs[i].type = types[i];
+    attrs[i].length = 4;
+    attrs[i].is_nullable = i < 2;
+  }
+  std::string meta_file = table_meta_file(".", table_name);
+  ASSERT_EQ(RC::SUCCESS, table.create(meta_file.c_str(), table_name, ".", 3, attrs));
+
+  for (int i = 0; i < ROW_NUM; i++) {
+    int a = (i * 37) % 1000 - 500;
+    float f = ((i * 13) % 500) / 4.0f - 60;
+    int b = i;
+    Value values[3];
+    values[0] = {INTS, &a, i % 7 == 0};
+    values[1] = {FLOATS, &f, i % 11 == 0};
+    values[2] = {INTS, &b, 0};
+    ASSERT_EQ(RC::SUCCESS, table.insert_record(nullptr, 3, values));
+  }
+}
+
+struct TestCondition {
+  const char *field_name;
+  CompOp comp;
+  AttrType type;
+  int int_value;
+  float float_value;
+  const char *right_field_name;  // 不为空时和另一个字段比较
+};
+
+static RC init_filters(Table &table, const std::vector<TestCondition> &test_conditions,
+                       std::vector<DefaultConditionFilter *> &filters)
+{
+  for (const TestCondition &test_condition : test_conditions) {
+    Condition condition;
+    memset(&condition, 0, sizeof(condition));
+    condition.comp = test_condition.comp;
+    condition.left_is_attr = 1;
+    condition.left_attr.attribute_name = (char *)test_condition.field_name;
+    condition.right_is_attr = test_condition.right_field_name != nullptr;
+    condition.right_attr.attribute_name = (char *)test_condition.right_field_name;
+    condition.right_value.type = test_condition.type;
+    condition.right_value.data =
+        test_condition.type == INTS ? (void *)&test_condition.int_value : (void *)&test_condition.float_value;
+
+    DefaultConditionFilter *filter = new DefaultConditionFilter();
+    filters.push_back(filter);
+    RC rc = filter->init(table, condition);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+static void add_functions(AttrFunction &attr_function)
+{
+  attr_function.add_function_type("*", FuncType::COUNT, nullptr);
+  for (const char *field_name : {"a", "f"}) {
+    attr_function.add_function_type(field_name, FuncType::COUNT, nullptr);
+    attr_function.add_function_type(field_name, FuncType::MIN, nullptr);
+    attr_function.add_function_type(field_name, FuncType::MAX, nullptr);
+    attr_function.add_function_type(field_name, FuncType::AVG, nullptr);
+  }
+}
+
+static void add_record_to_tuple_set(const char *data, void *context)
+{
+  TupleRecordConverter *converter = (TupleRecordConverter *)context;
+  converter->add_record(data);
+}
+
+// 逐行扫描，在元组上用聚合节点计算
+static std::string row_aggregation(Table &table, std::vector<DefaultConditionFilter *> &filters)
+{
+  TupleSchema schema;
+  TupleSchema::from_table(&table, schema);
+  TupleSet tuple_set;
+  tuple_set.set_schema(schema);
+  TupleRecordConverter converter(&table, tuple_set);
+
+  CompositeConditionFilter filter;
+  filter.init((const ConditionFilter **)filters.data(), filters.size());
+  EXPECT_EQ(RC::SUCCESS, table.scan_record(nullptr, &filter, -1, &converter, add_record_to_tuple_set));
+
+  AttrFunction attr_function;
+  add_functions(attr_function);
+  std::vector<AggregateSpec> specs;
+  for (int j = attr_function.get_size() - 1; j >= 0; --j) {
+    const char *attr_name = attr_function.get_attr_name(j);
+    int index = 0 == strcmp(attr_name, "*") ? -1 : schema.index_of_field(attr_name);
+    specs.push_back({attr_function.get_function_type(j), index, attr_function.to_string(j, 1)});
+  }
+  TupleSetScanExeNode scan_node;
+  scan_node.init(&tuple_set);
+  AggregateExeNode aggregate_node;
+  EXPECT_EQ(RC::SUCCESS, aggregate_node.init(&scan_node, {}, specs));
+  TupleSet result;
+  EXPECT_EQ(RC::SUCCESS, aggregate_node.execute(result));
+  std::stringstream ss;
+  result.print(ss);
+  return ss.str();
+}
+
+// 和do_column_aggregation一样按批扫描、按列计算
+static std::string column_aggregation(Table &table, std::vector<DefaultConditionFilter *> &filters)
+{
+  AttrFunction attr_function;
+  add_functions(attr_function);
+  std::vector<const FieldMeta *> fields = {table.table_meta().field("a"), table.table_meta().field("f")};
+  ColumnAggregator aggregator;
+  for (int j = attr_function.get_size() - 1; j >= 0; --j) {
+    const char *attr_name = attr_function.get_attr_name(j);
+    if (0 == strcmp(attr_name, "*")) {
+      aggregator.add(FuncType::COUNT, -1, INTS);
+    } else {
+      int column = 0 == strcmp(attr_name, "a") ? 0 : 1;
+      aggregator.add(attr_function.get_function_type(j), column, fields[column]->type());
+    }
+  }
+
+  ColumnScanExeNode scan_node;
+  EXPECT_EQ(RC::SUCCESS, scan_node.init(nullptr, &table, filters, fields));
+  ColumnBatch batch;
+  scan_node.init_batch(batch);
+  RC rc = scan_node.open();
+  while (rc == RC::SUCCESS && (rc = scan_node.next_batch(batch)) == RC::SUCCESS) {
+    aggregator.update(batch);
+  }
+  scan_node.close();
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+
+  TupleSchema schema;
+  Tuple tuple;
+  for (int j = attr_function.get_size() - 1, index = 0; j >= 0; --j, ++index) {
+    AttrType type = aggregator.output(index, tuple);
+    schema.add_if_not_exists(type, "", attr_function.to_string(j, 1).c_str());
+  }
+  TupleSet result;
+  result.set_schema(schema);
+  result.add(std::move(tuple));
+  std::stringstream ss;
+  result.print(ss);
+  return ss.str();
+}
+
+static void check_aggregation(Table &table, const std::vector<TestCondition> &test_conditions)
+{
+  std::vector<DefaultConditionFilter *> filters;
+  ASSERT_EQ(RC::SUCCESS, init_filters(table, test_conditions, filters));
+  std::string expected = row_aggregation(table, filters);
+  std::string result = column_aggregation(table, filters);
+  for (DefaultConditionFilter *filter : filters) {
+    delete filter;
+  }
+  ASSERT_EQ(expected, result);
+}
+
+TEST(test_column_batch, test_column_aggregation)
+{
+  const char *table_name = "column_batch_t";
+  Table table;
+  create_table(table, table_name);
+
+  // 没有条件
+  check_aggregation(table, {});
+  // 按列过滤的整数、浮点数条件，NULL不满足任何比较
+  check_aggregation(table, {{"a", GREAT_THAN, INTS, 100, 0}});
+  check_aggregation(table, {{"a", NOT_EQUAL, INTS, 3, 0}});
+  check_aggregation(table, {{"f", LESS_EQUAL, FLOATS, 0, 10.5f}});
+  check_aggregation(table, {{"f", EQUAL_TO, FLOATS, 0, 1.25f}});
+  check_aggregation(table, {{"a", GREAT_EQUAL, INTS, -200, 0}, {"f", GREAT_THAN, FLOATS, 0, 0}, {"b", LESS_THAN, INTS, 2500, 0}});
+  // 两个字段之间的比较，逐行过滤
+  check_aggregation(table, {{"a", LESS_THAN, INTS, 0, 0, "b"}, {"f", GREAT_THAN, FLOATS, 0, 20}});
+  // 没有满足条件的行，COUNT是0，其余都是NULL
+  check_aggregation(table, {{"b", LESS_THAN, INTS, 0, 0}});
+  // 只剩第一行，a、f都是NULL
+  check_aggregation(table, {{"b", EQUAL_TO, INTS, 0, 0}});
+  // 用到索引时所有条件都在存储层逐行判断
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_b", "b", 0));
+  check_aggregation(table, {{"b", EQUAL_TO, INTS, 77, 0}});
+  check_aggregation(table, {{"b", LESS_THAN, INTS, 100, 0}, {"a", GREAT_THAN, INTS, 0, 0}});
+
+  remove_table(table_name);
+}
+
+// MIN跳过NULL：第一行和中间的NULL都不能成为最小值
+TEST(test_column_batch, test_min_skips_null)
+{
+  const char *table_name = "column_batch_min_t";
+  Table table;
+  create_table(table, table_name);
+
+  int min_a = 0;
+  bool found = false;
+  for (int i = 0; i < ROW_NUM; i++) {
+    int a = (i * 37) % 1000 - 500;
+    if (i % 7 != 0 && (!found || a < min_a)) {
+      min_a = a;
+      found = true;
+    }
+  }
+
+  std::vector<DefaultConditionFilter *> filters;
+  std::string result = column_aggregation(table, filters);
+  ASSERT_EQ(row_aggregation(table, filters), result);
+  ASSERT_NE(std::string::npos, result.find(" | " + std::to_string(min_a) + " | "));
+
+  remove_table(table_name);
+}
+
+// 扫描全表时只用record_filter过滤，选中索引时用全部条件过滤
+TEST(test_column_batch, test_scanner_record_filter)
+{
+  const char *table_name = "column_batch_scanner_t";
+  Table table;
+  create_table(table, table_name);
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_b", "b", 0));
+
+  // 过滤器引用条件中的值，条件要一直保留到扫描结束
+  std::vector<TestCondition> test_conditions = {{"a", GREAT_THAN, INTS, 100, 0}, {"b", EQUAL_TO, INTS, 5, 0}};
+  std::vector<DefaultConditionFilter *> filters;
+  ASSERT_EQ(RC::SUCCESS, init_filters(table, test_conditions, filters));
+  CompositeConditionFilter no_filter;
+  no_filter.init(nullptr, 0);
+  const char *field_names[3] = {"a", "f", "b"};
+
+  TableScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, scanner.open(&table, nullptr, filters[0], &no_filter, field_names, 3));
+  ASSERT_FALSE(scanner.uses_index());
+  Record record;
+  int count = 0;
+  while (scanner.next(record) == RC::SUCCESS) {
+    count++;
+  }
+  ASSERT_EQ(ROW_NUM, count);
+
+  ASSERT_EQ(RC::SUCCESS, scanner.open(&table, nullptr, filters[1], &no_filter, field_names, 3));
+  ASSERT_TRUE(scanner.uses_index());
+  count = 0;
+  while (scanner.next(record) == RC::SUCCESS) {
+    count++;
+  }
+  ASSERT_EQ(1, count);
+  scanner.close();
+  for (DefaultConditionFilter *filter : filters) {
+    delete filter;
+  }
+
+  remove_table(table_name);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
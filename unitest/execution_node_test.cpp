@@ -0,0 +1,724 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sql/executor/execution_node.h"
+#include "storage/common/meta_util.h"
+#include "gtest/gtest.h"
+
+// 返回负数表示NULL
+using KeyFunc = std::function<int(int)>;
+using FloatFunc = std::function<float(int)>;
+
+// 表relation(id int, k int null, f float null)，id是行号，k由key_of决定，f由k算出，k是NULL时f也是NULL
+static TupleSet make_tuple_set(const char *relation, int row_num, KeyFunc key_of,
+                               FloatFunc float_of = [](int k) { return k * 0.1f; })
+{
+  TupleSchema schema;
+  schema.add(INTS, relation, "id", false);
+  schema.add(INTS, relation, "k", true);
+  schema.add(FLOATS, relation, "f", true);
+  TupleSet tuple_set;
+  tuple_set.set_schema(schema);
+  for (int i = 0; i < row_num; i++) {
+    int k = key_of(i);
+    Tuple tuple;
+    tuple.add(i);
+    tuple.add(k < 0 ? 0 : k, k < 0);
+    tuple.add(k < 0 ? 0.0f : float_of(k), k < 0);
+    tuple_set.add(std::move(tuple));
+  }
+  return tuple_set;
+}
+
+struct TestCondition {
+  const char *left_relation;
+  const char *left_field;
+  CompOp comp;
+  const char *right_relation;
+  const char *right_field;
+};
+
+static void init_selects(Selects &selects, const std::vector<TestCondition> &test_conditions)
+{
+  memset(&selects, 0, sizeof(selects));
+  for (const TestCondition &test_condition : test_conditions) {
+    Condition &condition = selects.conditions[selects.condition_num++];
+    condition.left_is_attr = 1;
+    condition.left_attr.relation_name = (char *)test_condition.left_relation;
+    condition.left_attr.attribute_name = (char *)test_condition.left_field;
+    condition.comp = test_condition.comp;
+    condition.right_is_attr = 1;
+    condition.right_attr.relation_name = (char *)test_condition.right_relation;
+    condition.right_attr.attribute_name = (char *)test_condition.right_field;
+  }
+}
+
+// 左侧在外层的嵌套循环，逐个检查两侧都有的字段上的条件，NULL不满足任何比较
+static TupleSet nested_loop_join(const TupleSet &left, const TupleSet &right,
+                                 const std::vector<TestCondition> &test_conditions)
+{
+  TupleSchema schema;
+  schema.append(left.get_schema());
+  schema.append(right.get_schema());
+  TupleSet result;
+  result.set_schema(schema);
+  for (const Tuple &left_tuple : left.tuples()) {
+    for (const Tuple &right_tuple : right.tuples()) {
+      Tuple tuple(left_tuple);
+      tuple.merge(right_tuple);
+      bool matched = true;
+      for (const TestCondition &condition : test_conditions) {
+        int left_index = schema.index_of_field(condition.left_relation, condition.left_field);
+        int right_index = schema.index_of_field(condition.right_relation, condition.right_field);
+        if (left_index < 0 || right_index < 0) {
+          continue;
+        }
+        const TupleValue &left_value = tuple.get(left_index);
+        const TupleValue &right_value = tuple.get(right_index);
+        if (left_value.is_null() || right_value.is_null() || !valueCompare(&left_value, &right_value, condition.comp)) {
+          matched = false;
+          break;
+        }
+      }
+      if (matched) {
+        result.add(std::move(tuple));
+      }
+    }
+  }
+  return result;
+}
+
+static std::string to_string(const TupleSet &tuple_set)
+{
+  std::stringstream ss;
+  tuple_set.print(ss, true);
+  return ss.str();
+}
+
+static TupleSet hash_join(const TupleSet &left, const TupleSet &right, const std::vector<TestCondition> &test_conditions,
+                          const char *expected_name)
+{
+  Selects selects;
+  init_selects(selects, test_conditions);
+  HashJoinExeNode join_node;
+  EXPECT_EQ(RC::SUCCESS, join_node.init(left, right, selects));
+  EXPECT_STREQ(expected_name, join_node.name());
+  TupleSet result;
+  EXPECT_EQ(RC::SUCCESS, join_node.execute(result));
+  return result;
+}
+
+static void check_hash_join(const TupleSet &left, const TupleSet &right, const std::vector<TestCondition> &test_conditions,
+                            const char *expected_name = "Hash join")
+{
+  TupleSet expected = nested_loop_join(left, right, test_conditions);
+  TupleSet result = hash_join(left, right, test_conditions, expected_name);
+  ASSERT_EQ(to_string(expected), to_string(result));
+}
+
+// 行数少的一侧建哈希表。在左侧建表时按右侧探测，输出仍然要恢复成左侧在外层的顺序
+TEST(test_hash_join, test_build_smaller_side)
+{
+  TupleSet small = make_tuple_set("s", 40, [](int i) { return i % 13; });
+  TupleSet large = make_tuple_set("l", 500, [](int i) { return (i * 7) % 29; });
+  check_hash_join(small, large, {{"s", "k", EQUAL_TO, "l", "k"}});
+  check_hash_join(large, small, {{"l", "k", EQUAL_TO, "s", "k"}});
+  // 条件写成 右侧字段 = 左侧字段 也一样
+  check_hash_join(small, large, {{"l", "k", EQUAL_TO, "s", "k"}});
+  // 连接键以外的条件在拼接前检查
+  check_hash_join(large, small, {{"l", "k", EQUAL_TO, "s", "k"}, {"l", "id", LESS_THAN, "s", "id"}});
+}
+
+// 两侧的键都有大量重复，每一对键相同的行都要输出
+TEST(test_hash_join, test_duplicate_keys)
+{
+  TupleSet left = make_tuple_set("a", 60, [](int i) { return i % 3; });
+  TupleSet right = make_tuple_set("b", 45, [](int i) { return i % 5; });
+  TupleSet result = hash_join(left, right, {{"a", "k", EQUAL_TO, "b", "k"}}, "Hash join");
+  // 键0、1、2在左侧各20行，在右侧各9行
+  ASSERT_EQ(3 * 20 * 9, result.size());
+  check_hash_join(left, right, {{"a", "k", EQUAL_TO, "b", "k"}});
+}
+
+// NULL和任何值都不相等，包括另一侧的NULL和存储的值同样是0的键
+TEST(test_hash_join, test_null_keys)
+{
+  TupleSet left = make_tuple_set("a", 30, [](int i) { return i % 3 == 0 ? -1 : i % 4; });
+  TupleSet right = make_tuple_set("b", 20, [](int i) { return i % 2 == 0 ? -1 : (i / 2) % 4; });
+  TupleSet result = hash_join(left, right, {{"a", "k", EQUAL_TO, "b", "k"}}, "Hash join");
+  ASSERT_LT(0, result.size());
+  for (const Tuple &tuple : result.tuples()) {
+    ASSERT_FALSE(tuple.get(1).is_null());
+    ASSERT_FALSE(tuple.get(4).is_null());
+  }
+  check_hash_join(left, right, {{"a", "k", EQUAL_TO, "b", "k"}});
+  check_hash_join(right, left, {{"a", "k", EQUAL_TO, "b", "k"}});
+
+  // 只有NULL键的一侧没有任何输出
+  TupleSet all_null = make_tuple_set("c", 10, [](int i) { return -1; });
+  ASSERT_EQ(0, hash_join(left, all_null, {{"a", "k", EQUAL_TO, "c", "k"}}, "Hash join").size());
+  // 非等值条件中的NULL同样不满足
+  check_hash_join(left, right, {{"a", "k", EQUAL_TO, "b", "k"}, {"a", "f", LESS_EQUAL, "b", "f"}});
+  check_hash_join(left, right, {{"a", "k", NOT_EQUAL, "b", "k"}}, "Nested loop join");
+}
+
+// 浮点数按误差判断相等，哈希值可能不同，不能作为连接键，退化为嵌套循环
+TEST(test_hash_join, test_float_key_fallback)
+{
+  TupleSet left = make_tuple_set("a", 50, [](int i) { return i % 10; });
+  // 右侧的f用另一种算法得到，和左侧的值在误差内相等，但二进制表示不一定相同
+  FloatFunc float_of = [](int k) { return k * 0.3f / 3; };
+  TupleSet right = make_tuple_set("b", 30, [](int i) { return i % 10 == 9 ? -1 : i % 10; }, float_of);
+  bool has_different_bits = false;
+  for (int k = 0; k < 10; k++) {
+    has_different_bits = has_different_bits || float_of(k) != k * 0.1f;
+  }
+  ASSERT_TRUE(has_different_bits);
+
+  TupleSet result = hash_join(left, right, {{"a", "f", EQUAL_TO, "b", "f"}}, "Nested loop join");
+  // 左侧每个k有5行，右侧k为0到8时各3行
+  ASSERT_EQ(9 * 5 * 3, result.size());
+  check_hash_join(left, right, {{"a", "f", EQUAL_TO, "b", "f"}}, "Nested loop join");
+  // 同时有整数等值条件时，用整数键建哈希表，浮点数条件逐行检查
+  check_hash_join(left, right, {{"a", "f", EQUAL_TO, "b", "f"}, {"a", "k", EQUAL_TO, "b", "k"}});
+}
+
+// 多表连接把上一次的结果作为下一次的左侧，列和行的顺序都和依次嵌套的循环相同
+TEST(test_hash_join, test_three_way_chain)
+{
+  TupleSet a = make_tuple_set("a", 80, [](int i) { return i % 11; });
+  TupleSet b = make_tuple_set("b", 30, [](int i) { return i % 7 == 6 ? -1 : i % 11; });
+  TupleSet c = make_tuple_set("c", 200, [](int i) { return i % 30; });
+  std::vector<TestCondition> conditions = {
+      {"a", "k", EQUAL_TO, "b", "k"}, {"c", "k", EQUAL_TO, "b", "id"}, {"a", "id", GREAT_THAN, "c", "id"}};
+
+  TupleSet ab = hash_join(a, b, conditions, "Hash join");
+  TupleSet abc = hash_join(ab, c, conditions, "Hash join");
+  TupleSet expected = nested_loop_join(nested_loop_join(a, b, conditions), c, conditions);
+  ASSERT_LT(0, expected.size());
+  ASSERT_EQ(to_string(expected), to_string(abc));
+  ASSERT_EQ(9, abc.get_schema().size());
+  ASSERT_STREQ("c", abc.get_schema().field(6).table_name());
+}
+
+// 左侧分批输入时哈希表总在右侧建，各批的输出拼起来和整体连接相同
+TEST(test_hash_join, test_keep_right_table)
+{
+  TupleSet left = make_tuple_set("a", 100, [](int i) { return i % 9 == 0 ? -1 : i % 17; });
+  TupleSet right = make_tuple_set("b", 400, [](int i) { return i % 23; });
+  std::vector<TestCondition> conditions = {{"a", "k", EQUAL_TO, "b", "k"}};
+  Selects selects;
+  init_selects(selects, conditions);
+
+  // 和StreamJoinExeNode一样，节点只初始化一次，之后每批替换左侧TupleSet中的元组
+  TupleSet expected = nested_loop_join(left, right, conditions);
+  TupleSet result(expected.get_schema());
+  TupleSet batch(left.get_schema());
+  HashJoinExeNode join_node;
+  ASSERT_EQ(RC::SUCCESS, join_node.init(batch, right, selects));
+  join_node.keep_right_table();
+  for (int begin = 0; begin < left.size(); begin += 30) {
+    batch.clear_tuples();
+    for (int i = begin; i < begin + 30 && i < left.size(); i++) {
+      batch.add(Tuple(left.get(i)));
+    }
+    TupleSet output;
+    ASSERT_EQ(RC::SUCCESS, join_node.execute(output));
+    for (Tuple &tuple : output.release_tuples()) {
+      result.add(std::move(tuple));
+    }
+  }
+  ASSERT_EQ(to_string(expected), to_string(result));
+}
+
+static TupleSet sort_merge_join(const TupleSet &left, const TupleSet &right,
+                                const std::vector<TestCondition> &test_conditions, const char *expected_name,
+                                bool expected_ordered)
+{
+  Selects selects;
+  init_selects(selects, test_conditions);
+  SortMergeJoinExeNode join_node;
+  EXPECT_EQ(RC::SUCCESS, join_node.init(left, right, selects));
+  EXPECT_STREQ(expected_name, join_node.name());
+  EXPECT_EQ(expected_ordered, join_node.inputs_ordered());
+  TupleSet result;
+  EXPECT_EQ(RC::SUCCESS, join_node.execute(result));
+  return result;
+}
+
+static void check_sort_merge_join(const TupleSet &left, const TupleSet &right,
+                                  const std::vector<TestCondition> &test_conditions, const char *expected_name,
+                                  bool expected_ordered = false)
+{
+  TupleSet expected = nested_loop_join(left, right, test_conditions);
+  TupleSet result = sort_merge_join(left, right, test_conditions, expected_name, expected_ordered);
+  ASSERT_EQ(to_string(expected), to_string(result));
+}
+
+// 两侧都已经按键有序(NULL可以出现在任意位置)时不再排序，有一侧无序时排序后归并
+TEST(test_sort_merge_join, test_ordered_detection)
+{
+  TupleSet sorted_left = make_tuple_set("a", 90, [](int i) { return i % 10 == 3 ? -1 : i / 4; });
+  TupleSet sorted_right = make_tuple_set("b", 70, [](int i) { return i % 9 == 0 ? -1 : i / 3; });
+  TupleSet unsorted_right = make_tuple_set("b", 70, [](int i) { return (i * 11) % 23; });
+  std::vector<TestCondition> conditions = {{"a", "k", EQUAL_TO, "b", "k"}};
+  check_sort_merge_join(sorted_left, sorted_right, conditions, "Sort merge join", true);
+  check_sort_merge_join(sorted_left, unsorted_right, conditions, "Sort merge join", false);
+  check_sort_merge_join(unsorted_right, sorted_left, {{"b", "k", EQUAL_TO, "a", "k"}}, "Sort merge join", false);
+
+  // 只有最后一行破坏顺序
+  TupleSet almost_sorted = make_tuple_set("b", 50, [](int i) { return i == 49 ? 0 : i / 2; });
+  check_sort_merge_join(sorted_left, almost_sorted, conditions, "Sort merge join", false);
+  // 两侧都是空表
+  TupleSet empty = make_tuple_set("b", 0, [](int i) { return i; });
+  check_sort_merge_join(sorted_left, empty, conditions, "Sort merge join", true);
+}
+
+// 两侧都有键相同的行，每一对都要输出，输出仍是左侧在外层、右侧保持原来顺序
+TEST(test_sort_merge_join, test_duplicate_runs)
+{
+  TupleSet left = make_tuple_set("a", 120, [](int i) { return (i * 7) % 6; });
+  TupleSet right = make_tuple_set("b", 80, [](int i) { return (i * 5) % 8; });
+  std::vector<TestCondition> conditions = {{"a", "k", EQUAL_TO, "b", "k"}};
+  TupleSet result = sort_merge_join(left, right, conditions, "Sort merge join", false);
+  // 键0到5在左侧各20行，在右侧各10行
+  ASSERT_EQ(6 * 20 * 10, result.size());
+  check_sort_merge_join(left, right, conditions, "Sort merge join");
+  // 连接键以外的条件在每一对键相同的行上检查
+  check_sort_merge_join(left, right, {{"a", "k", EQUAL_TO, "b", "k"}, {"a", "id", GREAT_EQUAL, "b", "id"}},
+                        "Sort merge join");
+  // 多个连接键
+  check_sort_merge_join(left, right, {{"a", "k", EQUAL_TO, "b", "k"}, {"b", "id", EQUAL_TO, "a", "k"}},
+                        "Sort merge join");
+}
+
+TEST(test_sort_merge_join, test_null_keys)
+{
+  TupleSet left = make_tuple_set("a", 40, [](int i) { return i % 3 == 0 ? -1 : i % 5; });
+  TupleSet right = make_tuple_set("b", 30, [](int i) { return i % 2 == 0 ? -1 : (i / 2) % 5; });
+  std::vector<TestCondition> conditions = {{"a", "k", EQUAL_TO, "b", "k"}};
+  TupleSet result = sort_merge_join(left, right, conditions, "Sort merge join", false);
+  ASSERT_LT(0, result.size());
+  for (const Tuple &tuple : result.tuples()) {
+    ASSERT_FALSE(tuple.get(1).is_null());
+    ASSERT_FALSE(tuple.get(4).is_null());
+  }
+  check_sort_merge_join(left, right, conditions, "Sort merge join");
+  TupleSet all_null = make_tuple_set("b", 10, [](int i) { return -1; });
+  ASSERT_EQ(0, sort_merge_join(left, all_null, conditions, "Sort merge join", false).size());
+}
+
+// 只有范围条件时在右侧二分查找匹配的区间，边界上有很多值相同的行，条件可以写在任意一侧
+TEST(test_sort_merge_join, test_range_join)
+{
+  TupleSet left = make_tuple_set("a", 60, [](int i) { return i % 8 == 0 ? -1 : (i * 3) % 13; });
+  TupleSet sorted_right = make_tuple_set("b", 50, [](int i) { return i % 7 == 0 ? -1 : i / 4; });
+  TupleSet unsorted_right = make_tuple_set("b", 50, [](int i) { return i % 7 == 0 ? -1 : (i * 9) % 14; });
+  for (CompOp comp : {LESS_THAN, LESS_EQUAL, GREAT_THAN, GREAT_EQUAL}) {
+    for (const TupleSet *right : {&sorted_right, &unsorted_right}) {
+      check_sort_merge_join(left, *right, {{"a", "k", comp, "b", "k"}}, "Sort merge range join");
+      check_sort_merge_join(left, *right, {{"b", "k", comp, "a", "k"}}, "Sort merge range join");
+      check_sort_merge_join(left, *right, {{"a", "f", comp, "b", "f"}}, "Sort merge range join");
+      // 只有一个条件用来二分查找，其它条件逐行检查
+      check_sort_merge_join(left, *right, {{"a", "k", comp, "b", "k"}, {"a", "id", NOT_EQUAL, "b", "k"}},
+                            "Sort merge range join");
+    }
+  }
+}
+
+#define INNER_ROW_NUM 4000
+#define INNER_KEY_NUM 300
+
+static void remove_table(const char *table_name)
+{
+  unlink(table_meta_file(".", table_name).c_str());
+  unlink((std::string("./") + table_name + TABLE_DATA_SUFFIX).c_str());
+  unlink(index_data_file(".", table_name, "i_k").c_str());
+}
+
+// 内表(id int, k int null, v int, s char(200))，k上有索引。k是NULL的行也在索引中，查找时不能返回。
+// 每行200多个字节，全表有上百个页面，少量键的查找比扫描划算
+static void create_inner_table(Table &table, const char *table_name)
+{
+  remove_table(table_name);
+  AttrInfo attrs[4];
+  const char *names[4] = {"id", "k", "v", "s"};
+  AttrType types[4] = {INTS, INTS, INTS, CHARS};
+  for (int i = 0; i < 4; i++) {
+    attrs[i].name = (char *)names[i];
+    attrs[i].type = types[i];
+    attrs[i].length = i == 3 ? 200 : 4;
+    attrs[i].is_nullable = i == 1;
+  }
+  ASSERT_EQ(RC::SUCCESS, table.create(table_meta_file(".", table_name).c_str(), table_name, ".", 4, attrs));
+  for (int i = 0; i < INNER_ROW_NUM; i++) {
+    int id = i;
+    int k = (i * 7) % INNER_KEY_NUM;
+    int v = i % 10;
+    Value values[4];
+    values[0] = {INTS, &id, 0};
+    values[1] = {INTS, &k, i % 13 == 0};
+    values[2] = {INTS, &v, 0};
+    values[3] = {CHARS, (void *)"row", 0};
+    ASSERT_EQ(RC::SUCCESS, table.insert_record(nullptr, 4, values));
+  }
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_k", "k", 0));
+}
+
+// 内表自己的过滤条件 v >= min_v。过滤器引用条件中的值，min_v要一直保留到连接结束
+static void init_inner_node(SelectExeNode &inner, Table &table, const int *min_v)
+{
+  std::vector<DefaultConditionFilter *> filters;
+  if (min_v != nullptr) {
+    Condition condition;
+    memset(&condition, 0, sizeof(condition));
+    condition.left_is_attr = 1;
+    condition.left_attr.attribute_name = (char *)"v";
+    condition.comp = GREAT_EQUAL;
+    condition.right_value.type = INTS;
+    condition.right_value.data = (void *)min_v;
+    DefaultConditionFilter *filter = new DefaultConditionFilter();
+    ASSERT_EQ(RC::SUCCESS, filter->init(table, condition));
+    filters.push_back(filter);
+  }
+  TupleSchema schema;
+  TupleSchema::from_table(&table, schema);
+  ASSERT_EQ(RC::SUCCESS, inner.init(nullptr, &table, std::move(schema), std::move(filters)));
+}
+
+// 外表的键无序、有重复、有NULL，也有内表中不存在的键
+static int outer_key(int i)
+{
+  return i % 5 == 4 ? -1 : (i * 37 + 11) % (INNER_KEY_NUM + 20);
+}
+
+// 逐键查找只返回满足内表条件、键相等的记录，NULL键的记录不会被查到
+TEST(test_index_nested_loop_join, test_scan_record_by_key)
+{
+  const char *table_name = "inlj_lookup_t";
+  Table table;
+  create_inner_table(table, table_name);
+  const int min_v = 5;
+  SelectExeNode inner;
+  init_inner_node(inner, table, &min_v);
+
+  for (int k : {0, 7, INNER_KEY_NUM - 1, INNER_KEY_NUM + 5}) {
+    TupleSet tuple_set(inner.schema());
+    ASSERT_EQ(RC::SUCCESS, inner.execute_by_key("k", (const char *)&k, tuple_set));
+    int expected = 0;
+    for (int i = 0; i < INNER_ROW_NUM; i++) {
+      expected += i % 13 != 0 && (i * 7) % INNER_KEY_NUM == k && i % 10 >= min_v;
+    }
+    ASSERT_EQ(expected, tuple_set.size()) << "k=" << k;
+    for (const Tuple &tuple : tuple_set.tuples()) {
+      ASSERT_EQ(k, static_cast<const IntValue &>(tuple.get(1)).get_value());
+      ASSERT_FALSE(tuple.get(1).is_null());
+      ASSERT_LE(min_v, static_cast<const IntValue &>(tuple.get(2)).get_value());
+    }
+  }
+
+  ASSERT_TRUE(table.is_key_lookup_cheaper("k", 5));
+  ASSERT_FALSE(table.is_key_lookup_cheaper("k", INNER_KEY_NUM));
+  ASSERT_FALSE(table.is_key_lookup_cheaper("v", 1));
+  remove_table(table_name);
+}
+
+// 查找的结果和扫描内表后嵌套循环的结果相同，输出按外表的顺序，内表的条件和批过滤都生效
+TEST(test_index_nested_loop_join, test_lookup_join)
+{
+  const char *table_name = "inlj_join_t";
+  Table table;
+  create_inner_table(table, table_name);
+  const int min_v = 3;
+  SelectExeNode inner;
+  init_inner_node(inner, table, &min_v);
+  // 存储层不能判断的条件，在查到的元组上检查
+  inner.add_batch_filter([](TupleSet &tuple_set) {
+    std::vector<Tuple> tuples = tuple_set.release_tuples();
+    for (Tuple &tuple : tuples) {
+      if (static_cast<const IntValue &>(tuple.get(0)).get_value() % 3 != 0) {
+        tuple_set.add(std::move(tuple));
+      }
+    }
+    return RC::SUCCESS;
+  });
+
+  TupleSet outer = make_tuple_set("o", 12, outer_key);
+  std::vector<TestCondition> conditions = {{"o", "k", EQUAL_TO, table_name, "k"}, {"o", "id", LESS_EQUAL, table_name, "v"}};
+  Selects selects;
+  init_selects(selects, conditions);
+
+  IndexNestedLoopJoinExeNode join_node;
+  ASSERT_EQ(RC::SUCCESS, join_node.init(outer, inner, selects));
+  ASSERT_TRUE(join_node.can_lookup());
+  TupleSet result;
+  ASSERT_EQ(RC::SUCCESS, join_node.execute(result));
+
+  TupleSet inner_set;
+  ASSERT_EQ(RC::SUCCESS, inner.execute(inner_set));
+  TupleSet expected = nested_loop_join(outer, inner_set, conditions);
+  ASSERT_LT(0, expected.size());
+  ASSERT_EQ(to_string(expected), to_string(result));
+
+  // 没有条件时内表的行更多，说明上面的结果确实经过了过滤
+  SelectExeNode unfiltered;
+  init_inner_node(unfiltered, table, nullptr);
+  TupleSet unfiltered_set;
+  ASSERT_EQ(RC::SUCCESS, unfiltered.execute(unfiltered_set));
+  ASSERT_LT(expected.size(), nested_loop_join(outer, unfiltered_set, conditions).size());
+  remove_table(table_name);
+}
+
+// 不同的键太多时查找不划算，StreamJoinExeNode改为扫描内表做哈希或归并连接，结果相同
+TEST(test_index_nested_loop_join, test_fallback)
+{
+  const char *table_name = "inlj_fallback_t";
+  Table table;
+  create_inner_table(table, table_name);
+  const int min_v = 2;
+  std::vector<TestCondition> conditions = {{"o", "k", EQUAL_TO, table_name, "k"}};
+  Selects selects;
+  init_selects(selects, conditions);
+
+  for (int outer_num : {12, 600}) {
+    TupleSet outer = make_tuple_set("o", outer_num, outer_key);
+    SelectExeNode inner;
+    init_inner_node(inner, table, &min_v);
+    IndexNestedLoopJoinExeNode join_node;
+    ASSERT_EQ(RC::SUCCESS, join_node.init(outer, inner, selects));
+    ASSERT_EQ(outer_num == 12, join_node.can_lookup());
+    if (!join_node.can_lookup()) {
+      TupleSet output;
+      ASSERT_NE(RC::SUCCESS, join_node.execute(output));
+    }
+
+    TupleSetScanExeNode outer_node;
+    outer_node.init(&outer);
+    StreamJoinExeNode stream_node;
+    ASSERT_EQ(RC::SUCCESS, stream_node.init(&outer_node, &inner, true, &selects));
+    TupleSet result;
+    ASSERT_EQ(RC::SUCCESS, stream_node.execute(result));
+
+    TupleSet inner_set;
+    ASSERT_EQ(RC::SUCCESS, inner.execute(inner_set));
+    TupleSet expected = nested_loop_join(outer, inner_set, conditions);
+    ASSERT_LT(0, expected.size());
+    ASSERT_EQ(to_string(expected), to_string(result)) << "outer_num=" << outer_num;
+  }
+  remove_table(table_name);
+}
+
+// 记录从子节点拉取了多少个元组
+class CountingExeNode : public ExecutionNode {
+public:
+  explicit CountingExeNode(ExecutionNode *child) : child_(child) {
+  }
+  RC execute(TupleSet &tuple_set) override {
+    return child_->execute(tuple_set);
+  }
+  const TupleSchema &schema() const override {
+    return child_->schema();
+  }
+  RC open() override {
+    pulled_ = 0;
+    return child_->open();
+  }
+  RC next(Tuple &tuple) override {
+    RC rc = child_->next(tuple);
+    if (rc == RC::SUCCESS) {
+      pulled_++;
+    }
+    return rc;
+  }
+  void close() override {
+    child_->close();
+  }
+  int pulled() const {
+    return pulled_;
+  }
+
+private:
+  ExecutionNode *child_;
+  int pulled_ = 0;
+};
+
+static int group_key(int i)
+{
+  return i % 9 == 0 ? -1 : (i * 5) % 7;
+}
+
+// 按k分组，NULL是单独的一组，分组按第一次出现的顺序输出
+TEST(test_operator_nodes, test_aggregate)
+{
+  const int row_num = 200;
+  TupleSet input = make_tuple_set("t", row_num, group_key, [](int k) { return k == 3 ? -1.0f : k * 0.5f; });
+  TupleSetScanExeNode input_node;
+  input_node.init(&input);
+  AggregateExeNode aggregate_node;
+  std::vector<AggregateSpec> specs = {{FuncType::NOFUNC, 1, "k"},
+                                      {FuncType::COUNT, -1, "count(*)"},
+                                      {FuncType::MAX, 0, "max(id)"},
+                                      {FuncType::MIN, 2, "min(f)"}};
+  ASSERT_EQ(RC::SUCCESS, aggregate_node.init(&input_node, {1}, specs));
+  TupleSet result;
+  ASSERT_EQ(RC::SUCCESS, aggregate_node.execute(result));
+  ASSERT_EQ(4, result.get_schema().size());
+
+  std::vector<int> keys;
+  for (int i = 0; i < row_num; i++) {
+    if (std::find(keys.begin(), keys.end(), group_key(i)) == keys.end()) {
+      keys.push_back(group_key(i));
+    }
+  }
+  ASSERT_EQ((int)keys.size(), result.size());
+  for (int j = 0; j < result.size(); j++) {
+    const Tuple &tuple = result.get(j);
+    int count = 0;
+    int max_id = 0;
+    for (int i = 0; i < row_num; i++) {
+      if (group_key(i) == keys[j]) {
+        count++;
+        max_id = i;
+      }
+    }
+    ASSERT_EQ(keys[j] < 0, tuple.get(0).is_null());
+    ASSERT_EQ(count, static_cast<const IntValue &>(tuple.get(1)).get_value());
+    ASSERT_EQ(max_id, static_cast<const IntValue &>(tuple.get(2)).get_value());
+    if (keys[j] < 0) {
+      // f全是NULL
+      ASSERT_STREQ("NULL", static_cast<const StringValue &>(tuple.get(3)).get_value());
+    } else {
+      float min_f = keys[j] == 3 ? -1.0f : keys[j] * 0.5f;
+      ASSERT_FLOAT_EQ(min_f, static_cast<const FloatValue &>(tuple.get(3)).get_value());
+    }
+  }
+}
+
+// 没有分组列时输入为空也输出一行，有分组列时不输出
+TEST(test_operator_nodes, test_aggregate_empty_input)
+{
+  TupleSet input = make_tuple_set("t", 0, group_key);
+  TupleSetScanExeNode input_node;
+  input_node.init(&input);
+  std::vector<AggregateSpec> specs = {
+      {FuncType::COUNT, -1, "count(*)"}, {FuncType::COUNT, 1, "count(k)"}, {FuncType::AVG, 2, "avg(f)"}};
+
+  AggregateExeNode aggregate_node;
+  ASSERT_EQ(RC::SUCCESS, aggregate_node.init(&input_node, {}, specs));
+  TupleSet result;
+  ASSERT_EQ(RC::SUCCESS, aggregate_node.execute(result));
+  std::stringstream ss;
+  result.print(ss);
+  ASSERT_EQ("count(*) | count(k) | avg(f)\n0 | 0 | NULL\n", ss.str());
+
+  AggregateExeNode group_node;
+  ASSERT_EQ(RC::SUCCESS, group_node.init(&input_node, {1}, specs));
+  ASSERT_EQ(RC::SUCCESS, group_node.execute(result));
+  ASSERT_EQ(0, result.size());
+}
+
+// 投影、排序、limit串起来和在物化的结果上逐步计算相同，排序是稳定的，NULL排在最前
+TEST(test_operator_nodes, test_project_sort_limit)
+{
+  const int row_num = 3000;
+  TupleSet input = make_tuple_set("t", row_num, [](int i) { return i % 13 == 0 ? -1 : (i * 31) % 50; });
+  TupleSetScanExeNode input_node;
+  input_node.init(&input);
+  TupleSchema project_schema;
+  project_schema.add(INTS, "t", "k", true);
+  project_schema.add(INTS, "t", "id", false);
+  ProjectExeNode project_node;
+  ASSERT_EQ(RC::SUCCESS, project_node.init(&input_node, project_schema, {1, 0}));
+  ProjectExeNode bad_project;
+  ASSERT_NE(RC::SUCCESS, bad_project.init(&input_node, project_schema, {1, 3}));
+
+  // 按k降序，k相同时保持输入的顺序
+  std::vector<int> expected_ids;
+  for (int i = 0; i < row_num; i++) {
+    expected_ids.push_back(i);
+  }
+  auto key_of = [](int i) { return i % 13 == 0 ? -1 : (i * 31) % 50; };
+  std::stable_sort(expected_ids.begin(), expected_ids.end(),
+                   [&key_of](int left, int right) { return key_of(left) > key_of(right); });
+
+  const int offset = 40;
+  const int limit = 100;
+  for (int top_n : {-1, offset + limit}) {
+    SortExeNode sort_node;
+    ASSERT_EQ(RC::SUCCESS, sort_node.init(&project_node, {{0, true}}, top_n));
+    LimitExeNode limit_node;
+    ASSERT_EQ(RC::SUCCESS, limit_node.init(&sort_node, offset, limit));
+    TupleSet result;
+    ASSERT_EQ(RC::SUCCESS, limit_node.execute(result));
+    ASSERT_EQ(2, result.get_schema().size());
+    ASSERT_STREQ("k", result.get_schema().field(0).field_name());
+    ASSERT_EQ(limit, result.size());
+    for (int i = 0; i < limit; i++) {
+      ASSERT_EQ(expected_ids[offset + i], static_cast<const IntValue &>(result.get(i).get(1)).get_value());
+    }
+  }
+
+  // 升序时NULL在最前
+  SortExeNode asc_node;
+  ASSERT_EQ(RC::SUCCESS, asc_node.init(&project_node, {{0, false}, {1, true}}, -1));
+  TupleSet sorted;
+  ASSERT_EQ(RC::SUCCESS, asc_node.execute(sorted));
+  ASSERT_EQ(row_num, sorted.size());
+  ASSERT_TRUE(sorted.get(0).get(0).is_null());
+  ASSERT_EQ((row_num - 1) / 13 * 13, static_cast<const IntValue &>(sorted.get(0).get(1)).get_value());
+}
+
+// limit输出够之后不再从子节点拉取，投影逐个元组输出，中间不物化
+TEST(test_operator_nodes, test_limit_stops_pulling)
+{
+  TupleSet input = make_tuple_set("t", 1000, [](int i) { return i; });
+  TupleSetScanExeNode input_node;
+  input_node.init(&input);
+  CountingExeNode counting_node(&input_node);
+  TupleSchema project_schema;
+  project_schema.add(INTS, "t", "id", false);
+  ProjectExeNode project_node;
+  ASSERT_EQ(RC::SUCCESS, project_node.init(&counting_node, project_schema, {0}));
+
+  LimitExeNode limit_node;
+  ASSERT_EQ(RC::SUCCESS, limit_node.init(&project_node, 5, 10));
+  TupleSet result;
+  ASSERT_EQ(RC::SUCCESS, limit_node.execute(result));
+  ASSERT_EQ(10, result.size());
+  ASSERT_EQ(5, static_cast<const IntValue &>(result.get(0).get(0)).get_value());
+  ASSERT_EQ(15, counting_node.pulled());
+
+  ASSERT_EQ(RC::SUCCESS, limit_node.open());
+  Tuple tuple;
+  ASSERT_EQ(RC::SUCCESS, limit_node.next(tuple));
+  ASSERT_EQ(6, counting_node.pulled());
+  limit_node.close();
+
+  // offset超过输入的行数
+  LimitExeNode empty_node;
+  ASSERT_EQ(RC::SUCCESS, empty_node.init(&project_node, 2000, 10));
+  ASSERT_EQ(RC::SUCCESS, empty_node.execute(result));
+  ASSERT_EQ(0, result.size());
+  ASSERT_EQ(1000, counting_node.pulled());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,145 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "storage/common/extendible_hash.h"
+#include "gtest/gtest.h"
+
+#define INSERT_NUM 20000
+
+static const char *index_name = "extendible_hash_test.index";
+
+static RID make_rid(int i)
+{
+  RID rid;
+  rid.page_num = i / 100 + 1;
+  rid.slot_num = i % 100;
+  return rid;
+}
+
+static int count_entries(ExtendibleHashHandler &handler, const char *value)
+{
+  ExtendibleHashScanner scanner(handler);
+  EXPECT_EQ(RC::SUCCESS, scanner.open({value}));
+  int count = 0;
+  RID rid;
+  while (scanner.next_entry(&rid) == RC::SUCCESS) {
+    count++;
+  }
+  scanner.close();
+  return count;
+}
+
+TEST(test_extendible_hash, test_insert_find_delete)
+{
+  ExtendibleHashHandler handler;
+  unlink(index_name);
+  AttrType attr_type[1] = {INTS};
+  int attr_length[1] = {sizeof(int)};
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, attr_type, attr_length, 1, 0));
+
+  // 插入的数量超过一个桶的容量，会触发多次分裂
+  for (int i = 0; i < INSERT_NUM; i++) {
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+  }
+  int value = 1;
+  RID rid = make_rid(1);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entry((const char *)&value, &rid));
+
+  for (int i = 0; i < INSERT_NUM; i += 97) {
+    ExtendibleHashScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open({(const char *)&i}));
+    ASSERT_EQ(RC::SUCCESS, scanner.next_entry(&rid));
+    ASSERT_EQ(make_rid(i).page_num, rid.page_num);
+    ASSERT_EQ(make_rid(i).slot_num, rid.slot_num);
+    ASSERT_EQ(i, *(const int *)scanner.current_key());
+    ASSERT_EQ(RC::RECORD_EOF, scanner.next_entry(&rid));
+  }
+  value = INSERT_NUM;
+  ASSERT_EQ(0, count_entries(handler, (const char *)&value));
+
+  for (int i = 0; i < INSERT_NUM; i += 2) {
+    RID deleted = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &deleted));
+  }
+  value = 0;
+  rid = make_rid(0);
+  ASSERT_EQ(RC::RECORD_INVALID_KEY, handler.delete_entry((const char *)&value, &rid));
+  ASSERT_EQ(0, count_entries(handler, (const char *)&value));
+  value = 1;
+  ASSERT_EQ(1, count_entries(handler, (const char *)&value));
+
+  // 重新打开后目录和桶保持不变
+  handler.close();
+  ASSERT_EQ(RC::SUCCESS, handler.open(index_name));
+  value = INSERT_NUM - 1;
+  ASSERT_EQ(1, count_entries(handler, (const char *)&value));
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_extendible_hash, test_duplicate_chars)
+{
+  ExtendibleHashHandler handler;
+  unlink(index_name);
+  AttrType attr_type[1] = {CHARS};
+  int attr_length[1] = {16};
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, attr_type, attr_length, 1, 0));
+
+  // 同一个key的索引项放不进一个桶，只能使用溢出页
+  char key[16];
+  memset(key, 0, sizeof(key));
+  strcpy(key, "session");
+  for (int i = 0; i < 1000; i++) {
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+  }
+  char other[16];
+  memset(other, 0, sizeof(other));
+  strcpy(other, "other");
+  RID rid = make_rid(1000);
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry(other, &rid));
+
+  ASSERT_EQ(1000, count_entries(handler, "session"));
+  ASSERT_EQ(1, count_entries(handler, "other"));
+  ASSERT_EQ(0, count_entries(handler, "sess"));
+
+  handler.close();
+  unlink(index_name);
+}
+
+TEST(test_extendible_hash, test_unique)
+{
+  ExtendibleHashHandler handler;
+  unlink(index_name);
+  AttrType attr_type[1] = {INTS};
+  int attr_length[1] = {sizeof(int)};
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, attr_type, attr_length, 1, 1));
+
+  int value = 7;
+  RID rid = make_rid(1);
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&value, &rid));
+  rid = make_rid(2);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entry((const char *)&value, &rid));
+
+  handler.close();
+  unlink(index_name);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,162 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "sql/executor/external_sorter.h"
+#include "gtest/gtest.h"
+
+#define ROW_NUM 2000
+
+// 列的下标
+#define K 0
+#define F 1
+#define S 2
+#define SEQ 3
+
+// 输入(k int, f float, s char, seq int)。k只有少数几个取值并且有NULL，键相同的行很多；
+// f有正负数、0和-0；s有空串和互为前缀的字符串；seq是输入的顺序
+static std::vector<Tuple> make_rows()
+{
+  const char *strings[] = {"", "a", "ab", "abc", "b", "ba", "z"};
+  std::vector<Tuple> rows;
+  for (int i = 0; i < ROW_NUM; i++) {
+    Tuple tuple;
+    tuple.add((i * 7) % 23 - 11, i % 17 == 0);
+    float f = ((i * 13) % 41 - 20) * 0.25f;
+    tuple.add(i % 41 == 5 ? -0.0f : f, i % 19 == 0);
+    const char *s = strings[(i * 3) % 7];
+    tuple.add(s, strlen(s), i % 23 == 0);
+    tuple.add(i);
+    rows.push_back(std::move(tuple));
+  }
+  return rows;
+}
+
+// NULL最小，降序时排在最后
+static int compare_value(const TupleValue &left, const TupleValue &right)
+{
+  if (left.is_null() || right.is_null()) {
+    return (int)right.is_null() - (int)left.is_null();
+  }
+  const IntValue *int_value = dynamic_cast<const IntValue *>(&left);
+  if (int_value != nullptr) {
+    int l = int_value->get_value();
+    int r = static_cast<const IntValue &>(right).get_value();
+    return l < r ? -1 : (l > r ? 1 : 0);
+  }
+  const FloatValue *float_value = dynamic_cast<const FloatValue *>(&left);
+  if (float_value != nullptr) {
+    float l = float_value->get_value();
+    float r = static_cast<const FloatValue &>(right).get_value();
+    return l < r ? -1 : (l > r ? 1 : 0);
+  }
+  return strcmp(static_cast<const StringValue &>(left).get_value(), static_cast<const StringValue &>(right).get_value());
+}
+
+// 稳定排序得到的seq列
+static std::vector<int> expected_order(const std::vector<Tuple> &rows, const std::vector<SortKey> &keys, int top_n)
+{
+  std::vector<const Tuple *> sorted;
+  for (const Tuple &row : rows) {
+    sorted.push_back(&row);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), [&keys](const Tuple *left, const Tuple *right) {
+    for (const SortKey &key : keys) {
+      int result = compare_value(left->get(key.index), right->get(key.index));
+      if (result != 0) {
+        return key.is_desc ? result > 0 : result < 0;
+      }
+    }
+    return false;
+  });
+
+  std::vector<int> order;
+  for (const Tuple *row : sorted) {
+    if (top_n >= 0 && (int)order.size() >= top_n) {
+      break;
+    }
+    order.push_back(static_cast<const IntValue &>(row->get(SEQ)).get_value());
+  }
+  return order;
+}
+
+static std::vector<int> sort_order(const std::vector<Tuple> &rows, const std::vector<SortKey> &keys,
+                                   size_t memory_budget, int top_n)
+{
+  ExternalSorter sorter;
+  sorter.init(keys, memory_budget, top_n);
+  for (const Tuple &row : rows) {
+    Tuple tuple(row);
+    EXPECT_EQ(RC::SUCCESS, sorter.add(std::move(tuple)));
+  }
+  TupleSet result;
+  EXPECT_EQ(RC::SUCCESS, sorter.finish(result));
+
+  std::vector<int> order;
+  for (const Tuple &tuple : result.tuples()) {
+    order.push_back(static_cast<const IntValue &>(tuple.get(SEQ)).get_value());
+  }
+  return order;
+}
+
+static void check_sort(const std::vector<SortKey> &keys)
+{
+  std::vector<Tuple> rows = make_rows();
+  // 不溢出；每段几十行；每段只有几行，归并上百个段
+  for (size_t memory_budget : {(size_t)ORDER_BY_MEMORY_BUDGET, (size_t)20000, (size_t)2000}) {
+    for (int top_n : {-1, 0, 1, 10, 137, ROW_NUM + 1}) {
+      ASSERT_EQ(expected_order(rows, keys, top_n), sort_order(rows, keys, memory_budget, top_n))
+          << "memory_budget=" << memory_budget << ", top_n=" << top_n;
+    }
+  }
+}
+
+// 键相同的行很多，跨越多个有序段后仍保持输入顺序
+TEST(test_external_sorter, test_stable_asc)
+{
+  check_sort({{K, false}});
+}
+
+// 降序时NULL排在最后，键相同的行仍按输入顺序
+TEST(test_external_sorter, test_desc_null_last)
+{
+  check_sort({{K, true}});
+}
+
+// 浮点数的正负数、0和-0
+TEST(test_external_sorter, test_float_keys)
+{
+  check_sort({{F, true}, {K, false}});
+  check_sort({{F, false}});
+}
+
+// 字符串按strcmp的顺序，空串和前缀排在前面
+TEST(test_external_sorter, test_string_keys)
+{
+  check_sort({{S, false}, {F, false}});
+  check_sort({{S, true}, {K, true}});
+}
+
+TEST(test_external_sorter, test_empty_input)
+{
+  for (int top_n : {-1, 0, 10}) {
+    ASSERT_TRUE(sort_order({}, {{K, false}}, 2000, top_n).empty());
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,205 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <limits.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sql/executor/hash_aggregator.h"
+#include "gtest/gtest.h"
+
+#define ROW_NUM 5000
+#define KEY_NUM 1000
+#define NULL_KEY LLONG_MIN
+
+struct ExpectedGroup {
+  int row_num = 0;
+  int count = 0;
+  int min = 0;
+  int max = 0;
+  float sum_v = 0;
+  float sum_f = 0;
+};
+
+// 输入(k int, v int, f float)。k有NULL，也有和NULL哈希值相同的0；v有NULL；最后一组的v全是NULL
+static std::vector<Tuple> make_rows()
+{
+  std::vector<Tuple> rows;
+  for (int i = 0; i < ROW_NUM; i++) {
+    Tuple tuple;
+    tuple.add(i % KEY_NUM, i % 97 == 0);
+    tuple.add((i * 7919) % 10007 - 5000, i % 13 == 0);
+    tuple.add(i * 0.5f);
+    rows.push_back(std::move(tuple));
+  }
+  Tuple tuple;
+  tuple.add(-7);
+  tuple.add(0, true);
+  tuple.add(1.0f);
+  rows.push_back(std::move(tuple));
+  return rows;
+}
+
+static long long key_of(const TupleValue &value)
+{
+  return value.is_null() ? NULL_KEY : static_cast<const IntValue &>(value).get_value();
+}
+
+static std::map<long long, ExpectedGroup> expected_groups(const std::vector<Tuple> &rows)
+{
+  std::map<long long, ExpectedGroup> groups;
+  for (const Tuple &row : rows) {
+    ExpectedGroup &group = groups[key_of(row.get(0))];
+    group.row_num++;
+    group.sum_f += static_cast<const FloatValue &>(row.get(2)).get_value();
+    if (row.get(1).is_null()) {
+      continue;
+    }
+    int v = static_cast<const IntValue &>(row.get(1)).get_value();
+    group.min = group.count == 0 ? v : std::min(group.min, v);
+    group.max = group.count == 0 ? v : std::max(group.max, v);
+    group.sum_v += v;
+    group.count++;
+  }
+  return groups;
+}
+
+static RC aggregate(const std::vector<Tuple> &rows, int max_groups, TupleSet &result)
+{
+  TupleSchema schema;
+  schema.add(INTS, "t", "k", true);
+  schema.add(INTS, "t", "v", true);
+  schema.add(FLOATS, "t", "f", false);
+  std::vector<AggregateSpec> specs = {{FuncType::NOFUNC, 0, "k"},    {FuncType::COUNT, -1, "count(*)"},
+                                      {FuncType::COUNT, 1, "count(v)"}, {FuncType::MIN, 1, "min(v)"},
+                                      {FuncType::MAX, 1, "max(v)"},     {FuncType::AVG, 1, "avg(v)"},
+                                      {FuncType::AVG, 2, "avg(f)"}};
+  HashAggregator aggregator;
+  RC rc = aggregator.init(schema, {0}, specs, max_groups);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  for (const Tuple &row : rows) {
+    rc = aggregator.add(row);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return aggregator.finish(result);
+}
+
+static bool is_null_string(const TupleValue &value)
+{
+  const StringValue *string_value = dynamic_cast<const StringValue *>(&value);
+  return string_value != nullptr && 0 == strcmp(string_value->get_value(), "NULL");
+}
+
+static void check_groups(const std::vector<Tuple> &rows, int max_groups)
+{
+  TupleSet result;
+  ASSERT_EQ(RC::SUCCESS, aggregate(rows, max_groups, result));
+  std::map<long long, ExpectedGroup> expected = expected_groups(rows);
+  // NULL和0各是一组，哈希值相同的两组不会被合并
+  ASSERT_EQ(KEY_NUM + 2, (int)expected.size());
+  ASSERT_EQ(expected.size(), result.tuples().size());
+
+  std::map<long long, int> seen;
+  for (const Tuple &tuple : result.tuples()) {
+    long long key = key_of(tuple.get(0));
+    ASSERT_EQ(0, seen[key]++) << "group " << key << " is output twice";
+    ASSERT_EQ(1, (int)expected.count(key));
+    const ExpectedGroup &group = expected[key];
+    ASSERT_EQ(group.row_num, static_cast<const IntValue &>(tuple.get(1)).get_value());
+    ASSERT_EQ(group.count, static_cast<const IntValue &>(tuple.get(2)).get_value());
+    if (group.count == 0) {
+      ASSERT_TRUE(is_null_string(tuple.get(3)));
+      ASSERT_TRUE(is_null_string(tuple.get(4)));
+      ASSERT_TRUE(is_null_string(tuple.get(5)));
+    } else {
+      ASSERT_EQ(group.min, static_cast<const IntValue &>(tuple.get(3)).get_value());
+      ASSERT_EQ(group.max, static_cast<const IntValue &>(tuple.get(4)).get_value());
+      ASSERT_FLOAT_EQ(group.sum_v / group.count, static_cast<const FloatValue &>(tuple.get(5)).get_value());
+    }
+    ASSERT_FLOAT_EQ(group.sum_f / group.row_num, static_cast<const FloatValue &>(tuple.get(6)).get_value());
+  }
+}
+
+static std::vector<std::string> sorted_lines(const TupleSet &tuple_set)
+{
+  std::stringstream ss;
+  tuple_set.print(ss);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(ss, line)) {
+    lines.push_back(line);
+  }
+  std::sort(lines.begin(), lines.end());
+  return lines;
+}
+
+TEST(test_hash_aggregator, test_in_memory)
+{
+  check_groups(make_rows(), GROUP_BY_MAX_GROUPS);
+}
+
+// 内存中只能放下很少的分组，分区仍然超过上限时继续溢出到下一层，直到最大层数
+TEST(test_hash_aggregator, test_multi_level_spill)
+{
+  std::vector<Tuple> rows = make_rows();
+  for (int max_groups : {1, 4, 100}) {
+    check_groups(rows, max_groups);
+  }
+
+  // 溢出后各组的行仍按输入顺序累加，结果和不溢出时完全相同
+  TupleSet in_memory;
+  ASSERT_EQ(RC::SUCCESS, aggregate(rows, GROUP_BY_MAX_GROUPS, in_memory));
+  TupleSet spilled;
+  ASSERT_EQ(RC::SUCCESS, aggregate(rows, 1, spilled));
+  ASSERT_EQ(sorted_lines(in_memory), sorted_lines(spilled));
+}
+
+// 只有NULL和0两个分组，哈希值相同，溢出后也在同一个分区里
+TEST(test_hash_aggregator, test_null_key_collision)
+{
+  std::vector<Tuple> rows;
+  for (int i = 0; i < 100; i++) {
+    Tuple tuple;
+    tuple.add(0, i % 3 == 0);
+    tuple.add(i);
+    tuple.add((float)i);
+    rows.push_back(std::move(tuple));
+  }
+  for (int max_groups : {1, GROUP_BY_MAX_GROUPS}) {
+    TupleSet result;
+    ASSERT_EQ(RC::SUCCESS, aggregate(rows, max_groups, result));
+    ASSERT_EQ(2, (int)result.tuples().size());
+    for (const Tuple &tuple : result.tuples()) {
+      bool is_null = tuple.get(0).is_null();
+      ASSERT_EQ(is_null ? 34 : 66, static_cast<const IntValue &>(tuple.get(1)).get_value());
+      ASSERT_EQ(is_null ? 0 : 1, static_cast<const IntValue &>(tuple.get(3)).get_value());
+    }
+  }
+}
+
+TEST(test_hash_aggregator, test_empty_input)
+{
+  TupleSet result;
+  ASSERT_EQ(RC::SUCCESS, aggregate({}, 1, result));
+  ASSERT_EQ(0, (int)result.tuples().size());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
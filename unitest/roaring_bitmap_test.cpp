@@ -0,0 +1,149 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#include "storage/common/roaring_bitmap.h"
+#include "storage/common/bitmap_index.h"
+#include "gtest/gtest.h"
+
+static std::set<uint32_t> to_set(const RoaringBitmap &bitmap)
+{
+  std::set<uint32_t> values;
+  RoaringBitmap::Iterator iter(bitmap);
+  uint32_t value = 0;
+  uint32_t last = 0;
+  while (iter.next(&value)) {
+    EXPECT_TRUE(values.empty() || value > last);
+    values.insert(value);
+    last = value;
+  }
+  return values;
+}
+
+// 前两个容器很稠密(位图容器)，其余的很稀疏(数组容器)
+static void fill_random(RoaringBitmap &bitmap, std::set<uint32_t> &expect, int seed)
+{
+  srand(seed);
+  for (int i = 0; i < 20000; i++) {
+    uint32_t value = (rand() % 2) * 65536 + rand() % 30000;
+    bitmap.add(value);
+    expect.insert(value);
+  }
+  for (int i = 0; i < 2000; i++) {
+    uint32_t value = rand() % (1 << 24);
+    bitmap.add(value);
+    expect.insert(value);
+  }
+}
+
+TEST(test_roaring_bitmap, test_add_remove)
+{
+  RoaringBitmap bitmap;
+  std::set<uint32_t> expect;
+  fill_random(bitmap, expect, 1);
+  ASSERT_EQ(expect.size(), bitmap.cardinality());
+  ASSERT_EQ(expect, to_set(bitmap));
+
+  // 删除到数组的大小以下，位图容器转回数组容器
+  int i = 0;
+  for (auto iter = expect.begin(); iter != expect.end(); i++) {
+    if (i % 3 != 0) {
+      bitmap.remove(*iter);
+      iter = expect.erase(iter);
+    } else {
+      iter++;
+    }
+  }
+  bitmap.remove(0xFFFFFFFF);
+  ASSERT_EQ(expect.size(), bitmap.cardinality());
+  ASSERT_EQ(expect, to_set(bitmap));
+  for (uint32_t value : expect) {
+    ASSERT_TRUE(bitmap.contains(value));
+  }
+
+  for (uint32_t value : expect) {
+    bitmap.remove(value);
+  }
+  ASSERT_TRUE(bitmap.empty());
+}
+
+TEST(test_roaring_bitmap, test_and_or)
+{
+  RoaringBitmap left;
+  RoaringBitmap right;
+  std::set<uint32_t> left_expect;
+  std::set<uint32_t> right_expect;
+  fill_random(left, left_expect, 2);
+  fill_random(right, right_expect, 3);
+
+  std::set<uint32_t> and_expect;
+  std::set_intersection(left_expect.begin(), left_expect.end(), right_expect.begin(), right_expect.end(),
+                        std::inserter(and_expect, and_expect.end()));
+  std::set<uint32_t> or_expect;
+  std::set_union(left_expect.begin(), left_expect.end(), right_expect.begin(), right_expect.end(),
+                 std::inserter(or_expect, or_expect.end()));
+
+  RoaringBitmap and_result = left;
+  and_result.and_with(right);
+  ASSERT_EQ(and_expect.size(), and_result.cardinality());
+  ASSERT_EQ(and_expect, to_set(and_result));
+
+  RoaringBitmap or_result = left;
+  or_result.or_with(right);
+  ASSERT_EQ(or_expect.size(), or_result.cardinality());
+  ASSERT_EQ(or_expect, to_set(or_result));
+
+  RoaringBitmap empty;
+  or_result.and_with(empty);
+  ASSERT_TRUE(or_result.empty());
+}
+
+TEST(test_roaring_bitmap, test_serialize)
+{
+  RoaringBitmap bitmap;
+  std::set<uint32_t> expect;
+  fill_random(bitmap, expect, 4);
+
+  std::stringstream ss;
+  bitmap.write(ss);
+  RoaringBitmap loaded;
+  ASSERT_TRUE(loaded.read(ss));
+  ASSERT_EQ(expect, to_set(loaded));
+
+  std::stringstream truncated(ss.str().substr(0, ss.str().size() / 2));
+  ASSERT_FALSE(loaded.read(truncated));
+  ASSERT_TRUE(loaded.empty());
+}
+
+TEST(test_roaring_bitmap, test_bitmap_index_row)
+{
+  RID rid;
+  rid.page_num = 12345;
+  rid.slot_num = (1 << BITMAP_INDEX_SLOT_BITS) - 1;
+  uint32_t row = 0;
+  ASSERT_TRUE(BitmapIndex::rid_to_row(rid, &row));
+  RID result = BitmapIndex::row_to_rid(row);
+  ASSERT_EQ(rid.page_num, result.page_num);
+  ASSERT_EQ(rid.slot_num, result.slot_num);
+
+  rid.slot_num = 1 << BITMAP_INDEX_SLOT_BITS;
+  ASSERT_FALSE(BitmapIndex::rid_to_row(rid, &row));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,218 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <memory>
+#include <vector>
+
+#include "sql/executor/semi_join.h"
+#include "gtest/gtest.h"
+
+struct TestRow {
+  float value;
+  bool value_is_null;
+  float key;
+};
+
+// 子查询结果(value float, key float)，key_index为-1时不带关联列
+static HashSemiJoin build_join(const std::vector<TestRow> &rows, bool is_related)
+{
+  TupleSchema schema;
+  schema.add(FLOATS, "s", "value", true);
+  if (is_related) {
+    schema.add(FLOATS, "s", "key", false);
+  }
+  TupleSet sub_res;
+  sub_res.set_schema(schema);
+  for (const TestRow &row : rows) {
+    Tuple tuple;
+    tuple.add(row.value, row.value_is_null);
+    if (is_related) {
+      tuple.add(row.key);
+    }
+    sub_res.add(std::move(tuple));
+  }
+  HashSemiJoin join;
+  join.build(sub_res, 0, is_related ? 1 : -1);
+  return join;
+}
+
+static InResult probe(const HashSemiJoin &join, float value, bool is_null = false)
+{
+  FloatValue left(value, is_null);
+  return join.probe(left, nullptr);
+}
+
+static InResult probe(const HashSemiJoin &join, float value, float key, bool is_null = false)
+{
+  FloatValue left(value, is_null);
+  FloatValue key_value(key, false);
+  return join.probe(left, &key_value);
+}
+
+// 只合并完全相同的值，整数1和浮点数1.0相等但不相同
+TEST(test_semi_join, test_value_index_exact_dedupe)
+{
+  ValueIndex index;
+  ASSERT_EQ(0, index.insert(std::make_shared<IntValue>(1, false)));
+  ASSERT_EQ(0, index.insert(std::make_shared<IntValue>(1, false)));
+  ASSERT_EQ(1, index.insert(std::make_shared<FloatValue>(1.0f, false)));
+  ASSERT_EQ(2, index.insert(std::make_shared<FloatValue>(1.0009f, false)));
+  ASSERT_EQ(2, index.insert(std::make_shared<FloatValue>(1.0009f, false)));
+  ASSERT_EQ(3, index.insert(std::make_shared<FloatValue>(1.0018f, false)));
+  ASSERT_EQ(-1, index.insert(std::make_shared<IntValue>(1, true)));
+  ASSERT_EQ(4, index.size());
+
+  // 1.0和1.0018不相等，但都和1.0009相等
+  std::vector<int> indexes;
+  index.find_all(FloatValue(1.0009f, false), indexes);
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), indexes);
+  indexes.clear();
+  index.find_all(FloatValue(1.0018f, false), indexes);
+  ASSERT_EQ(std::vector<int>({2, 3}), indexes);
+  ASSERT_EQ(-1, index.find(FloatValue(1.01f, false)));
+  ASSERT_EQ(-1, index.find(IntValue(1, true)));
+}
+
+// 相差不到1e-3的浮点数落在相邻的桶里也能找到
+TEST(test_semi_join, test_near_equal_floats)
+{
+  HashSemiJoin join = build_join({{1.0f, false, 0}, {1.0009f, false, 0}, {5.0f, false, 0}}, false);
+  ASSERT_EQ(InResult::MATCH, probe(join, 1.0018f));
+  ASSERT_EQ(InResult::MATCH, probe(join, 0.9995f));
+  ASSERT_EQ(InResult::MATCH, probe(join, 4.9991f));
+  ASSERT_EQ(InResult::NO_MATCH, probe(join, 1.003f));
+  ASSERT_EQ(InResult::NO_MATCH, probe(join, 4.998f));
+}
+
+// 子查询结果为空时IN不成立、NOT IN成立，左侧是NULL也一样
+TEST(test_semi_join, test_empty_result)
+{
+  HashSemiJoin join = build_join({}, false);
+  ASSERT_EQ(InResult::NO_MATCH, probe(join, 1.0f));
+  ASSERT_EQ(InResult::NO_MATCH, probe(join, 0, true));
+
+  HashSemiJoin related_join = build_join({}, true);
+  ASSERT_EQ(InResult::NO_MATCH, related_join.probe(FloatValue(1.0f, false), nullptr));
+  ASSERT_EQ(InResult::NO_MATCH, probe(related_join, 1.0f, 1.0f));
+  ASSERT_EQ(InResult::NO_MATCH, probe(related_join, 0, 1.0f, true));
+}
+
+TEST(test_semi_join, test_null_on_left)
+{
+  HashSemiJoin join = build_join({{1.0f, false, 0}, {2.0f, false, 0}}, false);
+  ASSERT_EQ(InResult::UNKNOWN, probe(join, 0, true));
+  ASSERT_EQ(InResult::UNKNOWN, probe(join, 1.0f, true));
+}
+
+// 集合中有NULL：有匹配时IN成立，没有匹配时结果未知
+TEST(test_semi_join, test_null_in_set)
+{
+  HashSemiJoin join = build_join({{1.0f, false, 0}, {0, true, 0}}, false);
+  ASSERT_EQ(InResult::MATCH, probe(join, 1.0f));
+  ASSERT_EQ(InResult::UNKNOWN, probe(join, 3.0f));
+
+  HashSemiJoin only_null = build_join({{0, true, 0}}, false);
+  ASSERT_EQ(InResult::UNKNOWN, probe(only_null, 3.0f));
+}
+
+// 关联列的值没有对应的组时，子查询的结果为空
+TEST(test_semi_join, test_correlated_group_without_key)
+{
+  HashSemiJoin join = build_join({{1.0f, false, 10.0f}, {0, true, 20.0f}, {2.0f, false, 20.0f}}, true);
+  ASSERT_EQ(InResult::MATCH, probe(join, 1.0f, 10.0f));
+  ASSERT_EQ(InResult::NO_MATCH, probe(join, 2.0f, 10.0f));
+  ASSERT_EQ(InResult::MATCH, probe(join, 2.0f, 20.0f));
+  ASSERT_EQ(InResult::UNKNOWN, probe(join, 1.0f, 20.0f));
+  // 没有关联列等于30的组，集合为空，其它组中的NULL不影响结果
+  ASSERT_EQ(InResult::NO_MATCH, probe(join, 1.0f, 30.0f));
+  ASSERT_EQ(InResult::NO_MATCH, probe(join, 0, 30.0f, true));
+}
+
+// 主查询的关联列和两个组的关联列都相等时，子查询的结果是两组的并集
+TEST(test_semi_join, test_near_equal_keys)
+{
+  HashSemiJoin join = build_join({{1.0f, false, 2.0f}, {3.0f, false, 2.0009f}, {0, true, 2.0018f}}, true);
+  ASSERT_EQ(InResult::MATCH, probe(join, 1.0f, 2.0005f));
+  ASSERT_EQ(InResult::MATCH, probe(join, 3.0f, 2.0005f));
+  ASSERT_EQ(InResult::NO_MATCH, probe(join, 5.0f, 2.0001f));
+  // 2.0012和2.0009、2.0018两组相等，2.0018的组中有NULL
+  ASSERT_EQ(InResult::MATCH, probe(join, 3.0f, 2.0012f));
+  ASSERT_EQ(InResult::UNKNOWN, probe(join, 1.0f, 2.0012f));
+}
+
+// 按关联列分组后的子查询结果(value int, key int)
+static TupleSet build_groups(const std::vector<std::pair<int, int>> &rows)
+{
+  TupleSchema schema;
+  schema.add(INTS, "", "value", true);
+  schema.add(INTS, "s", "key", true);
+  TupleSet sub_res;
+  sub_res.set_schema(schema);
+  for (const std::pair<int, int> &row : rows) {
+    Tuple tuple;
+    tuple.add(row.first);
+    tuple.add(row.second);
+    sub_res.add(std::move(tuple));
+  }
+  return sub_res;
+}
+
+// t1(a)={1,2,3}，t2(a)={1,1,2}，select count(*) from t2 where t2.a = t1.a按t2.a分组得到(2,1)、(1,2)。
+// a=3没有对应的组，COUNT的值是0，其它聚合函数的值是NULL
+TEST(test_semi_join, test_scalar_group_without_key)
+{
+  TupleSet sub_res = build_groups({{2, 1}, {1, 2}});
+  ScalarSubqueryGroups count_groups;
+  count_groups.build(sub_res, 0, 1, std::make_shared<IntValue>(0, false));
+  ScalarSubqueryGroups max_groups;
+  max_groups.build(sub_res, 0, 1, nullptr);
+
+  IntValue zero(0, false);
+  for (int a = 1; a <= 3; a++) {
+    const std::shared_ptr<TupleValue> &count = count_groups.find(IntValue(a, false));
+    ASSERT_TRUE(count != nullptr);
+    ASSERT_EQ(a == 3, 0 == zero.compare(*count));
+  }
+  ASSERT_EQ(2, std::dynamic_pointer_cast<IntValue>(count_groups.find(IntValue(1, false)))->get_value());
+  ASSERT_TRUE(max_groups.find(IntValue(3, false)) == nullptr);
+  // 主查询的关联列是NULL时也没有对应的组
+  ASSERT_TRUE(max_groups.find(IntValue(1, true)) == nullptr);
+  ASSERT_EQ(0, std::dynamic_pointer_cast<IntValue>(count_groups.find(IntValue(1, true)))->get_value());
+
+  // 子查询没有结果时每一行的COUNT都是0
+  ScalarSubqueryGroups empty_groups;
+  empty_groups.build(build_groups({}), 0, 1, std::make_shared<IntValue>(0, false));
+  ASSERT_EQ(0, std::dynamic_pointer_cast<IntValue>(empty_groups.find(IntValue(1, false)))->get_value());
+}
+
+// 关联的COUNT子查询，没有对应组的行的结果是只有0的集合，0 IN成立
+TEST(test_semi_join, test_correlated_count_without_key)
+{
+  HashSemiJoin count_join;
+  count_join.build(build_groups({{2, 1}, {1, 2}}), 0, 1, std::make_shared<IntValue>(0, false));
+  IntValue zero(0, false);
+  IntValue two(2, false);
+  IntValue three(3, false);
+  ASSERT_EQ(InResult::NO_MATCH, count_join.probe(zero, &two));
+  ASSERT_EQ(InResult::MATCH, count_join.probe(zero, &three));
+  ASSERT_EQ(InResult::NO_MATCH, count_join.probe(two, &three));
+  ASSERT_EQ(InResult::UNKNOWN, count_join.probe(IntValue(0, true), &three));
+
+  HashSemiJoin empty_join;
+  empty_join.build(build_groups({}), 0, 1, std::make_shared<IntValue>(0, false));
+  ASSERT_EQ(InResult::MATCH, empty_join.probe(zero, &three));
+  ASSERT_EQ(InResult::NO_MATCH, empty_join.probe(two, &three));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,322 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/common/table.h"
+#include "storage/common/index.h"
+#include "storage/common/meta_util.h"
+#include "storage/common/record_manager.h"
+#include "storage/trx/trx.h"
+#include "gtest/gtest.h"
+
+#define ROW_NUM 3000
+
+// 表t(a int, b int, c int)，都不允许为空
+static void create_table(Table &table, const char *table_name)
+{
+  std::string meta_file = table_meta_file(".", table_name);
+  std::string data_file = std::string("./") + table_name + TABLE_DATA_SUFFIX;
+  unlink(meta_file.c_str());
+  unlink(data_file.c_str());
+
+  AttrInfo attrs[3];
+  const char *names[3] = {"a", "b", "c"};
+  for (int i = 0; i < 3; i++) {
+    attrs[i].name = (char *)names[i];
+    attrs[i].type = INTS;
+    attrs[i].length = sizeof(int);
+    attrs[i].is_nullable = 0;
+  }
+  ASSERT_EQ(RC::SUCCESS, table.create(meta_file.c_str(), table_name, ".", 3, attrs));
+}
+
+static void remove_table(const char *table_name, const std::vector<const char *> &index_names)
+{
+  unlink(table_meta_file(".", table_name).c_str());
+  unlink((std::string("./") + table_name + TABLE_DATA_SUFFIX).c_str());
+  for (const char *index_name : index_names) {
+    unlink(index_data_file(".", table_name, index_name).c_str());
+  }
+}
+
+static RC insert_row(Table &table, int a, int b, int c)
+{
+  int data[3] = {a, b, c};
+  Value values[3];
+  for (int i = 0; i < 3; i++) {
+    values[i].type = INTS;
+    values[i].data = &data[i];
+    values[i].is_null = 0;
+  }
+  return table.insert_record(nullptr, 3, values);
+}
+
+static Condition make_equal_condition(const char *field_name, int *value)
+{
+  Condition condition;
+  memset(&condition, 0, sizeof(condition));
+  condition.comp = EQUAL_TO;
+  condition.left_is_attr = 1;
+  condition.left_attr.attribute_name = (char *)field_name;
+  condition.right_is_attr = 0;
+  condition.right_value.type = INTS;
+  condition.right_value.data = value;
+  return condition;
+}
+
+// 用TableScanner扫描，返回每行的字段c，同时检查是否使用了RID集合求交
+static std::vector<int> scan_c(Table &table, ConditionFilter &filter, const char *field_names[], int field_num,
+                               bool &intersected)
+{
+  std::vector<int> result;
+  TableScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, scanner.open(&table, nullptr, &filter, field_names, field_num));
+  intersected = dynamic_cast<const RidSetScanner *>(scanner.index_scanner()) != nullptr;
+  EXPECT_FALSE(intersected && scanner.index_only());
+
+  int c_offset = table.table_meta().field("c")->offset();
+  Record record;
+  RC rc = RC::SUCCESS;
+  while ((rc = scanner.next(record)) == RC::SUCCESS) {
+    result.push_back(*(const int *)(record.data + c_offset));
+  }
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+  scanner.close();
+  return result;
+}
+
+TEST(test_table_index, test_index_intersection)
+{
+  const char *table_name = "index_intersection_t";
+  Table table;
+  create_table(table, table_name);
+
+  // a有20个取值，b有30个取值，a和b同时确定时只有少数几行。一部分行有重复的(a, b)
+  std::vector<int> rows_a;
+  std::vector<int> rows_b;
+  for (int i = 0; i < ROW_NUM; i++) {
+    int a = i % 20;
+    int b = (i / 20) % 30;
+    rows_a.push_back(a);
+    rows_b.push_back(b);
+    ASSERT_EQ(RC::SUCCESS, insert_row(table, a, b, i));
+  }
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_a", "a", 0));
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_b", "b", 0));
+
+  const char *field_names[3] = {"a", "b", "c"};
+  int keys[][2] = {{3, 7}, {19, 29}, {0, 0}, {5, 31}, {25, 1}};
+  for (auto &key : keys) {
+    Condition conditions[2] = {make_equal_condition("a", &key[0]), make_equal_condition("b", &key[1])};
+    CompositeConditionFilter filter;
+    ASSERT_EQ(RC::SUCCESS, filter.init(table, conditions, 2));
+
+    std::vector<int> expected;
+    for (int i = 0; i < ROW_NUM; i++) {
+      if (rows_a[i] == key[0] && rows_b[i] == key[1]) {
+        expected.push_back(i);
+      }
+    }
+
+    // 只读取索引字段时也要回表，两个单字段索引都不能覆盖另一个条件的字段
+    bool intersected = false;
+    std::vector<int> result = scan_c(table, filter, field_names, 2, intersected);
+    ASSERT_TRUE(intersected);
+    std::sort(result.begin(), result.end());
+    ASSERT_EQ(expected, result);
+
+    result = scan_c(table, filter, field_names, 3, intersected);
+    ASSERT_TRUE(intersected);
+    std::sort(result.begin(), result.end());
+    ASSERT_EQ(expected, result);
+  }
+
+  // 有联合索引时不再求交集
+  const char *multi_fields[2] = {"a", "b"};
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_ab", 2, multi_fields, 0));
+  int a = 3;
+  int b = 7;
+  Condition conditions[2] = {make_equal_condition("a", &a), make_equal_condition("b", &b)};
+  CompositeConditionFilter filter;
+  ASSERT_EQ(RC::SUCCESS, filter.init(table, conditions, 2));
+  bool intersected = true;
+  std::vector<int> result = scan_c(table, filter, field_names, 3, intersected);
+  ASSERT_FALSE(intersected);
+  ASSERT_EQ(ROW_NUM / 600, (int)result.size());
+
+  remove_table(table_name, {"i_a", "i_b", "i_ab"});
+}
+
+struct ColumnCollector {
+  int offset;
+  std::vector<int> values;
+};
+
+static void collect_column(const char *data, void *context)
+{
+  ColumnCollector &collector = *(ColumnCollector *)context;
+  collector.values.push_back(*(const int *)(data + collector.offset));
+}
+
+/**
+ * 在另一个线程中插入、删除记录。建索引的线程每次调用hook时请求一次写入并等待它完成，
+ * 写入就落在扫描或者回放日志的中途，每次运行的交错方式都相同
+ */
+class ConcurrentWriter {
+public:
+  explicit ConcurrentWriter(Table &table, int next_c) : table_(table), next_c_(next_c), row_num_(next_c)
+  {
+    thread_ = std::thread([this]() { run(); });
+  }
+
+  ~ConcurrentWriter()
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    thread_.join();
+  }
+
+  static void hook(void *context)
+  {
+    ConcurrentWriter &writer = *(ConcurrentWriter *)context;
+    std::unique_lock<std::mutex> lock(writer.mutex_);
+    writer.requested_++;
+    writer.cond_.notify_all();
+    writer.cond_.wait(lock, [&writer]() { return writer.done_ == writer.requested_; });
+  }
+
+  int row_num() const
+  {
+    return row_num_;
+  }
+  int failed_num() const
+  {
+    return failed_num_;
+  }
+  int op_num() const
+  {
+    return done_;
+  }
+
+private:
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cond_.wait(lock, [this]() { return stop_ || done_ < requested_; });
+      if (stop_) {
+        return;
+      }
+      write(done_);
+      done_++;
+      cond_.notify_all();
+    }
+  }
+
+  // 每次插入一行新记录。新记录会填进删除留下的空位，也会追加到文件末尾，落在扫描位置的前后两侧；
+  // 再删除一行记录，原有的和新插入的都可能被选中。
+  // 和SQL一样在事务中删除，扫描索引时只做标记，提交时才修改记录文件和索引
+  void write(int k)
+  {
+    int c = next_c_++;
+    if (insert_row(table_, c % 100, c, c) != RC::SUCCESS) {
+      failed_num_++;
+    } else {
+      row_num_++;
+    }
+
+    int victim = (int)((long)k * 7919 % next_c_);
+    Condition condition = make_equal_condition("c", &victim);
+    DefaultConditionFilter filter;
+    Trx trx;
+    int deleted_count = 0;
+    if (filter.init(table_, condition) != RC::SUCCESS ||
+        table_.delete_record(&trx, &filter, &deleted_count) != RC::SUCCESS || trx.commit() != RC::SUCCESS) {
+      failed_num_++;
+      return;
+    }
+    row_num_ -= deleted_count;
+  }
+
+private:
+  Table &table_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  int requested_ = 0;
+  int done_ = 0;
+  bool stop_ = false;
+  int next_c_;
+  int row_num_;
+  int failed_num_ = 0;
+};
+
+// 建索引的同时另一个线程不断插入、删除记录，建好后每个索引都要和记录文件完全一致
+TEST(test_table_index, test_online_index_build)
+{
+  const char *table_name = "online_index_build_t";
+  remove_table(table_name, {"i_c", "i_a", "i_b", "i_ab"});
+  Table table;
+  create_table(table, table_name);
+  for (int i = 0; i < ROW_NUM; i++) {
+    ASSERT_EQ(RC::SUCCESS, insert_row(table, i % 100, i, i));
+  }
+  // 写入者按c删除记录，用这个索引定位
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_c", "c", 1));
+
+  const char *multi_fields[2] = {"a", "b"};
+  int row_num = 0;
+  {
+    ConcurrentWriter writer(table, ROW_NUM);
+    table.set_index_build_hook(ConcurrentWriter::hook, &writer);
+    ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_a", "a", 0));
+    ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_b", "b", 1));
+    ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, "i_ab", 2, multi_fields, 0));
+    table.set_index_build_hook(nullptr, nullptr);
+    ASSERT_EQ(0, writer.failed_num());
+    ASSERT_LT(ROW_NUM * 3, writer.op_num());
+    row_num = writer.row_num();
+  }
+
+  ColumnCollector heap;
+  heap.offset = table.table_meta().field("c")->offset();
+  ASSERT_EQ(RC::SUCCESS, table.scan_record(nullptr, nullptr, -1, &heap, collect_column));
+  std::sort(heap.values.begin(), heap.values.end());
+  ASSERT_EQ(row_num, (int)heap.values.size());
+
+  // 没有多余的索引项，也没有缺少的索引项：沿索引回表得到的记录和全表扫描相同
+  for (const char *index_name : {"i_c", "i_a", "i_b", "i_ab"}) {
+    ColumnCollector indexed;
+    indexed.offset = heap.offset;
+    ASSERT_EQ(RC::SUCCESS,
+              table.scan_record_in_index_order(nullptr, nullptr, index_name, false, -1, &indexed, collect_column));
+    std::sort(indexed.values.begin(), indexed.values.end());
+    ASSERT_EQ(heap.values, indexed.values) << index_name;
+  }
+
+  remove_table(table_name, {"i_c", "i_a", "i_b", "i_ab"});
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
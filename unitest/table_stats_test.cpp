@@ -0,0 +1,105 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "storage/common/table_stats.h"
+#include "json/json.h"
+#include "gtest/gtest.h"
+
+#define ROW_NUM 1000
+
+// 字段a取值0..999，每个值出现一次；另外有ROW_NUM / 10行的a为NULL
+static TableStats make_stats(FieldMeta &field)
+{
+  field.init("a", INTS, 4, sizeof(int), true, true);
+  static int data[ROW_NUM];
+  std::vector<const char *> values;
+  for (int i = ROW_NUM - 1; i >= 0; i--) {
+    data[i] = i;
+    values.push_back((const char *)&data[i]);
+  }
+  ColumnStats column;
+  column.init(field, values, ROW_NUM / 10);
+
+  TableStats stats;
+  stats.reset(ROW_NUM + ROW_NUM / 10);
+  stats.add_column(column);
+  IndexStats index;
+  index.index_name = "i_a";
+  index.height = 2;
+  index.leaf_num = 8;
+  stats.add_index(index);
+  return stats;
+}
+
+TEST(test_table_stats, test_selectivity)
+{
+  FieldMeta field;
+  TableStats stats = make_stats(field);
+  const ColumnStats *column = stats.column("a");
+  ASSERT_NE(nullptr, column);
+  ASSERT_EQ(ROW_NUM, column->ndv);
+  ASSERT_EQ(0, *(const int *)column->min_value.data());
+  ASSERT_EQ(ROW_NUM - 1, *(const int *)column->max_value.data());
+  ASSERT_EQ(STATS_HISTOGRAM_BUCKETS, (int)column->bounds.size());
+
+  double nonnull_frac = (double)ROW_NUM / (ROW_NUM + ROW_NUM / 10);
+  int value = 500;
+  ASSERT_NEAR(nonnull_frac / ROW_NUM, stats.selectivity("a", EQUAL_TO, (const char *)&value), 1e-9);
+  ASSERT_NEAR(0.5 * nonnull_frac, stats.selectivity("a", LESS_THAN, (const char *)&value), 0.05);
+  ASSERT_NEAR(0.5 * nonnull_frac, stats.selectivity("a", GREAT_EQUAL, (const char *)&value), 0.05);
+  ASSERT_NEAR(1 - nonnull_frac, stats.selectivity("a", IS_NULL, nullptr), 1e-9);
+
+  // 超出取值范围
+  value = ROW_NUM;
+  ASSERT_EQ(0, stats.selectivity("a", EQUAL_TO, (const char *)&value));
+  ASSERT_NEAR(nonnull_frac, stats.selectivity("a", LESS_THAN, (const char *)&value), 1e-9);
+  value = -1;
+  ASSERT_EQ(0, stats.selectivity("a", LESS_EQUAL, (const char *)&value));
+
+  // 没有统计信息的字段
+  ASSERT_LT(stats.selectivity("b", EQUAL_TO, (const char *)&value), 0);
+  TableStats empty;
+  ASSERT_FALSE(empty.analyzed());
+  ASSERT_LT(empty.selectivity("a", EQUAL_TO, (const char *)&value), 0);
+}
+
+TEST(test_table_stats, test_json)
+{
+  FieldMeta field;
+  TableStats stats = make_stats(field);
+  Json::Value json_value;
+  stats.to_json(json_value);
+
+  TableStats loaded;
+  ASSERT_EQ(RC::SUCCESS, TableStats::from_json({field}, json_value, loaded));
+  ASSERT_TRUE(loaded.analyzed());
+  ASSERT_EQ(stats.row_num(), loaded.row_num());
+  const ColumnStats *column = loaded.column("a");
+  ASSERT_NE(nullptr, column);
+  ASSERT_EQ(ROW_NUM, column->ndv);
+  ASSERT_EQ(ROW_NUM / 10, column->null_num);
+  ASSERT_EQ(stats.column("a")->bounds, column->bounds);
+  const IndexStats *index = loaded.index("i_a");
+  ASSERT_NE(nullptr, index);
+  ASSERT_EQ(2, index->height);
+  ASSERT_EQ(8, index->leaf_num);
+
+  int value = 123;
+  ASSERT_EQ(stats.selectivity("a", GREAT_THAN, (const char *)&value),
+            loaded.selectivity("a", GREAT_THAN, (const char *)&value));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}